@@ -56,6 +56,9 @@ class TrainCfg {
     this->loss_name_ = rhs.loss_name_;
     this->mix_precision_cfg_ = rhs.mix_precision_cfg_;
     this->accumulate_gradients_ = rhs.accumulate_gradients_;
+    this->enable_recompute_ = rhs.enable_recompute_;
+    this->recompute_checkpoints_ = rhs.recompute_checkpoints_;
+    this->recompute_memory_budget_ = rhs.recompute_memory_budget_;
   }
   ~TrainCfg() = default;
 
@@ -64,6 +67,9 @@ class TrainCfg {
     "loss_fct", "_loss_fn", "SigmoidCrossEntropy"}; /**< Set part of the name that identify a loss kernel */
   MixPrecisionCfg mix_precision_cfg_;               /**< Mix precision configuration */
   bool accumulate_gradients_ = false;
+  bool enable_recompute_ = false; /**< If true the activations are freed in forward and recomputed in backprop */
+  std::vector<std::string> recompute_checkpoints_; /**< Part of the names of kernels whose outputs are kept */
+  size_t recompute_memory_budget_ = 0; /**< The budget of tensor memory when checkpoints are chosen automatically */
 };
 }  // namespace mindspore
 #endif  // MINDSPORE_INCLUDE_API_CFG_H
@@ -69,6 +69,12 @@ constexpr auto kLifeStart = "life_start";
 constexpr auto kLifeEnd = "life_end";
 constexpr auto kOffset = "offset";
 constexpr auto kCachedResultThreshold = 2000;
+constexpr auto kAlgorithm = "algorithm";
+constexpr auto kSorting = "sorting";
+constexpr auto kFitting = "fitting";
+constexpr auto kStructureHash = "structure_hash";
+// Cache the somas result of all the graphs whatever the graph size.
+constexpr char kSomasCacheEnv[] = "MS_DEV_SOMAS_CACHE";
 constexpr size_t kLogMergedBlockSize = 10;
 
 // set somas result
@@ -191,7 +197,8 @@ size_t Somas::GetCommunicationReservedSize() const { return 0; }
 void Somas::CommunicationTensorProcess(const std::vector<SomasTensorPtr> &tensors) const {}
 
 bool Somas::GetEnableCacheFlag(const session::KernelGraph &graph) const {
-  return graph.execution_order().size() >= kCachedResultThreshold;
+  static const bool enable_all_cache = (common::GetEnv(kSomasCacheEnv) == "1");
+  return enable_all_cache || graph.execution_order().size() >= kCachedResultThreshold;
 }
 
 std::pair<bool, std::string> Somas::GetDebugConfig() const {
@@ -260,6 +267,73 @@ bool Somas::LoadSomasCache(const session::KernelGraph &graph) {
   return ret;
 }
 
+std::string Somas::CalcSomasStructureHash() const {
+  std::ostringstream oss;
+  for (const auto &tensor : tensors_list_) {
+    MS_EXCEPTION_IF_NULL(tensor);
+    const auto &solver_tensor = tensor->GetSolverTensorDesc();
+    if (solver_tensor == nullptr) {
+      continue;
+    }
+    oss << solver_tensor->index_ << ':' << solver_tensor->size_ << ':' << solver_tensor->lifelong_ << ':'
+        << tensor->lifetime_.start_ << ':' << tensor->lifetime_.end_ << ';';
+  }
+  oss << '|';
+  for (const auto &contiguous_list : processed_contiguous_tensors_list_) {
+    for (auto index : contiguous_list) {
+      oss << index << ',';
+    }
+    oss << ';';
+  }
+  oss << '|';
+  for (const auto &reuse_bits : reuse_matrix_) {
+    for (auto bits : reuse_bits.bit_) {
+      oss << std::hex << bits << std::dec << ',';
+    }
+    oss << ';';
+  }
+  return std::to_string(std::hash<std::string>()(oss.str()));
+}
+
+std::string Somas::GetSomasStrategyFileName(const std::string &structure_hash) const {
+  return Common::GetCompilerCachePath() + "/somas_meta/somas_strategy_" + structure_hash + ".json";
+}
+
+std::optional<SomasStrategy> Somas::LoadSomasStrategy(const std::string &structure_hash) const {
+  auto filename = GetSomasStrategyFileName(structure_hash);
+  std::ifstream strategy_fs(filename);
+  if (!strategy_fs.is_open()) {
+    MS_LOG(INFO) << "Open json file: " << filename << " error, Somas strategy Cache Missed.";
+    return std::nullopt;
+  }
+  try {
+    nlohmann::json strategy_json;
+    strategy_fs >> strategy_json;
+    if (strategy_json[kStructureHash].get<std::string>() != structure_hash) {
+      MS_LOG(INFO) << "The structure hash of Somas strategy file " << filename << " mismatches, Somas strategy Cache "
+                   << "Missed.";
+      return std::nullopt;
+    }
+    SomasStrategy strategy{static_cast<AlgorithmType>(strategy_json[kAlgorithm].get<int>()),
+                           static_cast<SortingType>(strategy_json[kSorting].get<int>()),
+                           static_cast<FittingType>(strategy_json[kFitting].get<int>())};
+    MS_LOG(INFO) << "Load Somas strategy file " << filename << " Successfully.";
+    return strategy;
+  } catch (const std::exception &e) {
+    MS_LOG(INFO) << "Parse json file error: " << filename << ", " << e.what();
+  }
+  return std::nullopt;
+}
+
+void Somas::SaveSomasStrategy(const std::string &structure_hash, const SomasStrategy &strategy) const {
+  nlohmann::json strategy_json;
+  strategy_json[kStructureHash] = structure_hash;
+  strategy_json[kAlgorithm] = static_cast<int>(strategy.algorithm);
+  strategy_json[kSorting] = static_cast<int>(strategy.sorting);
+  strategy_json[kFitting] = static_cast<int>(strategy.fitting);
+  (void)Common::SaveStringToFile(GetSomasStrategyFileName(structure_hash), strategy_json.dump());
+}
+
 bool Somas::CalcSomasModelHash(const session::KernelGraph &graph) {
   auto model_str = SomasInfo(true);
   hash_id_ = std::to_string(std::hash<std::string>()(model_str));
@@ -1532,9 +1606,23 @@ void Somas::Solve(const session::KernelGraph &graph) {
   }
 
   somas_solver_ = std::make_shared<SomasSolverPre>();
+  somas_solver_->SetLowerBound(CalcSolverLowerBound());
+  // The graph changed since the last compilation but the memory layout problem didn't, such as the renamed nodes, and
+  // the best strategy of the last compilation is solved first.
+  std::string structure_hash;
+  if (enable_cache_) {
+    structure_hash = CalcSomasStructureHash();
+    auto strategy = LoadSomasStrategy(structure_hash);
+    if (strategy.has_value()) {
+      somas_solver_->SetPreferredStrategy(strategy.value());
+    }
+  }
   auto status =
     somas_solver_->Solving(graph, &solver_tensor_desc_map_, &reuse_matrix_, processed_contiguous_tensors_list_, false);
   MS_LOG(INFO) << "End Solving";
+  if (enable_cache_ && status == SUCCESS) {
+    SaveSomasStrategy(structure_hash, somas_solver_->GetBestStrategy());
+  }
 
   GenGraphStatisticInfo();
 
@@ -2009,6 +2097,68 @@ void Somas::DumpOfflineIR(const string &filename) const {
   (void)Common::SaveStringToFile(filename, Offline());
 }
 
+size_t Somas::CalcSolverLowerBound() const {
+  // Find the time when the total size of the living solver tensors is max.
+  std::map<size_t, int64_t> size_changes;
+  size_t lifelong_size = 0;
+  for (const auto &tensor : tensors_list_) {
+    MS_EXCEPTION_IF_NULL(tensor);
+    const auto &solver_tensor = tensor->GetSolverTensorDesc();
+    if (solver_tensor == nullptr) {
+      continue;
+    }
+    if (solver_tensor->lifelong_) {
+      lifelong_size += solver_tensor->size_;
+      continue;
+    }
+    size_changes[tensor->lifetime_.start_] += SizeToLong(solver_tensor->size_);
+    size_changes[tensor->lifetime_.end_ + 1] -= SizeToLong(solver_tensor->size_);
+  }
+  int64_t living_size = 0;
+  int64_t max_living_size = 0;
+  size_t max_time = 0;
+  for (const auto &size_change : size_changes) {
+    living_size += size_change.second;
+    if (living_size > max_living_size) {
+      max_living_size = living_size;
+      max_time = size_change.first;
+    }
+  }
+
+  // The living tensors may share the memory by the reuse matrix, and only the tensors which conflict with each other
+  // pairwise can't share the memory, so the total size of them is the lower bound of all the solutions.
+  std::vector<SomasSolverTensorDescPtr> living_tensors;
+  for (const auto &tensor : tensors_list_) {
+    const auto &solver_tensor = tensor->GetSolverTensorDesc();
+    if (solver_tensor != nullptr && !solver_tensor->lifelong_ && tensor->lifetime_.start_ <= max_time &&
+        tensor->lifetime_.end_ >= max_time) {
+      living_tensors.push_back(solver_tensor);
+    }
+  }
+  std::sort(living_tensors.begin(), living_tensors.end(),
+            [](const SomasSolverTensorDescPtr &t1, const SomasSolverTensorDescPtr &t2) {
+              return t1->size_ > t2->size_;
+            });
+  std::vector<size_t> conflict_tensors;
+  size_t conflict_size = 0;
+  for (const auto &solver_tensor : living_tensors) {
+    if (solver_tensor->index_ >= reuse_matrix_.size()) {
+      continue;
+    }
+    bool conflict_all = std::all_of(conflict_tensors.begin(), conflict_tensors.end(), [&](size_t index) {
+      return !reuse_matrix_[solver_tensor->index_].IsBitTrue(index) &&
+             !reuse_matrix_[index].IsBitTrue(solver_tensor->index_);
+    });
+    if (conflict_all) {
+      conflict_tensors.push_back(solver_tensor->index_);
+      conflict_size += solver_tensor->size_;
+    }
+  }
+  MS_LOG(INFO) << "Somas solver lower bound: " << conflict_size << " Bytes from " << conflict_tensors.size()
+               << " conflict tensors and " << lifelong_size << " Bytes from lifelong tensors.";
+  return conflict_size + lifelong_size;
+}
+
 size_t Somas::CalcLowerBound() const {
   size_t max_node_id = std::accumulate(tensors_list_.begin(), tensors_list_.end(), 0, [](size_t max_id, auto tensor) {
     return std::max(max_id, tensor->lifetime_.end_);
@@ -24,6 +24,7 @@
 #include <vector>
 #include <stack>
 #include <set>
+#include <optional>
 
 #include "utils/hash_map.h"
 #include "utils/hash_set.h"
@@ -212,11 +213,19 @@ class BACKEND_EXPORT Somas {
   bool UpdateTensorsOffset(const std::vector<nlohmann::json> &tensors_json);
   bool CalcSomasModelHash(const session::KernelGraph &graph);
   bool LoadSomasCache(const session::KernelGraph &graph);
+  // The hash of the sizes, lifetimes, contiguous lists and reuse matrix of the solver tensors, the best strategy is
+  // only reused by the graph of the same hash.
+  std::string CalcSomasStructureHash() const;
+  std::string GetSomasStrategyFileName(const std::string &structure_hash) const;
+  std::optional<SomasStrategy> LoadSomasStrategy(const std::string &structure_hash) const;
+  void SaveSomasStrategy(const std::string &structure_hash, const SomasStrategy &strategy) const;
 
   // log
   std::string Offline() const;
   void DumpOfflineIR(const string &filename) const;
   size_t CalcLowerBound() const;
+  // The lower bound of the solver footprint which is valid for all the solving strategies.
+  size_t CalcSolverLowerBound() const;
   void GenGraphStatisticInfo();
   void DumpParameters(std::ostringstream &oss) const;
   void DumpTensors(std::ostringstream &oss) const;
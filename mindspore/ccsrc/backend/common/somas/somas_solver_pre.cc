@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <atomic>
 #include "include/common/thread_pool.h"
 
 #include "backend/common/somas/somas_solver_core.h"
@@ -106,6 +107,10 @@ void FindBest(size_t total_sol, const vector<std::shared_ptr<SomasSolverCore>> &
   for (size_t sol = 0; sol < total_sol; sol++) {
     auto &solver = solvers[sol];
     auto &upperbound = solver->GetUpperbound();
+    // The solver is skipped when the other solver reaches the lower bound.
+    if (upperbound == SIZE_MAX) {
+      continue;
+    }
     if (upperbound > best_info->worst) {
       best_info->worst = upperbound;
     }
@@ -122,6 +127,33 @@ void FindBest(size_t total_sol, const vector<std::shared_ptr<SomasSolverCore>> &
     best_info->best_timing = LongToSize(solver->timing_);
   }
 }
+vector<SomasStrategy> SomasSolverPre::GetStrategies() const {
+  vector<SomasStrategy> strategies;
+  auto preferred_strategy = preferred_strategy_;
+  // The cached strategy may be out of the strategies supported by this build.
+  if (preferred_strategy.has_value() && (preferred_strategy->algorithm >= kNumAlgorithmTypes ||
+                                         preferred_strategy->sorting >= kNumSortingTypes ||
+                                         preferred_strategy->fitting >= kNumFittingTypes)) {
+    preferred_strategy = std::nullopt;
+  }
+  if (preferred_strategy.has_value()) {
+    strategies.push_back(preferred_strategy.value());
+  }
+  for (size_t algorithm = 0; algorithm < static_cast<size_t>(kNumAlgorithmTypes); algorithm++) {
+    for (size_t sorting = 0; sorting < static_cast<size_t>(kNumSortingTypes); sorting++) {
+      for (size_t fitting = 0; fitting < static_cast<size_t>(kNumFittingTypes); fitting++) {
+        SomasStrategy strategy{AlgorithmType(algorithm), SortingType(sorting), FittingType(fitting)};
+        if (preferred_strategy.has_value() && preferred_strategy->algorithm == strategy.algorithm &&
+            preferred_strategy->sorting == strategy.sorting && preferred_strategy->fitting == strategy.fitting) {
+          continue;
+        }
+        strategies.push_back(strategy);
+      }
+    }
+  }
+  return strategies;
+}
+
 Status SomasSolverPre::Solving(const session::KernelGraph &graph, TensorsDescMap *ptensors,
                                const std::vector<DynamicBitSet> *pConstraints,
                                const vector<vector<size_t>> &continuous_v, bool bVerifySolution, bool ball,
@@ -142,27 +174,46 @@ Status SomasSolverPre::Solving(const session::KernelGraph &graph, TensorsDescMap
       return FAILED;
     }
     auto start = std::chrono::system_clock::now();
-    for (size_t algorithm_strategy = 0, sol = 0; algorithm_strategy < numAlgorithmTypes; algorithm_strategy++) {
-      for (size_t sort_strategy = 0; sort_strategy < numSortingTypes; sort_strategy++) {
-        for (size_t branching_strategy = 0; branching_strategy < numFittingTypes; branching_strategy++) {
-          std::shared_ptr<SomasSolverCore> pSolver =
-            std::make_shared<SomasSolverCore>(vecTensorsMap[sol], pConstraints, sol);
-          pSolver->SetAlgorithmStrategy(AlgorithmType(algorithm_strategy));
-          pSolver->SetSortingStrategy(SortingType(sort_strategy));
-          pSolver->SetFittingStrategy(FittingType(branching_strategy));
-          pSolver->VerifySolution(bVerifySolution);
-          auto task = [pSolver]() {
-            return pSolver->MemoryAllocationSolver() == SUCCESS ? common::SUCCESS : common::FAIL;
-          };
-          tasks.emplace_back(task);
-          solvers.emplace_back(pSolver);
-          sol++;
+    // The strategies are solved in parallel, and the remaining strategies are skipped once the lower bound is reached.
+    auto reach_lower_bound = std::make_shared<std::atomic<bool>>(false);
+    auto solved_num = std::make_shared<std::atomic<size_t>>(0);
+    auto lower_bound = lower_bound_;
+    auto strategies = GetStrategies();
+    for (size_t sol = 0; sol < total_sol; sol++) {
+      std::shared_ptr<SomasSolverCore> pSolver =
+        std::make_shared<SomasSolverCore>(vecTensorsMap[sol], pConstraints, sol);
+      pSolver->SetAlgorithmStrategy(strategies[sol].algorithm);
+      pSolver->SetSortingStrategy(strategies[sol].sorting);
+      pSolver->SetFittingStrategy(strategies[sol].fitting);
+      pSolver->VerifySolution(bVerifySolution);
+      auto task = [pSolver, reach_lower_bound, solved_num, lower_bound]() {
+        if (reach_lower_bound->load()) {
+          return common::SUCCESS;
         }
-      }
+        auto ret = pSolver->MemoryAllocationSolver();
+        (void)solved_num->fetch_add(1);
+        if (lower_bound != 0 && pSolver->GetUpperbound() <= lower_bound) {
+          reach_lower_bound->store(true);
+        }
+        return ret == SUCCESS ? common::SUCCESS : common::FAIL;
+      };
+      tasks.emplace_back(task);
+      solvers.emplace_back(pSolver);
     }
-    common::ThreadPool::GetInstance().SyncRun(tasks);
+    // The preferred strategy is solved alone first, and the others are not solved if it reaches the lower bound.
+    if (preferred_strategy_.has_value() && !tasks.empty()) {
+      (void)tasks.front()();
+      (void)tasks.erase(tasks.begin());
+    }
+    if (!reach_lower_bound->load()) {
+      common::ThreadPool::GetInstance().SyncRun(tasks);
+    }
+    solved_num_ = solved_num->load();
     BestInfo best_info;
     FindBest(total_sol, solvers, &best_info);
+    if (best_info.best == SIZE_MAX) {
+      MS_LOG(EXCEPTION) << "All the somas solvers failed.";
+    }
     auto end = std::chrono::system_clock::now();
     size_t total_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
     auto &best_solver = solvers[best_info.best_sol];
@@ -170,6 +221,7 @@ Status SomasSolverPre::Solving(const session::KernelGraph &graph, TensorsDescMap
       *(tensor.second.get()) = *(vecTensorsMap[best_info.best_sol][tensor.first]);
     }
     max_offset_ = best_solver->GetUpperbound();
+    best_strategy_ = strategies[best_info.best_sol];
     constexpr float kFloatPresent = 100.0;
     MS_LOG(INFO) << "SOMAS SOLVER RESUME:";
     MS_LOG(INFO) << "Best Solution:[" << 1 + best_info.best_sol << "/" << total_sol << "] ";
@@ -181,6 +233,8 @@ Status SomasSolverPre::Solving(const session::KernelGraph &graph, TensorsDescMap
     MS_LOG(INFO) << "Best sorting strategy: " << sortingNames[best_solver->sort_strategy_];
     MS_LOG(INFO) << "Best offset strategy: " << branchingNames[best_solver->branching_strategy_];
     MS_LOG(INFO) << "Time elapsed: " << total_time << " ms";
+    MS_LOG(INFO) << "Lower bound: " << lower_bound_ << " Bytes, reached: " << reach_lower_bound->load()
+                 << ", solved strategies: " << solved_num_ << "/" << total_sol;
     MS_LOG(INFO) << "Spread:"
                  << static_cast<double>((best_info.worst - best_info.best) /
                                         static_cast<double>(best_info.best * kFloatPresent))
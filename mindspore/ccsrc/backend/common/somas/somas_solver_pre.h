@@ -26,6 +26,7 @@
 #include <stack>
 #include <vector>
 #include <climits>
+#include <optional>
 #include "utils/hash_map.h"
 #include "backend/common/session/kernel_graph.h"
 
@@ -66,6 +67,12 @@ enum FittingType {
   kNumFittingTypes
 };
 
+struct SomasStrategy {
+  AlgorithmType algorithm;
+  SortingType sorting;
+  FittingType fitting;
+};
+
 struct BestInfo {
   size_t best_sol, worst, best, best_timing;
   AlgorithmType best_algo;
@@ -190,6 +197,14 @@ class SomasSolverPre {
   SomasSolverPre &operator=(const SomasSolverPre &) = delete;
 
   size_t GetMaxOffset() const { return max_offset_; }
+  // The solving stops early when the footprint of any strategy reaches the lower bound, which must be valid for all
+  // the strategies. Zero means no lower bound.
+  void SetLowerBound(size_t lower_bound) { lower_bound_ = lower_bound; }
+  // The strategy is solved first, such as the best strategy of the last compilation of graph.
+  void SetPreferredStrategy(const SomasStrategy &strategy) { preferred_strategy_ = strategy; }
+  const SomasStrategy &GetBestStrategy() const { return best_strategy_; }
+  // The number of the strategies solved by the last solving, the others are skipped by the lower bound.
+  size_t GetSolvedNum() const { return solved_num_; }
 
   Status Solving(const session::KernelGraph &graph, TensorsDescMap *ptensors,
                  const std::vector<DynamicBitSet> *pConstraints, const vector<vector<size_t>> &continuous_v,
@@ -208,6 +223,11 @@ class SomasSolverPre {
 
  private:
   size_t max_offset_;
+  size_t lower_bound_{0};
+  size_t solved_num_{0};
+  std::optional<SomasStrategy> preferred_strategy_;
+  SomasStrategy best_strategy_{kManyObjects, kGreaterSizeSmallerIndex, kBest};
+  vector<SomasStrategy> GetStrategies() const;
   void SolverInputLog(const session::KernelGraph &graph, const TensorsDescMap &tensors,
                       const vector<vector<size_t>> &continuous_v) const;
   void SolverOutputLog(const session::KernelGraph &graph, const TensorsDescMap &tensors) const;
@@ -16,7 +16,13 @@
 
 #include "common/mem_reuse/mem_dynamic_allocator.h"
 #include <string>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <unistd.h>
 #include "include/common/utils/convert_utils.h"
+#include "include/common/debug/common.h"
+#include "utils/file_utils.h"
 #include "utils/log_adapter.h"
 #include "utils/ms_context.h"
 
@@ -28,6 +34,41 @@ constexpr size_t kGBToByte = 1024 << 20;
 // The smallest memory request size, if it is smaller than this size, the device memory request may fail
 // Set experience value to 10M
 const size_t kMinimumAllocMem = 10 << 20;
+constexpr char kMemPoolThreadCacheEnv[] = "MS_DEV_MEM_POOL_THREAD_CACHE";
+constexpr char kMemPoolTraceEnv[] = "MS_DEV_MEM_POOL_TRACE";
+// The size classes of small size are the multiples of align size exactly.
+constexpr size_t kSmallSizeClassNum = 64;
+constexpr size_t kSmallSizeClassBits = 6;
+// The large size is divided into eight sub-divisions in one power of two.
+constexpr size_t kSubDivisionBits = 3;
+constexpr size_t kSubDivisionNum = 1 << kSubDivisionBits;
+constexpr size_t kMaxSizeClassBits = 64;
+constexpr size_t kSizeClassNum = kSmallSizeClassNum + (kMaxSizeClassBits - kSmallSizeClassBits) * kSubDivisionNum;
+// The memory bufs smaller than 32K are cached in the threads, and each size class caches 32 memory bufs at most. Only
+// the small size classes are cached, since each of them holds exactly one size and the cached memory buf fits any
+// allocation of its size class.
+constexpr size_t kThreadCacheMaxSizeClass = kSmallSizeClassNum - 1;
+constexpr size_t kThreadCacheCapacityPerSizeClass = 32;
+// The memory buf which overlaps its destination is moved by the chunks of the distance, and isn't moved if it needs too
+// many chunks.
+constexpr size_t kMaxMoveChunkNum = 16;
+
+size_t HighestBitIndex(size_t value) {
+  size_t index = 0;
+  while (value >>= 1) {
+    ++index;
+  }
+  return index;
+}
+
+size_t LowestBitIndex(uint64_t value) {
+  size_t index = 0;
+  while ((value & 1) == 0) {
+    value >>= 1;
+    ++index;
+  }
+  return index;
+}
 
 thread_local AllocatorDebugInfo DynamicMemAllocatorDebugInfo::debug_info_;
 
@@ -43,13 +84,182 @@ static const std::map<AllocatorType, std::string> kAllocatorTypeString = {
   {AllocatorType::kOther, "other"},
 };
 
+IdleMemBufIndex::IdleMemBufIndex()
+    : size_classes_(kSizeClassNum), bitmap_((kSizeClassNum + kBitsPerWord - 1) / kBitsPerWord, 0) {}
+
+size_t IdleMemBufIndex::SizeClass(size_t size) {
+  size_t units = size / DYNAMIC_MEM_ALIGN_SIZE;
+  if (units < kSmallSizeClassNum) {
+    return units;
+  }
+  size_t first_level = HighestBitIndex(units);
+  size_t second_level = (units >> (first_level - kSubDivisionBits)) & (kSubDivisionNum - 1);
+  return kSmallSizeClassNum + (first_level - kSmallSizeClassBits) * kSubDivisionNum + second_level;
+}
+
+size_t IdleMemBufIndex::FindNonEmptySizeClass(size_t size_class) const {
+  size_t word_index = size_class / kBitsPerWord;
+  if (word_index >= bitmap_.size()) {
+    return size_classes_.size();
+  }
+  // Mask the bits of smaller size classes in the first word.
+  uint64_t word = bitmap_[word_index] & (~0ULL << (size_class % kBitsPerWord));
+  while (word == 0) {
+    if (++word_index >= bitmap_.size()) {
+      return size_classes_.size();
+    }
+    word = bitmap_[word_index];
+  }
+  return word_index * kBitsPerWord + LowestBitIndex(word);
+}
+
+void IdleMemBufIndex::Insert(const DynamicMemBufPtr &mem_buf) {
+  MS_EXCEPTION_IF_NULL(mem_buf);
+  auto size_class = SizeClass(mem_buf->size_);
+  (void)size_classes_[size_class].emplace(mem_buf->size_, mem_buf);
+  SetBit(size_class);
+  ++mem_buf_num_;
+}
+
+DynamicMemBufPtr IdleMemBufIndex::PopBestFit(size_t size) {
+  // The best fit may be in the size class of size, and must be the smallest one of the following non-empty size class.
+  auto size_class = FindNonEmptySizeClass(SizeClass(size));
+  while (size_class < size_classes_.size()) {
+    auto &size_map = size_classes_[size_class];
+    const auto &iter = size_map.lower_bound(size);
+    if (iter != size_map.end()) {
+      auto mem_buf = iter->second;
+      (void)size_map.erase(iter);
+      if (size_map.empty()) {
+        ClearBit(size_class);
+      }
+      --mem_buf_num_;
+      return mem_buf;
+    }
+    size_class = FindNonEmptySizeClass(size_class + 1);
+  }
+  return nullptr;
+}
+
+bool IdleMemBufIndex::Erase(size_t size, const DeviceMemPtr &device_addr) {
+  auto size_class = SizeClass(size);
+  auto &size_map = size_classes_[size_class];
+  auto &&iter = size_map.equal_range(size);
+  while (iter.first != iter.second) {
+    MS_EXCEPTION_IF_NULL(iter.first->second);
+    if (iter.first->second->device_addr_ == device_addr) {
+      (void)size_map.erase(iter.first);
+      if (size_map.empty()) {
+        ClearBit(size_class);
+      }
+      --mem_buf_num_;
+      return true;
+    }
+    (void)iter.first++;
+  }
+  return false;
+}
+
+size_t IdleMemBufIndex::MaxSize() const {
+  for (size_t word_index = bitmap_.size(); word_index > 0; --word_index) {
+    auto word = bitmap_[word_index - 1];
+    if (word != 0) {
+      auto size_class = (word_index - 1) * kBitsPerWord + HighestBitIndex(word);
+      return size_classes_[size_class].rbegin()->first;
+    }
+  }
+  return 0;
+}
+
+void IdleMemBufIndex::clear() {
+  for (auto &size_map : size_classes_) {
+    size_map.clear();
+  }
+  std::fill(bitmap_.begin(), bitmap_.end(), 0);
+  mem_buf_num_ = 0;
+}
+
+DynamicMemPoolBestFit::DynamicMemPoolBestFit()
+    : persistent_mem_(std::make_shared<MemStatusManager>()), common_mem_(std::make_shared<MemStatusManager>()) {
+  static std::atomic<size_t> pool_num{0};
+  pool_id_ = pool_num++;
+  enable_thread_cache_ = (common::GetEnv(kMemPoolThreadCacheEnv) == "1");
+  if (common::GetEnv(kMemPoolTraceEnv) == "1") {
+    std::string path_name = GetSaveGraphsPathName("mem_pool_trace/mem_pool_trace_" + std::to_string(getpid()) + "_" +
+                                                  std::to_string(pool_id_) + ".bin");
+    auto realpath = Common::CreatePrefixPath(path_name);
+    if (!realpath.has_value()) {
+      MS_LOG(ERROR) << "Get real path failed, path: " << path_name;
+      return;
+    }
+    ChangeFileMode(realpath.value(), S_IWUSR | S_IRUSR);
+    auto trace_writer = std::make_shared<MemPoolTraceWriter>(realpath.value());
+    if (trace_writer->is_open()) {
+      trace_writer_ = trace_writer;
+      MS_LOG(INFO) << "Record the memory pool trace to file:" << realpath.value();
+    }
+  }
+}
+
+void DynamicMemPoolBestFit::RecordTrace(MemPoolTraceOp op, const DeviceMemPtr &device_addr, size_t size,
+                                        bool from_persistent_mem) const {
+  MS_EXCEPTION_IF_NULL(trace_writer_);
+  trace_writer_->Record(MakeTraceRecord(op, device_addr, size, from_persistent_mem));
+}
+
+MemPoolTraceRecord DynamicMemPoolBestFit::MakeTraceRecord(MemPoolTraceOp op, const DeviceMemPtr &device_addr,
+                                                          size_t size, bool from_persistent_mem) {
+  MemPoolTraceRecord record{};
+  record.timestamp_ = static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count());
+  record.addr_ = reinterpret_cast<uint64_t>(device_addr);
+  record.size_ = size;
+  // The memory pool doesn't distinguish the streams now, and all the memory is recorded in the default stream.
+  record.stream_id_ = 0;
+  record.group_size_ = 1;
+  record.op_ = op;
+  record.allocator_type_ = static_cast<uint8_t>(DynamicMemAllocatorDebugInfo::GetDebugInfo().type_);
+  record.from_persistent_mem_ = from_persistent_mem ? 1 : 0;
+  return record;
+}
+
 DynamicMemPoolBestFit::~DynamicMemPoolBestFit() {
+  {
+    std::lock_guard<std::mutex> locker(thread_caches_mutex_);
+    for (auto &thread_cache : thread_caches_) {
+      std::lock_guard<std::mutex> cache_locker(thread_cache->mutex_);
+      thread_cache->cached_addrs_.clear();
+    }
+  }
   persistent_mem_->clear();
   common_mem_->clear();
 }
 
 DeviceMemPtr DynamicMemPoolBestFit::AllocTensorMem(size_t size, bool from_persistent_mem) {
   size_t align_size = AlignMemorySize(size);
+  DeviceMemPtr device_addr = nullptr;
+  if (from_persistent_mem || !AllocFromThreadCache(align_size, &device_addr)) {
+    device_addr = AllocMemBuf(align_size, from_persistent_mem);
+    // The cached memory bufs may be combined to the required size.
+    if ((device_addr == nullptr) && enable_thread_cache_) {
+      FlushThreadCaches();
+      device_addr = AllocMemBuf(align_size, from_persistent_mem);
+    }
+    if ((device_addr != nullptr) && enable_thread_cache_ && !from_persistent_mem &&
+        (IdleMemBufIndex::SizeClass(align_size) <= kThreadCacheMaxSizeClass)) {
+      auto &shard = GetSmallMemBufShard(device_addr);
+      std::lock_guard<std::mutex> locker(shard.mutex_);
+      shard.mem_bufs_[device_addr] = {IdleMemBufIndex::SizeClass(align_size), false};
+    }
+  }
+  if (trace_writer_ != nullptr) {
+    RecordTrace(MemPoolTraceOp::kAlloc, device_addr, size, from_persistent_mem);
+  }
+  return device_addr;
+}
+
+DeviceMemPtr DynamicMemPoolBestFit::AllocMemBuf(size_t align_size, bool from_persistent_mem) {
   std::lock_guard<std::mutex> locker(mutex_);
   // Find the idle memory buf by tensor size, if not find, then add new memory block and memory buf.
   DeviceMemPtr device_addr = FindIdleMemBuf(align_size, from_persistent_mem);
@@ -64,21 +274,129 @@ DeviceMemPtr DynamicMemPoolBestFit::AllocTensorMem(size_t size, bool from_persis
   }
 
   MS_LOG(DEBUG) << "Alloc memory details, name:" << DynamicMemAllocatorDebugInfo::GetDebugInfo().name_
-                << ", address:" << device_addr << ", size:" << size << "B, total allocated mem:" << TotalMemStatistics()
-                << "B, peak used mem:" << UsedMemPeakStatistics() << "B, in used mem:" << TotalUsedMemStatistics()
+                << ", address:" << device_addr << ", size:" << align_size
+                << "B, total allocated mem:" << TotalMemStatistics() << "B, peak used mem:" << UsedMemPeakStatistics()
+                << "B, in used mem:" << TotalUsedMemStatistics()
                 << "B, total idle mem:" << (TotalMemStatistics() - TotalUsedMemStatistics()) << "B.";
   return device_addr;
 }
 
+bool DynamicMemPoolBestFit::AllocFromThreadCache(size_t align_size, DeviceMemPtr *device_addr) {
+  MS_EXCEPTION_IF_NULL(device_addr);
+  auto size_class = IdleMemBufIndex::SizeClass(align_size);
+  if (!enable_thread_cache_ || (size_class > kThreadCacheMaxSizeClass)) {
+    return false;
+  }
+  auto thread_cache = GetThreadCache();
+  MS_EXCEPTION_IF_NULL(thread_cache);
+  {
+    std::lock_guard<std::mutex> locker(thread_cache->mutex_);
+    auto &cached_addrs = thread_cache->cached_addrs_[size_class];
+    if (cached_addrs.empty()) {
+      return false;
+    }
+    *device_addr = cached_addrs.back();
+    cached_addrs.pop_back();
+  }
+  auto &shard = GetSmallMemBufShard(*device_addr);
+  std::lock_guard<std::mutex> locker(shard.mutex_);
+  shard.mem_bufs_[*device_addr].is_cached_ = false;
+  return true;
+}
+
+bool DynamicMemPoolBestFit::FreeToThreadCache(const DeviceMemPtr &device_addr) {
+  if (!enable_thread_cache_) {
+    return false;
+  }
+  size_t size_class = 0;
+  {
+    auto &shard = GetSmallMemBufShard(device_addr);
+    std::lock_guard<std::mutex> locker(shard.mutex_);
+    const auto &iter = shard.mem_bufs_.find(device_addr);
+    if (iter == shard.mem_bufs_.end()) {
+      return false;
+    }
+    if (iter->second.is_cached_) {
+      MS_LOG(EXCEPTION) << "Find the mem_buf is not used, mem_buf_address[" << device_addr << "].";
+    }
+    size_class = iter->second.size_class_;
+    auto thread_cache = GetThreadCache();
+    MS_EXCEPTION_IF_NULL(thread_cache);
+    std::lock_guard<std::mutex> cache_locker(thread_cache->mutex_);
+    auto &cached_addrs = thread_cache->cached_addrs_[size_class];
+    if (cached_addrs.size() < kThreadCacheCapacityPerSizeClass) {
+      iter->second.is_cached_ = true;
+      cached_addrs.push_back(device_addr);
+      return true;
+    }
+    // The thread cache is full and the memory buf is returned to the memory pool.
+    (void)shard.mem_bufs_.erase(iter);
+  }
+  FreeMemBuf(device_addr);
+  return true;
+}
+
+MemBufThreadCache *DynamicMemPoolBestFit::GetThreadCache() {
+  // Key is the id of memory pool, value is the thread cache of the memory pool in this thread.
+  thread_local mindspore::HashMap<size_t, MemBufThreadCachePtr> thread_caches;
+  const auto &iter = thread_caches.find(pool_id_);
+  if (iter != thread_caches.end()) {
+    return iter->second.get();
+  }
+  auto thread_cache = std::make_shared<MemBufThreadCache>();
+  thread_cache->cached_addrs_.resize(kThreadCacheMaxSizeClass + 1);
+  thread_caches[pool_id_] = thread_cache;
+  std::lock_guard<std::mutex> locker(thread_caches_mutex_);
+  (void)thread_caches_.emplace_back(thread_cache);
+  return thread_cache.get();
+}
+
+SmallMemBufShard &DynamicMemPoolBestFit::GetSmallMemBufShard(const DeviceMemPtr &device_addr) {
+  // The memory bufs are aligned, so the low bits of address are skipped.
+  auto shard_index = (reinterpret_cast<uintptr_t>(device_addr) / DYNAMIC_MEM_ALIGN_SIZE) % kSmallMemBufShardNum;
+  return small_mem_buf_shards_[shard_index];
+}
+
+void DynamicMemPoolBestFit::FlushThreadCaches() {
+  std::vector<DeviceMemPtr> cached_addrs;
+  {
+    std::lock_guard<std::mutex> locker(thread_caches_mutex_);
+    for (auto &thread_cache : thread_caches_) {
+      std::lock_guard<std::mutex> cache_locker(thread_cache->mutex_);
+      for (auto &size_class_addrs : thread_cache->cached_addrs_) {
+        cached_addrs.insert(cached_addrs.end(), size_class_addrs.begin(), size_class_addrs.end());
+        size_class_addrs.clear();
+      }
+    }
+  }
+  for (const auto &device_addr : cached_addrs) {
+    {
+      auto &shard = GetSmallMemBufShard(device_addr);
+      std::lock_guard<std::mutex> locker(shard.mutex_);
+      (void)shard.mem_bufs_.erase(device_addr);
+    }
+    FreeMemBuf(device_addr);
+  }
+  MS_LOG(DEBUG) << "Flush the thread caches of memory pool, memory buf num:" << cached_addrs.size();
+}
+
 std::vector<DeviceMemPtr> DynamicMemPoolBestFit::AllocContinuousTensorMem(const std::vector<size_t> &size_list) {
   std::vector<DeviceMemPtr> device_addr_list;
   size_t total_size = std::accumulate(size_list.begin(), size_list.end(), IntToSize(0));
   // Pre-alloc the one whole piece memory.
-  auto device_addr = AllocTensorMem(total_size, false);
+  // The continuous memory is split into the memory bufs of size list, which can't be cached in the threads.
+  auto device_addr = AllocMemBuf(AlignMemorySize(total_size), false);
+  if ((device_addr == nullptr) && enable_thread_cache_) {
+    FlushThreadCaches();
+    device_addr = AllocMemBuf(AlignMemorySize(total_size), false);
+  }
+  std::lock_guard<std::mutex> locker(mutex_);
   if (!device_addr) {
+    // The next compaction tries to combine the idle memory for the continuous memory.
+    failed_continuous_size_ = std::max(failed_continuous_size_, AlignMemorySize(total_size));
+    RecordContinuousTrace(size_list, device_addr_list);
     return device_addr_list;
   }
-  std::lock_guard<std::mutex> locker(mutex_);
   // Remove the pre-alloc memory.
   auto mem_block = FindMemBlock(device_addr, common_mem_);
   if (mem_block == nullptr) {
@@ -112,9 +430,37 @@ std::vector<DeviceMemPtr> DynamicMemPoolBestFit::AllocContinuousTensorMem(const
   }
   // Update the size of the last memory buf.
   continuous_mem_buf->size_ += rest_size;
+  RecordContinuousTrace(size_list, device_addr_list);
   return device_addr_list;
 }
 
+void DynamicMemPoolBestFit::RecordContinuousTrace(const std::vector<size_t> &size_list,
+                                                  const std::vector<DeviceMemPtr> &device_addr_list) const {
+  if (trace_writer_ == nullptr) {
+    return;
+  }
+  std::vector<MemPoolTraceRecord> records;
+  for (size_t i = 0; i < size_list.size(); ++i) {
+    // The failed allocation is recorded with the empty address list.
+    auto device_addr = (i < device_addr_list.size()) ? device_addr_list[i] : nullptr;
+    auto record = MakeTraceRecord(MemPoolTraceOp::kAllocContinuous, device_addr, size_list[i], false);
+    record.group_size_ = static_cast<uint32_t>(size_list.size());
+    records.push_back(record);
+  }
+  trace_writer_->Record(records);
+}
+
+void DynamicMemPoolBestFit::RecordMoveTrace(const DeviceMemPtr &src, const DeviceMemPtr &dst, size_t size) const {
+  MS_EXCEPTION_IF_NULL(trace_writer_);
+  // The move is recorded as the group of the source and the destination.
+  std::vector<MemPoolTraceRecord> records = {MakeTraceRecord(MemPoolTraceOp::kMove, src, size, false),
+                                             MakeTraceRecord(MemPoolTraceOp::kMove, dst, size, false)};
+  for (auto &record : records) {
+    record.group_size_ = static_cast<uint32_t>(records.size());
+  }
+  trace_writer_->Record(records);
+}
+
 size_t DynamicMemPoolBestFit::AlignMemorySize(size_t size) const {
   if (size == 0) {
     return DYNAMIC_MEM_ALIGN_SIZE;
@@ -128,10 +474,8 @@ DeviceMemPtr DynamicMemPoolBestFit::FindIdleMemBuf(size_t size, bool from_persis
     mem_mng = persistent_mem_;
   }
   MS_EXCEPTION_IF_NULL(mem_mng);
-  const auto &iter = mem_mng->idle_mem_buf_map_.lower_bound(size);
-  if (iter != mem_mng->idle_mem_buf_map_.end()) {
-    auto mem_buf = iter->second;
-    MS_EXCEPTION_IF_NULL(mem_buf);
+  auto mem_buf = mem_mng->idle_mem_buf_index_.PopBestFit(size);
+  if (mem_buf != nullptr) {
     if (mem_buf->status_ != DynamicMemBufStatus::kMemBufIdle) {
       DumpDynamicMemPoolDebugInfo();
       MS_LOG(EXCEPTION) << "Find the mem_buf is not idle, alloc_size[" << size << "] mem_buf_size[" << mem_buf->size_
@@ -140,8 +484,6 @@ DeviceMemPtr DynamicMemPoolBestFit::FindIdleMemBuf(size_t size, bool from_persis
     mem_buf->status_ = DynamicMemBufStatus::kMemBufUsed;
     mem_buf->allocator_name_ = DynamicMemAllocatorDebugInfo::GetDebugInfo().name_;
     mem_buf->allocator_type_ = DynamicMemAllocatorDebugInfo::GetDebugInfo().type_;
-    // Remove map of old idle memory buf
-    (void)mem_mng->idle_mem_buf_map_.erase(iter);
     // Divide memory buf
     if (IsSplit(size, mem_buf->size_)) {
       SplitMemBuf(size, mem_buf, mem_mng);
@@ -294,7 +636,7 @@ void DynamicMemPoolBestFit::SplitMemBuf(size_t size, const DynamicMemBufPtr &mem
   // Add map of new memory buf in the block
   (void)mem_block->block_all_mem_buf_map_.emplace(newbuf_addr, new_mem_buf);
   // Add map of new idle memory buf
-  (void)mem_mng->idle_mem_buf_map_.emplace(newbuf_size, new_mem_buf);
+  mem_mng->idle_mem_buf_index_.Insert(new_mem_buf);
 }
 
 bool DynamicMemPoolBestFit::CmpMemBlock(const DeviceMemPtr &device_addr, const DynamicMemBlockPtr &mem_block) {
@@ -316,6 +658,17 @@ DynamicMemBlockPtr DynamicMemPoolBestFit::FindMemBlock(const DeviceMemPtr &devic
 }
 
 void DynamicMemPoolBestFit::FreeTensorMem(const DeviceMemPtr &device_addr) {
+  MS_EXCEPTION_IF_NULL(device_addr);
+  if (trace_writer_ != nullptr) {
+    RecordTrace(MemPoolTraceOp::kFree, device_addr, 0, false);
+  }
+  if (FreeToThreadCache(device_addr)) {
+    return;
+  }
+  FreeMemBuf(device_addr);
+}
+
+void DynamicMemPoolBestFit::FreeMemBuf(const DeviceMemPtr &device_addr) {
   MS_EXCEPTION_IF_NULL(device_addr);
   std::lock_guard<std::mutex> locker(mutex_);
   auto fn = [this](const MemStatusManagerPtr &mem_mng, const DeviceMemPtr &device_addr) -> DynamicMemBlockPtr {
@@ -398,29 +751,163 @@ void DynamicMemPoolBestFit::CombineMemBuf(const DynamicMemBlockPtr &mem_block, c
   }
   // Add map of new idle memory
   if (forward_combine) {
-    (void)mem_mng->idle_mem_buf_map_.emplace(prev_mem_buf->size_, prev_mem_buf);
+    mem_mng->idle_mem_buf_index_.Insert(prev_mem_buf);
   } else {
-    (void)mem_mng->idle_mem_buf_map_.emplace(mem_buf->size_, mem_buf);
+    mem_mng->idle_mem_buf_index_.Insert(mem_buf);
   }
 }
 
 void DynamicMemPoolBestFit::EraseIdleMemBuf(size_t size, const DeviceMemPtr &device_addr,
                                             const MemStatusManagerPtr &mem_mng) const {
   MS_EXCEPTION_IF_NULL(device_addr);
-  auto &&iter = mem_mng->idle_mem_buf_map_.equal_range(size);
-  while (iter.first != iter.second) {
-    MS_EXCEPTION_IF_NULL(iter.first->second);
-    // Remove map of the idle memory buf by size and device address
-    if (iter.first->second->device_addr_ == device_addr) {
-      (void)mem_mng->idle_mem_buf_map_.erase(iter.first);
-      return;
-    }
-    (void)iter.first++;
+  // Remove map of the idle memory buf by size and device address
+  if (mem_mng->idle_mem_buf_index_.Erase(size, device_addr)) {
+    return;
   }
   MS_LOG(ERROR) << "Can't find the size[" << size << "] and device address[" << device_addr << "] in the idle mem_buf.";
 }
 
+double DynamicMemPoolBestFit::FragmentationRatio() {
+  std::lock_guard<std::mutex> locker(mutex_);
+  const auto &mps = common_mem_->mps_;
+  size_t idle_size = mps.total_mem_size_ - mps.total_used_mem_size_;
+  if (idle_size == 0) {
+    return 0;
+  }
+  return 1.0 - static_cast<double>(common_mem_->idle_mem_buf_index_.MaxSize()) / static_cast<double>(idle_size);
+}
+
+std::map<DeviceMemPtr, DeviceMemPtr> DynamicMemPoolBestFit::CompactMemBufs(double fragmentation_threshold,
+                                                                          const MemBufMovableFunc &is_movable) {
+  std::map<DeviceMemPtr, DeviceMemPtr> relocations;
+  // The memory bufs cached in the threads are idle actually.
+  if (enable_thread_cache_) {
+    FlushThreadCaches();
+  }
+  auto fragmentation_ratio = FragmentationRatio();
+  std::lock_guard<std::mutex> locker(mutex_);
+  const auto &mps = common_mem_->mps_;
+  size_t idle_size = mps.total_mem_size_ - mps.total_used_mem_size_;
+  size_t max_idle_size = common_mem_->idle_mem_buf_index_.MaxSize();
+  bool need_continuous_mem = (failed_continuous_size_ > max_idle_size) && (failed_continuous_size_ <= idle_size);
+  if (fragmentation_ratio < fragmentation_threshold && !need_continuous_mem) {
+    return relocations;
+  }
+  for (const auto &mem_block : common_mem_->mem_block_list_) {
+    CompactMemBlock(mem_block, is_movable, &relocations);
+  }
+  failed_continuous_size_ = 0;
+  MS_LOG(INFO) << "Compact the memory pool, fragmentation ratio: " << fragmentation_ratio
+               << ", moved memory buf num: " << relocations.size() << ", max idle memory buf size: " << max_idle_size
+               << "B -> " << common_mem_->idle_mem_buf_index_.MaxSize() << "B, total idle mem: " << idle_size << "B.";
+  return relocations;
+}
+
+void DynamicMemPoolBestFit::CompactMemBlock(const DynamicMemBlockPtr &mem_block, const MemBufMovableFunc &is_movable,
+                                            std::map<DeviceMemPtr, DeviceMemPtr> *relocations) {
+  MS_EXCEPTION_IF_NULL(mem_block);
+  MS_EXCEPTION_IF_NULL(relocations);
+  DeviceAddrMapMemBuf compacted_mem_buf_map;
+  auto add_idle_mem_buf = [this, &compacted_mem_buf_map](const DeviceMemPtr &addr, size_t size) {
+    auto idle_mem_buf = std::make_shared<DynamicMemBuf>(addr, DynamicMemBufStatus::kMemBufIdle, size);
+    (void)compacted_mem_buf_map.emplace(addr, idle_mem_buf);
+    common_mem_->idle_mem_buf_index_.Insert(idle_mem_buf);
+  };
+  // The used memory bufs are placed from the lowest address in the order of address.
+  auto compact_addr = static_cast<uint8_t *>(mem_block->device_addr());
+  for (const auto &item : mem_block->block_all_mem_buf_map_) {
+    const auto &mem_buf = item.second;
+    MS_EXCEPTION_IF_NULL(mem_buf);
+    if (mem_buf->status_ == DynamicMemBufStatus::kMemBufIdle) {
+      EraseIdleMemBuf(mem_buf->size_, mem_buf->device_addr_, common_mem_);
+      continue;
+    }
+    auto addr = static_cast<uint8_t *>(mem_buf->device_addr_);
+    if (addr != compact_addr && is_movable(mem_buf->device_addr_) &&
+        MoveMemBuf(compact_addr, mem_buf->device_addr_, mem_buf->size_)) {
+      (*relocations)[mem_buf->device_addr_] = compact_addr;
+      if (enable_thread_cache_) {
+        // Update the small memory buf info by the new address.
+        SmallMemBufInfo info{0, false};
+        bool is_small_mem_buf = false;
+        {
+          auto &shard = GetSmallMemBufShard(mem_buf->device_addr_);
+          std::lock_guard<std::mutex> shard_locker(shard.mutex_);
+          const auto &iter = shard.mem_bufs_.find(mem_buf->device_addr_);
+          if (iter != shard.mem_bufs_.end()) {
+            info = iter->second;
+            is_small_mem_buf = true;
+            (void)shard.mem_bufs_.erase(iter);
+          }
+        }
+        if (is_small_mem_buf) {
+          auto &shard = GetSmallMemBufShard(compact_addr);
+          std::lock_guard<std::mutex> shard_locker(shard.mutex_);
+          shard.mem_bufs_[compact_addr] = info;
+        }
+      }
+      if (trace_writer_ != nullptr) {
+        RecordMoveTrace(mem_buf->device_addr_, compact_addr, mem_buf->size_);
+      }
+      mem_buf->device_addr_ = compact_addr;
+    } else if (addr != compact_addr) {
+      // The memory before the unmovable memory buf is still idle.
+      add_idle_mem_buf(compact_addr, static_cast<size_t>(addr - compact_addr));
+      compact_addr = addr;
+    }
+    (void)compacted_mem_buf_map.emplace(mem_buf->device_addr_, mem_buf);
+    compact_addr += mem_buf->size_;
+  }
+  auto block_end = static_cast<uint8_t *>(mem_block->device_addr()) + mem_block->size();
+  if (compact_addr < block_end) {
+    add_idle_mem_buf(compact_addr, static_cast<size_t>(block_end - compact_addr));
+  }
+  mem_block->block_all_mem_buf_map_.swap(compacted_mem_buf_map);
+}
+
+bool DynamicMemPoolBestFit::MoveMemBuf(const DeviceMemPtr &dst, const DeviceMemPtr &src, size_t size) {
+  auto dst_addr = static_cast<uint8_t *>(dst);
+  auto src_addr = static_cast<uint8_t *>(src);
+  if (dst_addr >= src_addr) {
+    MS_LOG(EXCEPTION) << "The memory buf can only be moved to the lower address, src: " << src << ", dst: " << dst;
+  }
+  // Each chunk isn't overlapped with its destination, and the destination of later chunk is the copied source.
+  size_t chunk_size = std::min(size, static_cast<size_t>(src_addr - dst_addr));
+  if ((size + chunk_size - 1) / chunk_size > kMaxMoveChunkNum) {
+    return false;
+  }
+  for (size_t offset = 0; offset < size; offset += chunk_size) {
+    auto copy_size = std::min(chunk_size, size - offset);
+    if (!CopyDeviceMem(dst_addr + offset, src_addr + offset, copy_size)) {
+      // Only the idle memory is written by the first chunk.
+      if (offset == 0) {
+        return false;
+      }
+      MS_LOG(EXCEPTION) << "Copy the device memory failed in the compaction, src: " << src << ", dst: " << dst
+                        << ", size: " << size << ", offset: " << offset;
+    }
+  }
+  return true;
+}
+
 void DynamicMemPoolBestFit::ReleaseDeviceRes() {
+  if (trace_writer_ != nullptr) {
+    trace_writer_->Flush();
+  }
+  // The cached memory bufs are released with the memory blocks.
+  {
+    std::lock_guard<std::mutex> locker(thread_caches_mutex_);
+    for (auto &thread_cache : thread_caches_) {
+      std::lock_guard<std::mutex> cache_locker(thread_cache->mutex_);
+      for (auto &size_class_addrs : thread_cache->cached_addrs_) {
+        size_class_addrs.clear();
+      }
+    }
+  }
+  for (auto &shard : small_mem_buf_shards_) {
+    std::lock_guard<std::mutex> locker(shard.mutex_);
+    shard.mem_bufs_.clear();
+  }
   std::lock_guard<std::mutex> locker(mutex_);
   DumpDynamicMemPoolStateInfo();
 
@@ -437,7 +924,7 @@ void DynamicMemPoolBestFit::ReleaseDeviceRes() {
       }
     }
     mem_mng->mem_block_list_.clear();
-    mem_mng->idle_mem_buf_map_.clear();
+    mem_mng->idle_mem_buf_index_.clear();
   };
   fn(common_mem_);
   fn(persistent_mem_);
@@ -521,15 +1008,13 @@ void DynamicMemPoolBestFit::DumpDynamicMemPoolDebugInfo() {
       }
     }
     // Dump all the idle memory buf info.
-    MS_LOG(WARNING) << mem_type << " all idle mem_buf info: counts[" << mem_mng->idle_mem_buf_map_.size() << "].";
-    for (auto iter_idle = mem_mng->idle_mem_buf_map_.begin(); iter_idle != mem_mng->idle_mem_buf_map_.end();
-         ++iter_idle) {
-      auto mem_buf = iter_idle->second;
+    MS_LOG(WARNING) << mem_type << " all idle mem_buf info: counts[" << mem_mng->idle_mem_buf_index_.size() << "].";
+    mem_mng->idle_mem_buf_index_.ForEach([&total_idle_mem2](const DynamicMemBufPtr &mem_buf) {
       MS_EXCEPTION_IF_NULL(mem_buf);
       total_idle_mem2 += mem_buf->size_;
       MS_LOG(INFO) << " Idle mem_buf info: size[" << mem_buf->size_ << "] address[" << mem_buf->device_addr_
                    << "] status[" << kBufStatusString.at(mem_buf->status_) << "].";
-    }
+    });
     // Dump the memory statistical info.
     MS_LOG(WARNING) << mem_type << " total allocated memory[" << total_mem << "], used memory[" << total_used_mem
                     << "], idle memory[" << total_idle_mem1 << "].";
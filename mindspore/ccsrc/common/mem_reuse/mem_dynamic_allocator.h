@@ -25,6 +25,10 @@
 #include <thread>
 #include <mutex>
 #include <string>
+#include <array>
+#include <functional>
+#include "utils/hash_map.h"
+#include "common/mem_reuse/mem_pool_trace.h"
 #include "utils/ms_utils.h"
 #include "include/backend/visible.h"
 
@@ -101,6 +105,53 @@ using DynamicMemBufPtr = std::shared_ptr<DynamicMemBuf>;
 using SizeMapMemBuf = std::multimap<size_t, DynamicMemBufPtr>;
 // Map key is the device address, for finding the used memory buf in memory block by device address.
 using DeviceAddrMapMemBuf = std::map<DeviceMemPtr, DynamicMemBufPtr, DeviceAddrCmp>;
+// Return whether the used memory buf of the device address can be moved by the memory compaction.
+using MemBufMovableFunc = std::function<bool(const DeviceMemPtr &)>;
+
+// The segregated-fit index of idle memory bufs like the TLSF. The sizes are divided into the size classes of two
+// levels: the small sizes are classified by the multiple of align size exactly, and the large sizes are classified by
+// the power of two and eight sub-divisions. The bitmap records the non-empty size classes and the idle memory bufs in
+// one size class are ordered by size, so the best fit is found in the size class of required size or the first
+// non-empty larger size class without traversing all the idle memory bufs.
+class BACKEND_EXPORT IdleMemBufIndex {
+ public:
+  IdleMemBufIndex();
+  ~IdleMemBufIndex() = default;
+
+  void Insert(const DynamicMemBufPtr &mem_buf);
+  // Find and remove the smallest idle memory buf whose size is not less than the size, return nullptr if not found.
+  DynamicMemBufPtr PopBestFit(size_t size);
+  // Remove the idle memory buf by size and device address, return false if not found.
+  bool Erase(size_t size, const DeviceMemPtr &device_addr);
+  size_t size() const { return mem_buf_num_; }
+  bool empty() const { return mem_buf_num_ == 0; }
+  // The size of the largest idle memory buf, return 0 if empty.
+  size_t MaxSize() const;
+  void clear();
+  // Traverse the idle memory bufs from small size to large size.
+  template <typename Func>
+  void ForEach(Func &&func) const {
+    for (const auto &size_class : size_classes_) {
+      for (const auto &item : size_class) {
+        func(item.second);
+      }
+    }
+  }
+
+  static size_t SizeClass(size_t size);
+
+ private:
+  // Find the first non-empty size class which is not less than the size class, return the size classes number if not
+  // found.
+  size_t FindNonEmptySizeClass(size_t size_class) const;
+  void SetBit(size_t size_class) { bitmap_[size_class / kBitsPerWord] |= (1ULL << (size_class % kBitsPerWord)); }
+  void ClearBit(size_t size_class) { bitmap_[size_class / kBitsPerWord] &= ~(1ULL << (size_class % kBitsPerWord)); }
+
+  static constexpr size_t kBitsPerWord = 64;
+  std::vector<SizeMapMemBuf> size_classes_;
+  std::vector<uint64_t> bitmap_;
+  size_t mem_buf_num_{0};
+};
 
 // Memory block is composed of memory buf.
 class DynamicMemBlock {
@@ -136,20 +187,39 @@ struct MemStatusManager {
   // Mem pool state
   DeviceState mps_;
   std::vector<DynamicMemBlockPtr> mem_block_list_;
-  // The map of all idle memory buf by size.
-  SizeMapMemBuf idle_mem_buf_map_;
+  // The index of all idle memory buf by size.
+  IdleMemBufIndex idle_mem_buf_index_;
   void clear() noexcept {
     mem_block_list_.clear();
-    idle_mem_buf_map_.clear();
+    idle_mem_buf_index_.clear();
   }
 };
 using MemStatusManagerPtr = std::shared_ptr<MemStatusManager>;
 
+// The small memory bufs freed in the thread are cached and reused by the following allocations of the same size class
+// in the thread without locking the memory pool. The cache is created by the thread and flushed by the memory pool.
+struct MemBufThreadCache {
+  std::mutex mutex_;
+  // Index is the size class of small size, value is the cached device addresses.
+  std::vector<std::vector<DeviceMemPtr>> cached_addrs_;
+};
+using MemBufThreadCachePtr = std::shared_ptr<MemBufThreadCache>;
+
+// The small memory bufs in use which are allocated when the thread cache is enabled. They are sharded by the device
+// address, so the memory free finds the size without locking the memory pool.
+struct SmallMemBufInfo {
+  size_t size_class_;
+  bool is_cached_;
+};
+struct SmallMemBufShard {
+  std::mutex mutex_;
+  mindspore::HashMap<DeviceMemPtr, SmallMemBufInfo> mem_bufs_;
+};
+
 // The main class of dynamic memory pool.
 class BACKEND_EXPORT DynamicMemPoolBestFit {
  public:
-  DynamicMemPoolBestFit()
-      : persistent_mem_(std::make_shared<MemStatusManager>()), common_mem_(std::make_shared<MemStatusManager>()) {}
+  DynamicMemPoolBestFit();
   virtual ~DynamicMemPoolBestFit();
 
   // The main program entry of memory alloc.
@@ -167,6 +237,17 @@ class BACKEND_EXPORT DynamicMemPoolBestFit {
   // Set the minimum memory unit size using for dynamic extend.
   void SetMemAllocUintSize(size_t common_size, size_t persist_size = DYNAMIC_MEM_ALLOC_UNIT_SIZE);
 
+  // Whether cache the small memory bufs in the threads, which is enabled by the env MS_DEV_MEM_POOL_THREAD_CACHE by
+  // default and can only be changed before any memory allocation.
+  bool enable_thread_cache() const { return enable_thread_cache_; }
+  void set_enable_thread_cache(bool enable_thread_cache) { enable_thread_cache_ = enable_thread_cache; }
+  // Return the cached memory bufs of all threads to the memory pool.
+  void FlushThreadCaches();
+  // Record every memory alloc and free to the trace writer, which is created by the env MS_DEV_MEM_POOL_TRACE by
+  // default and can only be changed before any memory allocation.
+  const MemPoolTraceWriterPtr &trace_writer() const { return trace_writer_; }
+  void set_trace_writer(const MemPoolTraceWriterPtr &trace_writer) { trace_writer_ = trace_writer; }
+
   // The statistics information.
   size_t TotalMemStatistics() const {
     return common_mem_->mps_.total_mem_size_ + persistent_mem_->mps_.total_mem_size_;
@@ -178,6 +259,18 @@ class BACKEND_EXPORT DynamicMemPoolBestFit {
     return common_mem_->mps_.used_mem_peak_size_ + persistent_mem_->mps_.used_mem_peak_size_;
   }
 
+  // The ratio of the idle memory of common memory which can't be allocated in one piece, it is one minus the ratio of
+  // the largest idle memory buf size to the total idle memory size.
+  double FragmentationRatio();
+  // Compact the common memory by moving the movable used memory bufs to the lower addresses of memory block, so that
+  // the idle memory bufs between them are combined. It runs only if the fragmentation ratio reaches the threshold or
+  // the continuous memory allocation which failed since the last compaction can be served by the compaction. It must
+  // be called when no kernel is using the memory, such as at the step boundary, and is_movable is called with the
+  // memory pool locked. Return the map from the old address to the new address of the moved memory bufs, whose owners
+  // must be updated by the caller.
+  std::map<DeviceMemPtr, DeviceMemPtr> CompactMemBufs(double fragmentation_threshold,
+                                                      const MemBufMovableFunc &is_movable);
+
   // Display the brief state information of memory block and memory buf.
   void DumpDynamicMemPoolStateInfo();
   // Display the detailed debug information of memory block and memory buf.
@@ -187,6 +280,9 @@ class BACKEND_EXPORT DynamicMemPoolBestFit {
   virtual size_t AllocDeviceMem(size_t size, DeviceMemPtr *addr) = 0;
   virtual bool FreeDeviceMem(const DeviceMemPtr &addr) = 0;
   virtual size_t free_mem_size() = 0;
+  // Copy the device memory for the memory compaction, the dst and src memory aren't overlapped. The memory compaction
+  // is disabled if the copy isn't supported by the device type.
+  virtual bool CopyDeviceMem(const DeviceMemPtr &dst, const DeviceMemPtr &src, size_t size) { return false; }
   // Set mem pool block size
   virtual void SetMemPoolBlockSize(size_t available_device_mem_size);
 
@@ -199,6 +295,22 @@ class BACKEND_EXPORT DynamicMemPoolBestFit {
   virtual size_t CalMemBlockAllocSize(size_t size, bool from_persistent_mem);
 
  private:
+  // Alloc and free the memory buf in the memory pool with locking.
+  DeviceMemPtr AllocMemBuf(size_t align_size, bool from_persistent_mem);
+  void FreeMemBuf(const DeviceMemPtr &device_addr);
+  // Alloc and free the small memory buf by the thread cache, return false if the thread cache can't be used.
+  bool AllocFromThreadCache(size_t align_size, DeviceMemPtr *device_addr);
+  bool FreeToThreadCache(const DeviceMemPtr &device_addr);
+  MemBufThreadCache *GetThreadCache();
+  SmallMemBufShard &GetSmallMemBufShard(const DeviceMemPtr &device_addr);
+
+  static MemPoolTraceRecord MakeTraceRecord(MemPoolTraceOp op, const DeviceMemPtr &device_addr, size_t size,
+                                            bool from_persistent_mem);
+  void RecordTrace(MemPoolTraceOp op, const DeviceMemPtr &device_addr, size_t size, bool from_persistent_mem) const;
+  void RecordContinuousTrace(const std::vector<size_t> &size_list,
+                             const std::vector<DeviceMemPtr> &device_addr_list) const;
+  void RecordMoveTrace(const DeviceMemPtr &src, const DeviceMemPtr &dst, size_t size) const;
+
   // Find the idle memory buf by aligned size when memory alloc.
   DeviceMemPtr FindIdleMemBuf(size_t size, bool from_persistent_mem);
   // Add the memory block and memory buf when memory alloc not find the idle memory buf.
@@ -216,9 +328,25 @@ class BACKEND_EXPORT DynamicMemPoolBestFit {
                      const MemStatusManagerPtr &mem_mng);
   // Erase the idle memory buf by size and device address when idle memory buf is combined.
   void EraseIdleMemBuf(size_t size, const DeviceMemPtr &device_addr, const MemStatusManagerPtr &mem_mng) const;
+  // Move the movable used memory bufs of the memory block to the lower addresses and combine the idle memory bufs.
+  void CompactMemBlock(const DynamicMemBlockPtr &mem_block, const MemBufMovableFunc &is_movable,
+                       std::map<DeviceMemPtr, DeviceMemPtr> *relocations);
+  // Move the memory to the lower address, which may overlap the source memory.
+  bool MoveMemBuf(const DeviceMemPtr &dst, const DeviceMemPtr &src, size_t size);
 
   // Support multi-thread.
   std::mutex mutex_;
+  // The unique id of memory pool, which is used to find the thread cache of memory pool in the thread.
+  size_t pool_id_;
+  bool enable_thread_cache_{false};
+  std::mutex thread_caches_mutex_;
+  std::vector<MemBufThreadCachePtr> thread_caches_;
+  static constexpr size_t kSmallMemBufShardNum = 16;
+  std::array<SmallMemBufShard, kSmallMemBufShardNum> small_mem_buf_shards_;
+
+  MemPoolTraceWriterPtr trace_writer_{nullptr};
+  // The largest size of the continuous memory allocation which failed since the last compaction.
+  size_t failed_continuous_size_{0};
   MemStatusManagerPtr persistent_mem_{nullptr};
   MemStatusManagerPtr common_mem_{nullptr};
   // In the graph mode, the unit size set in the context will be modified through the FetchMemUnitSize function, so it
@@ -0,0 +1,205 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/mem_reuse/mem_pool_trace.h"
+#include <chrono>
+#include <algorithm>
+#include "common/mem_reuse/mem_dynamic_allocator.h"
+#include "utils/hash_map.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace device {
+namespace {
+constexpr char kMemPoolTraceMagic[] = "MSMPTRC1";
+constexpr size_t kMemPoolTraceMagicLen = sizeof(kMemPoolTraceMagic) - 1;
+constexpr size_t kTraceBufferSize = 4096;
+}  // namespace
+
+MemPoolTraceWriter::MemPoolTraceWriter(const std::string &file_path) : file_path_(file_path) {
+  ofs_.open(file_path_, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!ofs_.is_open()) {
+    MS_LOG(ERROR) << "Open file [" << file_path_ << "] failed!";
+    return;
+  }
+  (void)ofs_.write(kMemPoolTraceMagic, kMemPoolTraceMagicLen);
+  buffer_.reserve(kTraceBufferSize);
+}
+
+MemPoolTraceWriter::~MemPoolTraceWriter() {
+  Flush();
+  if (ofs_.is_open()) {
+    ofs_.close();
+  }
+}
+
+void MemPoolTraceWriter::Record(const MemPoolTraceRecord &record) {
+  std::lock_guard<std::mutex> locker(mutex_);
+  buffer_.push_back(record);
+  if (buffer_.size() >= kTraceBufferSize) {
+    FlushWithoutLock();
+  }
+}
+
+void MemPoolTraceWriter::Record(const std::vector<MemPoolTraceRecord> &records) {
+  // The records of one continuous memory allocation must be consecutive in the trace.
+  std::lock_guard<std::mutex> locker(mutex_);
+  buffer_.insert(buffer_.end(), records.begin(), records.end());
+  if (buffer_.size() >= kTraceBufferSize) {
+    FlushWithoutLock();
+  }
+}
+
+void MemPoolTraceWriter::Flush() {
+  std::lock_guard<std::mutex> locker(mutex_);
+  FlushWithoutLock();
+}
+
+void MemPoolTraceWriter::FlushWithoutLock() {
+  if (buffer_.empty() || !ofs_.is_open()) {
+    buffer_.clear();
+    return;
+  }
+  (void)ofs_.write(reinterpret_cast<const char *>(buffer_.data()),
+                   static_cast<std::streamsize>(buffer_.size() * sizeof(MemPoolTraceRecord)));
+  (void)ofs_.flush();
+  if (!ofs_.good()) {
+    MS_LOG(ERROR) << "Write the memory pool trace to file [" << file_path_ << "] failed.";
+  }
+  buffer_.clear();
+}
+
+bool LoadMemPoolTrace(const std::string &file_path, std::vector<MemPoolTraceRecord> *records) {
+  MS_EXCEPTION_IF_NULL(records);
+  std::ifstream ifs(file_path, std::ios::in | std::ios::binary);
+  if (!ifs.is_open()) {
+    MS_LOG(ERROR) << "Open file [" << file_path << "] failed!";
+    return false;
+  }
+  char magic[kMemPoolTraceMagicLen] = {0};
+  (void)ifs.read(magic, kMemPoolTraceMagicLen);
+  if (!ifs.good() || std::string(magic, kMemPoolTraceMagicLen) != kMemPoolTraceMagic) {
+    MS_LOG(ERROR) << "The file [" << file_path << "] isn't the memory pool trace.";
+    return false;
+  }
+
+  MemPoolTraceRecord record;
+  while (ifs.read(reinterpret_cast<char *>(&record), sizeof(MemPoolTraceRecord))) {
+    records->push_back(record);
+  }
+  // The truncated record at the end of file is written partially when the process exits abnormally.
+  if (ifs.gcount() != 0) {
+    MS_LOG(WARNING) << "Skip the truncated record at the end of memory pool trace file [" << file_path << "].";
+  }
+  return true;
+}
+
+MemPoolReplayResult ReplayMemPoolTrace(const std::vector<MemPoolTraceRecord> &records,
+                                       DynamicMemPoolBestFit *mem_pool) {
+  MS_EXCEPTION_IF_NULL(mem_pool);
+  MemPoolReplayResult result;
+  // Key is the address in the trace, value is the address in the replay.
+  mindspore::HashMap<uint64_t, DeviceMemPtr> addr_map;
+  auto update_peak = [&result, mem_pool]() {
+    result.peak_used_mem_ = std::max(result.peak_used_mem_, mem_pool->TotalUsedMemStatistics());
+    result.peak_total_mem_ = std::max(result.peak_total_mem_, mem_pool->TotalMemStatistics());
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < records.size(); ++i) {
+    const auto &record = records[i];
+    ++result.op_num_;
+    if (record.op_ == MemPoolTraceOp::kFree) {
+      const auto &iter = addr_map.find(record.addr_);
+      if (iter == addr_map.end()) {
+        continue;
+      }
+      mem_pool->FreeTensorMem(iter->second);
+      (void)addr_map.erase(iter);
+      continue;
+    }
+
+    if (record.op_ == MemPoolTraceOp::kMove) {
+      // The memory moved in the trace keeps its address in the replay.
+      if (i + 1 < records.size()) {
+        const auto &iter = addr_map.find(record.addr_);
+        if (iter != addr_map.end()) {
+          auto addr = iter->second;
+          (void)addr_map.erase(iter);
+          addr_map[records[i + 1].addr_] = addr;
+        }
+      }
+      ++i;
+      continue;
+    }
+
+    if (record.op_ == MemPoolTraceOp::kAlloc) {
+      if (record.addr_ == 0) {
+        ++result.trace_failed_num_;
+        continue;
+      }
+      auto addr = mem_pool->AllocTensorMem(record.size_, record.from_persistent_mem_ != 0);
+      if (addr == nullptr) {
+        ++result.replay_failed_num_;
+        continue;
+      }
+      addr_map[record.addr_] = addr;
+      update_peak();
+      continue;
+    }
+
+    // Collect the records of continuous memory allocation.
+    size_t group_size = std::max(record.group_size_, 1U);
+    if (i + group_size > records.size()) {
+      MS_LOG(WARNING) << "The continuous memory allocation of record " << i << " is truncated.";
+      break;
+    }
+    std::vector<size_t> size_list;
+    for (size_t j = i; j < i + group_size; ++j) {
+      size_list.push_back(records[j].size_);
+    }
+    if (record.addr_ == 0) {
+      ++result.trace_failed_num_;
+    } else {
+      auto addr_list = mem_pool->AllocContinuousTensorMem(size_list);
+      if (addr_list.size() != group_size) {
+        ++result.replay_failed_num_;
+      } else {
+        for (size_t j = 0; j < group_size; ++j) {
+          addr_map[records[i + j].addr_] = addr_list[j];
+        }
+        update_peak();
+      }
+    }
+    result.op_num_ += group_size - 1;
+    i += group_size - 1;
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  // Free the memory which is still in use at the end of trace.
+  for (const auto &item : addr_map) {
+    mem_pool->FreeTensorMem(item.second);
+  }
+  auto cost = std::chrono::duration<double>(end - start).count();
+  result.ops_per_sec_ = cost > 0 ? static_cast<double>(result.op_num_) / cost : 0;
+  if (result.peak_total_mem_ != 0) {
+    result.fragmentation_ =
+      1.0 - static_cast<double>(result.peak_used_mem_) / static_cast<double>(result.peak_total_mem_);
+  }
+  return result;
+}
+}  // namespace device
+}  // namespace mindspore
@@ -0,0 +1,96 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_COMMON_MEM_REUSE_MEM_POOL_TRACE_H_
+#define MINDSPORE_CCSRC_COMMON_MEM_REUSE_MEM_POOL_TRACE_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "utils/ms_utils.h"
+#include "include/backend/visible.h"
+
+namespace mindspore {
+namespace device {
+class DynamicMemPoolBestFit;
+
+enum class MemPoolTraceOp : uint8_t { kAlloc, kFree, kAllocContinuous, kMove };
+
+// The fixed size record of the binary trace. The continuous memory allocation is recorded as group_size_ consecutive
+// records of kAllocContinuous, one for each memory in the group. The failed allocation is recorded with zero address.
+// The memory moved by the compaction is recorded as two consecutive records of kMove, the source and the destination.
+struct MemPoolTraceRecord {
+  // The nanoseconds of steady clock.
+  uint64_t timestamp_;
+  uint64_t addr_;
+  uint64_t size_;
+  uint32_t stream_id_;
+  uint32_t group_size_;
+  MemPoolTraceOp op_;
+  // The value of AllocatorType.
+  uint8_t allocator_type_;
+  uint8_t from_persistent_mem_;
+  uint8_t reserved_[5];
+};
+static_assert(sizeof(MemPoolTraceRecord) == 40, "The size of trace record must be fixed.");
+
+// Write the trace records of memory pool to the binary file, the file begins with the magic number and is followed by
+// the records.
+class BACKEND_EXPORT MemPoolTraceWriter {
+ public:
+  explicit MemPoolTraceWriter(const std::string &file_path);
+  ~MemPoolTraceWriter();
+
+  bool is_open() const { return ofs_.is_open(); }
+  void Record(const MemPoolTraceRecord &record);
+  void Record(const std::vector<MemPoolTraceRecord> &records);
+  void Flush();
+
+ private:
+  void FlushWithoutLock();
+
+  std::string file_path_;
+  std::mutex mutex_;
+  std::ofstream ofs_;
+  std::vector<MemPoolTraceRecord> buffer_;
+};
+using MemPoolTraceWriterPtr = std::shared_ptr<MemPoolTraceWriter>;
+
+// Load the trace records from the binary file, return false if the file is invalid.
+BACKEND_EXPORT bool LoadMemPoolTrace(const std::string &file_path, std::vector<MemPoolTraceRecord> *records);
+
+struct MemPoolReplayResult {
+  size_t op_num_{0};
+  // The allocations failed in the trace, which are skipped in the replay.
+  size_t trace_failed_num_{0};
+  // The allocations succeeded in the trace but failed in the replay.
+  size_t replay_failed_num_{0};
+  size_t peak_used_mem_{0};
+  size_t peak_total_mem_{0};
+  // The ratio of the memory which is allocated from the device but not used at the peak of total memory.
+  double fragmentation_{0};
+  double ops_per_sec_{0};
+};
+
+// Replay the trace records against the memory pool in the order of records, and collect the statistics of pool.
+BACKEND_EXPORT MemPoolReplayResult ReplayMemPoolTrace(const std::vector<MemPoolTraceRecord> &records,
+                                                      DynamicMemPoolBestFit *mem_pool);
+}  // namespace device
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CCSRC_COMMON_MEM_REUSE_MEM_POOL_TRACE_H_
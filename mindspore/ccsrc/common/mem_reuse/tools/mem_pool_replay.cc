@@ -0,0 +1,153 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The offline tool replays the memory pool trace recorded by the env MS_DEV_MEM_POOL_TRACE against the memory pool
+// policies on the host memory, and reports the peak memory, fragmentation and throughput of each policy.
+// Usage: mem_pool_replay --trace=<trace file> [--capacity=<bytes>] [--unit_sizes=<bytes,bytes,...>]
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "common/mem_reuse/mem_dynamic_allocator.h"
+#include "common/mem_reuse/mem_pool_trace.h"
+
+namespace mindspore {
+namespace device {
+namespace {
+constexpr size_t kDefaultCapacity = 32UL << 30;
+constexpr size_t kDefaultUnitSize = 1UL << 30;
+
+// The memory pool on the host memory, the memory is reserved by malloc lazily and limited by the capacity.
+class HostReplayMemPool : public DynamicMemPoolBestFit {
+ public:
+  explicit HostReplayMemPool(size_t capacity) : capacity_(capacity) {
+    // The replay itself isn't traced.
+    set_trace_writer(nullptr);
+  }
+  ~HostReplayMemPool() override {
+    ReleaseDeviceRes();
+    for (auto addr : addrs_) {
+      free(addr);
+    }
+  }
+
+  size_t AllocDeviceMem(size_t size, DeviceMemPtr *addr) override {
+    if (allocated_size_ + size > capacity_) {
+      return 0;
+    }
+    *addr = malloc(size);
+    if (*addr == nullptr) {
+      return 0;
+    }
+    (void)addrs_.emplace_back(*addr);
+    allocated_size_ += size;
+    return size;
+  }
+  bool FreeDeviceMem(const DeviceMemPtr &) override { return true; }
+  size_t free_mem_size() override { return capacity_ - allocated_size_; }
+
+ private:
+  size_t capacity_;
+  size_t allocated_size_{0};
+  std::vector<DeviceMemPtr> addrs_;
+};
+
+struct ReplayPolicy {
+  size_t unit_size_;
+  bool enable_thread_cache_;
+};
+
+std::vector<size_t> ParseSizes(const std::string &value) {
+  std::vector<size_t> sizes;
+  size_t begin = 0;
+  while (begin < value.size()) {
+    auto end = value.find(',', begin);
+    if (end == std::string::npos) {
+      end = value.size();
+    }
+    sizes.push_back(std::stoull(value.substr(begin, end - begin)));
+    begin = end + 1;
+  }
+  return sizes;
+}
+
+int Run(int argc, char **argv) {
+  std::string trace_path;
+  size_t capacity = kDefaultCapacity;
+  std::vector<size_t> unit_sizes = {kDefaultUnitSize};
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto pos = arg.find('=');
+    auto key = arg.substr(0, pos);
+    auto value = (pos == std::string::npos) ? "" : arg.substr(pos + 1);
+    if (key == "--trace") {
+      trace_path = value;
+    } else if (key == "--capacity") {
+      capacity = std::stoull(value);
+    } else if (key == "--unit_sizes") {
+      unit_sizes = ParseSizes(value);
+    } else {
+      std::cerr << "Unknown argument: " << arg << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if (trace_path.empty()) {
+    std::cerr << "Usage: mem_pool_replay --trace=<trace file> [--capacity=<bytes>] [--unit_sizes=<bytes,...>]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<MemPoolTraceRecord> records;
+  if (!LoadMemPoolTrace(trace_path, &records)) {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Trace: " << trace_path << ", records: " << records.size() << std::endl;
+
+  std::vector<ReplayPolicy> policies;
+  for (auto unit_size : unit_sizes) {
+    policies.push_back({unit_size, false});
+    policies.push_back({unit_size, true});
+  }
+  std::cout << std::setw(14) << "unit_size" << std::setw(14) << "thread_cache" << std::setw(16) << "peak_used"
+            << std::setw(16) << "peak_total" << std::setw(16) << "fragmentation" << std::setw(16) << "ops/sec"
+            << std::setw(14) << "trace_fail" << std::setw(14) << "replay_fail" << std::endl;
+  for (const auto &policy : policies) {
+    HostReplayMemPool mem_pool(capacity);
+    mem_pool.SetMemAllocUintSize(policy.unit_size_, policy.unit_size_);
+    mem_pool.set_enable_thread_cache(policy.enable_thread_cache_);
+    auto result = ReplayMemPoolTrace(records, &mem_pool);
+    std::cout << std::setw(14) << policy.unit_size_ << std::setw(14) << policy.enable_thread_cache_ << std::setw(16)
+              << result.peak_used_mem_ << std::setw(16) << result.peak_total_mem_ << std::setw(16)
+              << std::setprecision(4) << result.fragmentation_ << std::setw(16) << std::setprecision(8)
+              << result.ops_per_sec_ << std::setw(14) << result.trace_failed_num_ << std::setw(14)
+              << result.replay_failed_num_ << std::endl;
+  }
+  return EXIT_SUCCESS;
+}
+}  // namespace
+}  // namespace device
+}  // namespace mindspore
+
+int main(int argc, char **argv) {
+  try {
+    return mindspore::device::Run(argc, argv);
+  } catch (const std::exception &e) {
+    std::cerr << "Replay the memory pool trace failed: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
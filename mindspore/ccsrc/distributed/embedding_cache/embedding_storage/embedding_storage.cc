@@ -78,8 +78,10 @@ void EmbeddingStorage<KeyType, ValueType, Allocator>::Initialize(const DeviceAdd
 
   std::map<std::string, std::string> config_map;
   config_map[kFileStoragePath] = real_storage_file_path;
+  config_map[kElementSize] = std::to_string(embedding_dim_);
   storage_ = std::make_unique<LocalFile<KeyType, ValueType>>(config_map);
   MS_EXCEPTION_IF_NULL(storage_);
+  storage_->Initialize();
 }
 
 template class EmbeddingStorage<int32_t, bool>;
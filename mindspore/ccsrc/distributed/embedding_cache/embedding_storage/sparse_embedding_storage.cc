@@ -0,0 +1,225 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "distributed/embedding_cache/embedding_storage/sparse_embedding_storage.h"
+#include <algorithm>
+#include "utils/hash_set.h"
+
+namespace mindspore {
+namespace distributed {
+namespace storage {
+template <typename KeyType, typename ValueType, typename Allocator>
+void SparseEmbeddingStorage<KeyType, ValueType, Allocator>::Initialize(const DeviceAddress *device_address) {
+  MS_EXCEPTION_IF_NULL(device_address);
+  EmbeddingStorage<KeyType, ValueType, Allocator>::Initialize(device_address);
+  const auto &user_data = device_address->user_data();
+  MS_EXCEPTION_IF_NULL(user_data);
+  hash_table_ = user_data->get<HashTable>(kUserDataData).get();
+  MS_EXCEPTION_IF_NULL(hash_table_);
+}
+
+template <typename KeyType, typename ValueType, typename Allocator>
+void SparseEmbeddingStorage<KeyType, ValueType, Allocator>::Finalize() {
+  hash_table_ = nullptr;
+}
+
+template <typename KeyType, typename ValueType, typename Allocator>
+bool SparseEmbeddingStorage<KeyType, ValueType, Allocator>::Get(const KeyType *keys, size_t key_num,
+                                                                ValueType *values) {
+  MS_EXCEPTION_IF_NULL(keys);
+  MS_EXCEPTION_IF_NULL(values);
+  MS_EXCEPTION_IF_NULL(hash_table_);
+
+  // 1. Query cache to update the positions of cache hit elements in the cache (cache refresh), and collect the cache
+  // miss keys.
+  std::vector<KeyType> cache_miss_keys;
+  RETURN_IF_FALSE_WITH_LOG(QueryCache(keys, key_num, &cache_miss_keys), "Query the host cache failed.");
+
+  if (!cache_miss_keys.empty()) {
+    // 2. Reserve space for cache miss keys in the cache (if there is enough space in the cache, then do nothing), and
+    // move the evicted elements from the hash table to persistent storage.
+    RETURN_IF_FALSE_WITH_LOG(TryEvict(cache_miss_keys.size()), "Reserve space for miss keys failed.");
+
+    // 3. Insert the cache miss elements into the hash table from persistent storage.
+    RETURN_IF_FALSE_WITH_LOG(InsertMissCacheFromStorage(cache_miss_keys),
+                             "Insert the cache miss elements into the cache from persistent storage failed.");
+  }
+
+  // 4. Copy the embeddings from the hash table to the returned values, the keys which are neither in the cache nor in
+  // the persistent storage are initialized by the hash table.
+  return hash_table_->Find(keys, key_num, true, values, nullptr);
+}
+
+template <typename KeyType, typename ValueType, typename Allocator>
+bool SparseEmbeddingStorage<KeyType, ValueType, Allocator>::Put(const KeyType *keys, size_t key_num,
+                                                                const ValueType *values) {
+  MS_EXCEPTION_IF_NULL(keys);
+  MS_EXCEPTION_IF_NULL(values);
+  MS_EXCEPTION_IF_NULL(hash_table_);
+
+  // 1. Query cache to update the positions of cache hit elements in the cache (cache refresh), and collect the cache
+  // miss keys.
+  std::vector<KeyType> cache_miss_keys;
+  RETURN_IF_FALSE_WITH_LOG(QueryCache(keys, key_num, &cache_miss_keys), "Query the host cache failed.");
+
+  if (!cache_miss_keys.empty()) {
+    // 2. Reserve space for cache miss keys in the cache (if there is enough space in the cache, then do nothing), and
+    // move the evicted elements from the hash table to persistent storage.
+    RETURN_IF_FALSE_WITH_LOG(TryEvict(cache_miss_keys.size()), "Reserve space for miss keys failed.");
+
+    // 3. Insert the cache miss keys into the cache, the stale values in persistent storage are overwritten by the
+    // later eviction.
+    for (const auto &key : cache_miss_keys) {
+      this->cache_->Put(key, 0);
+    }
+  }
+
+  // 4. Update the embeddings of all keys in the hash table.
+  return hash_table_->Insert(keys, key_num, values, nullptr);
+}
+
+template <typename KeyType, typename ValueType, typename Allocator>
+bool SparseEmbeddingStorage<KeyType, ValueType, Allocator>::QueryCache(const KeyType *keys, size_t key_num,
+                                                                       std::vector<KeyType> *cache_miss_keys) const {
+  MS_EXCEPTION_IF_NULL(keys);
+  MS_EXCEPTION_IF_NULL(cache_miss_keys);
+  MS_EXCEPTION_IF_NULL(this->cache_);
+
+  HashSet<KeyType> unique_keys;
+  for (size_t i = 0; i < key_num; i++) {
+    if (!unique_keys.insert(keys[i]).second) {
+      continue;
+    }
+    if (this->cache_->Exists(keys[i])) {
+      (void)this->cache_->Get(keys[i]);
+      continue;
+    }
+    cache_miss_keys->push_back(keys[i]);
+  }
+
+  // The cache hit elements of this batch must not be evicted by the cache miss ones.
+  if (unique_keys.size() > this->cache_->capacity()) {
+    MS_LOG(ERROR) << "The number of unique keys[" << unique_keys.size() << "] exceeds the capacity of host cache["
+                  << this->cache_->capacity() << "].";
+    return false;
+  }
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename Allocator>
+bool SparseEmbeddingStorage<KeyType, ValueType, Allocator>::TryEvict(size_t reserve_size) {
+  // 1. Try evict some non-hot data in cache to reserve space for elements that will be inserted into the cache.
+  MS_EXCEPTION_IF_NULL(this->cache_);
+  std::vector<CacheElement> evicted_elements;
+  this->cache_->TryEvict(reserve_size, &evicted_elements);
+  if (evicted_elements.empty()) {
+    return true;
+  }
+
+  std::vector<KeyType> evicted_keys(evicted_elements.size());
+  (void)std::transform(evicted_elements.begin(), evicted_elements.end(), evicted_keys.begin(),
+                       [](const CacheElement &element) { return element.first; });
+
+  // 2. Get all evicted embedding vector values from the hash table.
+  size_t evicted_keys_len = evicted_keys.size() * sizeof(KeyType);
+  size_t evicted_values_len = evicted_keys.size() * this->embedding_dim_ * sizeof(ValueType);
+  ValueType *evicted_values = this->template AllocateMemory<ValueType>(evicted_values_len);
+  MS_EXCEPTION_IF_NULL(evicted_values);
+  MS_EXCEPTION_IF_NULL(hash_table_);
+  if (!hash_table_->Find(evicted_keys.data(), evicted_keys.size(), false, evicted_values, nullptr)) {
+    MS_LOG(ERROR) << "Find the evicted elements in the hash table failed.";
+    this->FreeMemory(evicted_values);
+    return false;
+  }
+
+  // 3. Write evicted elements to persistent storage, and remove them from the hash table.
+  MS_EXCEPTION_IF_NULL(this->storage_);
+  this->storage_->Write({evicted_keys.data(), evicted_keys_len}, {evicted_values, evicted_values_len});
+  this->FreeMemory(evicted_values);
+  return hash_table_->Erase(evicted_keys.data(), evicted_keys.size(), nullptr);
+}
+
+template <typename KeyType, typename ValueType, typename Allocator>
+bool SparseEmbeddingStorage<KeyType, ValueType, Allocator>::InsertMissCacheFromStorage(
+  const std::vector<KeyType> &cache_miss_keys) {
+  MS_EXCEPTION_IF_NULL(this->cache_);
+  MS_EXCEPTION_IF_NULL(this->storage_);
+  MS_EXCEPTION_IF_NULL(hash_table_);
+
+  // 1. Find the cache miss keys which have been evicted to the persistent storage.
+  std::vector<bool> exists;
+  this->storage_->Exists({cache_miss_keys.data(), cache_miss_keys.size() * sizeof(KeyType)}, &exists);
+  if (exists.size() != cache_miss_keys.size()) {
+    MS_LOG(ERROR) << "The persistent storage does not support querying the keys.";
+    return false;
+  }
+  std::vector<KeyType> stored_keys;
+  for (size_t i = 0; i < cache_miss_keys.size(); i++) {
+    if (exists[i]) {
+      stored_keys.push_back(cache_miss_keys[i]);
+    }
+  }
+
+  // 2. Read the stored elements from the persistent storage and insert them into the hash table.
+  if (!stored_keys.empty()) {
+    size_t stored_keys_len = stored_keys.size() * sizeof(KeyType);
+    size_t stored_values_len = stored_keys.size() * this->embedding_dim_ * sizeof(ValueType);
+    ValueType *stored_values = this->template AllocateMemory<ValueType>(stored_values_len);
+    MS_EXCEPTION_IF_NULL(stored_values);
+    this->storage_->Read({stored_keys.data(), stored_keys_len}, {stored_values, stored_values_len});
+    bool ret = hash_table_->Insert(stored_keys.data(), stored_keys.size(), stored_values, nullptr);
+    this->FreeMemory(stored_values);
+    RETURN_IF_FALSE_WITH_LOG(ret, "Insert the stored elements into the hash table failed.");
+  }
+
+  // 3. Insert all the cache miss keys into the cache.
+  for (const auto &key : cache_miss_keys) {
+    this->cache_->Put(key, 0);
+  }
+  return true;
+}
+
+template class SparseEmbeddingStorage<int32_t, bool>;
+template class SparseEmbeddingStorage<int32_t, int8_t>;
+template class SparseEmbeddingStorage<int32_t, int16_t>;
+template class SparseEmbeddingStorage<int32_t, int32_t>;
+template class SparseEmbeddingStorage<int32_t, int64_t>;
+template class SparseEmbeddingStorage<int32_t, uint8_t>;
+template class SparseEmbeddingStorage<int32_t, uint16_t>;
+template class SparseEmbeddingStorage<int32_t, uint32_t>;
+template class SparseEmbeddingStorage<int32_t, uint64_t>;
+template class SparseEmbeddingStorage<int32_t, float16>;
+template class SparseEmbeddingStorage<int32_t, float>;
+template class SparseEmbeddingStorage<int32_t, double>;
+
+template class SparseEmbeddingStorage<int64_t, bool>;
+template class SparseEmbeddingStorage<int64_t, int8_t>;
+template class SparseEmbeddingStorage<int64_t, int16_t>;
+template class SparseEmbeddingStorage<int64_t, int32_t>;
+template class SparseEmbeddingStorage<int64_t, int64_t>;
+template class SparseEmbeddingStorage<int64_t, uint8_t>;
+template class SparseEmbeddingStorage<int64_t, uint16_t>;
+template class SparseEmbeddingStorage<int64_t, uint32_t>;
+template class SparseEmbeddingStorage<int64_t, uint64_t>;
+template class SparseEmbeddingStorage<int64_t, float16>;
+template class SparseEmbeddingStorage<int64_t, float>;
+template class SparseEmbeddingStorage<int64_t, double>;
+
+template class SparseEmbeddingStorage<int32_t, float, std::allocator<uint8_t>>;
+template class SparseEmbeddingStorage<int64_t, float, std::allocator<uint8_t>>;
+}  // namespace storage
+}  // namespace distributed
+}  // namespace mindspore
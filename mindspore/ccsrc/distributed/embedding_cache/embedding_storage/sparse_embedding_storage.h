@@ -18,6 +18,7 @@
 #define MINDSPORE_CCSRC_DISTRIBUTED_EMBEDDING_CACHE_SPARSE_EMBEDDING_STORAGE_EMBEDDING_STORAGE_H_
 
 #include <string>
+#include <vector>
 
 #include "distributed/embedding_cache/embedding_storage/embedding_storage.h"
 #include "runtime/device/hash_table.h"
@@ -27,6 +28,9 @@ namespace mindspore {
 namespace distributed {
 namespace storage {
 // A derived class for Sparse implementation to manage lookup and update of a huge Embedding Table for Hash Table type.
+// The hot embeddings are stored in the hash table of the Embedding Table parameter, whose keys are tracked by the host
+// cache, and the embeddings evicted from the host cache are moved to the persistent storage, so only the hot ones take
+// the host memory.
 template <typename KeyType, typename ValueType, typename Allocator = Allocator<uint8_t>>
 class BACKEND_EXPORT SparseEmbeddingStorage : public EmbeddingStorage<KeyType, ValueType, Allocator> {
  public:
@@ -45,26 +49,48 @@ class BACKEND_EXPORT SparseEmbeddingStorage : public EmbeddingStorage<KeyType, V
   // SparseEmbeddingStorage.
   // Parameter[in] `device_address`: The device address of the Embedding Table parameter corresponding to the
   // SparseEmbeddingStorage.
-  void Initialize(const DeviceAddress *device_address) override {}
+  void Initialize(const DeviceAddress *device_address) override;
 
   // Finalize the EmbeddingStorage, release allocated resource.
-  void Finalize() override {}
+  void Finalize() override;
 
   // Batch embeddings lookup operation.
   // Query Embeddings in the host cache first, if the corresponding element cannot be found in the host cache, then read
   // the element from the SSD and insert host cache.
   // Access an element of the cache generally affects the location or order of the elements in the cache, depending
   // on different cache strategies.
-  bool Get(const KeyType *keys, size_t key_num, ValueType *values) override { return true; }
+  bool Get(const KeyType *keys, size_t key_num, ValueType *values) override;
 
   // Batch embeddings update/insert operation.
   // Update/Insert Embeddings in the host cache first, if the host cache has insufficient space, the expired elements
   // will automatically be evicted the to the SSD.
   // Update or Insert an element of the cache generally affects the location or order of the elements in the cache,
   // depending on different cache strategies.
-  bool Put(const KeyType *keys, size_t key_num, const ValueType *values) override { return true; }
+  bool Put(const KeyType *keys, size_t key_num, const ValueType *values) override;
 
  private:
+  // Query cache to refresh the positions of cache hit elements in the cache, and collect the unique cache miss keys.
+  //
+  // Parameter[in] `keys`: The array records all keys which need to query.
+  // Parameter[in] `key_num`: The number of keys which need to query.
+  // Parameter[out] `cache_miss_keys`: The unique keys which do not exist in the cache.
+  // Return whether the unique keys could be held by the cache at the same time.
+  bool QueryCache(const KeyType *keys, size_t key_num, std::vector<KeyType> *cache_miss_keys) const;
+
+  // Reserve space for cache miss keys in the cache, move the evicted elements from the hash table to SSD.
+  //
+  // Parameter[in] `reserve_size`: The number of element slots that are expected to be reserved. If the
+  // reserve_size is less than or equal to the number of slots remaining in the cache, the function does nothing.
+  // Return whether the function was successfully executed.
+  bool TryEvict(size_t reserve_size);
+
+  // Insert the cache miss elements into the hash table from persistent storage, the keys which have never been
+  // evicted are left to be initialized by the hash table, and insert all the cache miss keys into the cache.
+  //
+  // Parameter[in] `cache_miss_keys`: The unique keys which do not exist in the cache.
+  // Return whether the function was successfully executed.
+  bool InsertMissCacheFromStorage(const std::vector<KeyType> &cache_miss_keys);
+
   // The base pointer to the hash table of the embedding table parameter.
   // All embeddings in host cache is recorded in it.
   HashTable *hash_table_{nullptr};
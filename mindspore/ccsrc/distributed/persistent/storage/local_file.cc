@@ -420,6 +420,22 @@ void LocalFile<KeyType, ValueType>::Read(const ConstDataWithLen &keys, const Dat
   }
 }
 
+template <typename KeyType, typename ValueType>
+void LocalFile<KeyType, ValueType>::Exists(const ConstDataWithLen &keys, std::vector<bool> *exists) const {
+  MS_EXCEPTION_IF_NULL(exists);
+  const KeyType *keys_data = reinterpret_cast<const KeyType *>(keys.data_);
+  size_t key_num = keys.data_len_ / sizeof(KeyType);
+  exists->assign(key_num, false);
+  if (key_num == 0) {
+    return;
+  }
+  MS_EXCEPTION_IF_NULL(keys_data);
+
+  for (size_t i = 0; i < key_num; i++) {
+    (*exists)[i] = keys_to_locations_.find(keys_data[i]) != keys_to_locations_.end();
+  }
+}
+
 template class LocalFile<int32_t, bool>;
 template class LocalFile<int32_t, int8_t>;
 template class LocalFile<int32_t, int16_t>;
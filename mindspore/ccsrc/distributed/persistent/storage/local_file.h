@@ -76,6 +76,11 @@ class LocalFile : public StorageBase {
   // length.
   void Read(const ConstDataWithLen &keys, const DataWithLen &values) override;
 
+  // Query whether the values of keys exist in local file storage.
+  // Parameter[in] `keys`: The keys need to query, containing data pointer and data buffer length.
+  // Parameter[out] `exists`: Whether the value of each key exists in local file storage.
+  void Exists(const ConstDataWithLen &keys, std::vector<bool> *exists) const override;
+
  private:
   // Create blocks and block metas and write input data to block files.
   void WriteBlockFiles(const std::vector<InputData> &inputs);
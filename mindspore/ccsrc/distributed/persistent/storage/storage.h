@@ -87,6 +87,11 @@ class StorageBase {
   // Parameter[out] `values`: The values corresponding to keys need to read, containing data pointer and data buffer
   // length.
   virtual void Read(const ConstDataWithLen &keys, const DataWithLen &values) {}
+
+  // Query whether the values of keys exist in persistent storage.
+  // Parameter[in] `keys`: The keys need to query, containing data pointer and data buffer length.
+  // Parameter[out] `exists`: Whether the value of each key exists in persistent storage.
+  virtual void Exists(const ConstDataWithLen &keys, std::vector<bool> *exists) const {}
 };
 }  // namespace storage
 }  // namespace distributed
@@ -171,7 +171,7 @@ Status DataQueueOp::operator()() {
     RETURN_IF_NOT_OK(SendDataToAscend());
 
 #endif
-  } else if (device_type_ == DeviceType::GPU) {
+  } else if ((device_type_ == DeviceType::GPU) || IsCpuDataQueueCreated()) {
 #ifdef WITH_BACKEND
     if (create_data_info_queue_) {
       // This place has a race condition with GetDataInfo, so the first one
@@ -741,6 +741,15 @@ Status DataQueueOp::ClearDevice() {
   return Status::OK();
 }
 
+bool DataQueueOp::IsCpuDataQueueCreated() const {
+#ifdef WITH_BACKEND
+  // The CPU data queue holds the host memory of dataset, so the data is sent in the same way as GPU.
+  return (device_type_ == DeviceType::CPU) && device::DataQueueMgr::GetInstance().IsCreated(channel_name_);
+#else
+  return false;
+#endif
+}
+
 Status DataQueueOp::SendDataToCPU() {
   MS_LOG(INFO) << "Device queue, sending data to CPU.";
   int64_t total_batch = 0;
@@ -153,6 +153,8 @@ class DataQueueOp : public PipelineOp {
   uint32_t queue_capacity_;
 
   Status SendDataToCPU();
+  // Whether the CPU data queue is created by the InitDataSetQueue kernel in the dataset sink mode of CPU backend.
+  bool IsCpuDataQueueCreated() const;
 #ifndef ENABLE_SECURITY
   // Create async thread to detect whether it takes too long and unable to fetch first batch
   Status DetectFirstBatch();
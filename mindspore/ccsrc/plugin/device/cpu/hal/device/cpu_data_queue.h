@@ -0,0 +1,45 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_CCSRC_PLUGIN_DEVICE_CPU_HAL_DEVICE_CPU_DATA_QUEUE_H_
+#define MINDSPORE_CCSRC_PLUGIN_DEVICE_CPU_HAL_DEVICE_CPU_DATA_QUEUE_H_
+
+#include <memory>
+#include <vector>
+#include <string>
+#include "include/backend/data_queue/data_queue.h"
+#include "include/backend/visible.h"
+
+namespace mindspore {
+namespace device {
+// The data queue of CPU is used in the dataset sink mode. The data queue op copies the batch into the host buffers, and
+// the queue holds the buffers without another copy in the push. The GetNext kernel copies the items into its outputs,
+// and the buffers are released to the dataset after the batch is consumed.
+class BACKEND_EXPORT CpuDataQueue : public DataQueue {
+ public:
+  CpuDataQueue(const std::string &channel_name, size_t capacity);
+  ~CpuDataQueue() override = default;
+
+  DataQueueStatus Push(std::vector<DataQueueItem> data) override;
+  DataQueueStatus Front(std::vector<DataQueueItem> *data) const override;
+  DataQueueStatus Pop() override;
+
+ private:
+  std::unique_ptr<std::vector<DataQueueItem>[]> node_info_;
+};
+}  // namespace device
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CCSRC_PLUGIN_DEVICE_CPU_HAL_DEVICE_CPU_DATA_QUEUE_H_
@@ -13,26 +13,132 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "plugin/device/cpu/hal/device/cpu_hash_table.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <climits>
 #include <memory>
 #include <vector>
 
 #include "utils/log_adapter.h"
 #include "utils/convert_utils_base.h"
-#include "utils/ms_context.h"
-#include "runtime/hardware/device_context_manager.h"
-#include "plugin/device/cpu/hal/device/cpu_hash_table.h"
+#include "plugin/device/cpu/hal/hardware/cpu_memory_pool.h"
 
 namespace mindspore {
 namespace device {
 namespace cpu {
+namespace {
+// The stripe is selected by the high bits of hash.
+constexpr size_t kStripeBits = 6;
+constexpr size_t kStripeNum = 1UL << kStripeBits;
+constexpr size_t kGroupSize = 16;
+// The control byte of a full slot is the low 7 bits of hash, and the empty or deleted slot is negative.
+constexpr size_t kH2Bits = 7;
+constexpr uint64_t kH2Mask = (1UL << kH2Bits) - 1;
+constexpr int8_t kCtrlEmpty = -128;
+constexpr int8_t kCtrlDeleted = -2;
+// The max load factor of a stripe is 7/8.
+constexpr size_t kMaxLoadNumerator = 7;
+constexpr size_t kMaxLoadDenominator = 8;
+// The memory of the keys several positions ahead in the batch is prefetched while probing.
+constexpr size_t kPrefetchDistance = 8;
+
+template <typename Key>
+uint64_t HashKey(const Key &key) {
+  // The finalizer of MurmurHash3, which spreads the sequential ids to all the bits.
+  auto hash = static_cast<uint64_t>(key);
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+size_t StripeIndex(uint64_t hash) { return static_cast<size_t>(hash >> (sizeof(uint64_t) * CHAR_BIT - kStripeBits)); }
+
+size_t GroupIndex(uint64_t hash, size_t group_mask) { return static_cast<size_t>(hash >> kH2Bits) & group_mask; }
+
+// Return the bit mask of the control bytes equal to the `ctrl` in the group.
+uint32_t MatchGroup(const int8_t *group, int8_t ctrl) {
+#if defined(__SSE2__)
+  auto ctrls = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(ctrl), ctrls)));
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < kGroupSize; ++i) {
+    mask |= static_cast<uint32_t>(group[i] == ctrl) << i;
+  }
+  return mask;
+#endif
+}
+
+// Return the bit mask of the empty or deleted slots in the group.
+uint32_t MatchGroupFree(const int8_t *group) {
+#if defined(__SSE2__)
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(group))));
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < kGroupSize; ++i) {
+    mask |= static_cast<uint32_t>(group[i] < 0) << i;
+  }
+  return mask;
+#endif
+}
+
+size_t LowestBit(uint32_t mask) {
+#if defined(__GNUC__)
+  return static_cast<size_t>(__builtin_ctz(mask));
+#else
+  size_t index = 0;
+  while ((mask & 1) == 0) {
+    mask >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+void Prefetch(const void *addr) {
+#if defined(__GNUC__)
+  __builtin_prefetch(addr);
+#endif
+}
+
+size_t RoundUpPowerOfTwo(size_t size) {
+  size_t result = kGroupSize;
+  while (result < size) {
+    result <<= 1;
+  }
+  return result;
+}
+
+// The slots needed to hold the elements under the max load factor.
+size_t CapacityForSize(size_t size) {
+  return RoundUpPowerOfTwo(size * kMaxLoadDenominator / kMaxLoadNumerator + 1);
+}
+}  // namespace
+
 template <typename Key, typename Value>
-bool CPUHashTable<Key, Value>::Initialize() {
-  const uint32_t device_id = 0;
-  device_ctx_ = device::DeviceContextManager::GetInstance().GetOrCreateDeviceContext({kCPUDevice, device_id});
-  MS_EXCEPTION_IF_NULL(device_ctx_);
-  device_ctx_->Initialize();
+CPUHashTable<Key, Value>::CPUHashTable(size_t value_dim, const Value &default_value)
+    : value_dim_(value_dim), value_size_(value_dim * sizeof(Value)), default_value_(default_value) {
+  for (size_t i = 0; i < kStripeNum; ++i) {
+    (void)stripes_.emplace_back(std::make_unique<Stripe>());
+  }
+}
+
+template <typename Key, typename Value>
+CPUHashTable<Key, Value>::~CPUHashTable() {
+  for (auto &stripe : stripes_) {
+    ReleaseStripe(stripe.get());
+  }
+}
 
-  value_size_ = value_dim_ * sizeof(Value);
+template <typename Key, typename Value>
+bool CPUHashTable<Key, Value>::Initialize() {
   return true;
 }
 
@@ -42,55 +148,310 @@ bool CPUHashTable<Key, Value>::Finalize() {
 }
 
 template <typename Key, typename Value>
-bool CPUHashTable<Key, Value>::Find(const Key *keys, size_t key_num, bool, Value *outputs, void *) {
-  std::unique_lock<std::shared_mutex> lock(mutex_);
-
-  // Find and copy values to output buffer if the keys exist.
+void CPUHashTable<Key, Value>::BucketKeys(const Key *keys, size_t key_num, std::vector<uint64_t> *hashes,
+                                          std::vector<size_t> *key_indices,
+                                          std::vector<size_t> *stripe_offsets) const {
+  hashes->resize(key_num);
+  key_indices->resize(key_num);
+  stripe_offsets->assign(kStripeNum + 1, 0);
   for (size_t i = 0; i < key_num; ++i) {
-    const auto &key = keys[i];
-    if (values_.find(key) != values_.end()) {
-      size_t offset = i * value_size_;
-      size_t src_size = value_size_;
-      size_t dst_size = value_size_;
+    (*hashes)[i] = HashKey(keys[i]);
+    ++(*stripe_offsets)[StripeIndex((*hashes)[i]) + 1];
+  }
+  for (size_t i = 0; i < kStripeNum; ++i) {
+    (*stripe_offsets)[i + 1] += (*stripe_offsets)[i];
+  }
+  std::vector<size_t> positions(stripe_offsets->begin(), stripe_offsets->end() - 1);
+  for (size_t i = 0; i < key_num; ++i) {
+    (*key_indices)[positions[StripeIndex((*hashes)[i])]++] = i;
+  }
+}
 
+template <typename Key, typename Value>
+int64_t CPUHashTable<Key, Value>::FindSlot(const Stripe &stripe, const Key &key, uint64_t hash) const {
+  if (stripe.capacity_ == 0) {
+    return -1;
+  }
+  const auto h2 = static_cast<int8_t>(hash & kH2Mask);
+  const size_t group_mask = stripe.capacity_ / kGroupSize - 1;
+  size_t group = GroupIndex(hash, group_mask);
+  // The triangular probing visits all the groups since the group number is a power of two.
+  for (size_t step = 1; step <= group_mask + 1; ++step) {
+    const int8_t *ctrls = stripe.ctrls_.data() + group * kGroupSize;
+    for (uint32_t mask = MatchGroup(ctrls, h2); mask != 0; mask &= mask - 1) {
+      size_t slot = group * kGroupSize + LowestBit(mask);
+      if (stripe.keys_[slot] == key) {
+        return SizeToLong(slot);
+      }
+    }
+    // The key is inserted to the first free slot of the probing, so it does not exist after an empty slot.
+    if (MatchGroup(ctrls, kCtrlEmpty) != 0) {
+      return -1;
+    }
+    group = (group + step) & group_mask;
+  }
+  return -1;
+}
+
+template <typename Key, typename Value>
+bool CPUHashTable<Key, Value>::PrepareInsertSlot(Stripe *stripe, uint64_t hash, size_t *slot) {
+  if ((stripe->size_ + stripe->deleted_num_ + 1) * kMaxLoadDenominator > stripe->capacity_ * kMaxLoadNumerator) {
+    // Drop the deleted slots in place if the elements take less than half of the slots, otherwise grow the stripe.
+    size_t new_capacity = stripe->capacity_;
+    if ((stripe->size_ + 1) * kMaxLoadDenominator * 2 > stripe->capacity_ * kMaxLoadNumerator) {
+      new_capacity = CapacityForSize(std::max(stripe->size_ + 1, stripe->capacity_));
+    }
+    if (!Rehash(stripe, new_capacity)) {
+      return false;
+    }
+  }
+  const size_t group_mask = stripe->capacity_ / kGroupSize - 1;
+  size_t group = GroupIndex(hash, group_mask);
+  for (size_t step = 1; step <= group_mask + 1; ++step) {
+    auto mask = MatchGroupFree(stripe->ctrls_.data() + group * kGroupSize);
+    if (mask != 0) {
+      *slot = group * kGroupSize + LowestBit(mask);
+      if (stripe->ctrls_[*slot] == kCtrlDeleted) {
+        --stripe->deleted_num_;
+      }
+      stripe->ctrls_[*slot] = static_cast<int8_t>(hash & kH2Mask);
+      ++stripe->size_;
+      return true;
+    }
+    group = (group + step) & group_mask;
+  }
+  MS_LOG(ERROR) << "There is no free slot in the hash table stripe of capacity " << stripe->capacity_;
+  return false;
+}
+
+template <typename Key, typename Value>
+bool CPUHashTable<Key, Value>::Rehash(Stripe *stripe, size_t new_capacity) {
+  MS_EXCEPTION_IF_NULL(stripe);
+  Value *new_values = nullptr;
+  if (value_size_ > 0) {
+    new_values = static_cast<Value *>(CPUMemoryPool::GetInstance().AllocTensorMem(new_capacity * value_size_));
+    if (new_values == nullptr) {
+      MS_LOG(ERROR) << "Allocate the memory of size " << new_capacity * value_size_ << " for the hash table failed.";
+      return false;
+    }
+  }
+  std::vector<int8_t> new_ctrls(new_capacity, kCtrlEmpty);
+  std::vector<Key> new_keys(new_capacity);
+  const size_t group_mask = new_capacity / kGroupSize - 1;
+  for (size_t i = 0; i < stripe->capacity_; ++i) {
+    if (stripe->ctrls_[i] < 0) {
+      continue;
+    }
+    const auto &key = stripe->keys_[i];
+    auto hash = HashKey(key);
+    size_t group = GroupIndex(hash, group_mask);
+    uint32_t mask = 0;
+    for (size_t step = 1; (mask = MatchGroup(new_ctrls.data() + group * kGroupSize, kCtrlEmpty)) == 0; ++step) {
+      group = (group + step) & group_mask;
+    }
+    size_t slot = group * kGroupSize + LowestBit(mask);
+    new_ctrls[slot] = stripe->ctrls_[i];
+    new_keys[slot] = key;
+    if (value_size_ > 0) {
+      auto ret = memcpy_s(new_values + slot * value_dim_, value_size_, stripe->values_ + i * value_dim_, value_size_);
+      if (ret != EOK) {
+        CPUMemoryPool::GetInstance().FreeTensorMem(new_values);
+        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+        return false;
+      }
+    }
+  }
+  if (stripe->values_ != nullptr) {
+    CPUMemoryPool::GetInstance().FreeTensorMem(stripe->values_);
+  }
+  stripe->ctrls_ = std::move(new_ctrls);
+  stripe->keys_ = std::move(new_keys);
+  stripe->values_ = new_values;
+  stripe->capacity_ = new_capacity;
+  stripe->deleted_num_ = 0;
+  return true;
+}
+
+template <typename Key, typename Value>
+void CPUHashTable<Key, Value>::ReleaseStripe(Stripe *stripe) {
+  MS_EXCEPTION_IF_NULL(stripe);
+  if (stripe->values_ != nullptr) {
+    CPUMemoryPool::GetInstance().FreeTensorMem(stripe->values_);
+    stripe->values_ = nullptr;
+  }
+  stripe->ctrls_.clear();
+  stripe->ctrls_.shrink_to_fit();
+  stripe->keys_.clear();
+  stripe->keys_.shrink_to_fit();
+  stripe->capacity_ = 0;
+  stripe->size_ = 0;
+  stripe->deleted_num_ = 0;
+}
+
+template <typename Key, typename Value>
+std::vector<std::shared_lock<std::shared_mutex>> CPUHashTable<Key, Value>::LockStripes() const {
+  std::vector<std::shared_lock<std::shared_mutex>> locks;
+  for (const auto &stripe : stripes_) {
+    (void)locks.emplace_back(stripe->mutex_);
+  }
+  return locks;
+}
+
+template <typename Key, typename Value>
+bool CPUHashTable<Key, Value>::CopyElements(Key *keys, Value *values) const {
+  size_t index = 0;
+  for (const auto &stripe : stripes_) {
+    for (size_t i = 0; i < stripe->capacity_; ++i) {
+      if (stripe->ctrls_[i] < 0) {
+        continue;
+      }
+      keys[index] = stripe->keys_[i];
+      if (value_size_ > 0) {
+        auto ret = memcpy_s(values + index * value_dim_, value_size_, stripe->values_ + i * value_dim_, value_size_);
+        if (ret != EOK) {
+          MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+          return false;
+        }
+      }
+      ++index;
+    }
+  }
+  return true;
+}
+
+template <typename Key, typename Value>
+bool CPUHashTable<Key, Value>::Find(const Key *keys, size_t key_num, bool insert_default_value, Value *outputs,
+                                    void *) {
+  std::vector<uint64_t> hashes;
+  std::vector<size_t> key_indices;
+  std::vector<size_t> stripe_offsets;
+  BucketKeys(keys, key_num, &hashes, &key_indices, &stripe_offsets);
+  std::vector<size_t> missing_indices;
+
+  // Find and copy values to output buffer if the keys exist.
+  for (size_t s = 0; s < kStripeNum; ++s) {
+    const auto begin = stripe_offsets[s];
+    const auto end = stripe_offsets[s + 1];
+    if (begin == end) {
+      continue;
+    }
+    const auto &stripe = *stripes_[s];
+    std::shared_lock<std::shared_mutex> lock(stripe.mutex_);
+    const size_t group_mask = stripe.capacity_ / kGroupSize - 1;
+    for (size_t j = begin; j < end; ++j) {
+      // Fetch the control bytes of the far keys, and the key and value of the first matched slot of the near keys,
+      // so the cache misses of the batch overlap with the probing.
+      if (stripe.capacity_ > 0 && j + kPrefetchDistance * 2 < end) {
+        auto hash = hashes[key_indices[j + kPrefetchDistance * 2]];
+        Prefetch(stripe.ctrls_.data() + GroupIndex(hash, group_mask) * kGroupSize);
+      }
+      if (stripe.capacity_ > 0 && j + kPrefetchDistance < end) {
+        auto hash = hashes[key_indices[j + kPrefetchDistance]];
+        auto group_begin = GroupIndex(hash, group_mask) * kGroupSize;
+        auto mask = MatchGroup(stripe.ctrls_.data() + group_begin, static_cast<int8_t>(hash & kH2Mask));
+        if (mask != 0) {
+          auto candidate = group_begin + LowestBit(mask);
+          Prefetch(&stripe.keys_[candidate]);
+          Prefetch(stripe.values_ + candidate * value_dim_);
+        }
+      }
+      const auto i = key_indices[j];
+      auto slot = FindSlot(stripe, keys[i], hashes[i]);
+      if (slot < 0) {
+        if (!insert_default_value) {
+          MS_LOG(ERROR) << "The key: " << keys[i] << " does not exist in the hash table.";
+        }
+        missing_indices.push_back(i);
+        continue;
+      }
       // Copy the value of the key from the hash table to the outputs.
-      auto value = values_[key];
-      MS_EXCEPTION_IF_NULL(value);
-      auto ret = memcpy_s(outputs + offset, dst_size, value, src_size);
+      auto ret = memcpy_s(outputs + i * value_dim_, value_size_, stripe.values_ + LongToSize(slot) * value_dim_,
+                          value_size_);
       if (ret != EOK) {
         MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
         return false;
       }
-    } else {
-      MS_LOG(ERROR) << "The key: " << key << " does not exist in the hash table.";
     }
   }
+  if (insert_default_value && !missing_indices.empty()) {
+    return InsertDefaultValues(keys, hashes, missing_indices, outputs);
+  }
+  return true;
+}
+
+template <typename Key, typename Value>
+bool CPUHashTable<Key, Value>::InsertDefaultValues(const Key *keys, const std::vector<uint64_t> &hashes,
+                                                   const std::vector<size_t> &missing_indices, Value *outputs) {
+  size_t begin = 0;
+  while (begin < missing_indices.size()) {
+    const auto stripe_index = StripeIndex(hashes[missing_indices[begin]]);
+    auto end = begin + 1;
+    while (end < missing_indices.size() && StripeIndex(hashes[missing_indices[end]]) == stripe_index) {
+      ++end;
+    }
+    auto stripe = stripes_[stripe_index].get();
+    std::unique_lock<std::shared_mutex> lock(stripe->mutex_);
+    for (size_t j = begin; j < end; ++j) {
+      const auto i = missing_indices[j];
+      // The key may have been inserted by the other threads or the same key before in the batch.
+      auto found_slot = FindSlot(*stripe, keys[i], hashes[i]);
+      size_t slot = 0;
+      if (found_slot >= 0) {
+        slot = LongToSize(found_slot);
+      } else {
+        if (!PrepareInsertSlot(stripe, hashes[i], &slot)) {
+          return false;
+        }
+        stripe->keys_[slot] = keys[i];
+        std::fill_n(stripe->values_ + slot * value_dim_, value_dim_, default_value_);
+      }
+      auto ret = memcpy_s(outputs + i * value_dim_, value_size_, stripe->values_ + slot * value_dim_, value_size_);
+      if (ret != EOK) {
+        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+        return false;
+      }
+    }
+    begin = end;
+  }
+  is_dirty_ = true;
   return true;
 }
 
 template <typename Key, typename Value>
 bool CPUHashTable<Key, Value>::Insert(const Key *keys, size_t key_num, const Value *value, void *) {
-  std::unique_lock<std::shared_mutex> lock(mutex_);
-  MS_EXCEPTION_IF_NULL(device_ctx_->device_res_manager_);
+  std::vector<uint64_t> hashes;
+  std::vector<size_t> key_indices;
+  std::vector<size_t> stripe_offsets;
+  BucketKeys(keys, key_num, &hashes, &key_indices, &stripe_offsets);
 
-  for (size_t i = 0; i < key_num; ++i) {
-    const auto &key = keys[i];
-
-    // The the key does not exist, a new value buffer should be allocated firstly.
-    if (values_.find(key) == values_.end()) {
-      auto value_addr = device_ctx_->device_res_manager_->AllocateMemory(value_size_);
-      MS_EXCEPTION_IF_NULL(value_addr);
-      values_[key] = reinterpret_cast<Value *>(value_addr);
-    }
-
-    // Do the insertion copy.
-    size_t offset = i * value_size_;
-    size_t src_size = value_size_;
-    size_t dst_size = value_size_;
-    auto ret = memcpy_s(values_[key], dst_size, value + offset, src_size);
-    if (ret != EOK) {
-      MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
-      return false;
+  for (size_t s = 0; s < kStripeNum; ++s) {
+    const auto begin = stripe_offsets[s];
+    const auto end = stripe_offsets[s + 1];
+    if (begin == end) {
+      continue;
+    }
+    auto stripe = stripes_[s].get();
+    std::unique_lock<std::shared_mutex> lock(stripe->mutex_);
+    for (size_t j = begin; j < end; ++j) {
+      const auto i = key_indices[j];
+      auto found_slot = FindSlot(*stripe, keys[i], hashes[i]);
+      size_t slot = 0;
+      if (found_slot >= 0) {
+        slot = LongToSize(found_slot);
+      } else {
+        // The key does not exist, a new slot should be taken firstly.
+        if (!PrepareInsertSlot(stripe, hashes[i], &slot)) {
+          return false;
+        }
+        stripe->keys_[slot] = keys[i];
+      }
+
+      // Do the insertion copy.
+      auto ret = memcpy_s(stripe->values_ + slot * value_dim_, value_size_, value + i * value_dim_, value_size_);
+      if (ret != EOK) {
+        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+        return false;
+      }
     }
   }
   is_dirty_ = true;
@@ -99,55 +460,62 @@ bool CPUHashTable<Key, Value>::Insert(const Key *keys, size_t key_num, const Val
 
 template <typename Key, typename Value>
 bool CPUHashTable<Key, Value>::Erase(const Key *keys, size_t key_num, void *) {
-  std::unique_lock<std::shared_mutex> lock(mutex_);
-  MS_EXCEPTION_IF_NULL(device_ctx_->device_res_manager_);
+  std::vector<uint64_t> hashes;
+  std::vector<size_t> key_indices;
+  std::vector<size_t> stripe_offsets;
+  BucketKeys(keys, key_num, &hashes, &key_indices, &stripe_offsets);
 
   // Erase all the keys in the hash table.
-  for (size_t i = 0; i < key_num; ++i) {
-    const auto &key = keys[i];
-    if (values_.find(key) != values_.end()) {
-      auto value = values_[keys[i]];
-      values_.erase(keys[i]);
-
-      // Return the memory of value to the pool.
-      MS_EXCEPTION_IF_NULL(value);
-      device_ctx_->device_res_manager_->FreeMemory(value);
-    } else {
-      MS_LOG(ERROR) << "The key: " << key << " does not exist in the hash table.";
+  for (size_t s = 0; s < kStripeNum; ++s) {
+    const auto begin = stripe_offsets[s];
+    const auto end = stripe_offsets[s + 1];
+    if (begin == end) {
+      continue;
+    }
+    auto stripe = stripes_[s].get();
+    std::unique_lock<std::shared_mutex> lock(stripe->mutex_);
+    for (size_t j = begin; j < end; ++j) {
+      const auto i = key_indices[j];
+      auto slot = FindSlot(*stripe, keys[i], hashes[i]);
+      if (slot < 0) {
+        MS_LOG(ERROR) << "The key: " << keys[i] << " does not exist in the hash table.";
+        continue;
+      }
+      // The probing stops at the group having an empty slot, so the slot could be empty again in such a group,
+      // otherwise it is marked deleted to keep the probing of the other keys.
+      auto group_begin = LongToSize(slot) / kGroupSize * kGroupSize;
+      if (MatchGroup(stripe->ctrls_.data() + group_begin, kCtrlEmpty) != 0) {
+        stripe->ctrls_[LongToSize(slot)] = kCtrlEmpty;
+      } else {
+        stripe->ctrls_[LongToSize(slot)] = kCtrlDeleted;
+        ++stripe->deleted_num_;
+      }
+      --stripe->size_;
     }
   }
+  is_dirty_ = true;
   return true;
 }
 
 template <typename Key, typename Value>
 bool CPUHashTable<Key, Value>::Reserve(size_t new_capacity, void *) {
-  std::unique_lock<std::shared_mutex> lock(mutex_);
-  values_.reserve(new_capacity);
+  // Assume the keys are spread evenly to the stripes.
+  auto stripe_capacity = CapacityForSize((new_capacity + kStripeNum - 1) / kStripeNum);
+  for (auto &stripe : stripes_) {
+    std::unique_lock<std::shared_mutex> lock(stripe->mutex_);
+    if (stripe->capacity_ < stripe_capacity && !Rehash(stripe.get(), stripe_capacity)) {
+      return false;
+    }
+  }
   return true;
 }
 
 template <typename Key, typename Value>
 bool CPUHashTable<Key, Value>::GetKeysAndValues(Key *keys, Value *values, void *) {
-  std::unique_lock<std::shared_mutex> lock(mutex_);
-  size_t index = 0;
-  for (auto iter = values_.begin(); iter != values_.end(); iter++) {
-    auto key = iter->first;
-    auto value = iter->second;
-    // Copy the key.
-    keys[index] = key;
-
-    // Copy the value.
-    size_t offset = index * value_size_;
-    size_t src_size = value_size_;
-    size_t dst_size = value_size_;
-    auto ret = memcpy_s(values + offset, dst_size, value, src_size);
-    if (ret != EOK) {
-      MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
-      return false;
-    }
-    ++index;
-  }
-  return true;
+  MS_EXCEPTION_IF_NULL(keys);
+  MS_EXCEPTION_IF_NULL(values);
+  auto locks = LockStripes();
+  return CopyElements(keys, values);
 }
 
 template <typename Key, typename Value>
@@ -157,41 +525,40 @@ bool CPUHashTable<Key, Value>::Import(const DataLenPair &input_data) {
 
 template <typename Key, typename Value>
 HashTableExportData CPUHashTable<Key, Value>::Export(bool) {
-  const size_t size = values_.size();
+  auto locks = LockStripes();
+  size_t size = 0;
+  for (const auto &stripe : stripes_) {
+    size += stripe->size_;
+  }
   auto host_keys = std::make_shared<std::vector<char>>(size * sizeof(Key));
   auto host_values = std::make_shared<std::vector<char>>(size * value_size_);
-  auto value_data = host_values->data();
   auto host_statuses = std::make_shared<std::vector<char>>(size * sizeof(HashTableElementStatus));
 
-  size_t index = 0;
-  for (auto iter = values_.begin(); iter != values_.end(); iter++) {
-    auto key = iter->first;
-    auto value = iter->second;
-    // Export the key and value.
-    (*host_keys)[index] = key;
-
-    size_t offset = index * value_size_;
-    size_t src_size = value_size_;
-    size_t dst_size = value_size_;
-    auto ret = memcpy_s(value_data + offset, dst_size, value, src_size);
-    if (ret != EOK) {
-      MS_LOG(EXCEPTION) << "memcpy_s error, errorno(" << ret << ")";
-    }
-    ++index;
+  // Export the keys and values.
+  if (!CopyElements(reinterpret_cast<Key *>(host_keys->data()), reinterpret_cast<Value *>(host_values->data()))) {
+    MS_LOG(EXCEPTION) << "Export the keys and values of the hash table failed.";
   }
   return {host_keys, host_values, host_statuses};
 }
 
 template <typename Key, typename Value>
 size_t CPUHashTable<Key, Value>::capacity() const {
-  std::unique_lock<std::shared_mutex> lock(mutex_);
-  return values_.capacity();
+  size_t capacity = 0;
+  for (const auto &stripe : stripes_) {
+    std::shared_lock<std::shared_mutex> lock(stripe->mutex_);
+    capacity += stripe->capacity_ * kMaxLoadNumerator / kMaxLoadDenominator;
+  }
+  return capacity;
 }
 
 template <typename Key, typename Value>
 size_t CPUHashTable<Key, Value>::size() const {
-  std::unique_lock<std::shared_mutex> lock(mutex_);
-  return values_.size();
+  size_t size = 0;
+  for (const auto &stripe : stripes_) {
+    std::shared_lock<std::shared_mutex> lock(stripe->mutex_);
+    size += stripe->size_;
+  }
+  return size;
 }
 
 template <typename Key, typename Value>
@@ -201,19 +568,17 @@ bool CPUHashTable<Key, Value>::is_dirty() const {
 
 template <typename Key, typename Value>
 bool CPUHashTable<Key, Value>::Clear() {
-  std::unique_lock<std::shared_mutex> lock(mutex_);
-  MS_EXCEPTION_IF_NULL(device_ctx_->device_res_manager_);
   // Return all the memory of values in hash table to the memory pool.
-  for (auto iter = values_.begin(); iter != values_.end(); iter++) {
-    auto key = iter->first;
-    auto value = iter->second;
-    if (value != nullptr) {
-      device_ctx_->device_res_manager_->FreeMemory(value);
-    }
-    values_.erase(key);
+  for (auto &stripe : stripes_) {
+    std::unique_lock<std::shared_mutex> lock(stripe->mutex_);
+    ReleaseStripe(stripe.get());
   }
+  is_dirty_ = true;
   return true;
 }
+
+template class CPUHashTable<int32_t, float>;
+template class CPUHashTable<int64_t, float>;
 }  // namespace cpu
 }  // namespace device
 }  // namespace mindspore
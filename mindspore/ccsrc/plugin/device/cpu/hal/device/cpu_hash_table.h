@@ -16,10 +16,13 @@
 #ifndef MINDSPORE_CCSRC_PLUGIN_DEVICE_CPU_HAL_DEVICE_CPU_HASH_TABLE_H_
 #define MINDSPORE_CCSRC_PLUGIN_DEVICE_CPU_HAL_DEVICE_CPU_HASH_TABLE_H_
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <shared_mutex>
-#include <unordered_map>
+#include <vector>
 
-#include "runtime/hardware/device_context.h"
 #include "runtime/device/hash_table.h"
 
 namespace mindspore {
@@ -28,19 +31,28 @@ namespace cpu {
 using mindspore::HashTableExportData;
 
 // A hash table base on the host side cpu.
+// The elements are spread to the stripes by the high bits of the key hash, and each stripe is an open addressing table
+// guarded by its own shared mutex, so the lookups run concurrently and the insertions only block the stripes they
+// touch. In a stripe, the keys and the control bytes are stored in the contiguous arrays and the values are stored
+// inline in a slab allocated from the cpu memory pool. The control byte of a slot records the low 7 bits of the key
+// hash, or marks the slot empty or deleted, and the slots are probed by the groups of 16 control bytes which are
+// compared with the SIMD instructions. The batch of keys is bucketed by stripe first, so that each stripe is locked
+// once per batch, and a stripe is rehashed alone when it is full, so a resize only stalls the keys of one stripe.
 template <typename Key, typename Value>
 class CPUHashTable : public HashTable<Key, Value> {
  public:
-  explicit CPUHashTable(size_t value_dim) : value_dim_(value_dim), value_size_(0) {}
-  ~CPUHashTable() override = default;
+  // The `default_value` is used to initialize the values of keys inserted by `Find`.
+  explicit CPUHashTable(size_t value_dim, const Value &default_value = Value(0));
+  ~CPUHashTable() override;
 
-  // Initialize the resources (e.g. device context) needed by this hash table.
+  // Initialize the resources needed by this hash table.
   bool Initialize();
 
   // Release all the resources (e.g. the host side memory) used by this hash table.
   bool Finalize();
 
   // The last parameter `stream` is meaningless for the cpu hash table version.
+  // The keys which do not exist are inserted with the default value if `insert_default_value` is true.
   bool Find(const Key *keys, size_t key_num, bool insert_default_value, Value *outputs, void *) override;
 
   bool Insert(const Key *keys, size_t key_num, const Value *value, void *) override;
@@ -64,23 +76,58 @@ class CPUHashTable : public HashTable<Key, Value> {
   bool Clear() override;
 
  private:
-  // The key-value style elements stored in this hash table.
-  std::unordered_map<Key, Value *> values_;
-
-  // This mutex is to guarantee the thread-safe of the `values_` above.
-  // The perforcemence of this thread-safe mechanism is poor, so a more efficient way could be used later.
-  mutable std::shared_mutex mutex_;
+  // An open addressing table holding the elements whose hashes fall into it.
+  struct Stripe {
+    // This mutex is to guarantee the thread-safe of the elements of this stripe.
+    mutable std::shared_mutex mutex_;
+    // The slot number, which is zero or a power of two not less than the group size.
+    size_t capacity_{0};
+    size_t size_{0};
+    // The number of deleted slots, which are reused by insertion and dropped by rehash.
+    size_t deleted_num_{0};
+    std::vector<int8_t> ctrls_;
+    std::vector<Key> keys_;
+    // The values of all the slots, `value_dim_` elements for each slot.
+    Value *values_{nullptr};
+  };
+
+  // Bucket the keys by stripe, `key_indices` records the indices of keys of stripe i in the range
+  // [stripe_offsets[i], stripe_offsets[i + 1]), and the keys of a stripe keep their order in the batch.
+  void BucketKeys(const Key *keys, size_t key_num, std::vector<uint64_t> *hashes, std::vector<size_t> *key_indices,
+                  std::vector<size_t> *stripe_offsets) const;
+
+  // Return the slot of the key in the stripe, or -1 if the key does not exist.
+  int64_t FindSlot(const Stripe &stripe, const Key &key, uint64_t hash) const;
+
+  // Return the slot for the new key, the stripe is grown or rehashed if it is full.
+  bool PrepareInsertSlot(Stripe *stripe, uint64_t hash, size_t *slot);
+
+  // Insert the keys of `missing_indices` with the default value, and copy the values to the outputs. The indices should
+  // be bucketed by stripe.
+  bool InsertDefaultValues(const Key *keys, const std::vector<uint64_t> &hashes,
+                           const std::vector<size_t> &missing_indices, Value *outputs);
+
+  // Rehash all the elements of the stripe to the new slots.
+  bool Rehash(Stripe *stripe, size_t new_capacity);
+
+  void ReleaseStripe(Stripe *stripe);
+
+  // Lock all the stripes in order for the operations on the whole table.
+  std::vector<std::shared_lock<std::shared_mutex>> LockStripes() const;
+
+  // Copy all the elements out in the order of stripes and slots, all the stripes should be locked.
+  bool CopyElements(Key *keys, Value *values) const;
+
+  std::vector<std::unique_ptr<Stripe>> stripes_;
 
   // The value dimension and byte size for each key.
   size_t value_dim_;
   size_t value_size_;
+  Value default_value_;
 
   // The flag records whether the elements of the hash table have changed since the last export, true means that there
   // has been a change.
-  bool is_dirty_{true};
-
-  // The device context is used to allocate host side memory from the pool for values in the hash table.
-  DeviceContext *device_ctx_{nullptr};
+  std::atomic<bool> is_dirty_{true};
 };
 }  // namespace cpu
 }  // namespace device
@@ -19,6 +19,7 @@
 #include <string>
 #include "plugin/device/cpu/hal/device/cpu_device_address.h"
 #include "plugin/device/cpu/hal/device/cpu_memory_manager.h"
+#include "plugin/device/cpu/hal/hardware/cpu_memory_pool.h"
 #include "plugin/device/cpu/optimizer/reg_cpu_const_input_to_attr.h"
 #include "plugin/device/cpu/optimizer/print_value_type.h"
 #include "plugin/device/cpu/hal/hardware/cpu_somas.h"
@@ -115,6 +116,11 @@ void CPUDeviceResManager::FreeMemory(void *ptr) const {
   mem_manager_->FreeMemFromMemPool(ptr);
 }
 
+std::map<void *, void *> CPUDeviceResManager::CompactMemory(double fragmentation_threshold,
+                                                           const std::function<bool(void *)> &is_movable) const {
+  return CPUMemoryPool::GetInstance().CompactMemBufs(fragmentation_threshold, is_movable);
+}
+
 std::vector<void *> CPUDeviceResManager::AllocateContinuousMemory(const std::vector<size_t> &size_list) const {
   MS_EXCEPTION_IF_NULL(mem_manager_);
   return mem_manager_->MallocContinuousMemFromMemPool(size_list);
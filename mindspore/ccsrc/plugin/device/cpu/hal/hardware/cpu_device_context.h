@@ -20,6 +20,8 @@
 #include <memory>
 #include <string>
 #include <mutex>
+#include <map>
+#include <functional>
 #include "runtime/hardware/device_context.h"
 #include "runtime/hardware/device_context_manager.h"
 #include "runtime/device/memory_manager.h"
@@ -48,6 +50,9 @@ class CPUDeviceResManager : public DeviceResManager {
   void *AllocateMemory(size_t size) const override;
   void FreeMemory(void *ptr) const override;
 
+  std::map<void *, void *> CompactMemory(double fragmentation_threshold,
+                                         const std::function<bool(void *)> &is_movable) const override;
+
  private:
   std::shared_ptr<MemoryManager> mem_manager_;
 };
@@ -90,6 +90,10 @@ bool CPUMemoryPool::FreeDeviceMem(const DeviceMemPtr &addr) {
 }
 
 size_t CPUMemoryPool::free_mem_size() { return GetSystemMemorySize("MemAvailable"); }
+
+bool CPUMemoryPool::CopyDeviceMem(const DeviceMemPtr &dst, const DeviceMemPtr &src, size_t size) {
+  return memcpy_s(dst, size, src, size) == EOK;
+}
 }  // namespace cpu
 }  // namespace device
 }  // namespace mindspore
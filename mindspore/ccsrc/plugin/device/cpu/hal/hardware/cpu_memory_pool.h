@@ -36,6 +36,7 @@ class BACKEND_EXPORT CPUMemoryPool : public DynamicMemPoolBestFit {
   size_t AllocDeviceMem(size_t size, DeviceMemPtr *addr) override;
   bool FreeDeviceMem(const DeviceMemPtr &addr) override;
   size_t free_mem_size() override;
+  bool CopyDeviceMem(const DeviceMemPtr &dst, const DeviceMemPtr &src, size_t size) override;
 
  private:
   CPUMemoryPool() = default;
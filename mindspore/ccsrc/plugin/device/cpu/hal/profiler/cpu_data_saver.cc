@@ -58,6 +58,7 @@ void CpuDataSaver::WriteFile(const std::string out_path_dir) {
   WriteOpDetail(out_path_dir);
   WriteOpType(out_path_dir);
   WriteOpTimestamp(out_path_dir);
+  WriteRuntimeStatistics(out_path_dir);
 }
 OpTimestampInfo &CpuDataSaver::GetOpTimeStampInfo() { return op_timestamps_map_; }
 
@@ -0,0 +1,63 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "plugin/device/cpu/kernel/dataset_init_cpu_kernel.h"
+#include <numeric>
+#include "include/backend/data_queue/data_queue_mgr.h"
+#include "include/common/utils/anfalgo.h"
+#include "kernel/common_utils.h"
+#include "utils/shape_utils.h"
+
+namespace mindspore {
+namespace kernel {
+using mindspore::device::DataQueueMgr;
+
+void DatasetInitCpuKernelMod::InitKernel(const CNodePtr &kernel_node) {
+  MS_EXCEPTION_IF_NULL(kernel_node);
+  kernel_name_ = common::AnfAlgo::GetCNodeName(kernel_node);
+  queue_name_ = common::AnfAlgo::GetNodeAttr<std::string>(kernel_node, "queue_name");
+  auto shapes = common::AnfAlgo::GetNodeAttr<std::vector<std::vector<int64_t>>>(kernel_node, "shapes");
+  auto types = common::AnfAlgo::GetNodeAttr<std::vector<TypePtr>>(kernel_node, "types");
+  if (shapes.size() != types.size()) {
+    MS_LOG(EXCEPTION) << "For '" << kernel_name_ << "', the size of shapes " << shapes.size()
+                      << " is not equal to the size of types " << types.size();
+  }
+
+  shapes_.clear();
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    MS_EXCEPTION_IF_NULL(types[i]);
+    if (IsDynamic(shapes[i])) {
+      MS_LOG(EXCEPTION) << "For '" << kernel_name_ << "', the dataset sink mode of CPU doesn't support the dynamic shape"
+                        << " data: " << shapes[i];
+    }
+    size_t bytes = std::accumulate(shapes[i].begin(), shapes[i].end(), UnitSizeInBytes(types[i]->type_id()),
+                                   [](size_t size, int64_t dim) { return size * LongToSize(dim); });
+    shapes_.push_back(bytes);
+  }
+}
+
+bool DatasetInitCpuKernelMod::Launch(const std::vector<AddressPtr> &, const std::vector<AddressPtr> &,
+                                     const std::vector<AddressPtr> &) {
+  auto status = DataQueueMgr::GetInstance().Create(queue_name_, shapes_, buffer_q_capacity_);
+  if (status != device::DataQueueStatus::SUCCESS) {
+    MS_LOG(EXCEPTION) << "For '" << kernel_name_ << "', init Dataset Failed, status:" << status;
+  }
+  return true;
+}
+
+MS_KERNEL_FACTORY_REG(NativeCpuKernelMod, InitDataSetQueue, DatasetInitCpuKernelMod);
+}  // namespace kernel
+}  // namespace mindspore
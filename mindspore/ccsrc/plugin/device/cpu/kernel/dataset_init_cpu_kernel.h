@@ -0,0 +1,52 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_PLUGIN_DEVICE_CPU_KERNEL_DATASET_INIT_CPU_KERNEL_H_
+#define MINDSPORE_CCSRC_PLUGIN_DEVICE_CPU_KERNEL_DATASET_INIT_CPU_KERNEL_H_
+
+#include <vector>
+#include <string>
+#include "plugin/device/cpu/kernel/cpu_kernel.h"
+#include "plugin/factory/ms_factory.h"
+
+namespace mindspore {
+namespace kernel {
+// Create the CPU data queue of dataset sink mode, which is fed by the dataset and consumed by the GetNext kernel.
+class DatasetInitCpuKernelMod : public DeprecatedNativeCpuKernelMod {
+ public:
+  DatasetInitCpuKernelMod() = default;
+  ~DatasetInitCpuKernelMod() override = default;
+
+  bool Launch(const std::vector<AddressPtr> &inputs, const std::vector<AddressPtr> &workspace,
+              const std::vector<AddressPtr> &outputs) override;
+  void InitKernel(const CNodePtr &kernel_node) override;
+
+  std::vector<KernelAttr> GetOpSupport() override {
+    static const std::vector<KernelAttr> support_list = {KernelAttr().AddSkipCheckAttr(true)};
+    return support_list;
+  }
+
+ private:
+  std::string queue_name_;
+  std::vector<size_t> shapes_;
+
+  // The capacity of data queue.
+  size_t buffer_q_capacity_{2};
+};
+}  // namespace kernel
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CCSRC_PLUGIN_DEVICE_CPU_KERNEL_DATASET_INIT_CPU_KERNEL_H_
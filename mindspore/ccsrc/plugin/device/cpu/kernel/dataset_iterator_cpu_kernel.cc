@@ -0,0 +1,101 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "plugin/device/cpu/kernel/dataset_iterator_cpu_kernel.h"
+#include "include/backend/data_queue/data_queue_mgr.h"
+#include "include/common/utils/anfalgo.h"
+#ifdef ENABLE_DUMP_IR
+#include "include/common/debug/rdr/recorder_manager.h"
+#endif
+
+namespace mindspore {
+namespace kernel {
+using mindspore::device::DataQueueMgr;
+namespace {
+// The max retry times of getting data from the data queue.
+constexpr int kMaxReadRetryTimes = 10;
+}  // namespace
+
+DatasetIteratorCpuKernelMod::~DatasetIteratorCpuKernelMod() { DataQueueMgr::GetInstance().Close(queue_name_); }
+
+void DatasetIteratorCpuKernelMod::InitKernel(const CNodePtr &kernel_node) {
+  MS_EXCEPTION_IF_NULL(kernel_node);
+  kernel_name_ = common::AnfAlgo::GetCNodeName(kernel_node);
+  queue_name_ = common::AnfAlgo::GetNodeAttr<std::string>(kernel_node, "shared_name");
+  if (common::AnfAlgo::IsDynamicShape(kernel_node)) {
+    MS_LOG(EXCEPTION) << "For '" << kernel_name_ << "', the dataset sink mode of CPU doesn't support the dynamic shape.";
+  }
+}
+
+bool DatasetIteratorCpuKernelMod::ReadDevice(std::vector<DataQueueItem> *data) {
+  int repeat = 0;
+  while (true) {
+    auto ret = DataQueueMgr::GetInstance().Front(queue_name_, data);
+    if (ret == device::DataQueueStatus::SUCCESS) {
+      break;
+    }
+    if (ret == device::DataQueueStatus::TIMEOUT) {
+      repeat++;
+      if (repeat < kMaxReadRetryTimes) {
+        MS_LOG(INFO) << "Waiting for data...(" << repeat << " / " << kMaxReadRetryTimes << ")";
+        continue;
+      } else {
+#ifdef ENABLE_DUMP_IR
+        mindspore::RDR::TriggerAll();
+#endif
+        MS_LOG(EXCEPTION) << "For '" << kernel_name_ << "', get data timeout. Queue name: " << queue_name_;
+      }
+    }
+    MS_LOG(ERROR) << "For '" << kernel_name_ << "', get data failed, errcode " << ret
+                  << ", queue name: " << queue_name_;
+    return false;
+  }
+  return true;
+}
+
+bool DatasetIteratorCpuKernelMod::Launch(const std::vector<AddressPtr> &, const std::vector<AddressPtr> &,
+                                         const std::vector<AddressPtr> &outputs) {
+  if (!is_opened_) {
+    auto ret = DataQueueMgr::GetInstance().Open(queue_name_);
+    if (ret != device::DataQueueStatus::SUCCESS) {
+      MS_LOG(EXCEPTION) << "For '" << kernel_name_ << "', cpu Queue(" << queue_name_ << ") Open Failed: " << ret;
+    }
+    is_opened_ = true;
+  }
+
+  if (!ReadDevice(&output_data_)) {
+    return false;
+  }
+  if (output_data_.size() != outputs.size()) {
+    MS_LOG(EXCEPTION) << "For '" << kernel_name_ << "', the data num " << output_data_.size()
+                      << " is not equal to the output num " << outputs.size() << ", queue name: " << queue_name_;
+  }
+
+  for (size_t i = 0; i < output_data_.size(); i++) {
+    MS_EXCEPTION_IF_NULL(outputs[i]);
+    auto ret = memcpy_s(outputs[i]->addr, outputs[i]->size, output_data_[i].device_addr, output_data_[i].data_len);
+    if (ret != EOK) {
+      MS_LOG(EXCEPTION) << "For '" << kernel_name_ << "', memcpy_s failed, ret code: " << ret
+                        << ", output size: " << outputs[i]->size << ", data size: " << output_data_[i].data_len;
+    }
+  }
+  (void)DataQueueMgr::GetInstance().Pop(queue_name_);
+  return true;
+}
+
+MS_KERNEL_FACTORY_REG(NativeCpuKernelMod, GetNext, DatasetIteratorCpuKernelMod);
+}  // namespace kernel
+}  // namespace mindspore
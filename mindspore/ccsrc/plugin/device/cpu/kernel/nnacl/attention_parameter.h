@@ -44,4 +44,16 @@ typedef struct RelativePositionAttentionParameter {
   int bias_tile_;  // tile for bias pack
 } RelativePositionAttentionParameter;
 
+typedef struct KVCacheAttentionParameter {
+  // Primitive parameter
+  OpParameter op_parameter_;
+  int max_seq_len_;  // capacity of the key/value cache, the older tokens are overwritten when it is full
+  // args for compute
+  int batch_;      // batch of query/key/value
+  int head_num_;   // number of heads of query/key/value
+  int head_size_;  // depth of each head
+  int q_seq_;      // number of the new tokens of this step, 1 when decoding
+  int past_len_;   // number of the tokens processed before this step
+} KVCacheAttentionParameter;
+
 #endif  // MINDSPORE_NNACL_ATTENTION_PARAMETER_H_
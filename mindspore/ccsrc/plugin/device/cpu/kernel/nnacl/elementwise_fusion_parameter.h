@@ -0,0 +1,72 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_NNACL_ELEMENTWISE_FUSION_PARAMETER_H_
+#define MINDSPORE_NNACL_ELEMENTWISE_FUSION_PARAMETER_H_
+
+#include "nnacl/op_base.h"
+
+#define ELEMENTWISE_FUSION_MAX_OPS 16
+
+typedef enum EltwiseFusionOpType {
+  // binary ops, the other operand is a scalar, a last-axis vector or a tensor of the same shape
+  EltwiseFusion_Add,
+  EltwiseFusion_Sub,
+  EltwiseFusion_Mul,
+  EltwiseFusion_Div,
+  EltwiseFusion_Maximum,
+  EltwiseFusion_Minimum,
+  // unary ops
+  EltwiseFusion_Relu,
+  EltwiseFusion_Relu6,
+  EltwiseFusion_LeakyRelu,
+  EltwiseFusion_Sigmoid,
+  EltwiseFusion_Tanh,
+  EltwiseFusion_Swish,
+  EltwiseFusion_HSwish,
+  EltwiseFusion_HSigmoid,
+  EltwiseFusion_HardTanh,
+  EltwiseFusion_Abs,
+  EltwiseFusion_Neg,
+  EltwiseFusion_Square,
+  EltwiseFusion_Sqrt,
+  EltwiseFusion_Rsqrt,
+  EltwiseFusion_OpTypeMax
+} EltwiseFusionOpType;
+
+// the layout of the other operand of a binary op
+typedef enum EltwiseFusionOperandType {
+  EltwiseFusionOperand_Scalar,   // one element
+  EltwiseFusionOperand_Channel,  // a vector of the last axis
+  EltwiseFusionOperand_Full,     // a tensor of the same layout as the output
+} EltwiseFusionOperandType;
+
+typedef struct EltwiseFusionOp {
+  int type_;
+  int operand_;    // index of the input tensor of the other operand, -1 for the unary ops
+  bool reversed_;  // the fused value is the second operand of the binary op, e.g. operand - value
+  float alpha_;    // leaky relu
+  float min_val_;  // hard tanh
+  float max_val_;  // hard tanh
+} EltwiseFusionOp;
+
+typedef struct ElementwiseFusionParameter {
+  // Primitive parameter
+  OpParameter op_parameter_;
+  int op_num_;
+  EltwiseFusionOp ops_[ELEMENTWISE_FUSION_MAX_OPS];
+} ElementwiseFusionParameter;
+
+#endif  // MINDSPORE_NNACL_ELEMENTWISE_FUSION_PARAMETER_H_
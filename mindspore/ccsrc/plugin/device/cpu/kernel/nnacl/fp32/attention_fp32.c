@@ -567,3 +567,67 @@ void RelPosAttention(RelativePositionAttentionParameter *param, Matrix *logits_m
               logits2v_trans_mat->row_, wo_mat->col_, wo_mat->col_, OutType_Nhwc);
   }
 }
+
+void KVCacheUpdate(const float *k, const float *v, float *k_cache, float *v_cache,
+                   const KVCacheAttentionParameter *param, int task_id, int thread_num) {
+  int head_size = param->head_size_;
+  int max_seq_len = param->max_seq_len_;
+  int q_seq = param->q_seq_;
+  int total = param->batch_ * param->head_num_;
+  for (int bh = task_id; bh < total; bh += thread_num) {
+    const float *cur_k = k + bh * q_seq * head_size;
+    const float *cur_v = v + bh * q_seq * head_size;
+    float *cur_k_cache = k_cache + bh * max_seq_len * head_size;
+    float *cur_v_cache = v_cache + bh * max_seq_len * head_size;
+    for (int i = 0; i < q_seq; i++) {
+      int slot = (param->past_len_ + i) % max_seq_len;
+      memcpy(cur_k_cache + slot * head_size, cur_k + i * head_size, head_size * sizeof(float));
+      memcpy(cur_v_cache + slot * head_size, cur_v + i * head_size, head_size * sizeof(float));
+    }
+  }
+}
+
+int KVCacheAttention(const float *q, const float *k_cache, const float *v_cache, float *output, float *score_buf,
+                     const KVCacheAttentionParameter *param, int task_id, int thread_num) {
+  int head_size = param->head_size_;
+  int max_seq_len = param->max_seq_len_;
+  int q_seq = param->q_seq_;
+  int past_len = param->past_len_;
+  int total = param->batch_ * param->head_num_;
+  // the tokens before begin are overwritten by the new tokens of this step.
+  int begin = MSMAX(0, past_len + q_seq - max_seq_len);
+  float scale = 1.0f / sqrtf((float)head_size);
+  for (int bh = task_id; bh < total; bh += thread_num) {
+    const float *cur_k_cache = k_cache + bh * max_seq_len * head_size;
+    const float *cur_v_cache = v_cache + bh * max_seq_len * head_size;
+    for (int i = 0; i < q_seq; i++) {
+      const float *cur_q = q + (bh * q_seq + i) * head_size;
+      float *cur_out = output + (bh * q_seq + i) * head_size;
+      int end = past_len + i + 1;
+      int len = end - begin;
+      // logits = q * k^T / sqrt(head_size)
+      for (int pos = begin; pos < end; pos++) {
+        const float *cur_k = cur_k_cache + (pos % max_seq_len) * head_size;
+        float dot = 0.0f;
+        for (int d = 0; d < head_size; d++) {
+          dot += cur_q[d] * cur_k[d];
+        }
+        score_buf[pos - begin] = dot * scale;
+      }
+      int ret = SoftmaxLastAxis(score_buf, score_buf, 1, len);
+      if (ret != NNACL_OK) {
+        return ret;
+      }
+      // output = softmax(logits) * v
+      memset(cur_out, 0, head_size * sizeof(float));
+      for (int pos = begin; pos < end; pos++) {
+        const float *cur_v = cur_v_cache + (pos % max_seq_len) * head_size;
+        float weight = score_buf[pos - begin];
+        for (int d = 0; d < head_size; d++) {
+          cur_out[d] += weight * cur_v[d];
+        }
+      }
+    }
+  }
+  return NNACL_OK;
+}
@@ -66,6 +66,16 @@ void CalculateLogits(RelativePositionAttentionParameter *param, Matrix *q2wq_wit
 void RelPosAttention(RelativePositionAttentionParameter *param, Matrix *logits_mat, Matrix *softmax_mat,
                      Matrix *v2wv_trans_mat, Matrix *logits2v_mat, Matrix *logits2v_trans_mat, const Matrix *wo_mat,
                      Matrix *bo_mat, Matrix *output_mat);
+
+// k/v: [batch, head_num, q_seq, head_size], k_cache/v_cache: [batch, head_num, max_seq_len, head_size]
+// The token of position pos is stored in the slot pos % max_seq_len of the cache.
+void KVCacheUpdate(const float *k, const float *v, float *k_cache, float *v_cache,
+                   const KVCacheAttentionParameter *param, int task_id, int thread_num);
+
+// q/output: [batch, head_num, q_seq, head_size], score_buf: [max_seq_len] of each task.
+// The query i attends the cached tokens whose position is in [past_len + q_seq - max_seq_len, past_len + i].
+int KVCacheAttention(const float *q, const float *k_cache, const float *v_cache, float *output, float *score_buf,
+                     const KVCacheAttentionParameter *param, int task_id, int thread_num);
 #ifdef __cplusplus
 }
 #endif
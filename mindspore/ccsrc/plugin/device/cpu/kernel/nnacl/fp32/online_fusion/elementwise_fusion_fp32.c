@@ -0,0 +1,147 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "nnacl/fp32/online_fusion/elementwise_fusion_fp32.h"
+#include "nnacl/errorcode.h"
+#include "nnacl/fp32/activation_fp32.h"
+#include "nnacl/fp32/arithmetic_self_fp32.h"
+#include "nnacl/fp32/arithmetic_fp32.h"
+
+static int EltwiseFusionBinary(int type, const float *in0, const float *in1, float *out, int size,
+                               const ArithmeticParameter *opt_param) {
+  if (opt_param == NULL) {
+    switch (type) {
+      case EltwiseFusion_Add:
+        return ElementAdd(in0, in1, out, size);
+      case EltwiseFusion_Sub:
+        return ElementSub(in0, in1, out, size);
+      case EltwiseFusion_Mul:
+        return ElementMul(in0, in1, out, size);
+      case EltwiseFusion_Div:
+        return ElementDiv(in0, in1, out, size);
+      case EltwiseFusion_Maximum:
+        return ElementMaximum(in0, in1, out, size);
+      case EltwiseFusion_Minimum:
+        return ElementMinimum(in0, in1, out, size);
+      default:
+        return NNACL_ERR;
+    }
+  }
+  switch (type) {
+    case EltwiseFusion_Add:
+      return ElementOptAdd(in0, in1, out, size, opt_param);
+    case EltwiseFusion_Sub:
+      return ElementOptSub(in0, in1, out, size, opt_param);
+    case EltwiseFusion_Mul:
+      return ElementOptMul(in0, in1, out, size, opt_param);
+    case EltwiseFusion_Div:
+      return ElementOptDiv(in0, in1, out, size, opt_param);
+    case EltwiseFusion_Maximum:
+      return ElementOptMaximum(in0, in1, out, size, opt_param);
+    case EltwiseFusion_Minimum:
+      return ElementOptMinimum(in0, in1, out, size, opt_param);
+    default:
+      return NNACL_ERR;
+  }
+}
+
+static int EltwiseFusionUnary(const EltwiseFusionOp *op, const float *in, float *out, int size) {
+  switch (op->type_) {
+    case EltwiseFusion_Relu:
+      return Fp32Relu(in, size, out);
+    case EltwiseFusion_Relu6:
+      return Fp32Relu6(in, size, out);
+    case EltwiseFusion_LeakyRelu:
+      return LRelu(in, size, out, op->alpha_);
+    case EltwiseFusion_Sigmoid:
+      return Sigmoid(in, size, out);
+    case EltwiseFusion_Tanh:
+      return Tanh(in, size, out);
+    case EltwiseFusion_Swish:
+      return Swish(in, size, out);
+    case EltwiseFusion_HSwish:
+      return HSwish(in, size, out);
+    case EltwiseFusion_HSigmoid:
+      return HSigmoid(in, size, out);
+    case EltwiseFusion_HardTanh:
+      return HardTanh(in, size, out, op->min_val_, op->max_val_);
+    case EltwiseFusion_Abs:
+      return ElementAbs(in, out, size);
+    case EltwiseFusion_Neg:
+      return ElementNegative(in, out, size);
+    case EltwiseFusion_Square:
+      return ElementSquare(in, out, size);
+    case EltwiseFusion_Sqrt:
+      return ElementSqrt(in, out, size);
+    case EltwiseFusion_Rsqrt:
+      return ElementRsqrt(in, out, size);
+    default:
+      return NNACL_ERR;
+  }
+}
+
+static int EltwiseFusionRunOp(const EltwiseFusionOp *op, const float *in, float *out, const float *operand,
+                              int operand_type, int64_t channel, int64_t offset, int size) {
+  if (op->operand_ < 0) {
+    return EltwiseFusionUnary(op, in, out, size);
+  }
+  if (operand_type == EltwiseFusionOperand_Scalar) {
+    ArithmeticParameter opt_param;
+    opt_param.in_elements_num0_ = op->reversed_ ? 1 : size;
+    opt_param.in_elements_num1_ = op->reversed_ ? size : 1;
+    return op->reversed_ ? EltwiseFusionBinary(op->type_, operand, in, out, size, &opt_param)
+                         : EltwiseFusionBinary(op->type_, in, operand, out, size, &opt_param);
+  }
+  if (operand_type == EltwiseFusionOperand_Channel) {
+    for (int i = 0; i < size; i += (int)channel) {
+      int ret = op->reversed_ ? EltwiseFusionBinary(op->type_, operand, in + i, out + i, (int)channel, NULL)
+                              : EltwiseFusionBinary(op->type_, in + i, operand, out + i, (int)channel, NULL);
+      if (ret != NNACL_OK) {
+        return ret;
+      }
+    }
+    return NNACL_OK;
+  }
+  return op->reversed_ ? EltwiseFusionBinary(op->type_, operand + offset, in, out, size, NULL)
+                       : EltwiseFusionBinary(op->type_, in, operand + offset, out, size, NULL);
+}
+
+int Fp32ElementwiseFusion(const float *src, float *dst, const float *const *operands, const int *operand_types,
+                          const ElementwiseFusionParameter *param, int64_t channel, int64_t block, int64_t start,
+                          int64_t end) {
+  NNACL_CHECK_NULL_RETURN_ERR(src);
+  NNACL_CHECK_NULL_RETURN_ERR(dst);
+  NNACL_CHECK_NULL_RETURN_ERR(param);
+  if (param->op_num_ <= 0 || block <= 0 || channel <= 0) {
+    return NNACL_ERR;
+  }
+  for (int64_t offset = start; offset < end; offset += block) {
+    int size = (int)MSMIN(block, end - offset);
+    const float *in = src + offset;
+    float *out = dst + offset;
+    for (int i = 0; i < param->op_num_; i++) {
+      const EltwiseFusionOp *op = &param->ops_[i];
+      const float *operand = op->operand_ < 0 ? NULL : operands[op->operand_];
+      int operand_type = op->operand_ < 0 ? EltwiseFusionOperand_Full : operand_types[op->operand_];
+      int ret = EltwiseFusionRunOp(op, in, out, operand, operand_type, channel, offset, size);
+      if (ret != NNACL_OK) {
+        return ret;
+      }
+      // the later ops work in place on the block of output
+      in = out;
+    }
+  }
+  return NNACL_OK;
+}
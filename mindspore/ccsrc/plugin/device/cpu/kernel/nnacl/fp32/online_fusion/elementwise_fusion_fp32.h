@@ -0,0 +1,37 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_NNACL_FP32_ONLINE_FUSION_ELEMENTWISE_FUSION_FP32_H_
+#define MINDSPORE_NNACL_FP32_ONLINE_FUSION_ELEMENTWISE_FUSION_FP32_H_
+
+#include "nnacl/op_base.h"
+#include "nnacl/elementwise_fusion_parameter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Run the fused ops on the elements [start, end) block by block, so that a block stays in the cache from the first op
+// to the last one. operand_types holds the EltwiseFusionOperandType of each operand. start and block are multiples of
+// channel when a last-axis vector is used.
+int Fp32ElementwiseFusion(const float *src, float *dst, const float *const *operands, const int *operand_types,
+                          const ElementwiseFusionParameter *param, int64_t channel, int64_t block, int64_t start,
+                          int64_t end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MINDSPORE_NNACL_FP32_ONLINE_FUSION_ELEMENTWISE_FUSION_FP32_H_
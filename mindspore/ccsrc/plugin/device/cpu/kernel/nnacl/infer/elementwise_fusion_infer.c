@@ -0,0 +1,61 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nnacl/infer/elementwise_fusion_infer.h"
+#include "nnacl/infer/infer_register.h"
+#include "nnacl/infer/broadcast_to_infer.h"
+
+// inputs: 0:the input of the fused ops, 1~n:the other operands of the binary ops
+// output: the broadcast shape of all the inputs, as the unfused binary ops infer one after another
+int ElementwiseFusionInferShape(const TensorC *const *inputs, size_t inputs_size, TensorC **outputs,
+                                size_t outputs_size, OpParameter *parameter) {
+  int check_ret = CheckAugmentWithMinSize(inputs, inputs_size, outputs, outputs_size, parameter, 1, 1);
+  if (check_ret != NNACL_OK) {
+    return check_ret;
+  }
+  SetDataTypeFormat(outputs[0], inputs[0]);
+  if (!InferFlag(inputs, inputs_size)) {
+    return NNACL_INFER_INVALID;
+  }
+  int out_shape[MAX_SHAPE_SIZE] = {0};
+  int out_shape_size = (int)inputs[0]->shape_size_;
+  if (out_shape_size > MAX_SHAPE_SIZE) {
+    return NNACL_ERR;
+  }
+  memcpy(out_shape, inputs[0]->shape_, out_shape_size * sizeof(int));
+  for (size_t i = 1; i < inputs_size; i++) {
+    if ((int)inputs[i]->shape_size_ > MAX_SHAPE_SIZE) {
+      return NNACL_ERR;
+    }
+    int in_shape0[MAX_SHAPE_SIZE] = {0};
+    int in_shape1[MAX_SHAPE_SIZE] = {0};
+    int ndim = out_shape_size;
+    MakeUpInputShapes(out_shape_size, (int)inputs[i]->shape_size_, out_shape, inputs[i]->shape_, &ndim, in_shape0,
+                      in_shape1);
+    if (ndim > MAX_SHAPE_SIZE) {
+      return NNACL_ERR;
+    }
+    bool has_broad_cast = false;
+    if (BroadCastOutputShape(in_shape0, in_shape1, ndim, out_shape, &has_broad_cast) != NNACL_OK) {
+      return NNACL_ERR;
+    }
+    out_shape_size = ndim;
+  }
+  SetShapeArray(outputs[0], out_shape, (size_t)out_shape_size);
+  return NNACL_OK;
+}
+
+REG_INFER(ElementwiseFusion, PrimType_Inner_ElementwiseFusion, ElementwiseFusionInferShape)
@@ -0,0 +1,53 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nnacl/infer/kv_cache_attention_infer.h"
+#include "nnacl/infer/infer_register.h"
+#include "nnacl/attention_parameter.h"
+
+// inputs: 0:Q 1:K 2:V [batch, head_num, seq, head_size] 3:position (optional) 4:sequence id (optional)
+// output: [batch, head_num, seq, head_size]
+int KVCacheAttentionInferShape(const TensorC *const *inputs, size_t inputs_size, TensorC **outputs,
+                               size_t outputs_size, OpParameter *parameter) {
+  int check_ret = CheckAugmentWithMinSize(inputs, inputs_size, outputs, outputs_size, parameter, C3NUM, 1);
+  if (check_ret != NNACL_OK) {
+    return check_ret;
+  }
+  const TensorC *q_input = inputs[FIRST_INPUT];
+  TensorC *output = outputs[FIRST_INPUT];
+  SetDataTypeFormat(output, q_input);
+  if (!InferFlag(inputs, inputs_size)) {
+    return NNACL_INFER_INVALID;
+  }
+  KVCacheAttentionParameter *param = (KVCacheAttentionParameter *)parameter;
+  const TensorC *k_input = inputs[SECOND_INPUT];
+  const TensorC *v_input = inputs[THIRD_INPUT];
+  if (q_input->shape_size_ != C4NUM || k_input->shape_size_ != C4NUM || v_input->shape_size_ != C4NUM) {
+    return NNACL_ERR;
+  }
+  for (size_t i = 0; i < C4NUM; i++) {
+    if (k_input->shape_[i] != q_input->shape_[i] || v_input->shape_[i] != q_input->shape_[i]) {
+      return NNACL_ERR;
+    }
+  }
+  if (param->max_seq_len_ <= 0 || q_input->shape_[THIRD_INPUT] > param->max_seq_len_) {
+    return NNACL_ERR;
+  }
+  SetShapeTensor(output, q_input);
+  return NNACL_OK;
+}
+
+REG_INFER(KVCacheAttention, PrimType_Inner_KVCacheAttention, KVCacheAttentionInferShape)
@@ -0,0 +1,91 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nnacl/int8/matmul_avx512_vnni_int8.h"
+#ifdef ENABLE_AVX512
+#include <immintrin.h>
+#include <string.h>
+#include "nnacl/int8/fixed_point.h"
+
+/* vpdpbusd multiplies the unsigned bytes of a by the signed bytes of b, so a is biased by 128 when broadcast and the
+ * 128 * sum(b) of each column is subtracted from the accumulator. */
+static inline __m512i BroadcastBiasedA(const int8_t *a) {
+  int32_t a4;
+  memcpy(&a4, a, sizeof(int32_t));
+  return _mm512_xor_si512(_mm512_set1_epi32(a4), _mm512_set1_epi32((int32_t)0x80808080));
+}
+
+static void StoreInt8Row(const int32_t *acc, int8_t *dst, size_t r, size_t c, size_t cur_col,
+                         const int32_t *input_sum, const int32_t *bias, const int32_t *left_shift,
+                         const int32_t *right_shift, const int32_t *multiplier, int32_t output_zp, int32_t mini,
+                         int32_t maxi, size_t per_channel, const int32_t *filter_zp) {
+  for (size_t j = 0; j < cur_col; j++) {
+    size_t ci = c + j;
+    int32_t value = acc[j];
+    int32_t cur_input_sum = per_channel ? input_sum[r] * filter_zp[ci] : input_sum[r];
+    value -= cur_input_sum;
+    value += bias[ci];
+    int32_t cur_left_shift = per_channel ? left_shift[ci] : left_shift[0];
+    int32_t cur_right_shift = per_channel ? right_shift[ci] : right_shift[0];
+    int32_t cur_multiplier = per_channel ? multiplier[ci] : multiplier[0];
+    value = MultiplyByQuantizedMultiplier(value, cur_multiplier, cur_left_shift, cur_right_shift) + output_zp;
+    value = MSMIN(maxi, value);
+    value = MSMAX(mini, value);
+    dst[j] = (int8_t)value;
+  }
+}
+
+void MatMulInt8Avx512Vnni(const int8_t *a, const int8_t *b, int8_t *dst, size_t row, size_t col, size_t deep_4,
+                          size_t stride, const int32_t *input_sum, const int32_t *bias, const int32_t *left_shift,
+                          const int32_t *right_shift, const int32_t *multiplier, int32_t output_zp, int32_t mini,
+                          int32_t maxi, size_t per_channel, const int32_t *filter_zp) {
+  const __m512i bias_a = _mm512_set1_epi8((char)0x80);
+  int32_t acc_buf[C4NUM][C16NUM];
+  for (size_t c = 0; c < col; c += C16NUM) {
+    size_t cur_col = MSMIN(C16NUM, col - c);
+    /* each 64 bytes of b hold 4 deep values of 16 columns, which is one vpdpbusd operand */
+    const int8_t *cur_b = b + c * deep_4;
+    __m512i comp = _mm512_setzero_si512();
+    for (size_t d = 0; d < deep_4; d += C4NUM) {
+      comp = _mm512_dpbusd_epi32(comp, bias_a, _mm512_loadu_si512(cur_b + d * C16NUM));
+    }
+    for (size_t r = 0; r < row; r += C4NUM) {
+      size_t cur_row = MSMIN(C4NUM, row - r);
+      const int8_t *cur_a = a + r * deep_4;
+      __m512i acc0 = _mm512_setzero_si512();
+      __m512i acc1 = _mm512_setzero_si512();
+      __m512i acc2 = _mm512_setzero_si512();
+      __m512i acc3 = _mm512_setzero_si512();
+      for (size_t d = 0; d < deep_4; d += C4NUM) {
+        __m512i vb = _mm512_loadu_si512(cur_b + d * C16NUM);
+        const int8_t *a4 = cur_a + d * C4NUM;
+        acc0 = _mm512_dpbusd_epi32(acc0, BroadcastBiasedA(a4), vb);
+        acc1 = _mm512_dpbusd_epi32(acc1, BroadcastBiasedA(a4 + C4NUM), vb);
+        acc2 = _mm512_dpbusd_epi32(acc2, BroadcastBiasedA(a4 + C8NUM), vb);
+        acc3 = _mm512_dpbusd_epi32(acc3, BroadcastBiasedA(a4 + C12NUM), vb);
+      }
+      _mm512_storeu_si512(acc_buf[0], _mm512_sub_epi32(acc0, comp));
+      _mm512_storeu_si512(acc_buf[1], _mm512_sub_epi32(acc1, comp));
+      _mm512_storeu_si512(acc_buf[2], _mm512_sub_epi32(acc2, comp));
+      _mm512_storeu_si512(acc_buf[3], _mm512_sub_epi32(acc3, comp));
+      for (size_t i = 0; i < cur_row; i++) {
+        StoreInt8Row(acc_buf[i], dst + (r + i) * stride + c, r + i, c, cur_col, input_sum, bias, left_shift,
+                     right_shift, multiplier, output_zp, mini, maxi, per_channel, filter_zp);
+      }
+    }
+  }
+}
+#endif
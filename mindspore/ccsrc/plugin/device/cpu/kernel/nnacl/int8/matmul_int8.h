@@ -64,6 +64,8 @@ void MatMulInt8_4x2_r(const int8_t *a, const int8_t *b, int8_t *dst, size_t row,
 
 /* 4x4 4x16 -> 4x16 */
 /* optimize conv1x1 */
+void RowMajor2Row4x4MajorInt8(const int8_t *src, int8_t *dst, int row, int col);
+void RowMajor2Col4x4MajorInt8(const int8_t *src, int row, int col, int8_t *dst);
 void RowMajor2Row4x16MajorInt8(const int8_t *src_ptr, int8_t *dst_ptr, int row, int col);
 void PackInput4x4AndInputSumPert(const int8_t *src_input, int8_t *packed_input, int32_t *input_sum,
                                  size_t input_channel, size_t plane_size, int32_t filter_zp);
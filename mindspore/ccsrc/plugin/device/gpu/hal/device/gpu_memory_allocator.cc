@@ -105,6 +105,11 @@ size_t GPUMemoryAllocator::AlignMemorySize(size_t size) const {
   }
   return ((size + MEM_ALIGN_SIZE - 1) / MEM_ALIGN_SIZE) * MEM_ALIGN_SIZE;
 }
+
+bool GPUMemoryAllocator::CopyDeviceMem(const DeviceMemPtr &dst, const DeviceMemPtr &src, size_t size) {
+  // The copy is synchronized, since the later copy of compaction may overwrite the source of this copy.
+  return CudaDriver::CopyDeviceMemToDeviceAsync(dst, src, size) && CudaDriver::SyncStream(nullptr);
+}
 }  // namespace gpu
 }  // namespace device
 }  // namespace mindspore
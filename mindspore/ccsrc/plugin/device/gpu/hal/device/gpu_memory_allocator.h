@@ -35,6 +35,7 @@ class GPUMemoryAllocator : public DynamicMemPoolBestFit {
   bool FreeDeviceMem(const DeviceMemPtr &addr) override;
   size_t free_mem_size() override;
   size_t AlignMemorySize(size_t size) const override;
+  bool CopyDeviceMem(const DeviceMemPtr &dst, const DeviceMemPtr &src, size_t size) override;
 
   static GPUMemoryAllocator &GetInstance() {
     static GPUMemoryAllocator instance;
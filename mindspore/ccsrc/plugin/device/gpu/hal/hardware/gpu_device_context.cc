@@ -233,6 +233,15 @@ void GPUDeviceResManager::FreeMemory(void *ptr) const {
   mem_manager_->FreeMemFromMemPool(ptr);
 }
 
+std::map<void *, void *> GPUDeviceResManager::CompactMemory(double fragmentation_threshold,
+                                                           const std::function<bool(void *)> &is_movable) const {
+  // The memory can't be moved until the kernels using it are finished.
+  if (!BindDeviceToCurrentThread() || !SyncAllStreams()) {
+    return {};
+  }
+  return GPUMemoryAllocator::GetInstance().CompactMemBufs(fragmentation_threshold, is_movable);
+}
+
 bool GPUDeviceResManager::AllocateMemory(DeviceAddress *const &address) const {
   MS_EXCEPTION_IF_NULL(address);
   auto device_name_in_address = GetDeviceNameByType(static_cast<const DeviceType>(address->GetDeviceType()));
@@ -20,6 +20,8 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <map>
+#include <functional>
 #include "runtime/hardware/device_context.h"
 #include "runtime/hardware/device_context_manager.h"
 #include "runtime/device/memory_manager.h"
@@ -49,6 +51,9 @@ class GPUDeviceResManager : public DeviceResManager {
 
   size_t GetAvailableMemSize() const override { return mem_manager_->GetAvailableMemSize(); }
 
+  std::map<void *, void *> CompactMemory(double fragmentation_threshold,
+                                         const std::function<bool(void *)> &is_movable) const override;
+
   DeviceAddressPtr CreateDeviceAddress(void *const device_ptr, size_t device_size, const string &format, TypeId type_id,
                                        const ShapeVector &shape = ShapeVector(),
                                        const UserDataPtr &user_data = nullptr) const override;
@@ -190,6 +190,30 @@ void DataSaver::WriteOpTimestamp(const std::string &saver_base_dir) {
   }
 }
 
+void DataSaver::WriteRuntimeStatistics(const std::string &saver_base_dir) {
+  const auto &runtime_statistics = ProfilerManager::GetInstance()->GetRuntimeStatistics();
+  if (runtime_statistics.empty()) {
+    return;
+  }
+  std::string file_path = saver_base_dir + "/" + op_side_ + "_runtime_statistics_" + device_id_ + ".csv";
+  std::ofstream ofs(file_path);
+  if (!ofs.is_open()) {
+    MS_LOG(WARNING) << "Open file '" << file_path << "' failed!";
+    return;
+  }
+  try {
+    ofs << "name,value" << std::endl;
+    for (const auto &statistics : runtime_statistics) {
+      ofs << statistics.first << "," << statistics.second << std::endl;
+    }
+  } catch (const std::exception &e) {
+    MS_LOG(ERROR) << "Write " << file_path << "failed: " << e.what();
+  }
+  ofs.close();
+  ChangeFileMode(file_path);
+  MS_LOG(INFO) << "Write runtime statistics into file: " << file_path;
+}
+
 void DataSaver::WriteFrameWork(const std::string &base_dir, const std::vector<CurKernelInfo> &all_kernel_info) {
   std::string file_path = base_dir + "/" + op_side_ + "_framework_" + device_id_ + ".txt";
   std::ofstream ofs(file_path);
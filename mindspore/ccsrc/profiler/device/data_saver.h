@@ -138,6 +138,8 @@ class BACKEND_EXPORT DataSaver {
 
   void WriteOpTimestamp(const std::string &saver_base_dir);
 
+  void WriteRuntimeStatistics(const std::string &saver_base_dir);
+
   void ChangeFileMode(const std::string &file_path) const;
 
   OpTypeInfos op_type_infos_;
@@ -208,6 +208,16 @@ void ProfilerManager::RecordOneStepStartEndInfo() const {
   }
 }
 
+void ProfilerManager::RecordRuntimeStatistics(const std::string &name, uint64_t value) {
+  std::lock_guard<std::mutex> locker(runtime_statistics_mutex_);
+  runtime_statistics_[name] = value;
+}
+
+std::map<std::string, uint64_t> ProfilerManager::GetRuntimeStatistics() {
+  std::lock_guard<std::mutex> locker(runtime_statistics_mutex_);
+  return runtime_statistics_;
+}
+
 std::string ProfilerManager::GetProfilingOptions() const {
   if (auto ascend_instance = Profiler::GetInstance(kAscendDevice); ascend_instance != nullptr) {
     return ascend_instance->GetProfilingOptions();
@@ -69,10 +69,15 @@ class BACKEND_EXPORT ProfilerManager {
   std::string GetProfilingOptions() const;
   bool GetNetDynamicShapeStatus() const { return is_dynamic_shape_net_; }
   void SetNetDynamicShapeStatus() { is_dynamic_shape_net_ = true; }
+  // The runtime statistics are saved with the profiling data, such as the hit count of memory plan cache.
+  void RecordRuntimeStatistics(const std::string &name, uint64_t value);
+  std::map<std::string, uint64_t> GetRuntimeStatistics();
 
  private:
   inline static std::shared_ptr<ProfilerManager> profiler_manager_inst_ = std::make_shared<ProfilerManager>();
   bool is_dynamic_shape_net_ = 0;
+  std::map<std::string, uint64_t> runtime_statistics_;
+  std::mutex runtime_statistics_mutex_;
 };
 
 class BACKEND_EXPORT Profiler {
@@ -15,42 +15,184 @@
  */
 
 #include "runtime/device/auto_mem_offload.h"
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <utility>
 #include <vector>
 #include <queue>
+#include <string>
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 #include "runtime/hardware/device_context.h"
 #include "runtime/device/memory_offload_strategy.h"
+#include "utils/convert_utils_base.h"
+#include "utils/file_utils.h"
+#include "utils/ms_utils.h"
 
 namespace mindspore {
 namespace device {
+namespace {
+constexpr char kOffloadDiskPathEnv[] = "MS_DEV_OFFLOAD_DISK_PATH";
+constexpr char kOffloadHostMemLimitEnv[] = "MS_DEV_OFFLOAD_HOST_MEM_LIMIT";
+constexpr float kGBToByte = static_cast<float>(1UL << 30);
+constexpr size_t kFileBackedMemAlignSize = 4096;
+}  // namespace
+
+OffloadedMemPool::OffloadedMemPool() : host_staging_mem_pool_(HostStagingMemPool::GetInstance()) {
+  const auto &disk_path = common::GetEnv(kOffloadDiskPathEnv);
+  if (disk_path.empty()) {
+    return;
+  }
+#if defined(_WIN32) || defined(_WIN64)
+  MS_LOG(WARNING) << "The file backed offload memory is not supported on windows, env " << kOffloadDiskPathEnv
+                  << " is ignored.";
+#else
+  const auto &real_path = FileUtils::CreateNotExistDirs(disk_path, true);
+  if (!real_path.has_value()) {
+    MS_LOG(EXCEPTION) << "Invalid env " << kOffloadDiskPathEnv << ": " << disk_path;
+  }
+  disk_path_ = real_path.value();
+  const auto &mem_limit = common::GetEnv(kOffloadHostMemLimitEnv);
+  if (!mem_limit.empty()) {
+    float mem_limit_gb = 0;
+    try {
+      mem_limit_gb = std::stof(mem_limit);
+    } catch (const std::exception &e) {
+      MS_LOG(EXCEPTION) << "Invalid env " << kOffloadHostMemLimitEnv << ": " << mem_limit;
+    }
+    if (mem_limit_gb < 0) {
+      MS_LOG(EXCEPTION) << "Invalid env " << kOffloadHostMemLimitEnv << ": " << mem_limit;
+    }
+    host_mem_limit_ = FloatToSize(mem_limit_gb * kGBToByte);
+  }
+  MS_LOG(INFO) << "Offload memory beyond " << host_mem_limit_ << " bytes of host memory to directory " << disk_path_;
+#endif
+}
+
+OffloadedMemPool::~OffloadedMemPool() {
+  for (const auto &item : host_mem_block_map_) {
+    host_staging_mem_pool_->Free(item.first);
+  }
+#if !defined(_WIN32) && !defined(_WIN64)
+  for (const auto &item : file_mem_block_map_) {
+    (void)munmap(item.first, item.second.size_);
+  }
+  if (file_fd_ >= 0) {
+    (void)close(file_fd_);
+  }
+#endif
+}
+
 void *OffloadedMemPool::MallocHost(size_t mem_size) {
-  auto &mem_que = cached_host_mem_[mem_size];
-  if (!mem_que.empty()) {
-    auto ret = mem_que.front();
-    mem_que.pop();
+  std::lock_guard<std::mutex> locker(mutex_);
+  if (!disk_path_.empty() && host_mem_size_ + mem_size > host_mem_limit_) {
+    return MallocFileBackedMem(mem_size);
+  }
+  auto ptr = host_staging_mem_pool_->Malloc(mem_size, true);
+  host_mem_block_map_[ptr] = mem_size;
+  host_mem_size_ += mem_size;
+  return ptr;
+}
+
+void *OffloadedMemPool::MallocFileBackedMem(size_t mem_size) {
+#if defined(_WIN32) || defined(_WIN64)
+  MS_LOG(EXCEPTION) << "The file backed offload memory is not supported on windows.";
+#else
+  // Each memory is mapped at the page aligned offset of the file, and the file grows as needed.
+  const size_t map_size = (mem_size + kFileBackedMemAlignSize - 1) / kFileBackedMemAlignSize * kFileBackedMemAlignSize;
+  const size_t numa_node = host_staging_mem_pool_->CurrentNumaNode();
+  auto ret = MallocFromFileMemCache(map_size, numa_node);
+  if (ret != nullptr) {
+    // The freed pages keep the data in the file, zero them as the memory extended from the file.
+    (void)memset(ret, 0, map_size);
     return ret;
   }
-  auto block = std::make_shared<std::vector<uint8_t>>();
-  try {
-    block->resize(mem_size, 0);
-    auto ptr = block->data();
-    host_mem_block_map_[ptr] = block;
-    return ptr;
-  } catch (const std::exception &e) {
-    MS_LOG(EXCEPTION) << "Malloc memory failed: size " << mem_size;
+  if (file_fd_ < 0) {
+    const auto file_path = disk_path_ + "/ms_offload_" + std::to_string(getpid()) + "_" +
+                           std::to_string(reinterpret_cast<uintptr_t>(this)) + ".swap";
+    file_fd_ = open(file_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (file_fd_ < 0) {
+      MS_LOG(EXCEPTION) << "Create the offload file " << file_path << " failed, errno: " << errno;
+    }
+    // The disk space is released by the system once the file is unmapped, even if the process exits abnormally.
+    (void)unlink(file_path.c_str());
+  }
+  const size_t offset = file_size_;
+  if (ftruncate(file_fd_, static_cast<off_t>(offset + map_size)) != 0) {
+    MS_LOG(EXCEPTION) << "Extend the offload file in " << disk_path_ << " to size " << (offset + map_size)
+                      << " failed, errno: " << errno;
+  }
+  auto ptr = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, file_fd_, static_cast<off_t>(offset));
+  if (ptr == MAP_FAILED) {
+    MS_LOG(EXCEPTION) << "Map the offload file in " << disk_path_ << " failed, size: " << map_size
+                      << ", errno: " << errno;
+  }
+  file_size_ += map_size;
+  file_mem_block_map_[ptr] = {map_size, numa_node};
+  MS_LOG(DEBUG) << "Malloc file backed memory " << ptr << ", size: " << mem_size << ", file size: " << file_size_;
+  return ptr;
+#endif
+}
+
+void *OffloadedMemPool::MallocFromFileMemCache(size_t map_size, size_t numa_node) {
+  // Prefer the memory freed on the local numa node, and reuse the others before growing the file.
+  auto iter = cached_file_mem_.find(std::make_pair(numa_node, map_size));
+  if (iter == cached_file_mem_.end() || iter->second.empty()) {
+    iter = std::find_if(cached_file_mem_.begin(), cached_file_mem_.end(), [map_size](const auto &item) {
+      return item.first.second == map_size && !item.second.empty();
+    });
+  }
+  if (iter == cached_file_mem_.end()) {
+    return nullptr;
   }
+  auto ptr = iter->second.front();
+  iter->second.pop();
+  return ptr;
 }
 
 void OffloadedMemPool::FreeHost(void *ptr) {
   MS_EXCEPTION_IF_NULL(ptr);
+  std::lock_guard<std::mutex> locker(mutex_);
   auto iter = host_mem_block_map_.find(ptr);
-  if (iter == host_mem_block_map_.end()) {
-    MS_LOG(DEBUG) << "Free ptr not be created from here, abort";
+  if (iter != host_mem_block_map_.end()) {
+    // The memory in host is recycled by the host staging memory pool, which is shared with the other transfers.
+    host_mem_size_ -= iter->second;
+    host_staging_mem_pool_->Free(ptr);
+    (void)host_mem_block_map_.erase(iter);
     return;
   }
-  MS_EXCEPTION_IF_NULL(iter->second);
-  auto mem_size = iter->second->size();
-  (void)cached_host_mem_[mem_size].emplace(iter->first);
+#if !defined(_WIN32) && !defined(_WIN64)
+  auto file_iter = file_mem_block_map_.find(ptr);
+  if (file_iter != file_mem_block_map_.end()) {
+    // The data of freed memory is useless, release its pages from the address space of process.
+    const auto &block = file_iter->second;
+    (void)madvise(ptr, block.size_, MADV_DONTNEED);
+    (void)cached_file_mem_[std::make_pair(block.numa_node_, block.size_)].emplace(ptr);
+    return;
+  }
+#endif
+  MS_LOG(DEBUG) << "Free ptr not be created from here, abort";
+}
+
+void OffloadedMemPool::Prefetch(const void *ptr) {
+#if !defined(_WIN32) && !defined(_WIN64)
+  if (ptr == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> locker(mutex_);
+  auto iter = file_mem_block_map_.find(const_cast<void *>(ptr));
+  if (iter == file_mem_block_map_.end()) {
+    return;
+  }
+  // The readahead is issued by the kernel asynchronously, the swap in later reads the pages from the page cache.
+  if (madvise(iter->first, iter->second.size_, MADV_WILLNEED) != 0) {
+    MS_LOG(DEBUG) << "Prefetch file backed memory " << ptr << " failed, errno: " << errno;
+  }
+#endif
 }
 
 void AutoMemoryOffload::SetInitHostPtr(const void *key, void *host_ptr, size_t mem_size) {
@@ -244,6 +386,17 @@ void *AutoMemoryOffload::SwapIn(const void *key, void *stream) {
   return iter->second;
 }
 
+void AutoMemoryOffload::Prefetch(const void *key) {
+  MS_EXCEPTION_IF_NULL(mem_handler_);
+  bool from_init = true;
+  void *host_ptr = nullptr;
+  GetHostPtr(key, &host_ptr, &from_init);
+  if (host_ptr == nullptr) {
+    return;
+  }
+  mem_handler_->PrefetchHost(host_ptr);
+}
+
 size_t AutoMemoryOffload::GetMemSize(const void *key) {
   const auto &iter = mem_size_.find(key);
   if (iter == mem_size_.end()) {
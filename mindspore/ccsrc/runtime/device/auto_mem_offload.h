@@ -21,25 +21,54 @@
 #include <map>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <shared_mutex>
 
 #include "runtime/device/memory_manager.h"
+#include "runtime/device/host_staging_mem_pool.h"
 #include "common/mem_reuse/mem_dynamic_allocator.h"
 #include "utils/hash_map.h"
 #include "utils/hash_set.h"
 
 namespace mindspore {
 namespace device {
+// The host memory pool of offloaded data. When the env MS_DEV_OFFLOAD_DISK_PATH is set, the memory beyond the host
+// memory limit (env MS_DEV_OFFLOAD_HOST_MEM_LIMIT in GB, 0 by default) is backed by the mmap'd file in the directory,
+// so that the offloaded data can exceed the host memory and the page cache keeps the hot pages in memory.
 class OffloadedMemPool {
  public:
-  OffloadedMemPool() = default;
-  ~OffloadedMemPool() = default;
+  OffloadedMemPool();
+  ~OffloadedMemPool();
+  // The memory is zero filled, including the memory reused after free.
   void *MallocHost(size_t mem_size);
   void FreeHost(void *ptr);
+  // Read the file backed memory from disk asynchronously, it is a no-op for the memory in host.
+  void Prefetch(const void *ptr);
+  bool enable_file_backed_mem() const { return !disk_path_.empty(); }
 
  private:
-  std::map<size_t, std::queue<void *>> cached_host_mem_;
-  std::map<void *, std::shared_ptr<std::vector<uint8_t>>> host_mem_block_map_;
+  void *MallocFileBackedMem(size_t mem_size);
+  void *MallocFromFileMemCache(size_t map_size, size_t numa_node);
+
+  std::mutex mutex_;
+  // The memory in host is allocated from the host staging memory pool, value is the size.
+  std::shared_ptr<HostStagingMemPool> host_staging_mem_pool_;
+  std::map<void *, size_t> host_mem_block_map_;
+  size_t host_mem_size_{0};
+  size_t host_mem_limit_{0};
+  struct FileMemBlock {
+    size_t size_;
+    // The numa node of the thread which faulted in the pages.
+    size_t numa_node_;
+  };
+  // The file backed memory.
+  std::map<void *, FileMemBlock> file_mem_block_map_;
+  // The file backed memory freed, key is the numa node and the mapped size.
+  std::map<std::pair<size_t, size_t>, std::queue<void *>> cached_file_mem_;
+  std::string disk_path_;
+  int file_fd_{-1};
+  size_t file_size_{0};
 };
 
 class MemHandler {
@@ -53,6 +82,8 @@ class MemHandler {
   void FreeDevice(void *ptr) { memory_manager_->FreeMemFromMemPool(ptr); }
   void *MallocHost(size_t mem_size) { return host_mem_cache_->MallocHost(mem_size); }
   void FreeHost(void *ptr) { host_mem_cache_->FreeHost(ptr); }
+  void PrefetchHost(const void *ptr) { host_mem_cache_->Prefetch(ptr); }
+  bool enable_file_backed_host_mem() const { return host_mem_cache_->enable_file_backed_mem(); }
   void SwapIn(const void *host_ptr, void *device_ptr, size_t mem_size, void *stream) {
     memory_manager_->SwapIn(host_ptr, device_ptr, mem_size, stream);
   }
@@ -84,6 +115,8 @@ class BACKEND_EXPORT AutoMemoryOffload {
   void SwapOut(const void *key, void *stream);
   // Return the device ptr where the data is copied to
   void *SwapIn(const void *key, void *stream);
+  // Read the host data of key from disk ahead of the swap in.
+  void Prefetch(const void *key);
 
  private:
   size_t GetMemSize(const void *key);
@@ -209,6 +209,32 @@ class DeviceAddress : public mindspore::DeviceSync {
   size_t flag() const { return flag_; }
   void set_flag(size_t flag) { flag_ = flag; }
 
+  // Bind the buffer of host tensor as the ptr directly to avoid the data copy, which is only valid when the device
+  // memory is the host memory, such as the CPU device. The host tensor is held until unbinding to keep the buffer
+  // alive.
+  void BindHostTensor(const tensor::TensorPtr &host_tensor) {
+    MS_EXCEPTION_IF_NULL(host_tensor);
+    std::lock_guard<std::recursive_mutex> lock(ptr_mutex_);
+    bound_host_tensor_ = host_tensor;
+    ptr_ = host_tensor->data_c();
+    from_mem_pool_ = false;
+  }
+  // The ptr is reset when unbinding, so the memory will be allocated from the memory pool in the next allocation.
+  void UnbindHostTensor() {
+    std::lock_guard<std::recursive_mutex> lock(ptr_mutex_);
+    if (bound_host_tensor_ == nullptr) {
+      return;
+    }
+    if (ptr_ == bound_host_tensor_->data_c()) {
+      ptr_ = nullptr;
+    }
+    bound_host_tensor_ = nullptr;
+  }
+  bool IsHostTensorBound() const {
+    std::lock_guard<std::recursive_mutex> lock(ptr_mutex_);
+    return (bound_host_tensor_ != nullptr) && (ptr_ == bound_host_tensor_->data_c());
+  }
+
  protected:
   const void *ptr() const { return ptr_; }
   size_t size() const { return size_; }
@@ -243,6 +269,9 @@ class DeviceAddress : public mindspore::DeviceSync {
   // The device address flag.
   size_t flag_{0};
 
+  // The host tensor whose buffer is bound as the ptr, refer to BindHostTensor.
+  tensor::TensorPtr bound_host_tensor_{nullptr};
+
   friend class KernelRuntime;
   friend class MemoryManager;
   friend class mindspore::device::ascend::tasksink::TaskGenerator;
@@ -0,0 +1,297 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "runtime/device/host_staging_mem_pool.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <sys/mman.h>
+#endif
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+#include "utils/convert_utils_base.h"
+#include "utils/log_adapter.h"
+#include "utils/ms_utils.h"
+
+namespace mindspore {
+namespace device {
+namespace {
+constexpr char kHostStagingMemLockEnv[] = "MS_DEV_HOST_STAGING_MEM_LOCK";
+constexpr char kHostStagingMemCacheSizeEnv[] = "MS_DEV_HOST_STAGING_MEM_CACHE_SIZE";
+constexpr float kGBToByte = static_cast<float>(1UL << 30);
+constexpr size_t kDefaultMaxCachedSize = 4UL << 30;
+constexpr size_t kHostPageSize = 4096;
+// Each power of two is divided into 2^kSizeClassShift size classes.
+constexpr size_t kSizeClassShift = 2;
+constexpr char kNumaNodeDirPrefix[] = "node";
+constexpr size_t kNumaNodeDirPrefixLen = sizeof(kNumaNodeDirPrefix) - 1;
+
+size_t HighestBitIndex(size_t value) {
+  size_t index = 0;
+  while (value >>= 1) {
+    ++index;
+  }
+  return index;
+}
+}  // namespace
+
+const std::shared_ptr<HostStagingMemPool> &HostStagingMemPool::GetInstance() {
+  static std::shared_ptr<HostStagingMemPool> instance(new HostStagingMemPool());
+  return instance;
+}
+
+HostStagingMemPool::HostStagingMemPool() : max_cached_size_(kDefaultMaxCachedSize) {
+  enable_mem_lock_ = common::GetEnv(kHostStagingMemLockEnv) == "1";
+  const auto &cache_size = common::GetEnv(kHostStagingMemCacheSizeEnv);
+  if (!cache_size.empty()) {
+    float cache_size_gb = 0;
+    try {
+      cache_size_gb = std::stof(cache_size);
+    } catch (const std::exception &e) {
+      MS_LOG(EXCEPTION) << "Invalid env " << kHostStagingMemCacheSizeEnv << ": " << cache_size;
+    }
+    if (cache_size_gb < 0) {
+      MS_LOG(EXCEPTION) << "Invalid env " << kHostStagingMemCacheSizeEnv << ": " << cache_size;
+    }
+    max_cached_size_ = FloatToSize(cache_size_gb * kGBToByte);
+  }
+  InitNumaNodes();
+  cached_blocks_.resize(numa_node_num_);
+}
+
+HostStagingMemPool::~HostStagingMemPool() {
+  std::lock_guard<std::mutex> locker(mutex_);
+  for (const auto &item : blocks_) {
+    FreeToOs(item.first, item.second);
+  }
+  blocks_.clear();
+  used_blocks_.clear();
+  cached_blocks_.clear();
+}
+
+void HostStagingMemPool::InitNumaNodes() {
+#ifdef __linux__
+  // The numa node of cpu is the directory named node<id> in the sysfs directory of cpu.
+  const auto cpu_num = sysconf(_SC_NPROCESSORS_CONF);
+  for (long cpu = 0; cpu < cpu_num; ++cpu) {
+    size_t numa_node = 0;
+    const auto cpu_path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    auto dir = opendir(cpu_path.c_str());
+    if (dir != nullptr) {
+      for (auto entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name.size() > kNumaNodeDirPrefixLen && name.compare(0, kNumaNodeDirPrefixLen, kNumaNodeDirPrefix) == 0 &&
+            std::all_of(name.begin() + kNumaNodeDirPrefixLen, name.end(), ::isdigit)) {
+          numa_node = std::stoul(name.substr(kNumaNodeDirPrefixLen));
+          break;
+        }
+      }
+      (void)closedir(dir);
+    }
+    cpu_numa_nodes_.push_back(numa_node);
+    numa_node_num_ = std::max(numa_node_num_, numa_node + 1);
+  }
+#endif
+  MS_LOG(INFO) << "Host staging memory pool, numa node num: " << numa_node_num_
+               << ", enable memory lock: " << enable_mem_lock_ << ", max cached size: " << max_cached_size_;
+}
+
+size_t HostStagingMemPool::CurrentNumaNode() const {
+#ifdef __linux__
+  const auto cpu = sched_getcpu();
+  if (cpu >= 0 && IntToSize(cpu) < cpu_numa_nodes_.size()) {
+    return cpu_numa_nodes_[IntToSize(cpu)];
+  }
+#endif
+  return 0;
+}
+
+size_t HostStagingMemPool::GetBlockSize(size_t size) {
+  if (size <= kHostPageSize) {
+    return kHostPageSize;
+  }
+  const size_t highest_bit = HighestBitIndex(size - 1);
+  const size_t step = std::max(kHostPageSize, static_cast<size_t>(1) << (highest_bit - kSizeClassShift));
+  return (size + step - 1) / step * step;
+}
+
+void *HostStagingMemPool::Malloc(size_t size, bool zero_fill) {
+  const size_t block_size = GetBlockSize(size);
+  const size_t numa_node = CurrentNumaNode();
+  void *cached_ptr = nullptr;
+  {
+    std::lock_guard<std::mutex> locker(mutex_);
+    ++statistics_.alloc_count_;
+    cached_ptr = MallocFromCache(block_size, numa_node);
+    if (cached_ptr != nullptr) {
+      (void)used_blocks_.insert(cached_ptr);
+      statistics_.used_size_ += block_size;
+      statistics_.peak_used_size_ = std::max(statistics_.peak_used_size_, statistics_.used_size_);
+    }
+  }
+  if (cached_ptr != nullptr) {
+    if (zero_fill) {
+      (void)memset(cached_ptr, 0, size);
+    }
+    return cached_ptr;
+  }
+
+  // Fault in the pages without lock, which costs the most time of allocation.
+  bool locked = false;
+  auto ptr = MallocFromOs(block_size, &locked);
+  std::lock_guard<std::mutex> locker(mutex_);
+  blocks_[ptr] = {block_size, numa_node, locked};
+  (void)used_blocks_.insert(ptr);
+  statistics_.total_size_ += block_size;
+  statistics_.locked_size_ += locked ? block_size : 0;
+  statistics_.used_size_ += block_size;
+  statistics_.peak_used_size_ = std::max(statistics_.peak_used_size_, statistics_.used_size_);
+  return ptr;
+}
+
+void *HostStagingMemPool::MallocFromCache(size_t block_size, size_t numa_node) {
+  // Prefer the memory of local numa node, and reuse the memory of the other numa node to avoid the page faults.
+  for (size_t i = 0; i < numa_node_num_; ++i) {
+    const size_t node = (numa_node + i) % numa_node_num_;
+    auto iter = cached_blocks_[node].find(block_size);
+    if (iter == cached_blocks_[node].end() || iter->second.empty()) {
+      continue;
+    }
+    auto ptr = iter->second.back();
+    iter->second.pop_back();
+    statistics_.cached_size_ -= block_size;
+    ++statistics_.reuse_count_;
+    if (node != numa_node) {
+      ++statistics_.remote_reuse_count_;
+    }
+    return ptr;
+  }
+  return nullptr;
+}
+
+void *HostStagingMemPool::MallocFromOs(size_t block_size, bool *locked) const {
+  MS_EXCEPTION_IF_NULL(locked);
+  void *ptr = nullptr;
+#if !defined(_WIN32) && !defined(_WIN64)
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_POPULATE
+  // Fault in the pages by the allocating thread, so that the pages are placed on its numa node by the first touch.
+  flags |= MAP_POPULATE;
+#endif
+  ptr = mmap(nullptr, block_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (ptr == MAP_FAILED) {
+    MS_LOG(EXCEPTION) << "Malloc host staging memory failed, size: " << block_size << ", errno: " << errno;
+  }
+  if (enable_mem_lock_) {
+    *locked = mlock(ptr, block_size) == 0;
+    if (!*locked) {
+      MS_LOG(WARNING) << "Lock host staging memory failed, size: " << block_size << ", errno: " << errno
+                      << ". Please check the RLIMIT_MEMLOCK.";
+    }
+  }
+#else
+  // The memory from the os is zero filled as the anonymous mapping is.
+  ptr = calloc(1, block_size);
+  if (ptr == nullptr) {
+    MS_LOG(EXCEPTION) << "Malloc host staging memory failed, size: " << block_size;
+  }
+#endif
+  return ptr;
+}
+
+void HostStagingMemPool::Free(void *ptr) {
+  MS_EXCEPTION_IF_NULL(ptr);
+  std::lock_guard<std::mutex> locker(mutex_);
+  if (used_blocks_.erase(ptr) == 0) {
+    MS_LOG(EXCEPTION) << "The host staging memory " << ptr << " is not allocated from the pool or is freed twice.";
+  }
+  auto iter = blocks_.find(ptr);
+  if (iter == blocks_.end()) {
+    MS_LOG(EXCEPTION) << "Can not find the host staging memory block " << ptr;
+  }
+  const auto &block = iter->second;
+  statistics_.used_size_ -= block.size_;
+  if (statistics_.cached_size_ + block.size_ > max_cached_size_) {
+    FreeToOs(ptr, block);
+    (void)blocks_.erase(iter);
+    return;
+  }
+  (void)cached_blocks_[block.numa_node_][block.size_].emplace_back(ptr);
+  statistics_.cached_size_ += block.size_;
+}
+
+std::shared_ptr<void> HostStagingMemPool::MallocShared(size_t size) {
+  auto ptr = Malloc(size);
+  // The deleter holds the pool, so that the memory is freed before the pool is destroyed.
+  return std::shared_ptr<void>(ptr, [pool = GetInstance()](void *mem) { pool->Free(mem); });
+}
+
+void HostStagingMemPool::FreeToOs(void *ptr, const HostMemBlock &block) {
+  statistics_.total_size_ -= block.size_;
+  if (block.locked_) {
+    statistics_.locked_size_ -= block.size_;
+  }
+#if !defined(_WIN32) && !defined(_WIN64)
+  // The munmap also unlocks the memory.
+  if (munmap(ptr, block.size_) != 0) {
+    MS_LOG(ERROR) << "Free host staging memory " << ptr << " failed, errno: " << errno;
+  }
+#else
+  free(ptr);
+#endif
+}
+
+void HostStagingMemPool::ReleaseCachedMem() {
+  std::lock_guard<std::mutex> locker(mutex_);
+  for (auto &node_blocks : cached_blocks_) {
+    for (auto &item : node_blocks) {
+      for (auto ptr : item.second) {
+        auto iter = blocks_.find(ptr);
+        if (iter == blocks_.end()) {
+          continue;
+        }
+        FreeToOs(ptr, iter->second);
+        (void)blocks_.erase(iter);
+      }
+    }
+    node_blocks.clear();
+  }
+  statistics_.cached_size_ = 0;
+}
+
+HostStagingMemStatistics HostStagingMemPool::GetStatistics() const {
+  std::lock_guard<std::mutex> locker(mutex_);
+  return statistics_;
+}
+
+void HostStagingMemPool::DumpStatistics() const {
+  const auto statistics = GetStatistics();
+  const double reuse_ratio =
+    statistics.alloc_count_ == 0 ? 0 : static_cast<double>(statistics.reuse_count_) / statistics.alloc_count_;
+  MS_LOG(INFO) << "Host staging memory pool statistics: total size " << statistics.total_size_ << ", used size "
+               << statistics.used_size_ << ", peak used size " << statistics.peak_used_size_ << ", cached size "
+               << statistics.cached_size_ << ", locked size " << statistics.locked_size_ << ", alloc count "
+               << statistics.alloc_count_ << ", reuse ratio " << reuse_ratio << ", remote numa reuse count "
+               << statistics.remote_reuse_count_;
+}
+}  // namespace device
+}  // namespace mindspore
@@ -0,0 +1,102 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_RUNTIME_DEVICE_HOST_STAGING_MEM_POOL_H_
+#define MINDSPORE_CCSRC_RUNTIME_DEVICE_HOST_STAGING_MEM_POOL_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "utils/hash_map.h"
+#include "utils/hash_set.h"
+#include "include/backend/visible.h"
+
+namespace mindspore {
+namespace device {
+struct HostStagingMemStatistics {
+  // The memory reserved from the os, including the used and the cached memory.
+  size_t total_size_{0};
+  size_t used_size_{0};
+  size_t peak_used_size_{0};
+  size_t cached_size_{0};
+  // The memory locked in the physical memory.
+  size_t locked_size_{0};
+  size_t alloc_count_{0};
+  // The allocations served by the cached memory, and the ones served by the cached memory of the other numa node.
+  size_t reuse_count_{0};
+  size_t remote_reuse_count_{0};
+};
+
+// The host memory pool shared by the swap, data queue and embedding cache transfers. The memory is rounded up to the
+// size class which has four classes for each power of two, the memory freed is cached per numa node and size class
+// and reused by the later allocation, so that the repeated allocation of large buffers doesn't fault in the pages
+// again. The memory is mapped and faulted in by the allocating thread, so that the pages are placed on its numa node,
+// and is locked in the physical memory if the env MS_DEV_HOST_STAGING_MEM_LOCK is set to 1. The cached memory is
+// limited by the env MS_DEV_HOST_STAGING_MEM_CACHE_SIZE in GB, 4GB by default.
+class BACKEND_EXPORT HostStagingMemPool {
+ public:
+  ~HostStagingMemPool();
+  // The instance is shared by the users which free the memory in their destructors.
+  static const std::shared_ptr<HostStagingMemPool> &GetInstance();
+
+  // The memory reused from the cache keeps the data of its last user unless zero_fill is set. The swap buffers of the
+  // embedding cache and the data queue arena are written before read and don't need it, while the offloaded memory
+  // is zero filled as the host memory of offload was.
+  void *Malloc(size_t size, bool zero_fill = false);
+  void Free(void *ptr);
+  // Allocate the memory which is freed to the pool when the reference count is zero.
+  std::shared_ptr<void> MallocShared(size_t size);
+  // Release all the cached memory to the os.
+  void ReleaseCachedMem();
+
+  HostStagingMemStatistics GetStatistics() const;
+  void DumpStatistics() const;
+
+  // Return the block size of the size class which the size belongs to.
+  static size_t GetBlockSize(size_t size);
+  // Return the numa node of the cpu running the current thread.
+  size_t CurrentNumaNode() const;
+
+ private:
+  HostStagingMemPool();
+  struct HostMemBlock {
+    size_t size_;
+    size_t numa_node_;
+    bool locked_;
+  };
+
+  void InitNumaNodes();
+  void *MallocFromCache(size_t block_size, size_t numa_node);
+  void *MallocFromOs(size_t block_size, bool *locked) const;
+  void FreeToOs(void *ptr, const HostMemBlock &block);
+
+  mutable std::mutex mutex_;
+  // The cached memory of each numa node, key is the block size.
+  std::vector<std::map<size_t, std::vector<void *>>> cached_blocks_;
+  // All the memory reserved from the os.
+  HashMap<void *, HostMemBlock> blocks_;
+  HashSet<void *> used_blocks_;
+  // The numa node of each cpu.
+  std::vector<size_t> cpu_numa_nodes_;
+  size_t numa_node_num_{1};
+  bool enable_mem_lock_{false};
+  size_t max_cached_size_;
+  HostStagingMemStatistics statistics_;
+};
+}  // namespace device
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_RUNTIME_DEVICE_HOST_STAGING_MEM_POOL_H_
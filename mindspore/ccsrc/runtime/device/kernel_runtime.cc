@@ -16,6 +16,7 @@
 
 #include "runtime/device/kernel_runtime.h"
 #include <algorithm>
+#include <chrono>
 #include <functional>
 #include <utility>
 #include <vector>
@@ -47,6 +48,53 @@ namespace mindspore {
 namespace device {
 constexpr size_t kAtomicCleanInputSize = 2;
 namespace {
+constexpr char kMemOffloadRecomputeEnv[] = "MS_DEV_MEM_OFFLOAD_RECOMPUTE";
+// The size of the memory copied between host and device to measure the transfer bandwidth.
+constexpr size_t kBandwidthProbeSize = 16 << 20;
+
+bool IsMemOffloadRecomputeEnabled() {
+  static const bool enable_recompute = common::GetEnv(kMemOffloadRecomputeEnv) == "1";
+  return enable_recompute;
+}
+
+// The input is modified in place by the optimizer or assign kernels, so the kernel recomputed later may read the
+// updated value instead of the one of its original launch.
+bool IsInputUpdatedInPlace(const session::KernelGraph &graph, const AnfNodePtr &kernel) {
+  size_t input_num = common::AnfAlgo::GetInputTensorNum(kernel);
+  for (size_t i = 0; i < input_num; ++i) {
+    auto input_with_index = common::AnfAlgo::GetPrevNodeOutput(kernel, i, true);
+    MS_EXCEPTION_IF_NULL(input_with_index.first);
+    if (graph.IsRefOutputMapValue(input_with_index)) {
+      return true;
+    }
+    auto parameter = input_with_index.first->cast<ParameterPtr>();
+    if (parameter != nullptr && graph.IsUpdatedParameter(parameter)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The kernel can be launched again to recompute its output instead of swapping the output, if the kernel only writes
+// its single output, the output isn't updated in place and none of its inputs is updated in place.
+bool IsRecomputableKernel(const session::KernelGraph &graph, const AnfNodePtr &kernel) {
+  auto cnode = kernel->cast<CNodePtr>();
+  MS_EXCEPTION_IF_NULL(cnode);
+  auto kernel_mod = AnfAlgo::GetKernelMod(kernel);
+  MS_EXCEPTION_IF_NULL(kernel_mod);
+  if (common::AnfAlgo::IsCommunicationOp(kernel) || common::AnfAlgo::IsDynamicShape(kernel) ||
+      common::AnfAlgo::IsUpdateParameterKernel(cnode) || common::AnfAlgo::HasNodeAttr(kAttrAtomicOutputIndexs, cnode)) {
+    return false;
+  }
+  const auto cnode_name = common::AnfAlgo::GetCNodeName(cnode);
+  if (cnode_name == kAtomicAddrCleanOpName || cnode_name == kDynamicAtomicAddrCleanOpName) {
+    return false;
+  }
+  if (!kernel_mod->GetWorkspaceSizeList().empty() || kernel_mod->GetOutputSizeList().size() != 1) {
+    return false;
+  }
+  return !graph.IsInRefOutputMap(std::make_pair(kernel, 0)) && !IsInputUpdatedInPlace(graph, kernel);
+}
 std::vector<AnfNodePtr> GetGraphInputs(const session::KernelGraph &graph) {
   auto graph_inputs = graph.inputs();
   std::vector<AnfNodePtr> result(graph_inputs.begin(), graph_inputs.end());
@@ -1188,6 +1236,34 @@ bool KernelRuntime::MemSchedulerPreCompute(const AnfNodePtr &kernel, const std::
   return true;
 }
 
+void KernelRuntime::MemSchedulerSetRecompute(const session::KernelGraph &graph, const AnfNodePtr &kernel,
+                                             const std::shared_ptr<MemScheduler> &mem_scheduler) {
+  MS_EXCEPTION_IF_NULL(mem_scheduler);
+  if (!IsMemOffloadRecomputeEnabled() || !IsRecomputableKernel(graph, kernel)) {
+    return;
+  }
+  std::vector<const void *> input_keys;
+  size_t input_num = common::AnfAlgo::GetInputTensorNum(kernel);
+  for (size_t i = 0; i < input_num; ++i) {
+    auto real_input = AnfAlgo::GetInputGraphIdxByKernelIdx(kernel, i);
+    auto kernel_with_index = common::AnfAlgo::GetPrevNodeOutput(kernel, real_input, true);
+    (void)input_keys.emplace_back(AnfAlgo::GetOutputAddr(kernel_with_index.first, kernel_with_index.second, true));
+  }
+  auto output_address = AnfAlgo::GetOutputAddr(kernel, 0, true);
+  // The scheduler holds the recompute function, so the function doesn't hold the scheduler.
+  std::weak_ptr<MemScheduler> weak_mem_scheduler = mem_scheduler;
+  mem_scheduler->SetRecompute(output_address, input_keys, [this, kernel, weak_mem_scheduler](void *stream) {
+    auto mem_scheduler = weak_mem_scheduler.lock();
+    MS_EXCEPTION_IF_NULL(mem_scheduler);
+    auto kernel_mod = AnfAlgo::GetKernelMod(kernel);
+    MS_EXCEPTION_IF_NULL(kernel_mod);
+    KernelLaunchInfo kernel_launch_info;
+    AssignKernelAddress(mem_scheduler, kernel, &kernel_launch_info);
+    MS_LOG(DEBUG) << "Recompute the output of kernel " << kernel->fullname_with_scope();
+    return kernel_mod->Launch(kernel_launch_info, stream);
+  });
+}
+
 bool KernelRuntime::MemSchedulerPostCompute(const session::KernelGraph &graph, const AnfNodePtr &kernel,
                                             const std::shared_ptr<MemScheduler> &mem_scheduler, void *stream,
                                             bool mock) {
@@ -1692,6 +1768,9 @@ bool KernelRuntime::LaunchKernel(const session::KernelGraph &graph, const AnfNod
     if (!ret) {
       return ret;
     }
+    if (mock) {
+      MemSchedulerSetRecompute(graph, kernel, mem_scheduler);
+    }
   } else if (!kernel_mod->GetInputsAddr().empty() || !kernel_mod->GetOutputsAddr().empty()) {
     kernel_launch_info.inputs_ = kernel_mod->GetInputsAddr();
     kernel_launch_info.outputs_ = kernel_mod->GetOutputsAddr();
@@ -1846,8 +1925,13 @@ void KernelRuntime::UseMemSchedulerIfNeeded(const session::KernelGraph &graph) {
   if (mem_scheduler->optimized()) {
     return;
   }
-  mem_scheduler->SetMemHandler(std::make_shared<MemHandler>(mem_manager_));
+  auto mem_handler = std::make_shared<MemHandler>(mem_manager_);
+  mem_scheduler->SetMemHandler(mem_handler);
   mem_scheduler->SetTotalStep(graph.execution_order().size());
+  // The bandwidth is only used to choose between swap and recompute.
+  if (IsMemOffloadRecomputeEnabled()) {
+    mem_scheduler->set_transfer_bandwidth(GetTransferBandwidth(mem_handler));
+  }
 
   if (mem_scheduler->need_record_event()) {
     (void)LaunchKernelMod(graph, true);
@@ -1859,6 +1943,36 @@ void KernelRuntime::UseMemSchedulerIfNeeded(const session::KernelGraph &graph) {
   }
 }
 
+double KernelRuntime::GetTransferBandwidth(const std::shared_ptr<MemHandler> &mem_handler) {
+  MS_EXCEPTION_IF_NULL(mem_handler);
+  if (transfer_bandwidth_ > 0) {
+    return transfer_bandwidth_;
+  }
+  // The bandwidth is measured once for the device, and the default one is used if the probe memory is not available.
+  transfer_bandwidth_ = kDefaultTransferBandwidth;
+  auto device_ptr = mem_handler->MallocDevice(kBandwidthProbeSize);
+  auto host_ptr = mem_handler->MallocHost(kBandwidthProbeSize);
+  if (device_ptr != nullptr && host_ptr != nullptr) {
+    auto start = std::chrono::steady_clock::now();
+    mem_handler->SwapOut(device_ptr, host_ptr, kBandwidthProbeSize, stream_);
+    mem_handler->SwapIn(host_ptr, device_ptr, kBandwidthProbeSize, stream_);
+    bool ret = SyncStream();
+    auto cost = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (ret && cost > 0) {
+      transfer_bandwidth_ = 2.0 * kBandwidthProbeSize / cost;
+    }
+  }
+  if (device_ptr != nullptr) {
+    mem_handler->FreeDevice(device_ptr);
+  }
+  if (host_ptr != nullptr) {
+    mem_handler->FreeHost(host_ptr);
+  }
+  MS_LOG(INFO) << "The transfer bandwidth between host and device " << device_id_ << " is " << transfer_bandwidth_
+               << " bytes per us.";
+  return transfer_bandwidth_;
+}
+
 bool KernelRuntime::LaunchKernels(const session::KernelGraph &graph) {
   UseMemSchedulerIfNeeded(graph);
   if (!LaunchKernelMod(graph)) {
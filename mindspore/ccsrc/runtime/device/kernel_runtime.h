@@ -205,6 +205,10 @@ class BACKEND_EXPORT KernelRuntime {
                               void *stream, bool mock, KernelLaunchInfo *kernel_launch_info);
   bool MemSchedulerPostCompute(const session::KernelGraph &graph, const AnfNodePtr &kernel,
                                const std::shared_ptr<MemScheduler> &mem_scheduler, void *stream, bool mock);
+  void MemSchedulerSetRecompute(const session::KernelGraph &graph, const AnfNodePtr &kernel,
+                                const std::shared_ptr<MemScheduler> &mem_scheduler);
+  // The bandwidth between host and device in bytes per us, which is measured at the first call.
+  double GetTransferBandwidth(const std::shared_ptr<MemHandler> &mem_handler);
 
  protected:
   uint32_t device_id_{0};
@@ -220,6 +224,7 @@ class BACKEND_EXPORT KernelRuntime {
     graph_kernel_events_map_;
   mindspore::HashMap<int64_t, std::pair<uint8_t *, uint8_t *>> reuse_communication_address_;
   MemSchedulerManager mem_scheduler_manager_;
+  double transfer_bandwidth_{0};
 };
 using KernelRuntimePtr = std::shared_ptr<KernelRuntime>;
 }  // namespace device
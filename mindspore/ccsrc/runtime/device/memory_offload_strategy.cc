@@ -408,6 +408,9 @@ void MemOffloadStrategy<Key>::GenComputeMemEvents() {
   post_compute_events_.clear();
   pre_compute_events_.resize(total_compute_index_);
   post_compute_events_.resize(total_compute_index_);
+  offload_actions_.clear();
+  // The recompute event and the index of kernel to recompute.
+  std::vector<std::pair<size_t, MemEventPtr<Key>>> recompute_events;
   for (auto &item : mem_events_) {
     auto &mem_events = item.second;
     // No need to generate events for memory that has only one event, which means it is never used by any kernel.
@@ -435,20 +438,12 @@ void MemOffloadStrategy<Key>::GenComputeMemEvents() {
     for (size_t i = kFirstGetMemEventIndex; i < mem_events.size(); ++i) {
       auto &event = mem_events[i];
       MS_EXCEPTION_IF_NULL(event);
+      bool recomputed = false;
       if (need_swap_ && swap_events_.find(event) != swap_events_.end()) {
-        auto swap_out_event = std::make_shared<MemEvent<Key>>(kSwapOut, pre_index);
-        swap_out_event->key = item.first;
-        swap_out_event->mem_size = first_event->mem_size;
-        (void)post_compute_events_[pre_index].emplace_back(swap_out_event);
-        // avoid swap-in-event follow init-event
-        if (i != kFirstGetMemEventIndex || first_event->type != kInit) {
-          auto swap_in_event = std::make_shared<MemEvent<Key>>(kSwapIn, event->index);
-          swap_in_event->key = item.first;
-          swap_in_event->mem_size = first_event->mem_size;
-          (void)pre_compute_events_[event->index].emplace_back(swap_in_event);
-        }
+        recomputed = GenOffloadEvents(first_event, event, pre_index, i, &recompute_events);
       }
-      if (event->index < pre_compute_events_.size()) {
+      // The recompute event allocates the memory and takes the place of the get event.
+      if (!recomputed && event->index < pre_compute_events_.size()) {
         (void)pre_compute_events_[event->index].emplace_back(event);
       }
       pre_index = event->index;
@@ -457,6 +452,112 @@ void MemOffloadStrategy<Key>::GenComputeMemEvents() {
       GenFreeEvent(last_event);
     }
   }
+  // The kernels are recomputed after the other events of the index, when their inputs are in device memory, and in the
+  // execution order, since the input of a recomputed kernel may be recomputed too.
+  std::stable_sort(recompute_events.begin(), recompute_events.end(),
+                   [](const auto &l, const auto &r) { return l.first < r.first; });
+  for (const auto &item : recompute_events) {
+    (void)pre_compute_events_[item.second->index].emplace_back(item.second);
+  }
+  if (!recompute_events.empty()) {
+    MS_LOG(INFO) << "Offload " << offload_actions_.size() << " memory, " << recompute_events.size()
+                 << " of which are recomputed instead of swapped.";
+  }
+}
+
+template <typename Key>
+bool MemOffloadStrategy<Key>::GenOffloadEvents(const MemEventPtr<Key> &first_event, const MemEventPtr<Key> &event,
+                                               size_t release_index, size_t event_pos,
+                                               std::vector<std::pair<size_t, MemEventPtr<Key>>> *recompute_events) {
+  MS_EXCEPTION_IF_NULL(first_event);
+  MS_EXCEPTION_IF_NULL(event);
+  MS_EXCEPTION_IF_NULL(recompute_events);
+  const auto key = first_event->key;
+  const auto mem_size = first_event->mem_size;
+  double swap_cost = 0;
+  double recompute_cost = 0;
+  if (NeedRecompute(first_event, event->index, &swap_cost, &recompute_cost)) {
+    auto free_event = std::make_shared<MemEvent<Key>>(kFree, release_index);
+    free_event->key = key;
+    (void)post_compute_events_[release_index].emplace_back(free_event);
+    auto recompute_event = std::make_shared<MemEvent<Key>>(kRecompute, event->index);
+    recompute_event->key = key;
+    recompute_event->mem_size = mem_size;
+    (void)recompute_events->emplace_back(first_event->index, recompute_event);
+    offload_actions_.push_back(
+      {key, OffloadActionType::kRecompute, release_index, event->index, mem_size, recompute_cost});
+    return true;
+  }
+
+  auto swap_out_event = std::make_shared<MemEvent<Key>>(kSwapOut, release_index);
+  swap_out_event->key = key;
+  swap_out_event->mem_size = mem_size;
+  (void)post_compute_events_[release_index].emplace_back(swap_out_event);
+  // avoid swap-in-event follow init-event
+  if (event_pos != kFirstGetMemEventIndex || first_event->type != kInit) {
+    auto swap_in_event = std::make_shared<MemEvent<Key>>(kSwapIn, event->index);
+    swap_in_event->key = key;
+    swap_in_event->mem_size = mem_size;
+    (void)pre_compute_events_[event->index].emplace_back(swap_in_event);
+    GenPrefetchEvent(swap_in_event, release_index);
+  }
+  offload_actions_.push_back({key, OffloadActionType::kSwap, release_index, event->index, mem_size, swap_cost});
+  return false;
+}
+
+template <typename Key>
+bool MemOffloadStrategy<Key>::NeedRecompute(const MemEventPtr<Key> &first_event, size_t reload_index,
+                                            double *swap_cost, double *recompute_cost) const {
+  MS_EXCEPTION_IF_NULL(first_event);
+  MS_EXCEPTION_IF_NULL(swap_cost);
+  MS_EXCEPTION_IF_NULL(recompute_cost);
+  // The swap costs the transfer of both swap out and swap in, which share the bandwidth between host and device.
+  *swap_cost = transfer_bandwidth_ > 0 ? 2.0 * first_event->mem_size / transfer_bandwidth_ : 0;
+  // Only the memory allocated by the kernel can be recomputed, and the cost is the time of kernel.
+  if (first_event->type != kMalloc || first_event->index >= compute_time_.size()) {
+    return false;
+  }
+  const auto &iter = recompute_input_keys_.find(first_event->key);
+  if (iter == recompute_input_keys_.end()) {
+    return false;
+  }
+  *recompute_cost = compute_time_[first_event->index];
+  if (*recompute_cost <= 0 || *recompute_cost >= *swap_cost) {
+    return false;
+  }
+  // The kernel is recomputed before the compute of reload index, so its inputs must be in device memory then.
+  return std::all_of(iter->second.begin(), iter->second.end(),
+                     [this, reload_index](const Key &input_key) { return IsMemInDevice(input_key, reload_index); });
+}
+
+template <typename Key>
+bool MemOffloadStrategy<Key>::IsMemInDevice(Key key, size_t index) const {
+  const auto &iter = mem_events_.find(key);
+  if (iter == mem_events_.end()) {
+    return false;
+  }
+  return std::any_of(iter->second.begin(), iter->second.end(), [index](const MemEventPtr<Key> &event) {
+    return event != nullptr && event->type == kGet && event->index == index;
+  });
+}
+
+template <typename Key>
+void MemOffloadStrategy<Key>::GenPrefetchEvent(const MemEventPtr<Key> &swap_in_event, size_t swap_out_index) {
+  MS_EXCEPTION_IF_NULL(swap_in_event);
+  if (prefetch_span_ == 0) {
+    return;
+  }
+  // The data must be swapped out before it is prefetched, so the prefetch is no earlier than the step after swap out.
+  const size_t swap_span = GetSpanBetweenMemEvents(swap_out_index, swap_in_event->index);
+  if (swap_span <= 1) {
+    return;
+  }
+  const size_t span = std::min(prefetch_span_, swap_span - 1);
+  const size_t prefetch_index = GetPreMemEventIndex(swap_in_event->index, span);
+  auto prefetch_event = std::make_shared<MemEvent<Key>>(kPrefetch, prefetch_index);
+  prefetch_event->key = swap_in_event->key;
+  prefetch_event->mem_size = swap_in_event->mem_size;
+  (void)pre_compute_events_[prefetch_index].emplace_back(prefetch_event);
 }
 
 template <typename Key>
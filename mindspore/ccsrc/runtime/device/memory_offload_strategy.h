@@ -29,7 +29,12 @@ namespace mindspore {
 namespace device {
 enum MemPriority { kMemPriorityLow, kMemPriorityHigh };
 
-enum MemEventType { kInit, kMalloc, kGet, kFree, kSwapIn, kSwapOut };
+enum MemEventType { kInit, kMalloc, kGet, kFree, kSwapIn, kSwapOut, kPrefetch, kRecompute };
+
+enum class OffloadActionType { kSwap, kRecompute };
+
+// The default bandwidth between host and device in bytes per us, which is about 10GB/s.
+constexpr double kDefaultTransferBandwidth = 1.0e4;
 
 template <typename Key>
 struct MemEvent {
@@ -43,6 +48,20 @@ struct MemEvent {
 
 template <typename Key>
 using MemEventPtr = std::shared_ptr<MemEvent<Key>>;
+
+// The memory of key is released after the compute of release_index, and is reloaded by swap in or recompute before the
+// compute of reload_index.
+template <typename Key>
+struct OffloadAction {
+  Key key;
+  OffloadActionType type;
+  size_t release_index;
+  size_t reload_index;
+  size_t mem_size;
+  // The estimated time cost of the action in us.
+  double cost;
+};
+
 template <typename Key>
 using MemEventPtrList = std::vector<MemEventPtr<Key>>;
 
@@ -173,6 +192,18 @@ class MemOffloadStrategy {
 
   void set_mem_size(size_t mem_size) { mem_size_ = mem_size; }
 
+  // Generate the prefetch event the span of steps ahead of each swap in event, 0 means no prefetch.
+  void set_prefetch_span(size_t prefetch_span) { prefetch_span_ = prefetch_span; }
+
+  // The memory of key can be recomputed by the kernel of its malloc event index, whose inputs are input_keys.
+  void SetRecomputeInfo(Key key, const std::vector<Key> &input_keys) { recompute_input_keys_[key] = input_keys; }
+
+  // The bandwidth between host and device in bytes per us.
+  void set_transfer_bandwidth(double transfer_bandwidth) { transfer_bandwidth_ = transfer_bandwidth; }
+
+  // The combined schedule of swap and recompute of the latest execution.
+  const std::vector<OffloadAction<Key>> &offload_actions() const { return offload_actions_; }
+
   bool need_swap() const { return need_swap_; }
 
   std::vector<ContinuousMemInfoPtr<Key>> GetContinuousMemAllocInfo(size_t index) {
@@ -196,6 +227,17 @@ class MemOffloadStrategy {
 
   void GenFreeEvent(const MemEventPtr<Key> &last_event);
 
+  void GenPrefetchEvent(const MemEventPtr<Key> &swap_in_event, size_t swap_out_index);
+
+  // Generate the swap or recompute events to offload the memory before the event, return true if recomputed.
+  bool GenOffloadEvents(const MemEventPtr<Key> &first_event, const MemEventPtr<Key> &event, size_t release_index,
+                        size_t event_pos, std::vector<std::pair<size_t, MemEventPtr<Key>>> *recompute_events);
+
+  bool NeedRecompute(const MemEventPtr<Key> &first_event, size_t reload_index, double *swap_cost,
+                     double *recompute_cost) const;
+
+  bool IsMemInDevice(Key key, size_t index) const;
+
   void AddToSwapEventSetIfOutOfMem(const MemEventPtr<Key> &mem_event, size_t span, std::vector<size_t> *mem_used);
 
   void GenContinuousMemSwapEvent(const ContinuousMemInfoPtr<Key> &continuous_mem_info, std::vector<size_t> *mem_used,
@@ -228,7 +270,11 @@ class MemOffloadStrategy {
   std::vector<MemEventPtrList<Key>> post_compute_events_;
 
   size_t mem_size_{0};
+  size_t prefetch_span_{0};
   std::vector<double> compute_time_;
+  std::map<Key, std::vector<Key>> recompute_input_keys_;
+  double transfer_bandwidth_{kDefaultTransferBandwidth};
+  std::vector<OffloadAction<Key>> offload_actions_;
   bool need_swap_{false};
   std::multimap<size_t, std::pair<MemEventPtr<Key>, size_t>> event_span_;
   std::set<MemEventPtr<Key>> swap_events_;
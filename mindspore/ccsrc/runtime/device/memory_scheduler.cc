@@ -33,6 +33,8 @@ constexpr float kMaxMemReuseFactor = 1.0;
 constexpr float kMinMemReuseFactor = 0.5;
 constexpr float kRetryFactor = 0.1;
 constexpr size_t kMockTimes = 5;
+// The steps between prefetch and swap in, which hides the disk read latency of file backed host memory.
+constexpr size_t kFileBackedMemPrefetchSpan = 2;
 
 double GetCurrentTime() {
 #ifdef _MSC_VER
@@ -173,6 +175,18 @@ bool MemScheduler::PreComputeGet(const MemEventPtr<const void *> &event, void *s
   return auto_mem_offload_->Get(event->key, stream, GetNoReuseKeys()) != nullptr;
 }
 
+bool MemScheduler::PreComputeRecompute(const MemEventPtr<const void *> &event, void *stream) {
+  MS_EXCEPTION_IF_NULL(event);
+  if (Malloc(event, stream) == nullptr) {
+    return false;
+  }
+  const auto &iter = recompute_funcs_.find(event->key);
+  if (iter == recompute_funcs_.end() || iter->second == nullptr) {
+    MS_LOG(EXCEPTION) << "Can not find the recompute function of key " << event->key;
+  }
+  return iter->second(stream);
+}
+
 bool MemScheduler::PreCompute(void *stream) {
   if (strategy_ == nullptr) {
     return true;
@@ -183,7 +197,13 @@ bool MemScheduler::PreCompute(void *stream) {
     MS_EXCEPTION_IF_NULL(event);
     MS_LOG(DEBUG) << "Pre compute " << current_step_ << ": " << event->key << " v " << event->type;
     bool ret = true;
-    if (!optimized_) {
+    if (event->type == kPrefetch) {
+      // Prefetch only hints the host memory, it does not allocate device memory.
+      if (optimized_) {
+        MS_EXCEPTION_IF_NULL(auto_mem_offload_);
+        auto_mem_offload_->Prefetch(event->key);
+      }
+    } else if (!optimized_) {
       ret = PreComputeMock(event);
     } else if (event->type == kInit) {
       ret = PreComputeInit(event, stream);
@@ -193,6 +213,8 @@ bool MemScheduler::PreCompute(void *stream) {
       ret = PreComputeSwapIn(event, stream);
     } else if (event->type == kGet) {
       ret = PreComputeGet(event, stream);
+    } else if (event->type == kRecompute) {
+      ret = PreComputeRecompute(event, stream);
     }
     if (!ret) {
       cur_step_allocated_continuous_mem_.clear();
@@ -239,11 +261,16 @@ void MemScheduler::OptMemUsage(float mem_used_factor) {
     } else {
       updated_ = true;
     }
+    for (const auto &item : recompute_input_keys_) {
+      strategy_->SetRecomputeInfo(item.first, item.second);
+    }
+    strategy_->set_transfer_bandwidth(transfer_bandwidth_);
   }
 
   auto available_mem_size = mem_handler_->GetAvailableMemSize();
   available_mem_size = FloatToSize(available_mem_size * mem_used_factor);
   strategy_->set_mem_size(available_mem_size);
+  strategy_->set_prefetch_span(mem_handler_->enable_file_backed_host_mem() ? kFileBackedMemPrefetchSpan : 0);
   strategy_->Execute();
 }
 
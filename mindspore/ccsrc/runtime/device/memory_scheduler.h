@@ -22,6 +22,7 @@
 #include <memory>
 #include <queue>
 #include <utility>
+#include <functional>
 #include "runtime/device/memory_offload_strategy.h"
 #include "runtime/device/auto_mem_offload.h"
 
@@ -70,6 +71,17 @@ class MemScheduler {
 
   void SetOffload(const void *key) { (void)manual_offload_keys_.insert(key); }
 
+  // The memory of key can be recomputed by the recompute_func instead of swap, which launches the kernel allocating the
+  // memory with the inputs input_keys.
+  void SetRecompute(const void *key, const std::vector<const void *> &input_keys,
+                    const std::function<bool(void *)> &recompute_func) {
+    recompute_input_keys_[key] = input_keys;
+    recompute_funcs_[key] = recompute_func;
+  }
+
+  // The measured bandwidth between host and device in bytes per us, which is used to estimate the cost of swap.
+  void set_transfer_bandwidth(double transfer_bandwidth) { transfer_bandwidth_ = transfer_bandwidth; }
+
   void AddMemNeedInit(const void *key) { (void)high_priority_mem_need_init_.insert(key); }
 
   void ClearMemNeedInit() { high_priority_mem_need_init_.clear(); }
@@ -95,6 +107,8 @@ class MemScheduler {
 
   bool PreComputeGet(const MemEventPtr<const void *> &event, void *stream);
 
+  bool PreComputeRecompute(const MemEventPtr<const void *> &event, void *stream);
+
   const HashSet<const void *> &GetNoReuseKeys() const { return step_keys_[current_step_]; }
 
   void *Malloc(const MemEventPtr<const void *> &event, void *stream);
@@ -115,6 +129,9 @@ class MemScheduler {
     std::make_shared<ContinuousMemInfoHelper<const void *>>()};
   std::set<ContinuousMemInfoPtr<const void *>> cur_step_allocated_continuous_mem_;
   std::set<const void *> manual_offload_keys_;
+  std::map<const void *, std::vector<const void *>> recompute_input_keys_;
+  std::map<const void *, std::function<bool(void *)>> recompute_funcs_;
+  double transfer_bandwidth_{kDefaultTransferBandwidth};
   // Compute time
   std::vector<double> compute_time_;
   double compute_start_time_{0};
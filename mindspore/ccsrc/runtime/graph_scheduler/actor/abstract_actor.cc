@@ -16,6 +16,7 @@
 
 #include "runtime/graph_scheduler/actor/abstract_actor.h"
 #include "runtime/graph_scheduler/actor/output_actor.h"
+#include "runtime/graph_scheduler/actor_profiler.h"
 #include "utils/log_adapter.h"
 
 namespace mindspore {
@@ -38,6 +39,7 @@ void AbstractActor::RunOpData(OpData<DeviceTensor> *const input_data, OpContext<
                 << ", current ref count:" << input_data->data_->ref_count()
                 << ", dynamic ref count:" << input_data->data_->dynamic_ref_count();
   if (is_run) {
+    ActorProfilerScope profiler_scope(this, ActorTraceEventType::kRun);
     Run(context);
   }
 }
@@ -52,6 +54,7 @@ void AbstractActor::RunOpControl(AID *const input_control, OpContext<DeviceTenso
                 << ") receive the input op control and check running condition:" << is_run
                 << ", sequential num:" << sequential_num;
   if (is_run) {
+    ActorProfilerScope profiler_scope(this, ActorTraceEventType::kRun);
     Run(context);
   }
 }
@@ -165,6 +168,10 @@ void AbstractActor::InitOutputData() {
 
 void AbstractActor::SendOutput(OpContext<DeviceTensor> *const context) {
   MS_EXCEPTION_IF_NULL(context);
+  if (ActorProfiler::GetInstance().is_running()) {
+    auto send_time = ActorProfiler::Now();
+    ActorProfiler::GetInstance().Record(this, ActorTraceEventType::kSend, send_time, send_time);
+  }
   // Must be the execution order: send data --> send control, avoid the illegal timing problem.
   // 1.Send output data.
   if (((output_data_arrows_.size() != output_data_.size()) ||
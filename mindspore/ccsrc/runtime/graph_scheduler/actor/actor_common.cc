@@ -17,6 +17,7 @@
 #include "runtime/graph_scheduler/actor/actor_common.h"
 #include <memory>
 #include "runtime/graph_scheduler/device_tensor_store.h"
+#include "runtime/graph_scheduler/memory_plan_cache.h"
 #include "utils/ms_context.h"
 #include "include/common/utils/anfalgo.h"
 #include "ps/ps_context.h"
@@ -28,6 +29,8 @@ bool ActorDispatcher::is_memory_allocation_sync_ = true;
 bool ActorDispatcher::is_memory_free_sync_ = true;
 
 constexpr char kLaunchSkippedEnv[] = "MS_KERNEL_LAUNCH_SKIP";
+constexpr char kDynamicShapePrefetchEnv[] = "MS_DEV_DYNAMIC_SHAPE_PREFETCH";
+constexpr char kHostTensorBindingEnv[] = "MS_DEV_HOST_TENSOR_BINDING";
 
 bool IsRunningFailed(const OpContext<DeviceTensor> *context) {
   MS_EXCEPTION_IF_NULL(context);
@@ -189,6 +192,16 @@ bool IsMemoryActor(KernelTransformType actor_type) {
           (actor_type == KernelTransformType::kMemoryFreeActor));
 }
 
+bool EnableDynamicShapePrefetch() {
+  static bool enable_prefetch = (common::GetEnv(kDynamicShapePrefetchEnv) == "1");
+  return enable_prefetch;
+}
+
+bool EnableHostTensorBinding() {
+  static bool enable_binding = (common::GetEnv(kHostTensorBindingEnv) == "1");
+  return enable_binding;
+}
+
 bool IsSkippedLaunch(const CNodePtr &kernel, const KernelGraphPtr &kernel_graph) {
   static std::string launch_skipped = "";
   static bool first_get_launch_skipped_env = true;
@@ -266,6 +279,10 @@ void UpdateRefCount(const AnfNodePtr &node, size_t output_idx, bool is_max_ref_c
 
 void FreeMemoryByDeviceContext(DeviceTensor *const device_tensor, const DeviceContext *device_context) {
   MS_EXCEPTION_IF_NULL(device_tensor);
+  // The memory assigned by the cached memory plan is released with the whole block instead of the memory pool.
+  if (MemoryPlanCache::GetInstance().FreeMemory(device_tensor)) {
+    return;
+  }
   // The device context may be not accurate in the control flow scene, so need fetch by device name and device id.
   if ((device_context == nullptr) || (device_context->GetDeviceType() != device_tensor->GetDeviceType())) {
     const auto &new_device_context = device::DeviceContextManager::GetInstance().GetOrCreateDeviceContext(
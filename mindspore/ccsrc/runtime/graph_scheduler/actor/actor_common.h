@@ -282,6 +282,12 @@ bool IsControlFlowActor(KernelTransformType actor_type);
 
 bool IsMemoryActor(KernelTransformType actor_type);
 
+// Judge whether prefetch the memory of dynamic shape kernel after resize by the env MS_DEV_DYNAMIC_SHAPE_PREFETCH.
+bool EnableDynamicShapePrefetch();
+
+// Judge whether bind the host tensor buffer to the device tensor of graph input by the env MS_DEV_HOST_TENSOR_BINDING.
+bool EnableHostTensorBinding();
+
 // Judge whether skip the launch by the env MS_KERNEL_LAUNCH_SKIP.
 bool IsSkippedLaunch(const CNodePtr &kernel, const KernelGraphPtr &kernel_graph);
 
@@ -16,6 +16,7 @@
 
 #include "runtime/graph_scheduler/actor/custom_actor.h"
 #include "runtime/graph_scheduler/actor/memory_manager_actor.h"
+#include "runtime/graph_scheduler/actor/kernel_actor.h"
 #include "utils/log_adapter.h"
 #include "utils/anf_utils.h"
 
@@ -76,6 +77,12 @@ void CustomActor::Run(OpContext<DeviceTensor> *const ctx) {
       // Update the shape of internal parameter.
       AnfAlgo::UpdateInternalParameterShape(internal_parameters_, base_node);
     }
+
+    // The output and workspace size of kernel are determined after the resize, so the memory can be allocated in
+    // advance and the kernel actor doesn't need to wait for the memory allocation.
+    if (prefetch_kernel_actor_ != nullptr) {
+      prefetch_kernel_actor_->PrefetchMemory(ctx);
+    }
   } catch (const std::exception &e) {
     if (strategy_ == GraphExecutionStrategy::kPipeline) {
       MsException::Instance().SetException();
@@ -26,6 +26,8 @@
 
 namespace mindspore {
 namespace runtime {
+class KernelActor;
+
 class CustomActor : public AbstractActor {
  public:
   CustomActor(const std::string &name, const AnfNodePtr &kernel, const device::DeviceContext *device_context,
@@ -56,6 +58,8 @@ class CustomActor : public AbstractActor {
   GraphExecutionStrategy strategy_{GraphExecutionStrategy::kPipeline};
   // The device tensors for launch.
   std::vector<DeviceTensor *> input_device_tensors_;
+  // The kernel actor of base node whose memory is prefetched after the resize of init custom actor.
+  KernelActor *prefetch_kernel_actor_{nullptr};
 };
 
 using CustomActorPtr = std::shared_ptr<CustomActor>;
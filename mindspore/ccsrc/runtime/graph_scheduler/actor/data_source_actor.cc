@@ -26,6 +26,27 @@
 
 namespace mindspore {
 namespace runtime {
+namespace {
+// The host tensor can be bound to the device tensor only when the device memory is the host memory and the data needn't
+// be converted. The device tensor which holds the persisted or ref ptr can't be bound, because the ptr may be modified.
+bool CanBindHostTensor(const TensorPtr &host_tensor, const DeviceTensor *device_tensor,
+                       const DeviceContext *device_context) {
+  MS_EXCEPTION_IF_NULL(host_tensor);
+  MS_EXCEPTION_IF_NULL(device_tensor);
+  MS_EXCEPTION_IF_NULL(device_context);
+  if ((device_context->GetDeviceType() != device::DeviceType::kCPU) || (host_tensor->device_address() != nullptr) ||
+      device_tensor->IsPtrValid() || device_tensor->is_ptr_persisted() ||
+      TEST_FLAG(device_tensor->flag(), device::kDeviceAddressFlagRefNode)) {
+    return false;
+  }
+  if ((host_tensor->data_type() != device_tensor->type_id()) ||
+      (LongToSize(host_tensor->data().nbytes()) != device_tensor->GetSize())) {
+    return false;
+  }
+  return host_tensor->data_c() != nullptr;
+}
+}  // namespace
+
 void DataSourceActor::Init() {
   // Check device contexts number.
   if (device_contexts_.size() < device::kDeviceContextsNumOne) {
@@ -209,6 +230,7 @@ void HostQueueDataSourceActor::SendMemoryAllocReq(OpContext<DeviceTensor> *const
     SET_OPCONTEXT_FAIL_RET_WITH_ERROR((*context), "Empty device contexts in device data source actor.");
   }
   auto &device_tensors = buffers_.back();
+  BindHostTensors(device_tensors);
   if (ActorDispatcher::is_memory_allocation_sync()) {
     if (IsSameDeviceType()) {
       ActorDispatcher::SendSync(memory_manager_aid_, &MemoryManagerActor::AllocateMemory, &device_tensors,
@@ -280,6 +302,10 @@ void HostQueueDataSourceActor::OnMemoryAllocFinish(OpContext<DeviceTensor> *cons
     auto &device_tensor = device_tensors[i];
     MS_EXCEPTION_IF_NULL(device_tensor);
     MS_EXCEPTION_IF_NULL(host_tensor);
+    // The device tensor which is bound to the host tensor shares the same buffer, so the copy is unnecessary.
+    if (device_tensor->IsHostTensorBound()) {
+      continue;
+    }
     auto tensor_device_address = std::dynamic_pointer_cast<DeviceTensor>(host_tensor->device_address());
     // Sync data from host_tensor_device_address to device_tensor.
     if (tensor_device_address != nullptr) {
@@ -322,6 +348,32 @@ KernelWithIndex HostQueueDataSourceActor::FetchNode(size_t node_position) const
   return data_node_with_indexs_[node_position];
 }
 
+void HostQueueDataSourceActor::BindHostTensors(const std::vector<DeviceTensor *> &device_tensors) {
+  // The host tensors bound in the last step need be unbound, because their buffers are owned by the user.
+  for (auto &device_tensor : device_tensors) {
+    MS_EXCEPTION_IF_NULL(device_tensor);
+    device_tensor->UnbindHostTensor();
+  }
+  MS_EXCEPTION_IF_NULL(host_queue_);
+  if ((!EnableHostTensorBinding()) || host_queue_->IsEmpty()) {
+    return;
+  }
+
+  // The invalid size is checked in the OnMemoryAllocFinish.
+  auto &host_tensors = host_queue_->Pull();
+  if ((host_tensors.size() != device_tensors.size()) || (device_contexts_.size() < device_tensors.size())) {
+    return;
+  }
+  for (size_t i = 0; i < host_tensors.size(); ++i) {
+    if ((host_tensors[i] == nullptr) || (!CanBindHostTensor(host_tensors[i], device_tensors[i], device_contexts_[i]))) {
+      continue;
+    }
+    MS_LOG(DEBUG) << "Bind the host tensor:" << host_tensors[i]->ToString() << " to device tensor:" << device_tensors[i]
+                  << " of data node:" << data_node_with_indexs_[i].first->DebugString();
+    device_tensors[i]->BindHostTensor(host_tensors[i]);
+  }
+}
+
 bool HostQueueDataSourceActor::IsSameDeviceType() const {
   for (size_t i = 1; i < device_contexts_.size(); i++) {
     if (device_contexts_[i] != device_contexts_[0]) {
@@ -140,6 +140,9 @@ class HostQueueDataSourceActor : public DataSourceActor {
 
   // Judge all the data_nodes_ is from the same device.
   bool IsSameDeviceType() const;
+  // Bind the host tensors as the device tensors of data nodes to avoid the data copy in the CPU device, refer to
+  // DeviceAddress::BindHostTensor.
+  void BindHostTensors(const std::vector<DeviceTensor *> &device_tensors);
 
   HostTensorQueuePtr host_queue_;
   // Input data nodes fetch data from host queue.
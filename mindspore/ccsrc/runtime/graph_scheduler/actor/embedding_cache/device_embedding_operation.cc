@@ -20,6 +20,7 @@
 #include "backend/common/optimizer/dynamic_shape/dynamic_shape_helper.h"
 #include "runtime/graph_scheduler/actor/embedding_cache/embedding_cache_prefetch_actor.h"
 #include "runtime/graph_scheduler/actor/embedding_cache/device_embedding_operation.h"
+#include "runtime/device/host_staging_mem_pool.h"
 
 namespace mindspore {
 namespace runtime {
@@ -50,14 +51,17 @@ bool DeviceEmbeddingOperation::PullCacheFromLocalHostToDevice(const HashTableInf
   auto cache_vocab_size = hash_info.cache_vocab_size;
   MS_ERROR_IF_NULL(hash_info.host_address);
   auto host_hash_table_addr = reinterpret_cast<float *>(hash_info.host_address.get());
-  auto swap_out_data = std::make_unique<float[]>(swap_indices_size * embedding_size);
+  // The swap buffer is recycled by the host staging memory pool to avoid faulting in the pages every step.
+  auto swap_out_mem =
+    device::HostStagingMemPool::GetInstance()->MallocShared(swap_indices_size * embedding_size * sizeof(float));
+  auto swap_out_data = static_cast<float *>(swap_out_mem.get());
   RETURN_IF_FALSE_WITH_LOG(actor_->LookupLocalHostCache(embedding_size, swap_indices_size, host_hash_table_addr,
-                                                        host_cache_host_to_device_index, swap_out_data.get()),
+                                                        host_cache_host_to_device_index, swap_out_data),
                            "Lookup local host cache failed.");
 
   RETURN_IF_FALSE_WITH_LOG(
     MemcpyHostToDeviceAsync(embedding_cache_table_manager.embedding_device_cache_->hash_swap_value_addr_,
-                            swap_out_data.get(), swap_indices_size * embedding_size * sizeof(float), device_context_,
+                            swap_out_data, swap_indices_size * embedding_size * sizeof(float), device_context_,
                             stream_id_),
     "Memcpy host to device asynchronously failed.");
   RETURN_IF_FALSE_WITH_LOG(
@@ -96,7 +100,10 @@ bool DeviceEmbeddingOperation::PushCacheFromDeviceToLocalHost(const HashTableInf
   auto cache_vocab_size = hash_info.cache_vocab_size;
   auto host_hash_table_addr = reinterpret_cast<float *>(hash_info.host_address.get());
   auto embedding_size = hash_info.embedding_size;
-  auto swap_out_data = std::make_unique<float[]>(swap_indices_size * embedding_size);
+  // The swap buffer is recycled by the host staging memory pool to avoid faulting in the pages every step.
+  auto swap_out_mem =
+    device::HostStagingMemPool::GetInstance()->MallocShared(swap_indices_size * embedding_size * sizeof(float));
+  auto swap_out_data = static_cast<float *>(swap_out_mem.get());
 
   RETURN_IF_FALSE_WITH_LOG(
     MemcpyHostToDeviceAsync(embedding_cache_table_manager.embedding_device_cache_->hash_swap_index_addr_,
@@ -111,7 +118,7 @@ bool DeviceEmbeddingOperation::PushCacheFromDeviceToLocalHost(const HashTableInf
     "Lookup device cache failed.");
 
   RETURN_IF_FALSE_WITH_LOG(
-    MemcpyDeviceToHostAsync(swap_out_data.get(),
+    MemcpyDeviceToHostAsync(swap_out_data,
                             embedding_cache_table_manager.embedding_device_cache_->hash_swap_value_addr_,
                             swap_indices_size * embedding_size * sizeof(float), device_context_, stream_id_),
     "Memcpy device to host asynchronously failed.");
@@ -121,7 +128,7 @@ bool DeviceEmbeddingOperation::PushCacheFromDeviceToLocalHost(const HashTableInf
   RETURN_IF_FALSE_WITH_LOG(device_context_->device_res_manager_->SyncStream(stream_id_), "Synchronize stream failed.");
   RETURN_IF_FALSE_WITH_LOG(
     actor_->InsertLocalHostCache(embedding_size, IntToSize(swap_indices_size), host_cache_device_to_host_index,
-                                 swap_out_data.get(), host_hash_table_addr),
+                                 swap_out_data, host_hash_table_addr),
     "Insert local host cache failed.");
   return true;
 }
@@ -19,6 +19,8 @@
 #include "runtime/graph_scheduler/actor/output_actor.h"
 #include "runtime/graph_scheduler/actor/recorder_actor.h"
 #include "runtime/graph_scheduler/actor/debug_actor.h"
+#include "runtime/graph_scheduler/memory_plan_cache.h"
+#include "runtime/graph_scheduler/actor_profiler.h"
 #include "mindrt/include/async/async.h"
 #include "utils/log_adapter.h"
 #include "distributed/recovery/recovery_context.h"
@@ -168,6 +170,12 @@ void KernelActor::Run(OpContext<DeviceTensor> *const context) {
   MS_EXCEPTION_IF_NULL(device_contexts_[0]);
 
   FetchInputDeviceTensor(context);
+  // The output and workspace device tensors have been fetched and allocated in the prefetch.
+  if (TakePrefetchedMemory(context)) {
+    OnMemoryAllocFinish(context);
+    return;
+  }
+
   FetchOutputDeviceTensor(context);
   if (is_dynamic_shape_) {
     FetchWorkspaceDeviceTensor();
@@ -255,7 +263,7 @@ void FreeMemory(const std::vector<DeviceTensor *> &free_list, const DeviceContex
     device_tensor->DecreaseRefCount();
     if (device_tensor->ref_count() == 0) {
       // Free memory through the device context.
-      if (device_tensor->GetPtr() != nullptr) {
+      if ((device_tensor->GetPtr() != nullptr) && !MemoryPlanCache::GetInstance().FreeMemory(device_tensor)) {
         device_context->device_res_manager_->FreeMemory(device_tensor);
       }
       device_tensor->ClearUserData();
@@ -265,6 +273,58 @@ void FreeMemory(const std::vector<DeviceTensor *> &free_list, const DeviceContex
 }
 }  // namespace
 
+void KernelActor::PrefetchMemory(OpContext<DeviceTensor> *const context) {
+  MS_EXCEPTION_IF_NULL(context);
+  if ((!is_dynamic_shape_) || IsRunningFailed(context)) {
+    return;
+  }
+  if (device_contexts_.empty() || device_contexts_[0] == nullptr) {
+    SET_OPCONTEXT_FAIL_RET_WITH_ERROR_BY_STRATEGY(strategy_, (*context),
+                                                  "Invalid device context for kernel actor:" + GetAID().Name());
+  }
+
+  // The size of output and workspace is updated after the kernel resize.
+  FetchOutputDeviceTensor(context);
+  FetchWorkspaceDeviceTensor();
+  // The run of the prefetched step skips the fetch, so the memory address of the somas tensors is also set here.
+  SetSomasMemory(context);
+  if (IsRunningFailed(context)) {
+    return;
+  }
+
+  for (auto &device_tensor : memory_alloc_list_) {
+    MS_EXCEPTION_IF_NULL(device_tensor);
+    if (device_tensor->IsPtrValid() || (device_tensor->GetSize() == 0) ||
+        MemoryPlanCache::GetInstance().AllocateMemory(device_tensor, device_contexts_[0])) {
+      continue;
+    }
+    device::DynamicMemAllocatorDebugInfo::SetDebugInfo(GetAID().Name(), device::AllocatorType::kKernelOutput);
+    if (!device_contexts_[0]->device_res_manager_->AllocateMemory(device_tensor)) {
+      SET_OPCONTEXT_MEMORY_ALLOC_FAIL_BY_STRATEGY(strategy_, *context, *(device_contexts_[0]), GetAID().Name(),
+                                                  device_tensor->GetSize());
+    }
+  }
+  if (IsRunningFailed(context)) {
+    return;
+  }
+  is_memory_prefetched_ = true;
+  prefetched_sequential_num_ = context->sequential_num_;
+}
+
+bool KernelActor::TakePrefetchedMemory(const OpContext<DeviceTensor> *const context) {
+  MS_EXCEPTION_IF_NULL(context);
+  if (!is_memory_prefetched_) {
+    return false;
+  }
+  is_memory_prefetched_ = false;
+  // The prefetch of an aborted step is stale, and the memory is fetched and allocated again.
+  if (prefetched_sequential_num_ != context->sequential_num_) {
+    MS_LOG(INFO) << "The memory prefetched in the aborted step is stale for actor: " << GetAID().Name();
+    return false;
+  }
+  return true;
+}
+
 void KernelActor::SetSomasMemory(OpContext<DeviceTensor> *const context) const {
   MS_EXCEPTION_IF_NULL(context);
   MS_EXCEPTION_IF_NULL(kernel_info_);
@@ -351,6 +411,8 @@ void KernelActor::SendMemoryAllocReq(OpContext<DeviceTensor> *const context) {
 }
 
 void KernelActor::SendMemoryFreeReq(OpContext<DeviceTensor> *const context) {
+  // The prefetched memory is consumed or released in this step.
+  is_memory_prefetched_ = false;
   if (device_contexts_.empty() || device_contexts_[0] == nullptr) {
     MS_LOG(EXCEPTION) << "Invalid device context for kernel actor:" << GetAID();
   }
@@ -390,6 +452,7 @@ void KernelActor::OnMemoryAllocFinish(OpContext<DeviceTensor> *const context) {
       MS_LOG(WARNING) << "Collective communication need reinitialize, skip launch kernel: "
                       << kernel_->fullname_with_scope();
     } else if (!IsSkippedLaunch(kernel_, nullptr)) {
+      ActorProfilerScope profiler_scope(this, ActorTraceEventType::kLaunch);
       auto ret = LaunchKernel(context);
       if (!ret) {
         std::string error_info = "Launch kernel failed: " + kernel_->fullname_with_scope();
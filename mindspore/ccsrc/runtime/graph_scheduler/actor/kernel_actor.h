@@ -80,6 +80,10 @@ class KernelActor : public DebugAwareActor {
   // The callback after memory alloc finished.
   void OnMemoryAllocFinish(OpContext<DeviceTensor> *const context) override;
 
+  // Prefetch the output and workspace memory after the kernel resized in the dynamic shape scenario, which is called by
+  // the init custom actor of kernel, so the memory allocation is overlapped with the launch of previous kernels.
+  void PrefetchMemory(OpContext<DeviceTensor> *const context);
+
   // The debug related operation interface.
   void SendDebugReq(OpContext<DeviceTensor> *const context) override;
   // The callback after debug finished.
@@ -159,6 +163,9 @@ class KernelActor : public DebugAwareActor {
   void SetSomasMemory(OpContext<DeviceTensor> *const context) const;
   void *GetSomasDevicePtr(size_t offset) const;
 
+  // Consume the prefetch of memory, return whether the memory has been prefetched in the step of context.
+  bool TakePrefetchedMemory(const OpContext<DeviceTensor> *const context);
+
   // The real input number of kernel launch.
   size_t real_input_num_;
 
@@ -179,6 +186,11 @@ class KernelActor : public DebugAwareActor {
 
   // The information used for integration of dynamic and static memory.
   SomasInfo *somas_info_;
+
+  // Whether the output and workspace memory has been prefetched by the init custom actor in this step.
+  bool is_memory_prefetched_{false};
+  // The sequential number of the step which prefetches the memory, used to discard the prefetch of an aborted step.
+  int prefetched_sequential_num_{0};
 };
 
 using KernelActorPtr = std::shared_ptr<KernelActor>;
@@ -17,12 +17,37 @@
 #include "runtime/graph_scheduler/actor/memory_manager_actor.h"
 #include "runtime/graph_scheduler/actor/data_source_actor.h"
 #include "runtime/graph_scheduler/actor/kernel_actor.h"
+#include "runtime/graph_scheduler/memory_plan_cache.h"
 #include "mindrt/include/async/async.h"
 #include "utils/log_adapter.h"
+#include "utils/ms_utils.h"
 
 namespace mindspore {
 namespace runtime {
 namespace {
+constexpr char kMemPoolCompactThresholdEnv[] = "MS_DEV_MEM_POOL_COMPACT_THRESHOLD";
+
+// The fragmentation ratio to trigger the memory compaction, zero means the compaction is disabled.
+double GetMemoryCompactThreshold() {
+  static const double threshold = []() {
+    const auto &env = common::GetEnv(kMemPoolCompactThresholdEnv);
+    if (env.empty()) {
+      return 0.0;
+    }
+    double value = 0;
+    try {
+      value = std::stod(env);
+    } catch (const std::exception &e) {
+      MS_LOG(EXCEPTION) << "Invalid env " << kMemPoolCompactThresholdEnv << ": " << env;
+    }
+    if (value <= 0 || value > 1) {
+      MS_LOG(EXCEPTION) << "The env " << kMemPoolCompactThresholdEnv << " should be in range (0, 1], but got " << env;
+    }
+    return value;
+  }();
+  return threshold;
+}
+
 void OnMemoryAllocFinish(const AID &from_aid, OpContext<DeviceTensor> *const op_context) {
   if (!ActorDispatcher::is_memory_allocation_sync()) {
     ActorDispatcher::Send(from_aid, &MemoryAwareActor::OnMemoryAllocFinish, op_context);
@@ -42,6 +67,10 @@ void MemoryManagerActor::AllocateMemory(const std::vector<DeviceTensor *> *alloc
     if (device_tensor->IsPtrValid()) {
       continue;
     }
+    // The memory of device tensor may be assigned by the cached memory plan in the dynamic shape scenario.
+    if (MemoryPlanCache::GetInstance().AllocateMemory(device_tensor, device_context)) {
+      continue;
+    }
     try {
       // Allocate memory through the device context.
       device::DynamicMemAllocatorDebugInfo::SetDebugInfo(from_aid.Name(), device::AllocatorType::kKernelOutput);
@@ -49,6 +78,9 @@ void MemoryManagerActor::AllocateMemory(const std::vector<DeviceTensor *> *alloc
         SetOpContextMemoryAllocFail(from_aid.Name(), device_context, device_tensor->GetSize(), op_context);
         return;
       }
+      if (IsMemoryCompactEnabled()) {
+        AddMovableMemory(device_tensor, device_context);
+      }
     } catch (const std::exception &e) {
       SetOpContextMemoryAllocFail(from_aid.Name(), device_context, device_tensor->GetSize(), op_context);
       return;
@@ -150,6 +182,9 @@ void MemoryManagerActor::AllocateBatchMemory(const std::vector<DeviceTensor *> *
         SetOpContextMemoryAllocFail(from_aid.Name(), device_context, device_tensor->GetSize(), op_context);
         return;
       }
+      if (IsMemoryCompactEnabled()) {
+        AddMovableMemory(device_tensor, device_context);
+      }
     } catch (const std::exception &e) {
       SetOpContextMemoryAllocFail(from_aid.Name(), device_context, device_tensor->GetSize(), op_context);
       return;
@@ -294,6 +329,7 @@ void MemoryManagerActor::FreeMemoryByRefCount(DeviceTensor *const device_tensor,
       if (device_tensor->GetPtr() != nullptr) {
         auto held_by_nodes = device_tensor->held_by_nodes();
         if (held_by_nodes.empty()) {
+          RemoveMovableMemory(device_tensor);
           FreeMemoryByDeviceContext(device_tensor, device_context);
         } else {
           FreeMemoryByValueNode(held_by_nodes, device_tensor);
@@ -306,11 +342,59 @@ void MemoryManagerActor::FreeMemoryByRefCount(DeviceTensor *const device_tensor,
     if ((device_tensor->dynamic_ref_count() == 0) && (device_tensor->GetPtr() != nullptr)) {
       device_tensor->ClearUserData();
       MS_LOG(DEBUG) << "Free memory by the dynamic reference count, device address" << device_tensor->GetPtr();
+      RemoveMovableMemory(device_tensor);
       FreeMemoryByDeviceContext(device_tensor, device_context);
     }
   }
 }
 
+bool MemoryManagerActor::IsMemoryCompactEnabled() { return GetMemoryCompactThreshold() > 0; }
+
+void MemoryManagerActor::AddMovableMemory(DeviceTensor *const device_tensor, const DeviceContext *device_context) {
+  MS_EXCEPTION_IF_NULL(device_tensor);
+  std::lock_guard<std::mutex> locker(movable_memory_mutex_);
+  movable_memory_[device_tensor->GetMutablePtr()] = std::make_pair(device_tensor, device_context);
+}
+
+void MemoryManagerActor::RemoveMovableMemory(const DeviceTensor *device_tensor) {
+  MS_EXCEPTION_IF_NULL(device_tensor);
+  if (!IsMemoryCompactEnabled()) {
+    return;
+  }
+  std::lock_guard<std::mutex> locker(movable_memory_mutex_);
+  const auto &iter = movable_memory_.find(device_tensor->GetMutablePtr());
+  if (iter != movable_memory_.end() && iter->second.first == device_tensor) {
+    (void)movable_memory_.erase(iter);
+  }
+}
+
+void MemoryManagerActor::CompactMemory() {
+  std::lock_guard<std::mutex> locker(movable_memory_mutex_);
+  std::set<const DeviceContext *> device_contexts;
+  for (const auto &item : movable_memory_) {
+    (void)device_contexts.insert(item.second.second);
+  }
+  for (const auto &device_context : device_contexts) {
+    MS_EXCEPTION_IF_NULL(device_context);
+    MS_EXCEPTION_IF_NULL(device_context->device_res_manager_);
+    // The memory whose device tensor doesn't hold it any more may be shared by the other owners, and can't be moved.
+    auto is_movable = [this, device_context](void *ptr) {
+      const auto &iter = movable_memory_.find(ptr);
+      return (iter != movable_memory_.end()) && (iter->second.second == device_context) &&
+             (iter->second.first->GetMutablePtr() == ptr) && iter->second.first->held_by_nodes().empty();
+    };
+    const auto &relocations =
+      device_context->device_res_manager_->CompactMemory(GetMemoryCompactThreshold(), is_movable);
+    for (const auto &relocation : relocations) {
+      auto device_tensor = movable_memory_[relocation.first].first;
+      MS_EXCEPTION_IF_NULL(device_tensor);
+      device_tensor->set_ptr(relocation.second);
+    }
+  }
+  // The device tensors may be destroyed after the step, so only the memory allocated in the next step can be moved.
+  movable_memory_.clear();
+}
+
 void MemoryManagerActor::SetOpContextMemoryAllocFail(const std::string &kernel_name,
                                                      const DeviceContext *device_context, size_t alloc_size,
                                                      OpContext<DeviceTensor> *const op_context) {
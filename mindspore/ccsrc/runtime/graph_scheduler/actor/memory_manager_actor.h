@@ -22,6 +22,7 @@
 #include <string>
 #include <set>
 #include <mutex>
+#include <utility>
 #include "utils/hash_map.h"
 #include "runtime/graph_scheduler/actor/actor_common.h"
 #include "runtime/graph_scheduler/device_tensor_store.h"
@@ -70,10 +71,20 @@ class MemoryManagerActor : public ActorBase {
   // Wait the MemoryManagerActor to finish running all current messages.
   void Wait(OpContext<DeviceTensor> *const op_context, const AID &from_aid);
 
+  // Whether compact the memory pool at the step boundary, which is enabled by the env MS_DEV_MEM_POOL_COMPACT_THRESHOLD
+  // as the fragmentation ratio of memory pool to trigger the compaction.
+  static bool IsMemoryCompactEnabled();
+  // Compact the memory pools by moving the memory of device tensors which are allocated in this step and still alive,
+  // and update the device tensors by the moved memory. It must be called at the step boundary.
+  void CompactMemory();
+
  private:
   void FreeMemoryByRefCount(DeviceTensor *const device_tensor, const DeviceContext *device_context,
                             const std::string &op_name);
 
+  void AddMovableMemory(DeviceTensor *const device_tensor, const DeviceContext *device_context);
+  void RemoveMovableMemory(const DeviceTensor *device_tensor);
+
   // When allocate device memory fail, print error log and set op context failed status.
   void SetOpContextMemoryAllocFail(const std::string &kernel_name, const DeviceContext *device_context,
                                    size_t alloc_size, OpContext<DeviceTensor> *const op_context);
@@ -86,6 +97,11 @@ class MemoryManagerActor : public ActorBase {
 
   // The memory free by the ref count maybe triggered concurrently, and the ref count decreased need the lock.
   std::mutex mem_free_mutex_;
+
+  // The memory allocated from the memory pool in this step, which can be moved by the compaction. Key is the device
+  // ptr, value is the device tensor and the device context which allocates the memory.
+  mindspore::HashMap<void *, std::pair<DeviceTensor *, const DeviceContext *>> movable_memory_;
+  std::mutex movable_memory_mutex_;
 };
 }  // namespace runtime
 }  // namespace mindspore
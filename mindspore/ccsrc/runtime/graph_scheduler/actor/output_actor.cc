@@ -33,6 +33,11 @@ bool IsOutputAddressPersisted(const DeviceTensor *output_device_tensor, const Ke
     return true;
   }
 
+  // The bound ptr is the buffer of input host tensor owned by the user, refer to DeviceAddress::BindHostTensor.
+  if (output_device_tensor->IsHostTensorBound()) {
+    return true;
+  }
+
   if (output_node.first->isa<ValueNode>()) {
     return true;
   }
@@ -0,0 +1,452 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "runtime/graph_scheduler/actor_profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <utility>
+#include "nlohmann/json.hpp"
+#include "runtime/graph_scheduler/actor/abstract_actor.h"
+#include "include/common/debug/common.h"
+#include "mindspore/core/utils/file_utils.h"
+#include "profiler/device/profiling.h"
+#include "utils/log_adapter.h"
+
+namespace mindspore {
+namespace runtime {
+namespace {
+constexpr char kActorProfilerEnv[] = "MS_DEV_ACTOR_PROFILER";
+// The event capacity of ring buffer for one actor thread.
+constexpr size_t kRingBufferCapacity = 1 << 16;
+// Only the first steps of each actor set are exported to the trace files, to avoid too many files in the training.
+constexpr size_t kMaxExportStepNum = 10;
+constexpr double kNanosecondsToMicroseconds = 1000.0;
+constexpr size_t kPermilleBase = 1000;
+
+thread_local ActorTraceRingBuffer *thread_buffer = nullptr;
+
+struct ActorRunInfo {
+  const ActorTraceRecord *record_;
+  // The time of sending output in this running, which is the end of running if the actor doesn't send output.
+  uint64_t exec_end_;
+};
+
+const char *GetEventTypeName(ActorTraceEventType type) {
+  switch (type) {
+    case ActorTraceEventType::kRun:
+      return "run";
+    case ActorTraceEventType::kLaunch:
+      return "launch";
+    case ActorTraceEventType::kSend:
+      return "send";
+    default:
+      return "unknown";
+  }
+}
+
+// Get the latest time of input actor sending output before the time, return false if the input actor has not sent.
+bool GetInputReadyTime(const std::vector<ActorRunInfo> &input_runs, const std::vector<uint64_t> &input_sends,
+                       uint64_t time, uint64_t *ready_time) {
+  auto send_iter = std::upper_bound(input_sends.begin(), input_sends.end(), time);
+  if (send_iter != input_sends.begin()) {
+    *ready_time = *(--send_iter);
+    return true;
+  }
+  // The input actor which doesn't send output by itself, such as the control flow actors.
+  bool is_found = false;
+  for (const auto &run_info : input_runs) {
+    if ((run_info.exec_end_ <= time) && ((!is_found) || (run_info.exec_end_ > *ready_time))) {
+      *ready_time = run_info.exec_end_;
+      is_found = true;
+    }
+  }
+  return is_found;
+}
+
+// Get the latest running of actor which starts before the time.
+const ActorRunInfo *GetRunInfoBefore(const std::vector<ActorRunInfo> &runs, uint64_t time) {
+  const ActorRunInfo *run_info = nullptr;
+  for (const auto &run : runs) {
+    if (run.record_->start_ > time) {
+      break;
+    }
+    run_info = &run;
+  }
+  return run_info;
+}
+
+uint64_t GetThreadBusyTime(std::vector<std::pair<uint64_t, uint64_t>> *spans) {
+  MS_EXCEPTION_IF_NULL(spans);
+  std::sort(spans->begin(), spans->end());
+  uint64_t busy_time = 0;
+  uint64_t current_start = 0;
+  uint64_t current_end = 0;
+  bool has_span = false;
+  for (const auto &span : *spans) {
+    if (has_span && (span.first <= current_end)) {
+      current_end = std::max(current_end, span.second);
+      continue;
+    }
+    if (has_span) {
+      busy_time += current_end - current_start;
+    }
+    current_start = span.first;
+    current_end = span.second;
+    has_span = true;
+  }
+  if (has_span) {
+    busy_time += current_end - current_start;
+  }
+  return busy_time;
+}
+}  // namespace
+
+size_t ActorTraceRingBuffer::Drain(std::vector<ActorTraceEvent> *events) {
+  MS_EXCEPTION_IF_NULL(events);
+  size_t capacity = events_.size();
+  size_t event_num = std::min(write_index_, capacity);
+  size_t begin_index = (write_index_ > capacity) ? (write_index_ % capacity) : 0;
+  for (size_t i = 0; i < event_num; ++i) {
+    (void)events->emplace_back(events_[(begin_index + i) % capacity]);
+  }
+  size_t dropped_num = write_index_ - event_num;
+  write_index_ = 0;
+  return dropped_num;
+}
+
+bool ActorProfiler::IsEnabled() {
+  static bool is_enabled = (common::GetEnv(kActorProfilerEnv) == "1");
+  return is_enabled;
+}
+
+uint64_t ActorProfiler::Now() {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void ActorProfiler::BeginStep(const std::string &actor_set_name) {
+  actor_set_name_ = actor_set_name;
+  step_ = step_nums_[actor_set_name_]++;
+  // Discard the events which are recorded out of the step.
+  (void)CollectRecords();
+  dropped_event_num_ = 0;
+  is_running_ = true;
+}
+
+void ActorProfiler::AbortStep() {
+  StopRecording();
+  (void)CollectRecords();
+}
+
+void ActorProfiler::EndStep(const std::vector<AbstractActorPtr> &actors) {
+  StopRecording();
+  auto records = CollectRecords();
+  if (dropped_event_num_ > 0) {
+    MS_LOG(WARNING) << "The actor trace events are overwritten in the ring buffers, dropped event number:"
+                    << dropped_event_num_ << ", actor set:" << actor_set_name_ << ", step:" << step_;
+  }
+
+  // Collect the input actors, the sub actors in the fusion actor run with their own inputs.
+  mindspore::HashMap<std::string, std::vector<std::string>> actor_inputs;
+  std::vector<const AbstractActor *> unvisited_actors;
+  for (const auto &actor : actors) {
+    (void)unvisited_actors.emplace_back(actor.get());
+  }
+  while (!unvisited_actors.empty()) {
+    const auto actor = unvisited_actors.back();
+    unvisited_actors.pop_back();
+    MS_EXCEPTION_IF_NULL(actor);
+    auto &inputs = actor_inputs[actor->GetAID().Name()];
+    for (const auto &input_data_arrow_aid : actor->input_data_arrow_aids()) {
+      (void)inputs.emplace_back(input_data_arrow_aid.first.Name());
+    }
+    for (const auto &input_control_arrow_aid : actor->input_control_arrow_aids()) {
+      (void)inputs.emplace_back(input_control_arrow_aid.first.Name());
+    }
+    for (const auto &sub_actor : actor->sub_actors()) {
+      (void)unvisited_actors.emplace_back(sub_actor.second.get());
+    }
+  }
+
+  auto summary = Analyze(records, actor_inputs);
+  MS_LOG(INFO) << "The actor profiler of actor set:" << actor_set_name_ << ", step:" << step_
+               << ", step time:" << summary.step_time_ << "ns, critical path time:" << summary.critical_path_time_
+               << "ns, critical path actor num:" << summary.critical_path_.size()
+               << ", thread idle ratio:" << summary.thread_idle_ratio_;
+  for (const auto &node : summary.critical_path_) {
+    MS_LOG(DEBUG) << "Critical path actor:" << node.actor_name_ << ", thread:" << node.thread_index_
+                  << ", queue time:" << node.queue_time_ << "ns, exec time:" << node.exec_time_ << "ns";
+  }
+  RecordStatistics(summary);
+  if (step_ < kMaxExportStepNum) {
+    ExportChromeTrace(records, summary);
+  }
+}
+
+void ActorProfiler::Record(const AbstractActor *actor, ActorTraceEventType type, uint64_t start, uint64_t end) {
+  // The recording number is increased before checking the running status, so the step end can wait the recordings
+  // which have passed the checking.
+  ++recording_num_;
+  if (is_running_) {
+    auto buffer = GetThreadBuffer();
+    MS_EXCEPTION_IF_NULL(buffer);
+    buffer->Push({actor, type, start, end});
+  }
+  --recording_num_;
+}
+
+void ActorProfiler::StopRecording() {
+  is_running_ = false;
+  while (recording_num_ > 0) {
+    std::this_thread::yield();
+  }
+}
+
+ActorTraceRingBuffer *ActorProfiler::GetThreadBuffer() {
+  if (thread_buffer == nullptr) {
+    std::lock_guard<std::mutex> locker(buffers_mutex_);
+    (void)buffers_.emplace_back(std::make_unique<ActorTraceRingBuffer>(buffers_.size(), kRingBufferCapacity));
+    thread_buffer = buffers_.back().get();
+  }
+  return thread_buffer;
+}
+
+std::vector<ActorTraceRecord> ActorProfiler::CollectRecords() {
+  // The recording is stopped and the actor threads don't write the ring buffers.
+  std::lock_guard<std::mutex> locker(buffers_mutex_);
+  std::vector<ActorTraceRecord> records;
+  std::vector<ActorTraceEvent> events;
+  for (const auto &buffer : buffers_) {
+    MS_EXCEPTION_IF_NULL(buffer);
+    events.clear();
+    dropped_event_num_ += buffer->Drain(&events);
+    for (const auto &event : events) {
+      MS_EXCEPTION_IF_NULL(event.actor_);
+      records.push_back({event.actor_->GetAID().Name(), buffer->thread_index(), event.type_, event.start_, event.end_});
+    }
+  }
+  return records;
+}
+
+ActorTraceSummary ActorProfiler::Analyze(
+  const std::vector<ActorTraceRecord> &records,
+  const mindspore::HashMap<std::string, std::vector<std::string>> &actor_inputs) {
+  ActorTraceSummary summary;
+  if (records.empty()) {
+    return summary;
+  }
+
+  uint64_t step_start = UINT64_MAX;
+  uint64_t step_end = 0;
+  mindspore::HashMap<std::string, std::vector<ActorRunInfo>> actor_runs;
+  mindspore::HashMap<std::string, std::vector<uint64_t>> actor_sends;
+  std::map<size_t, std::vector<std::pair<uint64_t, uint64_t>>> thread_spans;
+  for (const auto &record : records) {
+    step_start = std::min(step_start, record.start_);
+    step_end = std::max(step_end, record.end_);
+    if (record.type_ == ActorTraceEventType::kRun) {
+      actor_runs[record.actor_name_].push_back({&record, record.end_});
+      (void)thread_spans[record.thread_index_].emplace_back(record.start_, record.end_);
+    } else if (record.type_ == ActorTraceEventType::kSend) {
+      (void)actor_sends[record.actor_name_].emplace_back(record.start_);
+    }
+  }
+  summary.step_time_ = step_end - step_start;
+
+  // The running of actor ends at the first sending of output, the following time is spent on the downstream actors
+  // which run in the same thread directly.
+  const ActorRunInfo *last_run = nullptr;
+  for (auto &actor_run : actor_runs) {
+    auto &runs = actor_run.second;
+    std::sort(runs.begin(), runs.end(), [](const ActorRunInfo &left, const ActorRunInfo &right) {
+      return left.record_->start_ < right.record_->start_;
+    });
+    auto &sends = actor_sends[actor_run.first];
+    std::sort(sends.begin(), sends.end());
+    for (size_t i = 0; i < runs.size(); ++i) {
+      auto next_start = (i + 1 < runs.size()) ? runs[i + 1].record_->start_ : UINT64_MAX;
+      auto send_iter = std::lower_bound(sends.begin(), sends.end(), runs[i].record_->start_);
+      if ((send_iter != sends.end()) && (*send_iter < next_start)) {
+        runs[i].exec_end_ = *send_iter;
+      }
+    }
+  }
+  for (const auto &actor_run : actor_runs) {
+    for (const auto &run : actor_run.second) {
+      if ((last_run == nullptr) || (run.exec_end_ > last_run->exec_end_)) {
+        last_run = &run;
+      }
+    }
+  }
+
+  // Walk back from the last running actor by the latest arriving input, which bounds the step time.
+  static const std::vector<ActorRunInfo> empty_runs;
+  static const std::vector<uint64_t> empty_sends;
+  const ActorRunInfo *current_run = last_run;
+  while ((current_run != nullptr) && (summary.critical_path_.size() < records.size())) {
+    const auto &record = current_run->record_;
+    uint64_t ready_time = 0;
+    const std::string *ready_input = nullptr;
+    const auto &inputs_iter = actor_inputs.find(record->actor_name_);
+    if (inputs_iter != actor_inputs.end()) {
+      for (const auto &input : inputs_iter->second) {
+        const auto &runs_iter = actor_runs.find(input);
+        const auto &sends_iter = actor_sends.find(input);
+        const auto &input_runs = (runs_iter != actor_runs.end()) ? runs_iter->second : empty_runs;
+        const auto &input_sends = (sends_iter != actor_sends.end()) ? sends_iter->second : empty_sends;
+        uint64_t input_ready_time = 0;
+        if (GetInputReadyTime(input_runs, input_sends, record->start_, &input_ready_time) &&
+            ((ready_input == nullptr) || (input_ready_time > ready_time))) {
+          ready_time = input_ready_time;
+          ready_input = &input;
+        }
+      }
+    }
+
+    auto queue_time = (ready_input == nullptr) ? 0 : (record->start_ - ready_time);
+    auto exec_time = current_run->exec_end_ - record->start_;
+    summary.critical_path_.push_back(
+      {record->actor_name_, record->thread_index_, record->start_, queue_time, exec_time});
+    if (ready_input == nullptr) {
+      break;
+    }
+    auto prev_run = GetRunInfoBefore(actor_runs.at(*ready_input), ready_time);
+    if ((prev_run == nullptr) || (prev_run == current_run)) {
+      break;
+    }
+    current_run = prev_run;
+  }
+  std::reverse(summary.critical_path_.begin(), summary.critical_path_.end());
+  if (last_run != nullptr && !summary.critical_path_.empty()) {
+    summary.critical_path_time_ = last_run->exec_end_ - summary.critical_path_.front().start_;
+  }
+
+  uint64_t total_busy_time = 0;
+  for (auto &thread_span : thread_spans) {
+    auto busy_time = GetThreadBusyTime(&thread_span.second);
+    summary.thread_busy_times_[thread_span.first] = busy_time;
+    total_busy_time += busy_time;
+  }
+  auto total_time = static_cast<double>(summary.step_time_) * summary.thread_busy_times_.size();
+  if (total_time > 0) {
+    summary.thread_idle_ratio_ = std::max(0.0, 1.0 - static_cast<double>(total_busy_time) / total_time);
+  }
+  return summary;
+}
+
+void ActorProfiler::ExportChromeTrace(const std::vector<ActorTraceRecord> &records,
+                                      const ActorTraceSummary &summary) const {
+  if (records.empty()) {
+    return;
+  }
+  uint64_t step_start = UINT64_MAX;
+  size_t thread_num = 0;
+  for (const auto &record : records) {
+    step_start = std::min(step_start, record.start_);
+    thread_num = std::max(thread_num, record.thread_index_ + 1);
+  }
+  auto to_us = [step_start](uint64_t time) {
+    return static_cast<double>(time - step_start) / kNanosecondsToMicroseconds;
+  };
+
+  nlohmann::json trace_events = nlohmann::json::array();
+  for (size_t i = 0; i < thread_num; ++i) {
+    trace_events.push_back({{"name", "thread_name"},
+                            {"ph", "M"},
+                            {"pid", 0},
+                            {"tid", i},
+                            {"args", {{"name", "actor thread " + std::to_string(i)}}}});
+  }
+  // The critical path is shown in the separated row after the actor threads.
+  size_t critical_path_tid = thread_num;
+  trace_events.push_back({{"name", "thread_name"},
+                          {"ph", "M"},
+                          {"pid", 0},
+                          {"tid", critical_path_tid},
+                          {"args", {{"name", "critical path"}}}});
+
+  for (const auto &record : records) {
+    nlohmann::json event = {{"name", record.actor_name_},
+                            {"cat", GetEventTypeName(record.type_)},
+                            {"pid", 0},
+                            {"tid", record.thread_index_},
+                            {"ts", to_us(record.start_)}};
+    if (record.type_ == ActorTraceEventType::kSend) {
+      event["ph"] = "i";
+      event["s"] = "t";
+    } else {
+      event["ph"] = "X";
+      event["dur"] = static_cast<double>(record.end_ - record.start_) / kNanosecondsToMicroseconds;
+    }
+    trace_events.push_back(event);
+  }
+  for (const auto &node : summary.critical_path_) {
+    trace_events.push_back({{"name", node.actor_name_},
+                            {"cat", "critical_path"},
+                            {"ph", "X"},
+                            {"pid", 0},
+                            {"tid", critical_path_tid},
+                            {"ts", to_us(node.start_)},
+                            {"dur", static_cast<double>(node.exec_time_) / kNanosecondsToMicroseconds},
+                            {"args",
+                             {{"thread", node.thread_index_},
+                              {"queue_us", static_cast<double>(node.queue_time_) / kNanosecondsToMicroseconds}}}});
+  }
+
+  nlohmann::json trace = {
+    {"traceEvents", trace_events},
+    {"displayTimeUnit", "ms"},
+    {"otherData",
+     {{"actor_set", actor_set_name_},
+      {"step", step_},
+      {"step_time_us", static_cast<double>(summary.step_time_) / kNanosecondsToMicroseconds},
+      {"critical_path_time_us", static_cast<double>(summary.critical_path_time_) / kNanosecondsToMicroseconds},
+      {"thread_idle_ratio", summary.thread_idle_ratio_}}}};
+
+  std::string path_name =
+    GetSaveGraphsPathName("actor_trace/actor_trace_" + actor_set_name_ + "_step_" + std::to_string(step_) + ".json");
+  auto realpath = Common::CreatePrefixPath(path_name);
+  if (!realpath.has_value()) {
+    MS_LOG(ERROR) << "Get real path failed, path: " << path_name;
+    return;
+  }
+  ChangeFileMode(realpath.value(), S_IWUSR);
+  std::ofstream ofs(realpath.value());
+  if (!ofs.is_open()) {
+    MS_LOG(ERROR) << "Open file [" << realpath.value() << "] failed!";
+    return;
+  }
+  ofs << trace.dump();
+  ofs.close();
+  ChangeFileMode(realpath.value(), S_IRUSR);
+  MS_LOG(INFO) << "Export the actor trace to file:" << realpath.value();
+}
+
+void ActorProfiler::RecordStatistics(const ActorTraceSummary &summary) {
+  const auto &profiler_manager = profiler::ProfilerManager::GetInstance();
+  MS_EXCEPTION_IF_NULL(profiler_manager);
+  profiler_manager->RecordRuntimeStatistics("actor_profiler_step_time_ns", summary.step_time_);
+  profiler_manager->RecordRuntimeStatistics("actor_profiler_critical_path_time_ns", summary.critical_path_time_);
+  profiler_manager->RecordRuntimeStatistics("actor_profiler_critical_path_actor_num", summary.critical_path_.size());
+  profiler_manager->RecordRuntimeStatistics("actor_profiler_thread_num", summary.thread_busy_times_.size());
+  profiler_manager->RecordRuntimeStatistics("actor_profiler_thread_idle_permille",
+                                            static_cast<uint64_t>(summary.thread_idle_ratio_ * kPermilleBase));
+  profiler_manager->RecordRuntimeStatistics("actor_profiler_dropped_event_num", dropped_event_num_);
+}
+}  // namespace runtime
+}  // namespace mindspore
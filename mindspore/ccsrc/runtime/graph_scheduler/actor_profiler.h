@@ -0,0 +1,178 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_ACTOR_PROFILER_H_
+#define MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_ACTOR_PROFILER_H_
+
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <map>
+#include "utils/hash_map.h"
+#include "utils/ms_utils.h"
+#include "include/backend/visible.h"
+
+namespace mindspore {
+namespace runtime {
+class AbstractActor;
+using AbstractActorPtr = std::shared_ptr<AbstractActor>;
+
+enum class ActorTraceEventType : uint8_t {
+  // The span of actor running which is triggered by the input data or control.
+  kRun,
+  // The span of kernel launch in the kernel actor.
+  kLaunch,
+  // The instant of actor sending the output, which is the enqueue time of the downstream actors.
+  kSend
+};
+
+// The raw event recorded in the ring buffer of actor thread, the time is the nanoseconds of steady clock.
+struct ActorTraceEvent {
+  const AbstractActor *actor_;
+  ActorTraceEventType type_;
+  uint64_t start_;
+  uint64_t end_;
+};
+
+// The event which is collected from the ring buffers at the end of step.
+struct ActorTraceRecord {
+  std::string actor_name_;
+  size_t thread_index_;
+  ActorTraceEventType type_;
+  uint64_t start_;
+  uint64_t end_;
+};
+
+struct ActorCriticalPathNode {
+  std::string actor_name_;
+  size_t thread_index_;
+  uint64_t start_;
+  // The time from the last input arriving to the actor running.
+  uint64_t queue_time_;
+  // The time from the actor running to the output sending.
+  uint64_t exec_time_;
+};
+
+struct ActorTraceSummary {
+  uint64_t step_time_{0};
+  uint64_t critical_path_time_{0};
+  std::vector<ActorCriticalPathNode> critical_path_;
+  // Key is the thread index, value is the busy time of thread in the step.
+  std::map<size_t, uint64_t> thread_busy_times_;
+  // The ratio of idle time in the total time of all threads.
+  double thread_idle_ratio_{0};
+};
+
+// The single writer ring buffer of one actor thread, the oldest events are overwritten when the buffer is full.
+class ActorTraceRingBuffer {
+ public:
+  ActorTraceRingBuffer(size_t thread_index, size_t capacity) : thread_index_(thread_index), events_(capacity) {}
+  ~ActorTraceRingBuffer() = default;
+
+  void Push(const ActorTraceEvent &event) {
+    events_[write_index_ % events_.size()] = event;
+    ++write_index_;
+  }
+  // Move out the events in the order of writing and reset the buffer, return the number of overwritten events.
+  size_t Drain(std::vector<ActorTraceEvent> *events);
+  size_t thread_index() const { return thread_index_; }
+
+ private:
+  size_t thread_index_;
+  std::vector<ActorTraceEvent> events_;
+  size_t write_index_{0};
+};
+
+// The actor profiler records the running, sending and kernel launch time of actors into the per-thread ring buffers
+// with low overhead, and computes the critical path and idle-thread statistics at the end of each step. The trace of
+// step is exported to the Chrome trace json, which can be viewed by the Perfetto or chrome://tracing. It depends on
+// nothing of device profilers, so it can be used on all backends. Enabled by the env MS_DEV_ACTOR_PROFILER.
+class BACKEND_EXPORT ActorProfiler {
+ public:
+  static ActorProfiler &GetInstance() {
+    static ActorProfiler instance;
+    return instance;
+  }
+
+  // Whether enable the actor profiler by the env MS_DEV_ACTOR_PROFILER.
+  static bool IsEnabled();
+  static uint64_t Now();
+
+  bool is_running() const { return is_running_.load(std::memory_order_relaxed); }
+
+  void BeginStep(const std::string &actor_set_name);
+  // Collect the events of step, analyze and export them. The actors are used to get the dependencies between actors.
+  void EndStep(const std::vector<AbstractActorPtr> &actors);
+  // The step running failed, discard the events of this step.
+  void AbortStep();
+
+  void Record(const AbstractActor *actor, ActorTraceEventType type, uint64_t start, uint64_t end);
+
+  // Analyze the critical path and thread statistics of step by the records and the input actors of actors.
+  static ActorTraceSummary Analyze(const std::vector<ActorTraceRecord> &records,
+                                   const mindspore::HashMap<std::string, std::vector<std::string>> &actor_inputs);
+
+ private:
+  ActorProfiler() = default;
+  ~ActorProfiler() = default;
+  DISABLE_COPY_AND_ASSIGN(ActorProfiler);
+
+  ActorTraceRingBuffer *GetThreadBuffer();
+  // Stop recording and wait the recordings in progress finished.
+  void StopRecording();
+  std::vector<ActorTraceRecord> CollectRecords();
+  void ExportChromeTrace(const std::vector<ActorTraceRecord> &records, const ActorTraceSummary &summary) const;
+  void RecordStatistics(const ActorTraceSummary &summary);
+
+  std::atomic<bool> is_running_{false};
+  std::atomic<size_t> recording_num_{0};
+  std::string actor_set_name_;
+  // The step index of current actor set and the step numbers of all actor sets.
+  size_t step_{0};
+  mindspore::HashMap<std::string, size_t> step_nums_;
+  size_t dropped_event_num_{0};
+
+  // The ring buffers are created by the actor threads and never released, because the thread local pointers refer to
+  // them.
+  std::mutex buffers_mutex_;
+  std::vector<std::unique_ptr<ActorTraceRingBuffer>> buffers_;
+};
+
+// Record the span of actor event in the scope when the actor profiler is running.
+class ActorProfilerScope {
+ public:
+  ActorProfilerScope(const AbstractActor *actor, ActorTraceEventType type) : actor_(actor), type_(type) {
+    if (ActorProfiler::GetInstance().is_running()) {
+      start_ = ActorProfiler::Now();
+    }
+  }
+  ~ActorProfilerScope() {
+    if (start_ != 0) {
+      ActorProfiler::GetInstance().Record(actor_, type_, start_, ActorProfiler::Now());
+    }
+  }
+
+ private:
+  const AbstractActor *actor_;
+  ActorTraceEventType type_;
+  uint64_t start_{0};
+};
+}  // namespace runtime
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_ACTOR_PROFILER_H_
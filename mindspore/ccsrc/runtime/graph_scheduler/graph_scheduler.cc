@@ -17,6 +17,8 @@
 #include "runtime/graph_scheduler/graph_scheduler.h"
 #include <queue>
 #include "runtime/graph_scheduler/scheduler_helper.h"
+#include "runtime/graph_scheduler/memory_plan_cache.h"
+#include "runtime/graph_scheduler/actor_profiler.h"
 #include "runtime/graph_scheduler/actor/memory_manager_actor.h"
 #include "runtime/graph_scheduler/actor/debug_actor.h"
 #include "runtime/graph_scheduler/actor/recorder_actor.h"
@@ -291,6 +293,7 @@ GraphScheduler &GraphScheduler::GetInstance() noexcept {
 void GraphScheduler::Clear(const ActorInfo &actor_info, const std::vector<KernelGraphPtr> &graphs,
                            const std::vector<AnfNodePtr> &root_graph_parameters,
                            const ControlNodeParserPtr &parser) noexcept {
+  MemoryPlanCache::GetInstance().Clear(actor_info);
   // Terminate the actors of actor info.
   if (actors_.count(actor_info) > 0) {
     auto actor_manager = ActorMgr::GetActorMgrRef();
@@ -345,6 +348,8 @@ void GraphScheduler::Clear() {
   auto actor_manager = ActorMgr::GetActorMgrRef();
   MS_EXCEPTION_IF_NULL(actor_manager);
   actor_manager->Finalize();
+  memory_manager_actor_ = nullptr;
+  dynamic_shape_pool_ = nullptr;
 
   // Clear the member of DeviceTensorStore.
   DeviceTensorStore::GetInstance().Clear();
@@ -446,6 +451,7 @@ void GraphScheduler::BuildAndScheduleGlobalActor() {
   auto memory_manager_actor = std::make_shared<MemoryManagerActor>();
   MS_EXCEPTION_IF_NULL(memory_manager_actor);
   memory_manager_aid_ = memory_manager_actor->GetAID();
+  memory_manager_actor_ = memory_manager_actor;
   auto base_actor = static_cast<ActorReference>(memory_manager_actor);
   // Bind single thread to response to memory alloc and free quickly.
   (void)actor_manager->Spawn(base_actor, true);
@@ -554,8 +560,29 @@ ActorSet *GraphScheduler::Transform(const GraphCompilerInfo &graph_compiler_info
   return actor_set.get();
 }
 
+void GraphScheduler::BindDynamicShapeThread(const ActorSet *actor_set) {
+  MS_EXCEPTION_IF_NULL(actor_set);
+  if ((!EnableDynamicShapePrefetch()) || actor_set->custom_actors_.empty()) {
+    return;
+  }
+  if (dynamic_shape_pool_ == nullptr) {
+    dynamic_shape_pool_.reset(ActorThreadPool::CreateThreadPool(1));
+    if (dynamic_shape_pool_ == nullptr) {
+      MS_LOG(WARNING) << "Create the dynamic shape thread failed, the custom actors run in the actor thread pool.";
+      return;
+    }
+  }
+  // The infer actor of a kernel only waits for the infer actors of its inputs, so the infer and resize of the following
+  // kernels run on the helper thread while the kernel actors launch, and the init actors prefetch the memory.
+  for (const auto &custom_actor : actor_set->custom_actors_) {
+    MS_EXCEPTION_IF_NULL(custom_actor);
+    custom_actor->set_thread_pool(dynamic_shape_pool_.get());
+  }
+}
+
 void GraphScheduler::Schedule(const ActorSet *actor_set) {
   MS_EXCEPTION_IF_NULL(actor_set);
+  BindDynamicShapeThread(actor_set);
   auto actors = SchedulerHelper::CollectActors(actor_set);
   // Schedule actors.
   auto actor_manager = ActorMgr::GetActorMgrRef();
@@ -626,6 +653,18 @@ void GraphScheduler::Run(ActorSet *const actor_set, const std::vector<std::vecto
     thread_pool->SetSpinCountMaxValue();
   }
   ActorDispatcher::set_is_multi_thread_execution(actor_set->is_multi_thread_execution_);
+  // Reuse the memory plan between the steps with the repeated input shapes in the dynamic shape scenario.
+  bool is_memory_plan_cached =
+    MemoryPlanCache::IsEnabled() &&
+    std::any_of(actor_set->kernel_actors_.begin(), actor_set->kernel_actors_.end(),
+                [](const KernelActorPtr &kernel_actor) { return kernel_actor->is_dynamic_shape(); });
+  if (is_memory_plan_cached) {
+    MemoryPlanCache::GetInstance().BeginStep(actor_set->name_, input_tensors,
+                                             !actor_set->is_multi_thread_execution_ || execution_order_running_);
+  }
+  if (ActorProfiler::IsEnabled()) {
+    ActorProfiler::GetInstance().BeginStep(actor_set->name_);
+  }
   double start_time = GetTime();
   ActorDispatcher::Send(actor_set->data_prepare_actor_->GetAID(), &DataPrepareActor::PrepareData, input_tensors,
                         &op_context, GraphExecutionStrategy::kPipeline);
@@ -633,6 +672,20 @@ void GraphScheduler::Run(ActorSet *const actor_set, const std::vector<std::vecto
   // Get the run result.
   auto result_future = result[0].GetFuture();
   result_future.Wait();
+  if (is_memory_plan_cached) {
+    if (result_future.IsOK()) {
+      MemoryPlanCache::GetInstance().EndStep();
+    } else {
+      MemoryPlanCache::GetInstance().AbortStep();
+    }
+  }
+  if (ActorProfiler::IsEnabled()) {
+    if (result_future.IsOK()) {
+      ActorProfiler::GetInstance().EndStep(SchedulerHelper::CollectActors(actor_set));
+    } else {
+      ActorProfiler::GetInstance().AbortStep();
+    }
+  }
   MsException::Instance().CheckException();
   thread_pool->SetSpinCountMinValue();
   if (!result_future.IsOK()) {
@@ -652,6 +705,13 @@ void GraphScheduler::Run(ActorSet *const actor_set, const std::vector<std::vecto
     MS_LOG(EXCEPTION) << op_context.error_info_;
   }
 
+  // Compact the memory pool at the step boundary, so that the long running job with dynamic shapes doesn't fail to
+  // allocate the continuous memory by the fragmentation.
+  if (MemoryManagerActor::IsMemoryCompactEnabled()) {
+    MS_EXCEPTION_IF_NULL(memory_manager_actor_);
+    memory_manager_actor_->CompactMemory();
+  }
+
   double end_time = GetTime();
   const size_t kSecondsToMilliseconds = 1000;
   SetActorExecutionStrategy(actor_set, strategy, (end_time - start_time) * kSecondsToMilliseconds);
@@ -679,6 +739,11 @@ bool GraphScheduler::CheckSingleThreadRunningCondition(ActorSet *const actor_set
     return false;
   }
 
+  // The memory prefetch of dynamic shape needs the custom actors running in parallel with the kernel actors.
+  if (EnableDynamicShapePrefetch() && (actor_set->custom_actors_.size() > 0)) {
+    return false;
+  }
+
 #ifdef ENABLE_RPC_ACTOR
   // If there're rpc actors, do not use single thread execution because the callbacks of recv actors are
   // multi-thread.
@@ -2004,6 +2069,7 @@ void GraphScheduler::LinkGlobalControlArrow(ActorSet *const actor_set,
   // Link arrows for custom actor.
   LinkControlArrowForCustomActor(actor_set, graph_compiler_info);
   LinkDataArrowForCustomActor(actor_set, graph_compiler_info);
+  SetPrefetchActorForCustomActor(actor_set, graph_compiler_info);
 
   LinkControlArrowForLoopCountActor(actor_set->loop_count_actor_.get(), actor_set,
                                     graph_compiler_info.control_node_parser_);
@@ -2129,6 +2195,34 @@ void GraphScheduler::LinkDataArrowForCustomActor(const ActorSet *actor_set,
   }
 }
 
+void GraphScheduler::SetPrefetchActorForCustomActor(const ActorSet *actor_set,
+                                                    const GraphCompilerInfo &graph_compiler_info) const {
+  MS_EXCEPTION_IF_NULL(actor_set);
+  if ((!EnableDynamicShapePrefetch()) || (graph_compiler_info.strategy_ == GraphExecutionStrategy::kStep)) {
+    return;
+  }
+
+  for (const auto &custom_actor : actor_set->custom_actors_) {
+    MS_EXCEPTION_IF_NULL(custom_actor);
+    auto kernel = custom_actor->kernel().lock();
+    MS_EXCEPTION_IF_NULL(kernel);
+    if (AnfUtils::GetCustomActorType(kernel) != kInit) {
+      continue;
+    }
+    auto base_node = AnfUtils::GetCustomActorBaseNode(kernel);
+    MS_EXCEPTION_IF_NULL(base_node);
+    auto kernel_actor = dynamic_cast<KernelActor *>(FetchActor(base_node->fullname_with_scope()));
+    // Only the common kernel actor supports the prefetch, the derived actors such as rpc actors are excluded.
+    if ((kernel_actor == nullptr) || (kernel_actor->type_ != KernelTransformType::kKernelActor) ||
+        kernel_actor->inputs_continuous_memory()) {
+      continue;
+    }
+    MS_LOG(INFO) << "Set the memory prefetch actor:" << kernel_actor->GetAID().Name()
+                 << " for custom actor:" << custom_actor->GetAID().Name();
+    custom_actor->prefetch_kernel_actor_ = kernel_actor;
+  }
+}
+
 void GraphScheduler::LinkControlArrowByExecutionOrder(const KernelGraphPtr &graph,
                                                       const GraphCompilerInfo &graph_compiler_info) const {
   MS_EXCEPTION_IF_NULL(graph);
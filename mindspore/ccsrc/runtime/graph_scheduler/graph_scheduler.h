@@ -30,6 +30,7 @@
 #include "runtime/graph_scheduler/control_node_scheduler.h"
 #include "runtime/graph_scheduler/memory_swap_node_scheduler.h"
 #include "runtime/graph_scheduler/actor/actor_set.h"
+#include "runtime/graph_scheduler/actor/memory_manager_actor.h"
 #include "runtime/graph_scheduler/graph_compiler.h"
 #include "runtime/graph_scheduler/actor/actor_dump.h"
 #include "thread/actor_threadpool.h"
@@ -101,6 +102,8 @@ class BACKEND_EXPORT GraphScheduler {
 
   // The Global actors contain memory manager actor, recorder actor and debug actor.
   void BuildAndScheduleGlobalActor();
+  // Bind the custom actors of the dynamic shape to the helper thread when the dynamic shape prefetch is enabled.
+  void BindDynamicShapeThread(const ActorSet *actor_set);
 
   // Transform the nodes of graph to actors.
   ActorSetPtr Build(const GraphCompilerInfo &graph_compiler_info);
@@ -187,6 +190,8 @@ class BACKEND_EXPORT GraphScheduler {
                               const GraphCompilerInfo &graph_compiler_info);
   void LinkDataArrowForCustomActor(const ActorSet *actor_set, const GraphCompilerInfo &graph_compiler_info) const;
   void LinkControlArrowForCustomActor(const ActorSet *actor_set, const GraphCompilerInfo &graph_compiler_info);
+  // Set the kernel actor which prefetches memory after the resize of init custom actor in the dynamic shape.
+  void SetPrefetchActorForCustomActor(const ActorSet *actor_set, const GraphCompilerInfo &graph_compiler_info) const;
   void LinkControlArrowByExecutionOrder(const KernelGraphPtr &graph,
                                         const GraphCompilerInfo &graph_compiler_info) const;
   // Link the control arrows by the communication nodes in the kernel graph to ensure communication nodes running order.
@@ -246,8 +251,12 @@ class BACKEND_EXPORT GraphScheduler {
 
   // The id of global actor.
   AID memory_manager_aid_;
+  std::shared_ptr<MemoryManagerActor> memory_manager_actor_{nullptr};
   const AID *recorder_aid_{nullptr};
   const AID *debug_aid_{nullptr};
+  // The helper thread which runs the infer and resize of the dynamic shape kernels ahead of the kernel launch, so that
+  // the host-side shape work is pipelined with the kernel actors when the dynamic shape prefetch is enabled.
+  std::unique_ptr<ActorThreadPool> dynamic_shape_pool_{nullptr};
 
   // Whether actor running by the persistent execution order.
   bool execution_order_running_{false};
@@ -0,0 +1,383 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "runtime/graph_scheduler/memory_plan_cache.h"
+#include <algorithm>
+#include "utils/log_adapter.h"
+#include "utils/convert_utils_base.h"
+#include "common/mem_reuse/mem_dynamic_allocator.h"
+#include "profiler/device/profiling.h"
+
+namespace mindspore {
+namespace runtime {
+namespace {
+constexpr char kMemoryPlanCacheEnv[] = "MS_DEV_MEMORY_PLAN_CACHE";
+// The max number of memory plans for one actor set, to avoid the cache growing unlimited in the variable shapes.
+constexpr size_t kMaxMemoryPlanNumPerActorSet = 32;
+
+inline size_t AlignMemorySize(size_t size) {
+  return ((size + device::DYNAMIC_MEM_ALIGN_SIZE - 1) / device::DYNAMIC_MEM_ALIGN_SIZE) *
+         device::DYNAMIC_MEM_ALIGN_SIZE;
+}
+
+std::string GenerateShapeSignature(const std::vector<std::vector<TensorPtr>> &input_tensors) {
+  std::string signature;
+  for (const auto &tensors : input_tensors) {
+    for (const auto &tensor : tensors) {
+      if (tensor == nullptr) {
+        signature += "N;";
+        continue;
+      }
+      signature += std::to_string(static_cast<int>(tensor->data_type())) + ":";
+      for (const auto &dim : tensor->shape()) {
+        signature += std::to_string(dim) + ",";
+      }
+      signature += ";";
+    }
+    signature += "|";
+  }
+  return signature;
+}
+}  // namespace
+
+bool MemoryPlanCache::IsEnabled() {
+  static bool is_enabled = (common::GetEnv(kMemoryPlanCacheEnv) == "1");
+  return is_enabled;
+}
+
+void MemoryPlanCache::BeginStep(const std::string &actor_set_name,
+                                const std::vector<std::vector<TensorPtr>> &input_tensors, bool is_deterministic) {
+  std::lock_guard<std::mutex> locker(mutex_);
+  ResetStep();
+  // The memory plan is generated by the recorded order which can't be guaranteed in the non deterministic execution.
+  if (!is_deterministic) {
+    return;
+  }
+
+  actor_set_name_ = actor_set_name;
+  signature_ = GenerateShapeSignature(input_tensors);
+  auto &actor_set_plans = memory_plans_[actor_set_name_];
+  const auto &iter = actor_set_plans.find(signature_);
+  if (iter == actor_set_plans.end()) {
+    ++miss_count_;
+    if (actor_set_plans.size() >= kMaxMemoryPlanNumPerActorSet) {
+      MS_LOG(DEBUG) << "The memory plan number of actor set:" << actor_set_name_ << " reaches the max num.";
+      return;
+    }
+    MS_LOG(DEBUG) << "Record the memory plan of actor set:" << actor_set_name_ << " for signature:" << signature_;
+    status_ = PlanStatus::kRecording;
+    return;
+  }
+
+  current_plan_ = iter->second;
+  MS_EXCEPTION_IF_NULL(current_plan_);
+  if (current_plan_->whole_block_size_ > 0) {
+    MS_EXCEPTION_IF_NULL(current_plan_->device_context_);
+    MS_EXCEPTION_IF_NULL(current_plan_->device_context_->device_res_manager_);
+    device::DynamicMemAllocatorDebugInfo::SetDebugInfo(actor_set_name_ + "_MemoryPlan",
+                                                       device::AllocatorType::kKernelOutput);
+    whole_block_ptr_ = current_plan_->device_context_->device_res_manager_->AllocateMemory(
+      current_plan_->whole_block_size_);
+    if (whole_block_ptr_ == nullptr) {
+      MS_LOG(WARNING) << "Allocate the whole block of memory plan failed, size: " << current_plan_->whole_block_size_
+                      << ", actor set:" << actor_set_name_ << ". Allocate the memory from the memory pool.";
+      ++miss_count_;
+      current_plan_ = nullptr;
+      return;
+    }
+  }
+  ++hit_count_;
+  status_ = PlanStatus::kReplaying;
+}
+
+void MemoryPlanCache::EndStep() {
+  std::lock_guard<std::mutex> locker(mutex_);
+  if (status_ == PlanStatus::kRecording) {
+    auto memory_plan = GenerateMemoryPlan();
+    MS_EXCEPTION_IF_NULL(memory_plan);
+    MS_LOG(INFO) << "Generate the memory plan of actor set:" << actor_set_name_
+                 << ", tensor num:" << memory_plan->tensor_offsets_.size()
+                 << ", whole block size:" << memory_plan->whole_block_size_;
+    memory_plans_[actor_set_name_][signature_] = memory_plan;
+  } else if (status_ == PlanStatus::kReplaying) {
+    ReleaseWholeBlock();
+    // The plan doesn't match the running, so record it again in the next step.
+    if (is_plan_mismatched_) {
+      MS_LOG(INFO) << "The memory plan of actor set:" << actor_set_name_
+                   << " is mismatched and will be recorded again.";
+      (void)memory_plans_[actor_set_name_].erase(signature_);
+    }
+  }
+  RecordStatistics();
+  ResetStep();
+}
+
+void MemoryPlanCache::AbortStep() {
+  std::lock_guard<std::mutex> locker(mutex_);
+  if (status_ == PlanStatus::kReplaying) {
+    ReleaseWholeBlock();
+  }
+  ResetStep();
+}
+
+void MemoryPlanCache::Clear(const std::string &actor_set_name) {
+  std::lock_guard<std::mutex> locker(mutex_);
+  (void)memory_plans_.erase(actor_set_name);
+}
+
+bool MemoryPlanCache::AllocateMemory(DeviceTensor *const device_tensor, const DeviceContext *device_context) {
+  if (status_ == PlanStatus::kIdle) {
+    return false;
+  }
+  MS_EXCEPTION_IF_NULL(device_tensor);
+  std::lock_guard<std::mutex> locker(mutex_);
+  if (status_ == PlanStatus::kRecording) {
+    if (recording_device_context_ == nullptr) {
+      recording_device_context_ = device_context;
+    }
+    const auto &iter = tensor_info_indexes_.find(device_tensor);
+    if (iter != tensor_info_indexes_.end()) {
+      tensor_infos_[iter->second].is_valid_ = false;
+    } else {
+      tensor_info_indexes_[device_tensor] = tensor_infos_.size();
+      (void)tensor_infos_.emplace_back(device_tensor, device_tensor->GetSize(), time_);
+      tensor_infos_.back().is_valid_ = (device_context == recording_device_context_);
+    }
+    ++time_;
+    return false;
+  }
+
+  if (status_ == PlanStatus::kReplaying) {
+    MS_EXCEPTION_IF_NULL(current_plan_);
+    // The device tensor out of the memory plan is allocated from the memory pool, such as the graph output.
+    const auto &iter = current_plan_->tensor_offsets_.find(device_tensor);
+    if (iter == current_plan_->tensor_offsets_.end()) {
+      return false;
+    }
+    if ((device_context != current_plan_->device_context_) || (device_tensor->GetSize() > iter->second.second) ||
+        (in_use_tensors_.count(device_tensor) > 0)) {
+      is_plan_mismatched_ = true;
+      return false;
+    }
+    auto plan_ptr = AddressOffset(whole_block_ptr_, iter->second.first);
+    device_tensor->set_ptr(plan_ptr);
+    device_tensor->set_from_mem_pool(false);
+    in_use_tensors_[device_tensor] = plan_ptr;
+    return true;
+  }
+  return false;
+}
+
+bool MemoryPlanCache::FreeMemory(DeviceTensor *const device_tensor) {
+  if ((status_ == PlanStatus::kIdle) && (!has_pending_blocks_)) {
+    return false;
+  }
+  MS_EXCEPTION_IF_NULL(device_tensor);
+  std::lock_guard<std::mutex> locker(mutex_);
+  if (has_pending_blocks_ && FreePendingMemory(device_tensor)) {
+    return true;
+  }
+  if (status_ == PlanStatus::kRecording) {
+    const auto &iter = tensor_info_indexes_.find(device_tensor);
+    if ((iter != tensor_info_indexes_.end()) && (tensor_infos_[iter->second].free_time_ == SIZE_MAX)) {
+      tensor_infos_[iter->second].free_time_ = time_;
+      ++time_;
+    }
+    return false;
+  }
+
+  if (status_ == PlanStatus::kReplaying) {
+    const auto &iter = in_use_tensors_.find(device_tensor);
+    if (iter == in_use_tensors_.end()) {
+      return false;
+    }
+    // The ptr replaced outside the memory plan doesn't reference the whole block and is freed by the caller.
+    if (device_tensor->GetPtr() != iter->second) {
+      MS_LOG(INFO) << "The ptr of device tensor:" << device_tensor
+                   << " is replaced outside the memory plan of actor set:" << actor_set_name_
+                   << ", the plan will be recorded again.";
+      (void)in_use_tensors_.erase(iter);
+      is_plan_mismatched_ = true;
+      return false;
+    }
+    // The memory is released with the whole block at the end of step.
+    device_tensor->set_ptr(nullptr);
+    (void)in_use_tensors_.erase(iter);
+    return true;
+  }
+  return false;
+}
+
+size_t MemoryPlanCache::GenerateOffsets(const std::vector<MemoryPlanTensorInfo> &tensor_infos,
+                                        std::vector<size_t> *offsets) {
+  MS_EXCEPTION_IF_NULL(offsets);
+  offsets->assign(tensor_infos.size(), 0);
+  size_t whole_block_size = 0;
+  // The placed tensors in the order of allocation: the index of tensor info.
+  std::vector<size_t> placed_indexes;
+  std::vector<std::pair<size_t, size_t>> conflict_ranges;
+  for (size_t i = 0; i < tensor_infos.size(); ++i) {
+    const auto &tensor_info = tensor_infos[i];
+    size_t aligned_size = AlignMemorySize(tensor_info.size_);
+    // Collect the memory ranges of placed tensors whose lifetimes are overlapped with current tensor.
+    conflict_ranges.clear();
+    for (auto placed_index : placed_indexes) {
+      const auto &placed_info = tensor_infos[placed_index];
+      if ((placed_info.alloc_time_ < tensor_info.free_time_) && (tensor_info.alloc_time_ < placed_info.free_time_)) {
+        (void)conflict_ranges.emplace_back((*offsets)[placed_index],
+                                           (*offsets)[placed_index] + AlignMemorySize(placed_info.size_));
+      }
+    }
+    std::sort(conflict_ranges.begin(), conflict_ranges.end());
+
+    // Best fit: find the smallest gap which can hold current tensor, otherwise put it at the end.
+    size_t best_offset = SIZE_MAX;
+    size_t best_gap = SIZE_MAX;
+    size_t gap_begin = 0;
+    for (const auto &range : conflict_ranges) {
+      if ((range.first > gap_begin) && (range.first - gap_begin >= aligned_size) &&
+          (range.first - gap_begin < best_gap)) {
+        best_gap = range.first - gap_begin;
+        best_offset = gap_begin;
+      }
+      gap_begin = std::max(gap_begin, range.second);
+    }
+    if (best_offset == SIZE_MAX) {
+      best_offset = gap_begin;
+    }
+
+    (*offsets)[i] = best_offset;
+    whole_block_size = std::max(whole_block_size, best_offset + aligned_size);
+    (void)placed_indexes.emplace_back(i);
+  }
+  return whole_block_size;
+}
+
+MemoryPlanPtr MemoryPlanCache::GenerateMemoryPlan() const {
+  auto memory_plan = std::make_shared<MemoryPlan>();
+  MS_EXCEPTION_IF_NULL(memory_plan);
+  memory_plan->device_context_ = recording_device_context_;
+
+  // The device tensor which isn't freed in the step may be used after the step, such as graph output, so it can't be
+  // put into the whole block.
+  std::vector<MemoryPlanTensorInfo> plan_tensor_infos;
+  for (const auto &tensor_info : tensor_infos_) {
+    if (tensor_info.is_valid_ && (tensor_info.free_time_ != SIZE_MAX) && (tensor_info.size_ > 0)) {
+      (void)plan_tensor_infos.emplace_back(tensor_info);
+    }
+  }
+
+  std::vector<size_t> offsets;
+  memory_plan->whole_block_size_ = GenerateOffsets(plan_tensor_infos, &offsets);
+  for (size_t i = 0; i < plan_tensor_infos.size(); ++i) {
+    memory_plan->tensor_offsets_[plan_tensor_infos[i].device_tensor_] =
+      std::make_pair(offsets[i], AlignMemorySize(plan_tensor_infos[i].size_));
+  }
+  return memory_plan;
+}
+
+void MemoryPlanCache::ReleaseWholeBlock() {
+  if (whole_block_ptr_ == nullptr) {
+    return;
+  }
+  MS_EXCEPTION_IF_NULL(current_plan_);
+  MS_EXCEPTION_IF_NULL(current_plan_->device_context_);
+  // The device tensors freed outside the memory plan don't keep the whole block, and the plan doesn't match them.
+  if (DropDetachedTensors(&in_use_tensors_) > 0) {
+    is_plan_mismatched_ = true;
+  }
+  // The device tensors in use may be referenced after the step, so the whole block is released when the last of them
+  // is freed.
+  if (!in_use_tensors_.empty()) {
+    MS_LOG(INFO) << "There are " << in_use_tensors_.size() << " device tensors still in use of memory plan, actor set:"
+                 << actor_set_name_ << ", the release of whole block size:" << current_plan_->whole_block_size_
+                 << " is deferred.";
+    is_plan_mismatched_ = true;
+    PendingWholeBlock pending_block;
+    pending_block.device_context_ = current_plan_->device_context_;
+    pending_block.ptr_ = whole_block_ptr_;
+    pending_block.in_use_tensors_.swap(in_use_tensors_);
+    (void)pending_blocks_.emplace_back(std::move(pending_block));
+    has_pending_blocks_ = true;
+    whole_block_ptr_ = nullptr;
+    return;
+  }
+  current_plan_->device_context_->device_res_manager_->FreeMemory(whole_block_ptr_);
+  whole_block_ptr_ = nullptr;
+}
+
+bool MemoryPlanCache::FreePendingMemory(DeviceTensor *const device_tensor) {
+  for (auto iter = pending_blocks_.begin(); iter != pending_blocks_.end(); ++iter) {
+    auto &in_use_tensors = iter->in_use_tensors_;
+    const auto &tensor_iter = in_use_tensors.find(device_tensor);
+    if (tensor_iter == in_use_tensors.end()) {
+      continue;
+    }
+    // The ptr replaced outside the memory plan is freed by the caller.
+    bool is_plan_ptr = (device_tensor->GetPtr() == tensor_iter->second);
+    if (is_plan_ptr) {
+      device_tensor->set_ptr(nullptr);
+    }
+    (void)in_use_tensors.erase(tensor_iter);
+    if (in_use_tensors.empty()) {
+      MS_EXCEPTION_IF_NULL(iter->device_context_);
+      iter->device_context_->device_res_manager_->FreeMemory(iter->ptr_);
+      (void)pending_blocks_.erase(iter);
+      has_pending_blocks_ = !pending_blocks_.empty();
+    }
+    return is_plan_ptr;
+  }
+  return false;
+}
+
+size_t MemoryPlanCache::DropDetachedTensors(InUseTensorMap *in_use_tensors) {
+  MS_EXCEPTION_IF_NULL(in_use_tensors);
+  size_t dropped_num = 0;
+  for (auto iter = in_use_tensors->begin(); iter != in_use_tensors->end();) {
+    MS_EXCEPTION_IF_NULL(iter->first);
+    if (iter->first->GetPtr() == iter->second) {
+      ++iter;
+      continue;
+    }
+    MS_LOG(INFO) << "The ptr of device tensor:" << iter->first << " is freed or replaced outside the memory plan.";
+    iter = in_use_tensors->erase(iter);
+    ++dropped_num;
+  }
+  return dropped_num;
+}
+
+void MemoryPlanCache::ResetStep() {
+  status_ = PlanStatus::kIdle;
+  actor_set_name_.clear();
+  signature_.clear();
+  recording_device_context_ = nullptr;
+  tensor_infos_.clear();
+  tensor_info_indexes_.clear();
+  time_ = 0;
+  current_plan_ = nullptr;
+  whole_block_ptr_ = nullptr;
+  in_use_tensors_.clear();
+  is_plan_mismatched_ = false;
+}
+
+void MemoryPlanCache::RecordStatistics() const {
+  const auto &profiler_manager = profiler::ProfilerManager::GetInstance();
+  MS_EXCEPTION_IF_NULL(profiler_manager);
+  profiler_manager->RecordRuntimeStatistics("memory_plan_cache_hit_count", hit_count_);
+  profiler_manager->RecordRuntimeStatistics("memory_plan_cache_miss_count", miss_count_);
+}
+}  // namespace runtime
+}  // namespace mindspore
@@ -0,0 +1,163 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_MEMORY_PLAN_CACHE_H_
+#define MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_MEMORY_PLAN_CACHE_H_
+
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <utility>
+#include "utils/hash_map.h"
+#include "utils/ms_utils.h"
+#include "ir/tensor.h"
+#include "runtime/device/device_address.h"
+#include "runtime/hardware/device_context.h"
+#include "include/backend/visible.h"
+
+namespace mindspore {
+namespace runtime {
+using DeviceTensor = mindspore::device::DeviceAddress;
+using mindspore::device::DeviceContext;
+using mindspore::tensor::TensorPtr;
+
+// The lifetime of device tensor in one step, the time is the order of memory allocation and free.
+struct MemoryPlanTensorInfo {
+  MemoryPlanTensorInfo(DeviceTensor *device_tensor, size_t size, size_t alloc_time)
+      : device_tensor_(device_tensor), size_(size), alloc_time_(alloc_time) {}
+  DeviceTensor *device_tensor_;
+  size_t size_;
+  size_t alloc_time_;
+  size_t free_time_{SIZE_MAX};
+  // The device tensor which is allocated repeatedly or from the other device context can't use the memory plan.
+  bool is_valid_{true};
+};
+
+// The memory plan of one input shape signature, which records the offsets of device tensors in the whole block.
+struct MemoryPlan {
+  const DeviceContext *device_context_{nullptr};
+  size_t whole_block_size_{0};
+  // Key is the device tensor, value is the pair of offset and size in the whole block.
+  mindspore::HashMap<const DeviceTensor *, std::pair<size_t, size_t>> tensor_offsets_;
+};
+using MemoryPlanPtr = std::shared_ptr<MemoryPlan>;
+
+// Key is the device tensor whose memory is assigned by the memory plan, value is the address in the whole block.
+using InUseTensorMap = mindspore::HashMap<const DeviceTensor *, void *>;
+
+// The whole block of the step which ends with some device tensors still in use, such as the mismatched or aborted step.
+// The block is released when the last device tensor in use is freed.
+struct PendingWholeBlock {
+  const DeviceContext *device_context_{nullptr};
+  void *ptr_{nullptr};
+  InUseTensorMap in_use_tensors_;
+};
+
+// The memory plan cache reuses the memory plan between the steps with the repeated input shape signature in the dynamic
+// shape scenario. The first step of signature records the memory allocation and free of device tensors in the memory
+// manager actor, and generates the memory plan at the end of step. The following steps of signature allocate the whole
+// block once and set the device tensors by the offsets of memory plan, without the memory allocation and free of
+// kernel. The memory plan is generated by the recorded order, so it can only be used in the deterministic execution,
+// such as the single thread execution or the execution order running.
+// The memory assigned by the plan isn't from the memory pool, so the actors free the device tensors through
+// FreeMemoryByDeviceContext which releases them to the plan first. The device tensor whose ptr is freed or replaced
+// outside the plan no longer references the whole block, it is dropped and the plan is recorded again, so the whole
+// block is never released while a device tensor still points into it.
+class BACKEND_EXPORT MemoryPlanCache {
+ public:
+  static MemoryPlanCache &GetInstance() {
+    static MemoryPlanCache instance;
+    return instance;
+  }
+
+  // Whether enable the memory plan cache by the env MS_DEV_MEMORY_PLAN_CACHE.
+  static bool IsEnabled();
+
+  // Begin the step of actor set by the input shape signature of input tensors.
+  void BeginStep(const std::string &actor_set_name, const std::vector<std::vector<TensorPtr>> &input_tensors,
+                 bool is_deterministic);
+  // End the step: generate the memory plan in the recording or free the whole block in the replaying.
+  void EndStep();
+  // The step running failed, discard the recorded info of this step.
+  void AbortStep();
+  // Clear the memory plans of actor set.
+  void Clear(const std::string &actor_set_name);
+
+  // Return true if the memory of device tensor is assigned by the memory plan, otherwise the memory needs to be
+  // allocated from the memory pool. The allocation is recorded in the recording step.
+  bool AllocateMemory(DeviceTensor *const device_tensor, const DeviceContext *device_context);
+  // Return true if the memory of device tensor is released by the memory plan, otherwise the memory needs to be freed
+  // to the memory pool. The free is recorded in the recording step.
+  bool FreeMemory(DeviceTensor *const device_tensor);
+
+  size_t hit_count() const { return hit_count_; }
+  size_t miss_count() const { return miss_count_; }
+
+  // Generate the offsets of tensors by the lifetimes, the tensors whose lifetimes are overlapped can't share the
+  // memory. Return the whole block size.
+  static size_t GenerateOffsets(const std::vector<MemoryPlanTensorInfo> &tensor_infos, std::vector<size_t> *offsets);
+
+ private:
+  MemoryPlanCache() = default;
+  ~MemoryPlanCache() = default;
+  DISABLE_COPY_AND_ASSIGN(MemoryPlanCache);
+
+  enum class PlanStatus { kIdle, kRecording, kReplaying };
+
+  // Generate the memory plan by the recorded tensor infos.
+  MemoryPlanPtr GenerateMemoryPlan() const;
+  // Release the whole block of replaying step, the release is deferred if some device tensors are still in use.
+  void ReleaseWholeBlock();
+  // Release the memory of device tensor in the pending whole blocks, and return true if the device tensor still
+  // references the pending whole block.
+  bool FreePendingMemory(DeviceTensor *const device_tensor);
+  // Drop the device tensors whose ptr is freed or replaced outside the memory plan, and return the dropped number.
+  static size_t DropDetachedTensors(InUseTensorMap *in_use_tensors);
+  void ResetStep();
+  void RecordStatistics() const;
+
+  std::mutex mutex_;
+  std::atomic<PlanStatus> status_{PlanStatus::kIdle};
+
+  // Key is the actor set name, value is the memory plans by the input shape signature.
+  mindspore::HashMap<std::string, mindspore::HashMap<std::string, MemoryPlanPtr>> memory_plans_;
+
+  // The running info of current step.
+  std::string actor_set_name_;
+  std::string signature_;
+  // The recording info.
+  const DeviceContext *recording_device_context_{nullptr};
+  std::vector<MemoryPlanTensorInfo> tensor_infos_;
+  mindspore::HashMap<const DeviceTensor *, size_t> tensor_info_indexes_;
+  size_t time_{0};
+  // The replaying info.
+  MemoryPlanPtr current_plan_{nullptr};
+  void *whole_block_ptr_{nullptr};
+  InUseTensorMap in_use_tensors_;
+  bool is_plan_mismatched_{false};
+  std::vector<PendingWholeBlock> pending_blocks_;
+  std::atomic<bool> has_pending_blocks_{false};
+
+  // The statistics info.
+  size_t hit_count_{0};
+  size_t miss_count_{0};
+};
+}  // namespace runtime
+}  // namespace mindspore
+
+#endif  // MINDSPORE_CCSRC_RUNTIME_FRAMEWORK_MEMORY_PLAN_CACHE_H_
@@ -21,6 +21,7 @@
 #include <vector>
 #include <memory>
 #include <map>
+#include <functional>
 #include "runtime/hardware/device_type.h"
 #include "runtime/device/device_address.h"
 #include "runtime/collective/collective_communication_lib.h"
@@ -31,6 +32,7 @@
 #include "backend/common/optimizer/common_backend_optimization.h"
 #include "runtime/hardware/deprecated_interface.h"
 #include "runtime/device/auto_mem_offload.h"
+#include "runtime/device/host_staging_mem_pool.h"
 
 namespace mindspore {
 namespace device {
@@ -113,9 +115,9 @@ class BACKEND_EXPORT DeviceResManager {
   virtual bool AllocateMemory(DeviceAddress *const &address) const;
   virtual void FreeMemory(DeviceAddress *const &address) const;
 
-  // Allocate host memory with raii and ref count
+  // Allocate host memory with raii and ref count, the memory is recycled by the host staging memory pool.
   virtual std::shared_ptr<void> AllocateHostMemory(size_t size) const {
-    return std::shared_ptr<void>(::malloc(size), ::free);
+    return device::HostStagingMemPool::GetInstance()->MallocShared(size);
   }
   // Allocate host memory for offload device memory.
   virtual void *AllocateOffloadMemory(size_t size) const;
@@ -125,6 +127,14 @@ class BACKEND_EXPORT DeviceResManager {
 
   virtual size_t GetAvailableMemSize() const { return 0; }
 
+  // Compact the memory pool when its fragmentation ratio reaches the threshold, only the memory which is_movable
+  // returns true is moved. It must be called at the step boundary, and returns the map from the old address to the new
+  // address of the moved memory. The device which doesn't support the compaction moves nothing.
+  virtual std::map<void *, void *> CompactMemory(double fragmentation_threshold,
+                                                 const std::function<bool(void *)> &is_movable) const {
+    return {};
+  }
+
   // Allocate continuous device memory according to size list.
   // Communication operators may need continuous memory for input and output
   // to optimize the communication performance.
@@ -15,6 +15,7 @@
  */
 #ifndef MINDSPORE_LITE_INCLUDE_TRAIN_TRAIN_CFG_H_
 #define MINDSPORE_LITE_INCLUDE_TRAIN_TRAIN_CFG_H_
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -54,11 +55,17 @@ class TrainCfg {
     this->loss_name_ = rhs.loss_name_;
     this->mix_precision_cfg_ = rhs.mix_precision_cfg_;
     this->accumulate_gradients_ = rhs.accumulate_gradients_;
+    this->enable_recompute_ = rhs.enable_recompute_;
+    this->recompute_checkpoints_ = rhs.recompute_checkpoints_;
+    this->recompute_memory_budget_ = rhs.recompute_memory_budget_;
   }
   TrainCfg &operator=(const TrainCfg &rhs) = default;
   std::vector<std::string> loss_name_ = {"loss_fct"}; /**< Set part of the name that identify a loss kernel */
   MixPrecisionCfg mix_precision_cfg_;                 /**< Mix precision configuration */
   bool accumulate_gradients_ = false; /**< If true gardents are accmulated and can be read by GetGradients */
+  bool enable_recompute_ = false; /**< If true the activations are freed in forward and recomputed in backprop */
+  std::vector<std::string> recompute_checkpoints_; /**< Part of the names of kernels whose outputs are kept */
+  size_t recompute_memory_budget_ = 0; /**< The budget of tensor memory when checkpoints are chosen automatically */
 };
 
 }  // namespace lite
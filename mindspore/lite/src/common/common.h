@@ -63,6 +63,10 @@ static const char *const kMSCacheSerializePathKey = "serialize_path";
 // mindir weight path
 static const char *const kConfigModelFileSection = "model_file";
 static const char *const kConfigMindIRPathKey = "mindir_path";
+static const char *const kConfigSharingWeightKey = "enable_sharing_weight";
+static const char *const kConfigMmapModelKey = "enable_mmap";
+static const char *const kConfigLazyWeightDecodeKey = "enable_lazy_weight_decode";
+static const char *const kConfigLazyWeightPrefetchKey = "lazy_weight_prefetch";
 static const char *const kWeightSection = "weight";
 static const char *const kWeightPathKey = "weight_path";
 // shared parallel thread pool
@@ -70,6 +74,16 @@ static const char *const kSharedThreadPoolSection = "shared_thread_pool";
 static const char *const kEnableSharedThreadPoolKey = "enable_shared_thread_pool";
 static const char *const kThreadNumLimitPerWorkerKey = "thread_num_limit_per_worker";
 static const char *const kThreadNumRemainingPerWorkerKey = "thread_num_remaining_per_worker";
+
+static const char *const kDynamicBatchSection = "dynamic_batch";
+static const char *const kMaxBatchSizeKey = "max_batch_size";
+static const char *const kBatchTimeoutKey = "batch_timeout_us";
+// resize plan cache
+static const char *const kResizePlanCacheSection = "resize_plan_cache";
+static const char *const kResizePlanCacheSizeKey = "cache_size";
+// runtime pass
+static const char *const kRuntimePassSection = "runtime_pass";
+static const char *const kEnableElementwiseFusionKey = "enable_elementwise_fusion";
 // model pool inner section and key
 static const char *const kInnerModelParallelRunnerSection = "inner_model_parallel_runner";
 static const char *const kInnerSharingWeightCopyBufKey = "sharing_weight_copy_buf";
@@ -23,8 +23,10 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <dirent.h>
+#include <sys/mman.h>
 #endif
 
+#include <cerrno>
 #include <cstdlib>
 #include "securec/include/securec.h"
 
@@ -207,6 +209,55 @@ char *ReadFile(const char *file, size_t *size, std::shared_ptr<Allocator> alloca
   return model_buf;
 }
 
+char *MapFile(const char *file, size_t *size) {
+#ifdef _WIN32
+  MS_LOG(INFO) << "Map file is not supported on windows.";
+  return nullptr;
+#else
+  if (file == nullptr || size == nullptr) {
+    MS_LOG(ERROR) << "File path or size is nullptr";
+    return nullptr;
+  }
+  std::string real_path = RealPath(file);
+  if (real_path.empty()) {
+    MS_LOG(DEBUG) << "File path not regular: " << file;
+    return nullptr;
+  }
+  auto fd = open(real_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    MS_LOG(ERROR) << "Open file " << real_path << " failed, errno: " << errno;
+    return nullptr;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+    MS_LOG(ERROR) << "Get the size of file " << real_path << " failed.";
+    (void)close(fd);
+    return nullptr;
+  }
+  auto file_size = static_cast<size_t>(file_stat.st_size);
+  // The mapping is private, the pages written by the kernels transforming weights in place are copied.
+  auto addr = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  (void)close(fd);
+  if (addr == MAP_FAILED) {
+    MS_LOG(ERROR) << "Map file " << real_path << " failed, errno: " << errno;
+    return nullptr;
+  }
+  *size = file_size;
+  return static_cast<char *>(addr);
+#endif
+}
+
+void UnmapFile(char *buf, size_t size) {
+#ifndef _WIN32
+  if (buf == nullptr || size == 0) {
+    return;
+  }
+  if (munmap(buf, size) != 0) {
+    MS_LOG(ERROR) << "Unmap file buffer failed, errno: " << errno;
+  }
+#endif
+}
+
 std::string RealPath(const char *path) {
   if (path == nullptr) {
     MS_LOG(ERROR) << "path is nullptr";
@@ -52,6 +52,12 @@ char *ReadFileSegment(const std::string &file, int64_t offset, int64_t len);
 
 char *ReadFile(const char *file, size_t *size, std::shared_ptr<Allocator> allocator = nullptr);
 
+// Map the file into memory copy-on-write, the pages are read from the file on the first access. The buffer must be
+// released by UnmapFile. Return nullptr if the file can't be mapped, such as on windows.
+char *MapFile(const char *file, size_t *size);
+
+void UnmapFile(char *buf, size_t size);
+
 std::string RealPath(const char *path);
 
 int CreateOutputDir(std::string *file_path);
@@ -18,6 +18,7 @@
 #include "src/tensor.h"
 #include "nnacl/custom_parameter.h"
 #include "nnacl/split_parameter.h"
+#include "nnacl/attention_parameter.h"
 using mindspore::schema::PrimitiveType_Custom;
 
 namespace mindspore {
@@ -97,6 +98,24 @@ OpParameter *PopulateCustomParameter(const void *prim) {
 
     param->op_parameter_.type_ = PrimType_Inner_SplitReduceConcatFusion;
     return reinterpret_cast<OpParameter *>(param);
+  } else if (type == "KVCacheAttention") {
+    if (value->attr() == nullptr || value->attr()->size() < 1) {
+      MS_LOG(ERROR) << "The max_seq_len attr of KVCacheAttention is missing.";
+      return nullptr;
+    }
+    auto *param = static_cast<KVCacheAttentionParameter *>(malloc(sizeof(KVCacheAttentionParameter)));
+    if (param == nullptr) {
+      MS_LOG(ERROR) << "malloc KVCacheAttentionParameter failed.";
+      return nullptr;
+    }
+    memset(param, 0, sizeof(KVCacheAttentionParameter));
+    if (!GetDataFromPrim(&param->max_seq_len_, sizeof(int), value, 0)) {
+      MS_LOG(ERROR) << "Get max_seq_len value From prim fail.";
+      free(param);
+      return nullptr;
+    }
+    param->op_parameter_.type_ = PrimType_Inner_KVCacheAttention;
+    return reinterpret_cast<OpParameter *>(param);
   } else {
     MS_LOG(ERROR) << "Unsupported custom type: " << type;
   }
@@ -27,6 +27,7 @@
 #include "mindapi/ir/func_graph.h"
 #include "mindapi/base/base.h"
 #include "src/extendrt/delegate/graph_executor/litert/func_graph_reuse_manager.h"
+#include "src/extendrt/shared_weight_store.h"
 #include "mindspore/core/load_mindir/load_model.h"
 #include "src/common/common.h"
 namespace mindspore {
@@ -131,6 +132,14 @@ Status ModelImpl::BuildByBufferImpl(const void *model_data, size_t data_size, Mo
     MS_LOG(ERROR) << "convert graph failed.";
     return ret;
   }
+  if (GetConfig(lite::kConfigModelFileSection, lite::kConfigSharingWeightKey) == "true") {
+    auto model_key = SharedWeightStore::GenModelKey(model_buff, model_size, weight_path);
+    ret = SharedWeightStore::GetInstance()->ShareWeights(func_graph, model_key);
+    if (ret != kSuccess) {
+      MS_LOG(ERROR) << "share weights failed.";
+      return ret;
+    }
+  }
 
   ret = FuncGraphReuseManager::GetInstance()->StoreFuncGraph(func_graph, config_info_);
   if (ret != kSuccess) {
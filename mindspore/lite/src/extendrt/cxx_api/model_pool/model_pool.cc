@@ -35,6 +35,7 @@ constexpr int kNumDeviceInfo = 2;
 constexpr int kNumIndex = 2;
 constexpr int kNumCoreDataLen = 3;
 constexpr int kNumMaxTaskQueueSize = 1000;
+constexpr int64_t kDefaultBatchTimeoutUs = 1000;
 constexpr int kNumPhysicalCoreThreshold = 16;
 constexpr int kDefaultWorkerNumPerPhysicalCpu = 2;
 constexpr int kDefaultThreadsNum = 8;
@@ -908,6 +909,38 @@ Status ModelPool::ParseSharedThreadPoolParam(const std::shared_ptr<RunnerConfig>
   return ParseParamByConfigInfo(runner_config->GetConfigInfo());
 }
 
+Status ModelPool::ParseDynamicBatchParam(const std::shared_ptr<RunnerConfig> &runner_config) {
+  if (runner_config == nullptr) {
+    return kSuccess;
+  }
+  auto config_info = runner_config->GetConfigInfo();
+  auto dynamic_batch = config_info.find(lite::kDynamicBatchSection);
+  if (dynamic_batch == config_info.end()) {
+    MS_LOG(INFO) << "not set dynamic batch.";
+    return kSuccess;
+  }
+  auto &dynamic_batch_param = dynamic_batch->second;
+  if (dynamic_batch_param.find(lite::kMaxBatchSizeKey) == dynamic_batch_param.end()) {
+    MS_LOG(ERROR) << "not find key of max_batch_size";
+    return kLiteParamInvalid;
+  }
+  int max_batch_size = std::atoi(dynamic_batch_param[lite::kMaxBatchSizeKey].c_str());
+  if (max_batch_size <= 0) {
+    MS_LOG(ERROR) << "max_batch_size is invalid, max_batch_size: " << dynamic_batch_param[lite::kMaxBatchSizeKey];
+    return kLiteParamInvalid;
+  }
+  int64_t batch_timeout_us = kDefaultBatchTimeoutUs;
+  if (dynamic_batch_param.find(lite::kBatchTimeoutKey) != dynamic_batch_param.end()) {
+    batch_timeout_us = std::atoll(dynamic_batch_param[lite::kBatchTimeoutKey].c_str());
+    if (batch_timeout_us < 0) {
+      MS_LOG(ERROR) << "batch_timeout_us is invalid, batch_timeout_us: " << dynamic_batch_param[lite::kBatchTimeoutKey];
+      return kLiteParamInvalid;
+    }
+  }
+  predict_task_queue_->EnableDynamicBatch(max_batch_size, batch_timeout_us);
+  return kSuccess;
+}
+
 ModelPoolConfig ModelPool::Init(const std::shared_ptr<RunnerConfig> &runner_config) {
   ModelPoolConfig model_pool_config = {};
   auto status = CanUseAllPhysicalResources();
@@ -956,6 +989,11 @@ ModelPoolConfig ModelPool::Init(const std::shared_ptr<RunnerConfig> &runner_conf
     MS_LOG(ERROR) << "predict task queue init failed, status=" << status;
     return model_pool_config;
   }
+  status = ParseDynamicBatchParam(runner_config);
+  if (status != kSuccess) {
+    MS_LOG(ERROR) << "parse dynamic batch param failed, status=" << status;
+    return {};
+  }
   // initialize the task pool
   tasks_ = new (std::nothrow) PredictTask[kNumMaxTaskQueueSize]();
   if (tasks_ == nullptr) {
@@ -1105,9 +1143,10 @@ Status ModelPool::Predict(const std::vector<MSTensor> &inputs, std::vector<MSTen
     }
     predict_task_queue_->PushPredictTask(task, max_wait_worker_node_id);
     predict_task_queue_->WaitUntilPredictActive(task, max_wait_worker_node_id);
+    auto status = task->status;
     UpdateFreeTaskId(task_id);
+    return status;
   }
-  return kSuccess;
 }
 
 ModelPool::~ModelPool() {
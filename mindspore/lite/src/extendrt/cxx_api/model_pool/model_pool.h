@@ -114,6 +114,8 @@ class ModelPool {
 
   Status ParseSharedThreadPoolParam(const std::shared_ptr<RunnerConfig> &runner_config);
 
+  Status ParseDynamicBatchParam(const std::shared_ptr<RunnerConfig> &runner_config);
+
   Status ParseParamByConfigInfo(std::map<std::string, std::map<std::string, std::string>> config_info);
 
   Status CheckSharingThreadPoolParam(const ModelPoolConfig &model_pool_config);
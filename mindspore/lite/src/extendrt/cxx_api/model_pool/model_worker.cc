@@ -15,6 +15,8 @@
  */
 #include "src/extendrt/cxx_api/model_pool/model_worker.h"
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 #include "src/common/log_adapter.h"
 #include "src/extendrt/numa_adapter.h"
 #include "src/common/common.h"
@@ -76,27 +78,31 @@ void ModelWorker::Run() {
   create_work_done_condition_.notify_one();
   MS_LOG(INFO) << "model worker is initialized.";
   while (!predict_task_queue_->IsPredictTaskDone()) {
-    auto task = predict_task_queue_->GetPredictTask(task_queue_id, this);
-    if (task == nullptr) {
+    auto tasks = predict_task_queue_->GetPredictTasks(task_queue_id, this);
+    if (tasks.empty()) {
       MS_LOG(DEBUG) << "task queue is empty, wait task ...";
       available_ = true;
       continue;
     }
     available_ = false;
-    auto inputs = task->inputs;
-    auto *outputs = task->outputs;
-    auto before = task->before;
-    auto after = task->after;
-    auto status = Predict(*inputs, outputs, before, after);
+    auto start_time = std::chrono::steady_clock::now();
+    Status status;
+    if (tasks.size() == 1) {
+      auto task = tasks.front();
+      status = Predict(*task->inputs, task->outputs, task->before, task->after);
+    } else {
+      status = PredictBatch(tasks);
+    }
+    predict_task_queue_->RecordTaskLatency(tasks, start_time, std::chrono::steady_clock::now());
     if (status != kSuccess) {
       PrintWorkerInfo();
       MS_LOG(ERROR) << "model predict failed.";
+    }
+    for (auto task : tasks) {
+      task->status = status;
       task->ready = true;
       predict_task_queue_->ActiveTask(task);
-      continue;
     }
-    task->ready = true;
-    predict_task_queue_->ActiveTask(task);
   }
   MS_LOG(INFO) << "task queue all tasks completed.";
   delete model_;
@@ -283,4 +289,79 @@ Status ModelWorker::Predict(const std::vector<MSTensor> &inputs, std::vector<MST
   predict_task_queue_->ActiveTaskQueue();
   return kSuccess;
 }
+
+Status ModelWorker::PredictBatch(const std::vector<PredictTask *> &tasks) {
+  // Concat the inputs of the tasks in the first dim.
+  const auto &first_inputs = *tasks.front()->inputs;
+  std::vector<int64_t> batch_sizes;
+  int64_t total_batch_size = 0;
+  for (auto task : tasks) {
+    batch_sizes.push_back(task->inputs->front().Shape()[0]);
+    total_batch_size += batch_sizes.back();
+  }
+  std::vector<MSTensor> batch_inputs;
+  for (size_t i = 0; i < first_inputs.size(); i++) {
+    size_t data_size = 0;
+    for (auto task : tasks) {
+      data_size += task->inputs->at(i).DataSize();
+    }
+    auto data = static_cast<uint8_t *>(malloc(data_size));
+    if (data == nullptr) {
+      MS_LOG(ERROR) << "malloc batch input failed, size: " << data_size;
+      return kLiteMemoryFailed;
+    }
+    size_t offset = 0;
+    for (auto task : tasks) {
+      const auto &input = task->inputs->at(i);
+      memcpy(data + offset, input.Data().get(), input.DataSize());
+      offset += input.DataSize();
+    }
+    auto shape = first_inputs[i].Shape();
+    shape[0] = total_batch_size;
+    // The batch input owns the data.
+    auto batch_input =
+      MSTensor::CreateRefTensor(first_inputs[i].Name(), first_inputs[i].DataType(), shape, data, data_size, true);
+    if (batch_input == nullptr) {
+      MS_LOG(ERROR) << "create batch input failed.";
+      return kLiteError;
+    }
+    batch_inputs.push_back(*batch_input);
+    delete batch_input;
+  }
+  std::vector<MSTensor> batch_outputs;
+  auto status = Predict(batch_inputs, &batch_outputs);
+  if (status != kSuccess) {
+    MS_LOG(ERROR) << "model predict batch of " << tasks.size() << " tasks failed.";
+    return status;
+  }
+  // Scatter the outputs to the tasks in the first dim.
+  for (auto task : tasks) {
+    task->outputs->clear();
+  }
+  for (auto &batch_output : batch_outputs) {
+    auto shape = batch_output.Shape();
+    if (shape.empty() || shape[0] != total_batch_size) {
+      MS_LOG(ERROR) << "the output " << batch_output.Name() << " of shape " << shape
+                    << " is not batched in the first dim, batch size: " << total_batch_size;
+      return kLiteError;
+    }
+    auto row_size = batch_output.DataSize() / static_cast<size_t>(total_batch_size);
+    auto data = static_cast<const uint8_t *>(batch_output.Data().get());
+    size_t offset = 0;
+    for (size_t i = 0; i < tasks.size(); i++) {
+      shape[0] = batch_sizes[i];
+      auto data_size = row_size * static_cast<size_t>(batch_sizes[i]);
+      auto output =
+        MSTensor::CreateTensor(batch_output.Name(), batch_output.DataType(), shape, data + offset, data_size);
+      if (output == nullptr) {
+        MS_LOG(ERROR) << "create output of task failed.";
+        return kLiteError;
+      }
+      tasks[i]->outputs->push_back(*output);
+      delete output;
+      offset += data_size;
+    }
+  }
+  return kSuccess;
+}
 }  // namespace mindspore
@@ -28,6 +28,7 @@
 #include "src/extendrt/cxx_api/model_pool/predict_task_queue.h"
 namespace mindspore {
 class PredictTaskQueue;
+struct PredictTask;
 
 struct WorkerConfig {
   std::map<std::string, std::map<std::string, std::string>> config_info;
@@ -73,6 +74,9 @@ class ModelWorker {
 
   Status CopyOutputTensor(std::vector<MSTensor> model_outputs, std::vector<MSTensor> *user_outputs);
 
+  // Run the tasks of the same input shapes except the first dim as one batch, and scatter the outputs to the tasks.
+  Status PredictBatch(const std::vector<PredictTask *> &tasks);
+
   void PrintWorkerInfo();
 
  private:
@@ -15,10 +15,58 @@
  */
 
 #include "src/extendrt/cxx_api/model_pool/predict_task_queue.h"
+#include <algorithm>
 #include "src/common/log_adapter.h"
 namespace mindspore {
+namespace {
+int64_t ElapsedMicroseconds(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+// Return the rows of the batchable task, or 0 if the task can't be batched with the others.
+int64_t GetTaskBatchSize(const PredictTask *task) {
+  if (task->before != nullptr || task->after != nullptr || task->inputs == nullptr || task->inputs->empty() ||
+      task->outputs == nullptr) {
+    return 0;
+  }
+  // The outputs set by user are filled in place, which can't be scattered from the batch.
+  for (auto &output : *task->outputs) {
+    if (output.Data() != nullptr || output.GetDeviceData() != nullptr) {
+      return 0;
+    }
+  }
+  int64_t batch_size = 0;
+  for (auto &input : *task->inputs) {
+    const auto &shape = input.Shape();
+    if (shape.empty() || shape[0] <= 0 || (batch_size != 0 && shape[0] != batch_size) || input.Data() == nullptr ||
+        const_cast<MSTensor &>(input).GetDeviceData() != nullptr) {
+      return 0;
+    }
+    batch_size = shape[0];
+  }
+  return batch_size;
+}
+
+// The tasks can be batched if their inputs have the same data type and the same shape except the first dim.
+bool IsSameBatchInputs(const PredictTask *first_task, const PredictTask *task) {
+  if (first_task->inputs->size() != task->inputs->size()) {
+    return false;
+  }
+  for (size_t i = 0; i < task->inputs->size(); i++) {
+    const auto &first_input = first_task->inputs->at(i);
+    const auto &input = task->inputs->at(i);
+    if (first_input.DataType() != input.DataType() || first_input.Shape().size() != input.Shape().size() ||
+        !std::equal(first_input.Shape().begin() + 1, first_input.Shape().end(), input.Shape().begin() + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
 PredictTaskQueue::~PredictTaskQueue() {
   MS_LOG(INFO) << "free predict task queue.";
+  DumpLatencyStatistics();
   if (predict_task_ != nullptr) {
 #ifdef USE_HQUEUE
     for (size_t i = 0; i < task_queue_num_; i++) {
@@ -72,9 +120,17 @@ Status PredictTaskQueue::InitTaskQueue(size_t num, size_t max_queue_size) {
     MS_LOG(ERROR) << "new wait worker num list failed.";
     return kLiteError;
   }
+  batch_candidates_.resize(num);
   return kSuccess;
 }
 
+void PredictTaskQueue::EnableDynamicBatch(size_t max_batch_size, int64_t batch_timeout_us) {
+  max_batch_size_ = max_batch_size;
+  batch_timeout_ = std::chrono::microseconds(batch_timeout_us);
+  MS_LOG(INFO) << "enable dynamic batch, max batch size: " << max_batch_size << ", batch timeout: " << batch_timeout_us
+               << "us.";
+}
+
 void PredictTaskQueue::WaitUntilPredictActive(PredictTask *task, int node_id) {
   std::unique_lock<std::mutex> result_lock(task->task_done_mutex);
   while (!task->ready) {
@@ -97,6 +153,8 @@ void PredictTaskQueue::ActiveTaskQueue() {
 
 void PredictTaskQueue::PushPredictTask(PredictTask *task, int node_id) {
   idle_worker_num_[node_id] -= 1;
+  task->status = kSuccess;
+  task->push_time = std::chrono::steady_clock::now();
 #ifdef USE_HQUEUE
   while (!predict_task_[node_id].Enqueue(task)) {
   }
@@ -133,4 +191,98 @@ PredictTask *PredictTaskQueue::GetPredictTask(int node_id, ModelWorker *worker)
   return predict_task;
 #endif
 }
+
+void PredictTaskQueue::DrainTaskQueue(int node_id) {
+  auto &candidates = batch_candidates_[node_id];
+#ifdef USE_HQUEUE
+  while (!predict_task_[node_id].Empty()) {
+    auto task = predict_task_[node_id].Dequeue();
+    if (task == nullptr) {
+      break;
+    }
+    candidates.push_back(task);
+  }
+#else
+  while (!predict_task_[node_id].empty()) {
+    candidates.push_back(predict_task_[node_id].front());
+    predict_task_[node_id].pop();
+  }
+#endif
+}
+
+std::vector<PredictTask *> PredictTaskQueue::GetPredictTasks(int node_id, ModelWorker *worker) {
+  if (!IsDynamicBatchEnabled()) {
+    auto task = GetPredictTask(node_id, worker);
+    if (task == nullptr) {
+      return {};
+    }
+    return {task};
+  }
+  // The queued tasks are moved to the candidates, so that the tasks not batched keep their order in the candidates.
+  std::unique_lock<std::mutex> task_lock(mtx_predict_task_);
+  auto &candidates = batch_candidates_[node_id];
+  DrainTaskQueue(node_id);
+  while ((candidates.empty() || (!worker->IsAvailable())) && (!predict_task_done_)) {
+    task_push_cond_.wait(task_lock);
+    DrainTaskQueue(node_id);
+  }
+  if (predict_task_done_) {
+    return {};
+  }
+  std::vector<PredictTask *> tasks = {candidates.front()};
+  candidates.pop_front();
+  auto batch_size = GetTaskBatchSize(tasks.front());
+  const auto deadline = tasks.front()->push_time + batch_timeout_;
+  while (batch_size != 0) {
+    for (auto iter = candidates.begin(); iter != candidates.end();) {
+      auto task_batch_size = GetTaskBatchSize(*iter);
+      if (task_batch_size == 0 || static_cast<size_t>(batch_size + task_batch_size) > max_batch_size_ ||
+          !IsSameBatchInputs(tasks.front(), *iter)) {
+        ++iter;
+        continue;
+      }
+      tasks.push_back(*iter);
+      batch_size += task_batch_size;
+      iter = candidates.erase(iter);
+    }
+    if (static_cast<size_t>(batch_size) >= max_batch_size_ || predict_task_done_ ||
+        std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+    (void)task_push_cond_.wait_until(task_lock, deadline);
+    DrainTaskQueue(node_id);
+  }
+  // The tasks not batched are left in the candidates, wake up the other workers waiting for them.
+  if (!candidates.empty()) {
+    task_push_cond_.notify_all();
+  }
+  return tasks;
+}
+
+void PredictTaskQueue::RecordTaskLatency(const std::vector<PredictTask *> &tasks,
+                                         std::chrono::steady_clock::time_point start_time,
+                                         std::chrono::steady_clock::time_point end_time) {
+  int64_t wait_time_us = 0;
+  for (auto task : tasks) {
+    wait_time_us += ElapsedMicroseconds(task->push_time, start_time);
+  }
+  auto compute_time_us = ElapsedMicroseconds(start_time, end_time);
+  batch_num_ += 1;
+  batched_task_num_ += tasks.size();
+  total_wait_time_us_ += wait_time_us;
+  total_compute_time_us_ += compute_time_us;
+  MS_LOG(DEBUG) << "run " << tasks.size() << " tasks in one batch, average queue wait time: "
+                << wait_time_us / static_cast<int64_t>(tasks.size()) << "us, compute time: " << compute_time_us
+                << "us.";
+}
+
+void PredictTaskQueue::DumpLatencyStatistics() const {
+  if (batch_num_ == 0) {
+    return;
+  }
+  MS_LOG(INFO) << "predict task queue statistics, batch num: " << batch_num_ << ", task num: " << batched_task_num_
+               << ", average batch size: " << static_cast<double>(batched_task_num_) / batch_num_
+               << ", average queue wait time: " << total_wait_time_us_ / static_cast<int64_t>(batched_task_num_)
+               << "us, average compute time: " << total_compute_time_us_ / static_cast<int64_t>(batch_num_) << "us.";
+}
 }  // namespace mindspore
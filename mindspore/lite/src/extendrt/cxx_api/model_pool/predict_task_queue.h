@@ -17,6 +17,9 @@
 #define MINDSPORE_LITE_SRC_EXTENDRT_CXX_API_MODEL_POOL_PREDICT_TASK_QUEUE_H_
 
 #include <queue>
+#include <deque>
+#include <chrono>
+#include <atomic>
 #include <mutex>
 #include <memory>
 #include <vector>
@@ -41,6 +44,8 @@ struct PredictTask {
   std::atomic_bool ready;
   std::condition_variable task_done_condition;
   std::mutex task_done_mutex;
+  Status status;
+  std::chrono::steady_clock::time_point push_time;
 };
 
 class PredictTaskQueue {
@@ -51,6 +56,16 @@ class PredictTaskQueue {
   void PushPredictTask(PredictTask *task, int node_id);
   void WaitUntilPredictActive(PredictTask *task, int node_id);
   PredictTask *GetPredictTask(int node_id, ModelWorker *worker);
+  // Get the tasks run by the worker as one batch. With the dynamic batching enabled, the worker coalesces the queued
+  // tasks whose inputs differ only in the first dim, up to max_batch_size rows in total, and waits at most
+  // batch_timeout_us after the first task is pushed for the others. Otherwise it gets one task.
+  std::vector<PredictTask *> GetPredictTasks(int node_id, ModelWorker *worker);
+  void EnableDynamicBatch(size_t max_batch_size, int64_t batch_timeout_us);
+  bool IsDynamicBatchEnabled() const { return max_batch_size_ > 1; }
+  // Record the time the tasks wait in the queue and the time the worker computes them.
+  void RecordTaskLatency(const std::vector<PredictTask *> &tasks, std::chrono::steady_clock::time_point start_time,
+                         std::chrono::steady_clock::time_point end_time);
+  void DumpLatencyStatistics() const;
   void ActiveTask(PredictTask *task);
   void ActiveTaskQueue();
   Status InitTaskQueue(size_t num, size_t max_queue_size);
@@ -74,6 +89,16 @@ class PredictTaskQueue {
   std::condition_variable task_pop_cond_;
   std::condition_variable task_push_cond_;
   bool predict_task_done_ = false;
+
+  // dynamic batch
+  void DrainTaskQueue(int node_id);
+  std::vector<std::deque<PredictTask *>> batch_candidates_;
+  size_t max_batch_size_ = 0;
+  std::chrono::microseconds batch_timeout_{0};
+  std::atomic_size_t batch_num_{0};
+  std::atomic_size_t batched_task_num_{0};
+  std::atomic_int64_t total_wait_time_us_{0};
+  std::atomic_int64_t total_compute_time_us_{0};
 };
 }  // namespace mindspore
 #endif  // MINDSPORE_LITE_SRC_EXTENDRT_CXX_API_MODEL_POOL_PREDICT_TASK_QUEUE_H_
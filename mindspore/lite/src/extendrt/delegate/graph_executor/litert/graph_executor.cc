@@ -35,6 +35,8 @@
 #include "src/common/helper/external_tensor/memory_helper.h"
 #include "src/litert/kernel_exec.h"
 #include "src/extendrt/delegate/graph_executor/litert/func_graph_reuse_manager.h"
+#include "src/extendrt/shared_weight_store.h"
+#include "src/common/common.h"
 
 namespace mindspore {
 namespace {
@@ -107,6 +109,11 @@ bool LiteRTGraphExecutor::CompileGraph(const FuncGraphPtr &graph, const std::map
       MS_LOG(ERROR) << "func graph convert to meta graph failed.";
       return false;
     }
+    if (IsSharingWeight() && !ReferenceSharedWeights(graph, meta_graph)) {
+      MS_LOG(ERROR) << "Reference the shared weights failed.";
+      delete meta_graph;
+      return false;
+    }
     if (this->IsNeedExtractTensorData(meta_graph)) {
       if (!this->ExtractTensorData(meta_graph)) {
         MS_LOG(ERROR) << "Compile Large Graph failed, extract tensor data error.";
@@ -371,17 +378,57 @@ std::shared_ptr<lite::LiteSession> LiteRTGraphExecutor::CreateLiteSession(
   return session;
 }
 
-bool LiteRTGraphExecutor::ExtractTensorData(mindspore::schema::MetaGraphT *meta_graph_t) {
+bool LiteRTGraphExecutor::IsSharingWeight() const {
+  auto model_file = config_infos_.find(lite::kConfigModelFileSection);
+  if (model_file == config_infos_.end()) {
+    return false;
+  }
+  auto sharing_iter = model_file->second.find(lite::kConfigSharingWeightKey);
+  return sharing_iter != model_file->second.end() && sharing_iter->second == "true";
+}
+
+bool LiteRTGraphExecutor::ReferenceSharedWeights(const FuncGraphPtr &graph,
+                                                 mindspore::schema::MetaGraphT *meta_graph_t) {
   MS_EXCEPTION_IF_NULL(meta_graph_t);
-  helpers_ = std::make_shared<mindspore::infer::helper::InferHelpers>();
+  // The lite session reads the shared weights through the helper instead of the copies in the model buffer.
+  auto tensor_helper = new (std::nothrow) SharedWeightTensorHelper();
+  if (tensor_helper == nullptr) {
+    MS_LOG(ERROR) << "Create Shared Weight TensorHelper failed.";
+    return false;
+  }
+  auto shared_size =
+    SharedWeightStore::ReferenceSharedWeights(std::const_pointer_cast<FuncGraph>(graph), meta_graph_t, tensor_helper);
+  if (shared_size == 0) {
+    delete tensor_helper;
+    return true;
+  }
+  helpers_ = std::make_shared<mindspore::infer::helper::InferHelpers>(tensor_helper);
   if (helpers_ == nullptr) {
     MS_LOG(ERROR) << "Create InferHelpers failed.";
+    delete tensor_helper;
     return false;
   }
-  auto tensor_helper = new (std::nothrow) mindspore::infer::helper::MemoryExternalTensorHelper();
+  return true;
+}
+
+bool LiteRTGraphExecutor::ExtractTensorData(mindspore::schema::MetaGraphT *meta_graph_t) {
+  MS_EXCEPTION_IF_NULL(meta_graph_t);
+  // The helper referencing the shared weights copies the extracted data as well.
+  if (helpers_ == nullptr) {
+    helpers_ = std::make_shared<mindspore::infer::helper::InferHelpers>();
+    if (helpers_ == nullptr) {
+      MS_LOG(ERROR) << "Create InferHelpers failed.";
+      return false;
+    }
+  }
+  auto tensor_helper = helpers_->GetExternalTensorHelper();
   if (tensor_helper == nullptr) {
-    MS_LOG(ERROR) << "Create Memory External TensorHelper failed.";
-    return false;
+    tensor_helper = new (std::nothrow) mindspore::infer::helper::MemoryExternalTensorHelper();
+    if (tensor_helper == nullptr) {
+      MS_LOG(ERROR) << "Create Memory External TensorHelper failed.";
+      return false;
+    }
+    helpers_->SetExternalTensorHelper(tensor_helper);
   }
   int64_t cur_offset = 0;
   size_t size = 0;
@@ -393,6 +440,9 @@ bool LiteRTGraphExecutor::ExtractTensorData(mindspore::schema::MetaGraphT *meta_
     if (tensor->dataType == kObjectTypeTensorType) {  // not support control-flow now
       continue;
     }
+    if (!tensor->externalData.empty()) {  // the shared weight referenced already
+      continue;
+    }
     auto *external_data_t = new (std::nothrow) schema::ExternalDataT;
     if (external_data_t == nullptr) {
       MS_LOG(ERROR) << "Create ExternalDataT failed";
@@ -417,7 +467,6 @@ bool LiteRTGraphExecutor::ExtractTensorData(mindspore::schema::MetaGraphT *meta_
     tensor->data.clear();
     tensor->externalData.emplace_back(external_data_t);
   }
-  helpers_->SetExternalTensorHelper(tensor_helper);
   return true;
 }
 
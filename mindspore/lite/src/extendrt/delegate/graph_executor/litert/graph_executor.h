@@ -59,6 +59,8 @@ class LiteRTGraphExecutor : public LiteGraphExecutor {
                                      bool verify_size);
 
  private:
+  bool IsSharingWeight() const;
+  bool ReferenceSharedWeights(const FuncGraphPtr &graph, mindspore::schema::MetaGraphT *meta_graph_t);
   bool ExtractTensorData(mindspore::schema::MetaGraphT *meta_graph_t);
   bool IsNeedExtractTensorData(mindspore::schema::MetaGraphT *meta_graph_t);
 
@@ -0,0 +1,313 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "src/extendrt/shared_weight_store.h"
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <string_view>
+#include <utility>
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "src/common/log_adapter.h"
+
+namespace mindspore {
+namespace {
+// Keep the weights aligned for the vectorized kernels.
+constexpr size_t kWeightAlignSize = 64;
+
+size_t AlignWeightSize(size_t size) { return (size + kWeightAlignSize - 1) / kWeightAlignSize * kWeightAlignSize; }
+
+tensor::TensorPtr GetWeightTensor(const ParameterPtr &parameter) {
+  if (parameter == nullptr || !parameter->has_default()) {
+    return nullptr;
+  }
+  auto tensor = parameter->default_param()->cast<tensor::TensorPtr>();
+  if (tensor == nullptr || tensor->data_ptr() == nullptr || tensor->data().const_data() == nullptr ||
+      tensor->data().nbytes() <= 0 || tensor->compression_type() != kNoCompression) {
+    return nullptr;
+  }
+  return tensor;
+}
+
+std::string GetExternalDataKey(const std::string &location, int64_t offset) {
+  return location + std::to_string(offset);
+}
+
+#ifdef __linux__
+int CreateMemFile(const std::string &name) {
+#ifdef SYS_memfd_create
+  return static_cast<int>(syscall(SYS_memfd_create, name.c_str(), 0));
+#else
+  return -1;
+#endif
+}
+
+bool WriteFile(int fd, size_t offset, const void *data, size_t size) {
+  auto buf = static_cast<const uint8_t *>(data);
+  while (size > 0) {
+    auto ret = pwrite(fd, buf, size, static_cast<off_t>(offset));
+    if (ret <= 0) {
+      return false;
+    }
+    buf += ret;
+    offset += static_cast<size_t>(ret);
+    size -= static_cast<size_t>(ret);
+  }
+  return true;
+}
+#endif
+}  // namespace
+
+SharedWeightFile::~SharedWeightFile() {
+#ifdef __linux__
+  if (fd >= 0) {
+    (void)close(fd);
+    fd = -1;
+  }
+#endif
+}
+
+SharedWeightView::~SharedWeightView() {
+#ifdef __linux__
+  if (addr_ != nullptr && file_ != nullptr) {
+    (void)munmap(addr_, file_->file_size);
+    addr_ = nullptr;
+  }
+#endif
+}
+
+std::string SharedWeightTensorData::ToString(TypeId type, const ShapeVector &shape, bool use_comma) const {
+  std::stringstream stream;
+  stream << "SharedWeightTensor:[";
+  for (size_t i = 0; i < shape.size(); i++) {
+    stream << shape[i];
+    if (i + 1 < shape.size()) {
+      stream << ",";
+    }
+  }
+  stream << "]" << type;
+  return stream.str();
+}
+
+SharedWeightTensorHelper::~SharedWeightTensorHelper() {
+  for (auto &item : copied_data_) {
+    free(item.second);
+  }
+  copied_data_.clear();
+}
+
+void *SharedWeightTensorHelper::GetExternalTensorData(const schema::ExternalData *external_info) {
+  if (external_info == nullptr || external_info->location() == nullptr) {
+    MS_LOG(ERROR) << "The external info is invalid.";
+    return nullptr;
+  }
+  auto key = GetExternalDataKey(external_info->location()->str(), external_info->offset());
+  auto shared_iter = shared_data_.find(key);
+  if (shared_iter != shared_data_.end()) {
+    return shared_iter->second->data();
+  }
+  auto copied_iter = copied_data_.find(key);
+  return copied_iter == copied_data_.end() ? nullptr : copied_iter->second;
+}
+
+void SharedWeightTensorHelper::SetExternalTensorData(const schema::ExternalData *external_info, void *data) {
+  if (external_info == nullptr || external_info->location() == nullptr || data == nullptr ||
+      external_info->length() <= 0) {
+    MS_LOG(ERROR) << "The external info or the data is invalid.";
+    return;
+  }
+  auto size = static_cast<size_t>(external_info->length());
+  auto new_data = malloc(size);
+  if (new_data == nullptr) {
+    MS_LOG(ERROR) << "Malloc the external data of size " << size << " failed.";
+    return;
+  }
+  (void)memcpy(new_data, data, size);
+  auto key = GetExternalDataKey(external_info->location()->str(), external_info->offset());
+  auto iter = copied_data_.find(key);
+  if (iter != copied_data_.end()) {
+    free(iter->second);
+  }
+  copied_data_[key] = new_data;
+}
+
+void SharedWeightTensorHelper::AddSharedWeight(const schema::ExternalDataT &external_info,
+                                               const tensor::TensorDataPtr &data) {
+  shared_data_[GetExternalDataKey(external_info.location, external_info.offset)] = data;
+}
+
+SharedWeightStore *SharedWeightStore::GetInstance() {
+  static SharedWeightStore instance;
+  return &instance;
+}
+
+std::string SharedWeightStore::GenModelKey(const void *model_buf, size_t model_size, const std::string &weight_path) {
+  if (model_buf == nullptr || model_size == 0) {
+    return "";
+  }
+  auto hash = std::hash<std::string_view>{}(std::string_view(static_cast<const char *>(model_buf), model_size));
+  return std::to_string(hash) + "_" + std::to_string(model_size) + "_" + weight_path;
+}
+
+std::shared_ptr<SharedWeightFile> SharedWeightStore::GetOrCreateFile(const std::string &model_key,
+                                                                     const std::vector<ParameterPtr> &weights) {
+  auto iter = files_.find(model_key);
+  if (iter != files_.end()) {
+    auto file = iter->second.lock();
+    if (file != nullptr) {
+      return file;
+    }
+    (void)files_.erase(iter);
+  }
+#ifdef __linux__
+  auto file = std::make_shared<SharedWeightFile>();
+  for (const auto &weight : weights) {
+    auto tensor = GetWeightTensor(weight);
+    auto size = static_cast<size_t>(tensor->data().nbytes());
+    file->slots[weight->name()] = {file->file_size, size, tensor->data_type()};
+    file->file_size += AlignWeightSize(size);
+  }
+  file->fd = CreateMemFile("mindspore_lite_weight");
+  if (file->fd < 0) {
+    MS_LOG(WARNING) << "Create the shared weight file failed, errno: " << errno;
+    return nullptr;
+  }
+  if (ftruncate(file->fd, static_cast<off_t>(file->file_size)) != 0) {
+    MS_LOG(WARNING) << "Resize the shared weight file to " << file->file_size << " failed, errno: " << errno;
+    return nullptr;
+  }
+  for (const auto &weight : weights) {
+    auto tensor = GetWeightTensor(weight);
+    const auto &slot = file->slots[weight->name()];
+    if (!WriteFile(file->fd, slot.offset, tensor->data().const_data(), slot.size)) {
+      MS_LOG(WARNING) << "Write the weight " << weight->name() << " to the shared weight file failed, errno: " << errno;
+      return nullptr;
+    }
+  }
+  files_[model_key] = file;
+  MS_LOG(INFO) << "Create the shared weight file of " << weights.size() << " weights, size: " << file->file_size;
+  return file;
+#else
+  return nullptr;
+#endif
+}
+
+Status SharedWeightStore::ShareWeights(const FuncGraphPtr &func_graph, const std::string &model_key) {
+  if (func_graph == nullptr || model_key.empty()) {
+    MS_LOG(ERROR) << "The func graph or the model key is invalid.";
+    return kLiteNullptr;
+  }
+  std::vector<ParameterPtr> weights;
+  for (const auto &node : func_graph->parameters()) {
+    auto parameter = node->cast<ParameterPtr>();
+    if (GetWeightTensor(parameter) != nullptr) {
+      weights.push_back(parameter);
+    }
+  }
+  if (weights.empty()) {
+    return kSuccess;
+  }
+#ifdef __linux__
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto file = GetOrCreateFile(model_key, weights);
+  if (file == nullptr) {
+    MS_LOG(WARNING) << "Share the weights failed, the session keeps the private weights.";
+    return kSuccess;
+  }
+  // Map the file privately, the pages written by this session are copied and the others are shared.
+  auto addr = mmap(nullptr, file->file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file->fd, 0);
+  if (addr == MAP_FAILED) {
+    MS_LOG(WARNING) << "Map the shared weight file failed, errno: " << errno
+                    << ", the session keeps the private weights.";
+    return kSuccess;
+  }
+  auto view = std::make_shared<SharedWeightView>(file, addr);
+  size_t shared_size = 0;
+  for (const auto &weight : weights) {
+    auto tensor = GetWeightTensor(weight);
+    auto slot_iter = file->slots.find(weight->name());
+    if (slot_iter == file->slots.end()) {
+      continue;
+    }
+    const auto &slot = slot_iter->second;
+    // The weights converted differently keep private.
+    const auto &data = tensor->data();
+    if (slot.data_type != tensor->data_type() || slot.size != static_cast<size_t>(data.nbytes()) ||
+        memcmp(view->addr() + slot.offset, data.const_data(), slot.size) != 0) {
+      MS_LOG(INFO) << "The weight " << weight->name() << " is different from the shared one, keep it private.";
+      continue;
+    }
+    auto shared_data = std::make_shared<SharedWeightTensorData>(view, slot.offset, data);
+    auto shared_tensor = std::make_shared<tensor::Tensor>(tensor->data_type(), tensor->shape(), shared_data);
+    shared_tensor->set_name(tensor->name());
+    if (tensor->param_info() != nullptr) {
+      shared_tensor->set_param_info(tensor->param_info());
+    }
+    weight->set_default_param(shared_tensor);
+    shared_size += slot.size;
+  }
+  MS_LOG(INFO) << "Share the weights of size " << shared_size << " with the sessions of the same model.";
+#endif
+  return kSuccess;
+}
+
+size_t SharedWeightStore::ReferenceSharedWeights(const FuncGraphPtr &func_graph, schema::MetaGraphT *meta_graph,
+                                                 SharedWeightTensorHelper *helper) {
+  if (func_graph == nullptr || meta_graph == nullptr || helper == nullptr) {
+    MS_LOG(ERROR) << "The func graph, the meta graph or the helper is nullptr.";
+    return 0;
+  }
+  std::unordered_map<std::string, tensor::TensorDataPtr> shared_weights;
+  for (const auto &node : func_graph->parameters()) {
+    auto parameter = node->cast<ParameterPtr>();
+    auto tensor = GetWeightTensor(parameter);
+    if (tensor != nullptr && std::dynamic_pointer_cast<SharedWeightTensorData>(tensor->data_ptr()) != nullptr) {
+      shared_weights[parameter->name()] = tensor->data_ptr();
+    }
+  }
+  size_t shared_size = 0;
+  for (auto &tensor : meta_graph->allTensors) {
+    if (tensor == nullptr || tensor->data.empty() || !tensor->externalData.empty() ||
+        tensor->dataType == kObjectTypeTensorType) {
+      continue;
+    }
+    auto iter = shared_weights.find(tensor->name);
+    if (iter == shared_weights.end()) {
+      continue;
+    }
+    // The weights transformed by the conversion keep in the model buffer.
+    const auto &shared_data = iter->second;
+    if (static_cast<size_t>(shared_data->nbytes()) != tensor->data.size() ||
+        memcmp(shared_data->const_data(), tensor->data.data(), tensor->data.size()) != 0) {
+      continue;
+    }
+    auto external_data = std::make_unique<schema::ExternalDataT>();
+    external_data->location = "SHARED: " + tensor->name;
+    external_data->offset = 0;
+    external_data->length = static_cast<int64_t>(tensor->data.size());
+    helper->AddSharedWeight(*external_data, shared_data);
+    shared_size += tensor->data.size();
+    std::vector<uint8_t>().swap(tensor->data);
+    tensor->externalData.emplace_back(std::move(external_data));
+  }
+  MS_LOG(INFO) << "Reference the shared weights of size " << shared_size << " in the model.";
+  return shared_size;
+}
+}  // namespace mindspore
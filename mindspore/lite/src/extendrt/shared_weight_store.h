@@ -0,0 +1,138 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_LITE_SRC_EXTENDRT_SHARED_WEIGHT_STORE_H_
+#define MINDSPORE_LITE_SRC_EXTENDRT_SHARED_WEIGHT_STORE_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "include/api/status.h"
+#include "ir/func_graph.h"
+#include "ir/tensor.h"
+#include "schema/inner/model_generated.h"
+#include "src/common/helper/external_tensor/helper.h"
+
+namespace mindspore {
+// The file holding the weights of a model, which is shared by all the sessions loading the same model.
+struct SharedWeightFile {
+  struct WeightSlot {
+    size_t offset = 0;
+    size_t size = 0;
+    TypeId data_type = kTypeUnknown;
+  };
+  ~SharedWeightFile();
+
+  int fd = -1;
+  size_t file_size = 0;
+  // tensor name <=> the location of weight in the file
+  std::unordered_map<std::string, WeightSlot> slots;
+};
+
+// The private copy-on-write mapping of the shared weight file in one session. The pages are shared with the other
+// sessions until they are written by this session.
+class SharedWeightView {
+ public:
+  SharedWeightView(const std::shared_ptr<SharedWeightFile> &file, void *addr) : file_(file), addr_(addr) {}
+  ~SharedWeightView();
+
+  uint8_t *addr() const { return static_cast<uint8_t *>(addr_); }
+
+ private:
+  std::shared_ptr<SharedWeightFile> file_;
+  void *addr_ = nullptr;
+};
+
+class SharedWeightTensorData : public tensor::TensorData {
+ public:
+  SharedWeightTensorData(const std::shared_ptr<SharedWeightView> &view, size_t offset, const tensor::TensorData &origin)
+      : view_(view),
+        offset_(offset),
+        elem_count_(origin.size()),
+        item_size_(origin.itemsize()),
+        data_size_(origin.nbytes()),
+        ndim_(origin.ndim()) {}
+  ~SharedWeightTensorData() override = default;
+
+  ssize_t size() const override { return elem_count_; }
+  ssize_t itemsize() const override { return item_size_; }
+  ssize_t nbytes() const override { return data_size_; }
+  ssize_t ndim() const override { return ndim_; }
+  void *data() override { return view_->addr() + offset_; }
+  const void *const_data() const override { return view_->addr() + offset_; }
+  bool is_sub_data() const override { return false; }
+  bool has_sub_data() const override { return false; }
+  std::string ToString(TypeId type, const ShapeVector &shape, bool use_comma) const override;
+
+ private:
+  std::shared_ptr<SharedWeightView> view_;
+  size_t offset_ = 0;
+  ssize_t elem_count_ = 0;
+  ssize_t item_size_ = 0;
+  ssize_t data_size_ = 0;
+  ssize_t ndim_ = 0;
+};
+
+// The external tensor helper of the lite session converted from the func graph, which references the shared weights
+// instead of serializing them into the model buffer. The other weights extracted from the model are copied.
+class SharedWeightTensorHelper : public infer::helper::ExternalTensorHelper {
+ public:
+  SharedWeightTensorHelper() = default;
+  ~SharedWeightTensorHelper() override;
+
+  void *GetExternalTensorData(const schema::ExternalData *external_info) override;
+  void SetExternalTensorData(const schema::ExternalData *external_info, void *data) override;
+  // The shared weight is kept alive by the helper, so the sessions loading the model from the cached model buffer can
+  // outlive the func graph.
+  void AddSharedWeight(const schema::ExternalDataT &external_info, const tensor::TensorDataPtr &data);
+
+ private:
+  std::unordered_map<std::string, void *> copied_data_;
+  std::unordered_map<std::string, tensor::TensorDataPtr> shared_data_;
+};
+
+// The process-wide store of the model weights keyed by the hash of model file. The weights of the first session are
+// staged into an in-memory file, and every session maps the file privately and replaces its weights with the mapped
+// ones, so the replicas of a model share the physical pages of weights. The kernels packing the weights read the
+// shared pages, and the kernel writing the weights in place copies only the pages it writes. The file is released
+// when all the sessions using it are destructed.
+// The weights are shared in the form after the online conversion, the compressed weights keep private since the shared
+// tensor can't carry the compression type. Only the LiteRT executor references the shared weights, by
+// ReferenceSharedWeights, the executors copying the weights into the device memory don't benefit from the sharing.
+class SharedWeightStore {
+ public:
+  static SharedWeightStore *GetInstance();
+  ~SharedWeightStore() = default;
+
+  static std::string GenModelKey(const void *model_buf, size_t model_size, const std::string &weight_path);
+  // Replace the weights of the func graph with the ones shared with the other sessions of the same model key.
+  Status ShareWeights(const FuncGraphPtr &func_graph, const std::string &model_key);
+  // Replace the data of the meta graph tensors equal to the shared weights of the func graph with the external data
+  // referencing the shared weights, and return the size of the weights referenced.
+  static size_t ReferenceSharedWeights(const FuncGraphPtr &func_graph, schema::MetaGraphT *meta_graph,
+                                       SharedWeightTensorHelper *helper);
+
+ private:
+  SharedWeightStore() = default;
+  std::shared_ptr<SharedWeightFile> GetOrCreateFile(const std::string &model_key,
+                                                    const std::vector<ParameterPtr> &weights);
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::weak_ptr<SharedWeightFile>> files_;
+};
+}  // namespace mindspore
+#endif  // MINDSPORE_LITE_SRC_EXTENDRT_SHARED_WEIGHT_STORE_H_
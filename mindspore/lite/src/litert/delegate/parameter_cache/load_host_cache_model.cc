@@ -50,7 +50,8 @@ MSTensor *SchemaTensorToMSTensor(lite::SchemaTensorWrapper *schema_tensor_wrappe
 }
 
 Status HostCacheModel::LoadCache(const std::string &model_path) {
-  cache_model_ = lite::LiteImportFromPath(model_path.c_str());
+  // The embedding tables are referenced by the cache tensors, map the model to read the rows on demand.
+  cache_model_ = lite::LiteImportFromPath(model_path.c_str(), true);
   if (cache_model_ == nullptr) {
     MS_LOG(ERROR) << "Import model failed";
     return kLiteGraphFileError;
@@ -0,0 +1,210 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/litert/kernel/cpu/fp32/kv_cache_attention_fp32.h"
+#include "nnacl/fp32/attention_fp32.h"
+#include "src/litert/kernel_registry.h"
+#include "include/errorcode.h"
+#include "src/common/log_adapter.h"
+#include "src/common/common.h"
+
+using mindspore::lite::KernelRegistrar;
+using mindspore::lite::RET_ERROR;
+using mindspore::lite::RET_MEMORY_FAILED;
+using mindspore::lite::RET_NOT_SUPPORT;
+using mindspore::lite::RET_OK;
+
+namespace mindspore::kernel {
+namespace {
+constexpr size_t kMinInputSize = 3;
+constexpr size_t kPositionIndex = 3;
+constexpr size_t kSequenceIdIndex = 4;
+constexpr size_t kShapeSize = 4;
+}  // namespace
+
+KVCacheAttentionCPUKernel::~KVCacheAttentionCPUKernel() { FreeCache(); }
+
+int KVCacheAttentionCPUKernel::Prepare() {
+  CHECK_LESS_RETURN(in_tensors_.size(), kMinInputSize);
+  CHECK_LESS_RETURN(out_tensors_.size(), 1);
+  CHECK_NULL_RETURN(param_);
+  if (param_->max_seq_len_ <= 0) {
+    MS_LOG(ERROR) << "The max_seq_len " << param_->max_seq_len_ << " of KVCacheAttention is invalid.";
+    return RET_ERROR;
+  }
+  if (in_tensors_.size() > kPositionIndex && in_tensors_[kPositionIndex]->data_type() != kNumberTypeInt32) {
+    MS_LOG(ERROR) << "The position of KVCacheAttention should be int32.";
+    return RET_ERROR;
+  }
+  if (in_tensors_.size() > kSequenceIdIndex && in_tensors_[kSequenceIdIndex]->data_type() != kNumberTypeInt32) {
+    MS_LOG(ERROR) << "The sequence id of KVCacheAttention should be int32.";
+    return RET_ERROR;
+  }
+  // The workers of the model parallel runner have their own caches and a sequence would be split over them.
+  if (!GetConfig(lite::kInnerModelParallelRunnerSection).empty()) {
+    MS_LOG(ERROR) << "KVCacheAttention keeps the sequence in the kernel and is not supported by the model parallel "
+                     "runner, use one model for each sequence instead.";
+    return RET_NOT_SUPPORT;
+  }
+  if (!InferShapeDone()) {
+    return RET_OK;
+  }
+  return ReSize();
+}
+
+int KVCacheAttentionCPUKernel::ReSize() {
+  auto shape = in_tensors_[0]->shape();
+  if (shape.size() != kShapeSize) {
+    MS_LOG(ERROR) << "The query of KVCacheAttention should be [batch, head_num, seq, head_size].";
+    return RET_ERROR;
+  }
+  param_->batch_ = shape[0];
+  param_->head_num_ = shape[1];
+  param_->q_seq_ = shape[kShapeSize - 2];
+  param_->head_size_ = shape[kShapeSize - 1];
+  if (param_->q_seq_ > param_->max_seq_len_) {
+    MS_LOG(ERROR) << "The sequence length " << param_->q_seq_ << " exceeds the max_seq_len " << param_->max_seq_len_;
+    return RET_ERROR;
+  }
+  thread_num_ = MSMAX(1, MSMIN(op_parameter_->thread_num_, param_->batch_ * param_->head_num_));
+  // The cache is kept when only the sequence length changes, e.g. from the prompt to the decoding steps.
+  if (k_cache_ != nullptr && cache_batch_ == param_->batch_ && cache_head_num_ == param_->head_num_ &&
+      cache_head_size_ == param_->head_size_) {
+    return RET_OK;
+  }
+  return MallocCache();
+}
+
+int KVCacheAttentionCPUKernel::MallocCache() {
+  FreeCache();
+  size_t cache_size = static_cast<size_t>(param_->batch_) * param_->head_num_ * param_->max_seq_len_ *
+                      param_->head_size_ * sizeof(float);
+  if (cache_size == 0) {
+    MS_LOG(ERROR) << "The cache size of KVCacheAttention is 0.";
+    return RET_ERROR;
+  }
+  k_cache_ = reinterpret_cast<float *>(malloc(cache_size));
+  v_cache_ = reinterpret_cast<float *>(malloc(cache_size));
+  if (k_cache_ == nullptr || v_cache_ == nullptr) {
+    MS_LOG(ERROR) << "Malloc the key/value cache of size " << cache_size << " failed.";
+    FreeCache();
+    return RET_MEMORY_FAILED;
+  }
+  cache_batch_ = param_->batch_;
+  cache_head_num_ = param_->head_num_;
+  cache_head_size_ = param_->head_size_;
+  cached_len_ = 0;
+  return RET_OK;
+}
+
+void KVCacheAttentionCPUKernel::FreeCache() {
+  if (k_cache_ != nullptr) {
+    free(k_cache_);
+    k_cache_ = nullptr;
+  }
+  if (v_cache_ != nullptr) {
+    free(v_cache_);
+    v_cache_ = nullptr;
+  }
+  cached_len_ = 0;
+}
+
+int KVCacheAttentionCPUKernel::CheckSequenceId(int past_len) {
+  if (in_tensors_.size() <= kSequenceIdIndex) {
+    return RET_OK;
+  }
+  auto seq_id = reinterpret_cast<int *>(in_tensors_[kSequenceIdIndex]->data());
+  CHECK_NULL_RETURN(seq_id);
+  if (past_len != 0 && seq_id[0] != cached_seq_id_) {
+    MS_LOG(ERROR) << "The sequence " << seq_id[0] << " of KVCacheAttention can't continue the cached sequence "
+                  << cached_seq_id_ << ", one session only holds one sequence.";
+    return RET_ERROR;
+  }
+  cached_seq_id_ = seq_id[0];
+  return RET_OK;
+}
+
+int KVCacheAttentionCPUKernel::UpdatePastLen() {
+  if (in_tensors_.size() <= kPositionIndex) {
+    param_->past_len_ = cached_len_;
+    return CheckSequenceId(cached_len_);
+  }
+  auto position = reinterpret_cast<int *>(in_tensors_[kPositionIndex]->data());
+  CHECK_NULL_RETURN(position);
+  int past_len = position[0];
+  // Rolling back is allowed while the tokens attended are not overwritten by the rolled back ones.
+  bool overwritten = cached_len_ > past_len + param_->q_seq_ && cached_len_ > param_->max_seq_len_;
+  if (past_len < 0 || past_len > cached_len_ || (past_len != 0 && overwritten)) {
+    MS_LOG(ERROR) << "The position " << past_len << " of KVCacheAttention is invalid, the cached length is "
+                  << cached_len_;
+    return RET_ERROR;
+  }
+  param_->past_len_ = past_len;
+  return CheckSequenceId(past_len);
+}
+
+int KVCacheAttentionCPUKernel::DoAttention(int task_id) {
+  auto q = reinterpret_cast<const float *>(in_tensors_[0]->data());
+  auto k = reinterpret_cast<const float *>(in_tensors_[1]->data());
+  auto v = reinterpret_cast<const float *>(in_tensors_[kMinInputSize - 1]->data());
+  auto output = reinterpret_cast<float *>(out_tensors_[0]->data());
+  CHECK_NULL_RETURN(q);
+  CHECK_NULL_RETURN(k);
+  CHECK_NULL_RETURN(v);
+  CHECK_NULL_RETURN(output);
+  // Each task owns the whole heads, so the cache of a head is written and read by the same task.
+  KVCacheUpdate(k, v, k_cache_, v_cache_, param_, task_id, thread_num_);
+  auto ret = KVCacheAttention(q, k_cache_, v_cache_, output, score_buf_ + task_id * param_->max_seq_len_, param_,
+                              task_id, thread_num_);
+  if (ret != NNACL_OK) {
+    MS_LOG(ERROR) << "KVCacheAttention error task_id[" << task_id << "] error_code[" << ret << "]";
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
+
+int KVCacheAttentionRun(void *cdata, int task_id, float lhs_scale, float rhs_scale) {
+  CHECK_NULL_RETURN(cdata);
+  auto kernel = reinterpret_cast<KVCacheAttentionCPUKernel *>(cdata);
+  return kernel->DoAttention(task_id);
+}
+
+int KVCacheAttentionCPUKernel::Run() {
+  auto ret = UpdatePastLen();
+  if (ret != RET_OK) {
+    return ret;
+  }
+  score_buf_ = reinterpret_cast<float *>(
+    ms_context_->allocator->Malloc(static_cast<size_t>(thread_num_) * param_->max_seq_len_ * sizeof(float)));
+  if (score_buf_ == nullptr) {
+    MS_LOG(ERROR) << "Malloc the score buffer of KVCacheAttention failed.";
+    return RET_MEMORY_FAILED;
+  }
+  ret = ParallelLaunch(this->ms_context_, KVCacheAttentionRun, this, thread_num_);
+  ms_context_->allocator->Free(score_buf_);
+  score_buf_ = nullptr;
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "KVCacheAttention run error, error_code[" << ret << "]";
+    // The cache may be partially updated, start a new sequence at the next step.
+    cached_len_ = 0;
+    return RET_ERROR;
+  }
+  cached_len_ = param_->past_len_ + param_->q_seq_;
+  return RET_OK;
+}
+
+REG_KERNEL(kCPU, kNumberTypeFloat32, PrimType_Inner_KVCacheAttention, LiteKernelCreator<KVCacheAttentionCPUKernel>)
+}  // namespace mindspore::kernel
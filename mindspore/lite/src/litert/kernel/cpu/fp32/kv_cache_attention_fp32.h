@@ -0,0 +1,69 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_LITERT_KERNEL_CPU_FP32_KV_CACHE_ATTENTION_FP32_H_
+#define MINDSPORE_LITE_SRC_LITERT_KERNEL_CPU_FP32_KV_CACHE_ATTENTION_FP32_H_
+
+#include <vector>
+#include "src/litert/lite_kernel.h"
+#include "nnacl/attention_parameter.h"
+
+namespace mindspore::kernel {
+// The attention of the autoregressive decoder, which is the custom op of type "KVCacheAttention" with the int32
+// attr max_seq_len. The keys and values of the processed tokens are kept in the ring buffer of the kernel across the
+// predict calls, so each decoding step only computes the projection of the new tokens and attends the cached ones.
+// inputs: 0:Q 1:K 2:V [batch, head_num, q_seq, head_size] 3:position (optional) 4:sequence id (optional)
+// The position is the number of tokens processed before this step, 0 starts a new sequence. Without it the kernel
+// continues the sequence of the last step.
+// The cache holds one sequence per session: the steps of interleaved sequences must not share a session, a step of
+// another sequence id is rejected unless it starts a new sequence. The kernel is rejected in the model parallel
+// runner, which dispatches the steps of one sequence to any of its workers.
+class KVCacheAttentionCPUKernel : public LiteKernel {
+ public:
+  KVCacheAttentionCPUKernel(OpParameter *parameter, const std::vector<lite::Tensor *> &inputs,
+                            const std::vector<lite::Tensor *> &outputs, const lite::InnerContext *ctx)
+      : LiteKernel(parameter, inputs, outputs, ctx) {
+    param_ = reinterpret_cast<KVCacheAttentionParameter *>(op_parameter_);
+  }
+  ~KVCacheAttentionCPUKernel() override;
+
+  int Prepare() override;
+  int ReSize() override;
+  int Run() override;
+  int DoAttention(int task_id);
+
+ private:
+  int MallocCache();
+  void FreeCache();
+  int UpdatePastLen();
+  int CheckSequenceId(int past_len);
+
+  KVCacheAttentionParameter *param_ = nullptr;
+  // [batch, head_num, max_seq_len, head_size]
+  float *k_cache_ = nullptr;
+  float *v_cache_ = nullptr;
+  int cache_batch_ = 0;
+  int cache_head_num_ = 0;
+  int cache_head_size_ = 0;
+  // the number of tokens written into the cache.
+  int cached_len_ = 0;
+  // the id of the sequence in the cache.
+  int cached_seq_id_ = 0;
+  float *score_buf_ = nullptr;
+};
+}  // namespace mindspore::kernel
+
+#endif  // MINDSPORE_LITE_SRC_LITERT_KERNEL_CPU_FP32_KV_CACHE_ATTENTION_FP32_H_
@@ -0,0 +1,205 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "src/litert/kernel/cpu/fp32/online_fusion/elementwise_fusion_fp32.h"
+#include <algorithm>
+#include "nnacl/fp32/online_fusion/elementwise_fusion_fp32.h"
+#include "nnacl/base/broadcast_to.h"
+#include "src/litert/kernel_registry.h"
+#include "include/errorcode.h"
+#include "src/common/log_adapter.h"
+
+using mindspore::lite::KernelRegistrar;
+using mindspore::lite::RET_ERROR;
+using mindspore::lite::RET_OK;
+
+namespace mindspore::kernel {
+namespace {
+// 8KB of fp32 elements, a block and the operands of the same size stay in the L1 cache through all the ops.
+constexpr int64_t kElementwiseFusionBlockSize = 2048;
+
+// numpy broadcast rule: the trailing axes are the same or 1, and the extra leading axes of the operand are 1.
+bool CanBroadcastTo(const std::vector<int> &shape, const std::vector<int> &out_shape) {
+  auto gap = static_cast<int>(out_shape.size()) - static_cast<int>(shape.size());
+  for (int i = 0; i < static_cast<int>(shape.size()); i++) {
+    if (shape[i] == 1) {
+      continue;
+    }
+    if (i + gap < 0 || shape[i] != out_shape[i + gap]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// [C] or [1, ..., 1, C], where C is the last axis of the output.
+bool IsLastAxisVector(const std::vector<int> &shape, const std::vector<int> &out_shape) {
+  if (shape.empty() || out_shape.empty() || shape.back() != out_shape.back()) {
+    return false;
+  }
+  return std::all_of(shape.begin(), shape.end() - 1, [](int dim) { return dim == 1; });
+}
+}  // namespace
+
+int ElementwiseFusionCPUKernel::Prepare() {
+  CHECK_LESS_RETURN(in_tensors_.size(), 1);
+  CHECK_LESS_RETURN(out_tensors_.size(), 1);
+  CHECK_NULL_RETURN(param_);
+  if (param_->op_num_ <= 0 || param_->op_num_ > ELEMENTWISE_FUSION_MAX_OPS) {
+    MS_LOG(ERROR) << "The op num of elementwise fusion is invalid: " << param_->op_num_;
+    return RET_ERROR;
+  }
+  for (int i = 0; i < param_->op_num_; i++) {
+    if (param_->ops_[i].operand_ >= static_cast<int>(in_tensors_.size())) {
+      MS_LOG(ERROR) << "The operand " << param_->ops_[i].operand_ << " of elementwise fusion is out of range.";
+      return RET_ERROR;
+    }
+  }
+  if (!InferShapeDone()) {
+    return RET_OK;
+  }
+  return ReSize();
+}
+
+int ElementwiseFusionCPUKernel::ReSize() {
+  auto out_tensor = out_tensors_.front();
+  CHECK_NULL_RETURN(out_tensor);
+  auto out_shape = out_tensor->shape();
+  if (out_shape.size() > MAX_SHAPE_SIZE) {
+    MS_LOG(ERROR) << "The output of elementwise fusion has too many dims: " << out_shape.size();
+    return RET_ERROR;
+  }
+  element_num_ = out_tensor->ElementsNum();
+  channel_ = out_shape.empty() ? 1 : out_shape.back();
+  channel_ = channel_ > 0 ? channel_ : 1;
+
+  // The operand is classified by its shape against the output: the same layout as the output, a scalar or a last-axis
+  // vector. Any other broadcastable operand is broadcast to the output shape at run, and then read as the same layout.
+  bool channel_operand = false;
+  operand_types_.assign(in_tensors_.size(), EltwiseFusionOperand_Full);
+  broadcast_operands_.assign(in_tensors_.size(), false);
+  broadcast_infos_.resize(in_tensors_.size());
+  for (size_t i = 0; i < in_tensors_.size(); i++) {
+    CHECK_NULL_RETURN(in_tensors_[i]);
+    auto shape = in_tensors_[i]->shape();
+    if (shape.size() > MAX_SHAPE_SIZE || !CanBroadcastTo(shape, out_shape)) {
+      MS_LOG(ERROR) << "The operand " << in_tensors_[i]->tensor_name() << " of elementwise fusion can not broadcast to "
+                    << out_tensor->tensor_name();
+      return RET_ERROR;
+    }
+    auto operand_size = in_tensors_[i]->ElementsNum();
+    if (operand_size == element_num_) {
+      continue;
+    }
+    if (i != 0 && operand_size == 1) {
+      operand_types_[i] = EltwiseFusionOperand_Scalar;
+      continue;
+    }
+    if (i != 0 && IsLastAxisVector(shape, out_shape)) {
+      operand_types_[i] = EltwiseFusionOperand_Channel;
+      channel_operand = true;
+      continue;
+    }
+    broadcast_operands_[i] = true;
+    auto &info = broadcast_infos_[i];
+    std::copy(shape.begin(), shape.end(), info.input_shape_);
+    info.input_shape_size_ = static_cast<int>(shape.size());
+    std::copy(out_shape.begin(), out_shape.end(), info.output_shape_);
+    info.output_shape_size_ = static_cast<int>(out_shape.size());
+  }
+  block_ = channel_operand ? channel_ * MSMAX(1, kElementwiseFusionBlockSize / channel_) : kElementwiseFusionBlockSize;
+
+  auto block_num = UP_DIV(element_num_, block_);
+  task_num_ = static_cast<int>(MSMAX(1, MSMIN(static_cast<int64_t>(thread_num_), block_num)));
+  task_stride_ = UP_DIV(block_num, task_num_) * block_;
+  return RET_OK;
+}
+
+int ElementwiseFusionCPUKernel::DoElementwiseFusion(int task_id) {
+  auto start = task_id * task_stride_;
+  auto end = MSMIN(start + task_stride_, element_num_);
+  if (start >= end) {
+    return RET_OK;
+  }
+  auto input = operands_.front();
+  auto output = reinterpret_cast<float *>(out_tensors_.front()->data());
+  auto ret = Fp32ElementwiseFusion(input, output, operands_.data(), operand_types_.data(), param_, channel_, block_,
+                                   start, end);
+  if (ret != NNACL_OK) {
+    MS_LOG(ERROR) << "Fp32ElementwiseFusion failed, task_id: " << task_id << ", ret: " << ret;
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
+
+int ElementwiseFusionRun(void *cdata, int task_id, float lhs_scale, float rhs_scale) {
+  CHECK_NULL_RETURN(cdata);
+  auto fusion_kernel = reinterpret_cast<ElementwiseFusionCPUKernel *>(cdata);
+  return fusion_kernel->DoElementwiseFusion(task_id);
+}
+
+int ElementwiseFusionCPUKernel::BroadcastOperands() {
+  broadcast_buffers_.assign(in_tensors_.size(), nullptr);
+  for (size_t i = 0; i < in_tensors_.size(); i++) {
+    if (!broadcast_operands_[i]) {
+      continue;
+    }
+    broadcast_buffers_[i] = ms_context_->allocator->Malloc(static_cast<size_t>(element_num_) * sizeof(float));
+    if (broadcast_buffers_[i] == nullptr) {
+      MS_LOG(ERROR) << "Malloc the broadcast buffer of elementwise fusion failed.";
+      return RET_ERROR;
+    }
+    // BroadcastToSize32 pads the input shape of the info in place, so it works on a copy.
+    auto info = broadcast_infos_[i];
+    auto ret = BroadcastToSize32(operands_[i], &info, broadcast_buffers_[i]);
+    if (ret != NNACL_OK) {
+      MS_LOG(ERROR) << "Broadcast the operand " << in_tensors_[i]->tensor_name() << " failed, ret: " << ret;
+      return RET_ERROR;
+    }
+    operands_[i] = reinterpret_cast<const float *>(broadcast_buffers_[i]);
+  }
+  return RET_OK;
+}
+
+void ElementwiseFusionCPUKernel::FreeBroadcastOperands() {
+  for (auto &buffer : broadcast_buffers_) {
+    if (buffer != nullptr) {
+      ms_context_->allocator->Free(buffer);
+      buffer = nullptr;
+    }
+  }
+}
+
+int ElementwiseFusionCPUKernel::Run() {
+  operands_.resize(in_tensors_.size());
+  for (size_t i = 0; i < in_tensors_.size(); i++) {
+    operands_[i] = reinterpret_cast<const float *>(in_tensors_[i]->data());
+    CHECK_NULL_RETURN(operands_[i]);
+  }
+  CHECK_NULL_RETURN(out_tensors_.front()->data());
+  auto ret = BroadcastOperands();
+  if (ret == RET_OK) {
+    ret = ParallelLaunch(this->ms_context_, ElementwiseFusionRun, this, task_num_);
+  }
+  FreeBroadcastOperands();
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "ElementwiseFusion run failed, ret: " << ret;
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
+
+REG_KERNEL(kCPU, kNumberTypeFloat32, PrimType_Inner_ElementwiseFusion, LiteKernelCreator<ElementwiseFusionCPUKernel>)
+}  // namespace mindspore::kernel
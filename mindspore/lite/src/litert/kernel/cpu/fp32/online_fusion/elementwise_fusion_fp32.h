@@ -0,0 +1,62 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_LITE_SRC_RUNTIME_KERNEL_CPU_FP32_ONLINE_FUSION_ELEMENTWISE_FUSION_FP32_H_
+#define MINDSPORE_LITE_SRC_RUNTIME_KERNEL_CPU_FP32_ONLINE_FUSION_ELEMENTWISE_FUSION_FP32_H_
+
+#include <vector>
+#include "src/litert/lite_kernel.h"
+#include "nnacl/elementwise_fusion_parameter.h"
+#include "nnacl/broadcast_to_parameter.h"
+
+namespace mindspore::kernel {
+// The chain of elementwise ops fused by the runtime pass. Input 0 is the input of the first op, and the others are the
+// other operands of the binary ops. The ops run on one block of elements after another, so that the intermediate
+// values stay in the cache instead of being written to the intermediate tensors. An operand that is not a scalar, a
+// last-axis vector or a tensor of the output shape, e.g. a [N, 1] operand after the input is resized to [N, C], is
+// broadcast to the output shape before the fused ops run, as the unfused binary ops would do.
+class ElementwiseFusionCPUKernel : public LiteKernel {
+ public:
+  ElementwiseFusionCPUKernel(OpParameter *parameter, const std::vector<lite::Tensor *> &inputs,
+                             const std::vector<lite::Tensor *> &outputs, const lite::InnerContext *ctx)
+      : LiteKernel(parameter, inputs, outputs, ctx) {
+    param_ = reinterpret_cast<ElementwiseFusionParameter *>(op_parameter_);
+  }
+  ~ElementwiseFusionCPUKernel() override = default;
+
+  int Prepare() override;
+  int ReSize() override;
+  int Run() override;
+  int DoElementwiseFusion(int task_id);
+
+ private:
+  int BroadcastOperands();
+  void FreeBroadcastOperands();
+
+  ElementwiseFusionParameter *param_ = nullptr;
+  std::vector<const float *> operands_;
+  std::vector<int> operand_types_;
+  std::vector<bool> broadcast_operands_;
+  std::vector<BroadcastShapeInfo> broadcast_infos_;
+  std::vector<void *> broadcast_buffers_;
+  int64_t element_num_ = 0;
+  int64_t channel_ = 1;
+  int64_t block_ = 0;
+  int64_t task_stride_ = 0;
+  int task_num_ = 1;
+};
+}  // namespace mindspore::kernel
+
+#endif  // MINDSPORE_LITE_SRC_RUNTIME_KERNEL_CPU_FP32_ONLINE_FUSION_ELEMENTWISE_FUSION_FP32_H_
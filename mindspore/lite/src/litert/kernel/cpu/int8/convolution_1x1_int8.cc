@@ -17,6 +17,10 @@
 #include "src/litert/kernel/cpu/int8/convolution_1x1_int8.h"
 #include "src/common/file_utils.h"
 #include "src/litert/kernel/cpu/int8/opt_op_handler.h"
+#ifdef ENABLE_AVX512
+#include "nnacl/int8/matmul_avx512_vnni_int8.h"
+#include "nnacl/intrinsics/ms_simd_cpu_info.h"
+#endif
 
 using mindspore::lite::RET_ERROR;
 using mindspore::lite::RET_MEMORY_FAILED;
@@ -151,6 +155,12 @@ void Convolution1x1Int8CPUKernel::CheckSupportOptimize() {
 #if !defined(SUPPORT_NNIE) && !defined(SUPPORT_34XX) && !defined(MACHINE_LINUX_ARM64)
   }
 #endif
+#elif defined(ENABLE_AVX512)
+  /* the vnni kernel shares the 4x4 input and 4x16 weight packing with the arm64 sdot kernel */
+  if (X86_Avx512Vnni_Support()) {
+    support_optimize_ = true;
+    matmul_func_ = MatMulInt8Avx512Vnni;
+  }
 #endif
   return;
 }
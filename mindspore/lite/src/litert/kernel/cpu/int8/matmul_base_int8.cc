@@ -17,12 +17,22 @@
 #include "src/litert/kernel/cpu/int8/matmul_base_int8.h"
 #include "src/litert/kernel/cpu/int8/opt_op_handler.h"
 #include "src/litert/kernel/cpu/fp32/matmul_fp32_base.h"
+#ifdef ENABLE_AVX512
+#include "nnacl/int8/matmul_avx512_vnni_int8.h"
+#include "nnacl/intrinsics/ms_simd_cpu_info.h"
+#endif
 
 using mindspore::lite::RET_ERROR;
 using mindspore::lite::RET_MEMORY_FAILED;
 using mindspore::lite::RET_OK;
 
 namespace mindspore::kernel {
+namespace {
+void RowMajor2Col4x4MajorPackInt8(const int8_t *src, int8_t *dst, int row, int col) {
+  RowMajor2Col4x4MajorInt8(src, row, col, dst);
+}
+}  // namespace
+
 int MatmulBaseInt8Run(void *cdata, int task_id, float, float) {
   CHECK_NULL_RETURN(cdata);
   auto op = reinterpret_cast<MatmulBaseInt8CPUKernel *>(cdata);
@@ -140,6 +150,15 @@ int MatmulBaseInt8CPUKernel::RunImpl(int task_id) {
     filter_per_channel_ ? quant_param_->quant_multiplier_ + cur_stride : quant_param_->quant_multiplier_;
   int32_t *cur_zp = filter_per_channel_ ? quant_param_->filter_zp_ + cur_stride : quant_param_->filter_zp_;
 
+#ifdef ENABLE_AVX512
+  if (support_vnni_) {
+    MatMulInt8Avx512Vnni(pack_a_ptr_, batch_b_ptr_ + cur_stride * param_->deep_align_, batch_c_ptr_ + cur_stride,
+                         param_->row_, cur_oc, param_->deep_align_, param_->col_, input_sums_, batch_sums_ + cur_stride,
+                         cur_left, cur_right, cur_mul, quant_param_->output_.zp_, quant_param_->out_act_min_,
+                         quant_param_->out_act_max_, filter_per_channel_, cur_zp);
+    return RET_OK;
+  }
+#endif
   MatmulInt8Opt(pack_a_ptr_, batch_b_ptr_ + cur_stride * param_->deep_align_, batch_c_ptr_ + cur_stride, param_->row_,
                 cur_oc, param_->deep_align_, input_sums_, batch_sums_ + cur_stride, quant_param_->out_act_min_,
                 quant_param_->out_act_max_, quant_param_->output_.zp_, cur_mul, cur_left, cur_right, param_->col_,
@@ -280,11 +299,21 @@ void MatmulBaseInt8CPUKernel::InitParameter() {
     deep_tile_ = C16NUM;
   }
 #else
+#ifdef ENABLE_AVX512
+  support_vnni_ = X86_Avx512Vnni_Support();
+#endif
   row_tile_ = C4NUM;
-  col_tile_ = C4NUM;
-  deep_tile_ = C16NUM;
+  if (support_vnni_) {
+    col_tile_ = C16NUM;
+    deep_tile_ = C4NUM;
+  } else {
+    col_tile_ = C4NUM;
+    deep_tile_ = C16NUM;
+  }
 #endif
-  if (param_->a_transpose_) {
+  if (support_vnni_) {
+    a_pack_func_ = param_->a_transpose_ ? RowMajor2Col4x4MajorPackInt8 : RowMajor2Row4x4MajorInt8;
+  } else if (param_->a_transpose_) {
     a_pack_func_ = RowMajor2Col16x4MajorInt8;
   } else {
     a_pack_func_ = RowMajor2Row16x4MajorInt8;
@@ -299,7 +328,7 @@ void MatmulBaseInt8CPUKernel::InitParameter() {
       b_pack_func_ = RowMajor2Row16x4MajorInt8;
     }
 #else
-    b_pack_func_ = RowMajor2Row16x4MajorInt8;
+    b_pack_func_ = support_vnni_ ? RowMajor2Row4x16MajorInt8 : RowMajor2Row16x4MajorInt8;
 #endif
   } else {
 #ifdef ENABLE_ARM32
@@ -311,7 +340,7 @@ void MatmulBaseInt8CPUKernel::InitParameter() {
       b_pack_func_ = RowMajor2Col16x4MajorInt8;
     }
 #else
-    b_pack_func_ = RowMajor2Col16x4MajorInt8;
+    b_pack_func_ = support_vnni_ ? RowMajor2Col4x16MajorInt8 : RowMajor2Col16x4MajorInt8;
 #endif
   }
   return;
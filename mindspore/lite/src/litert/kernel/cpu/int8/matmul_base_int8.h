@@ -88,6 +88,7 @@ class MatmulBaseInt8CPUKernel : public LiteKernel {
   int deep_tile_ = C16NUM;
   int channel_num_ = 0;
   bool support_sdot_ = false;
+  bool support_vnni_ = false;
   PackFunc a_pack_func_{nullptr};
   PackFunc b_pack_func_{nullptr};
   std::vector<int> a_offset_;
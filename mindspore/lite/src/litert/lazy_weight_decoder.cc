@@ -0,0 +1,396 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/litert/lazy_weight_decoder.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include "src/litert/inner_allocator.h"
+#include "src/litert/sub_graph_kernel.h"
+#include "src/litert/weight_decoder.h"
+#include "src/common/utils.h"
+#include "src/common/log_adapter.h"
+
+namespace mindspore::lite {
+namespace {
+constexpr size_t kInvalidKernelIndex = std::numeric_limits<size_t>::max();
+
+bool IsDeferredCompressType(int compress_type) {
+  // The weights bit packed by the old converters without the compress type recorded are decoded when loading.
+  return compress_type == schema::WeightQuantCompressType_BITPACKING ||
+         compress_type == schema::WeightQuantCompressType_INDEXING ||
+         compress_type == schema::WeightQuantCompressType_SPARSE ||
+         compress_type == schema::WeightQuantCompressType_FSE ||
+         compress_type == schema::WeightQuantCompressType_FSE_INT;
+}
+
+// Drop the compressed data of the deferred weight, which is copied when scheduling if the model buffer is not kept,
+// the size of the tensor is the decoded one after.
+void ResetDeferredTensor(Tensor *tensor) {
+  tensor->FreeData();
+  tensor->set_data(nullptr);
+  tensor->set_compress_type(kNoCompression);
+  tensor->set_compressed_size(0);
+}
+}  // namespace
+
+LazyWeightDecoder::~LazyWeightDecoder() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  prefetch_cond_.notify_all();
+  if (prefetch_thread_.joinable()) {
+    prefetch_thread_.join();
+  }
+  for (auto &weight : weights_) {
+    ReleaseWeight(weight.get());
+  }
+}
+
+bool LazyWeightDecoder::IsLazyDecodeInput(int op_type, size_t index, size_t input_num) {
+  // The kernels read these inputs only when running, the other inputs are read or packed when preparing.
+  switch (op_type) {
+    case schema::PrimitiveType_Gather:
+    case schema::PrimitiveType_GatherNd:
+    case schema::PrimitiveType_GatherD:
+      return index == 0;
+    case schema::PrimitiveType_EmbeddingLookupFusion:
+      return index + 1 < input_num;
+    default:
+      return false;
+  }
+}
+
+bool LazyWeightDecoder::CanReplayDequant(const LazyWeight &weight) {
+  // Only the dequant is replayed, the weight cast by the subgraph is kept decoded.
+  auto type = weight.decompressed_type_;
+  return (type == kNumberTypeInt8 || type == kNumberTypeInt16 || type == kNumberTypeInt32) &&
+         (!weight.quant_params_.empty() || !weight.quant_clusters_.empty());
+}
+
+void LazyWeightDecoder::SelectDeferredWeights(const LiteGraph &graph) {
+  std::unordered_map<size_t, size_t> consumer_num;
+  std::unordered_map<size_t, bool> lazy_input;
+  for (auto node : graph.all_nodes_) {
+    if (node == nullptr) {
+      return;
+    }
+    for (size_t i = 0; i < node->input_indices_.size(); i++) {
+      auto index = node->input_indices_[i];
+      consumer_num[index]++;
+      lazy_input[index] = IsLazyDecodeInput(node->node_type_, i, node->input_indices_.size());
+    }
+  }
+  for (auto &item : consumer_num) {
+    auto index = item.first;
+    if (item.second != 1 || !lazy_input[index] || index >= graph.all_tensors_.size() ||
+        graph.all_tensors_[index] == nullptr || lite::IsContain(graph.input_indices_, static_cast<uint32_t>(index)) ||
+        lite::IsContain(graph.output_indices_, static_cast<uint32_t>(index))) {
+      continue;
+    }
+    auto src_tensor = graph.all_tensors_[index];
+    if (src_tensor->data() == nullptr || src_tensor->dataType() == kObjectTypeTensorType ||
+        !IsDeferredCompressType(src_tensor->weightQuantCompressType())) {
+      continue;
+    }
+    (void)deferred_indices_.insert(index);
+  }
+  MS_LOG(INFO) << "Defer the decoding of " << deferred_indices_.size() << " compressed weights.";
+}
+
+void LazyWeightDecoder::AddCompressedWeight(size_t tensor_index, Tensor *tensor,
+                                            const SchemaTensorWrapper *src_tensor) {
+  if (tensor == nullptr || src_tensor == nullptr || src_tensor->handler() == nullptr ||
+      tensor->data_type() == kObjectTypeTensorType) {
+    return;
+  }
+  bool deferred = IsDeferredWeight(tensor_index);
+  // The tensor references the data of the model when it's not compressed.
+  if (!deferred && (tensor->data() == nullptr || tensor->data() == src_tensor->data())) {
+    return;
+  }
+  auto weight = std::make_unique<LazyWeight>();
+  weight->tensor_ = tensor;
+  weight->src_tensor_ = src_tensor;
+  weight->deferred_ = deferred;
+  weight->decompressed_type_ = tensor->data_type();
+  weight->quant_params_ = tensor->quant_params();
+  weight->quant_clusters_ = tensor->quant_clusters();
+  candidates_[tensor] = std::move(weight);
+}
+
+int LazyWeightDecoder::Init(const std::vector<kernel::KernelExec *> &kernels) {
+  if (candidates_.empty()) {
+    return RET_OK;
+  }
+  std::vector<kernel::KernelExec *> cpu_nodes;
+  std::unordered_map<const Tensor *, size_t> consumer_num;
+  for (auto kernel : kernels) {
+    MS_CHECK_TRUE_RET(kernel != nullptr, RET_NULL_PTR);
+    std::vector<kernel::KernelExec *> nodes = {kernel};
+    if (kernel->subgraph_type() != kernel::kNotSubGraph) {
+      nodes = reinterpret_cast<kernel::SubGraphKernel *>(kernel)->nodes();
+    }
+    for (auto node : nodes) {
+      for (auto tensor : node->in_tensors()) {
+        consumer_num[tensor]++;
+      }
+      if (kernel->desc().arch == kernel::kCPU && node->subgraph_type() == kernel::kNotSubGraph) {
+        cpu_nodes.push_back(node);
+      }
+    }
+  }
+  scratch_allocator_ = std::make_shared<DefaultAllocator>();
+  for (auto node : cpu_nodes) {
+    std::vector<LazyWeight *> kernel_weights;
+    const auto &inputs = node->in_tensors();
+    for (size_t i = 0; i < inputs.size(); i++) {
+      auto tensor = inputs[i];
+      auto iter = candidates_.find(tensor);
+      if (iter == candidates_.end()) {
+        continue;
+      }
+      auto &weight = iter->second;
+      weight->data_type_ = tensor->data_type();
+      bool need_dequant = weight->data_type_ != weight->decompressed_type_;
+      if (need_dequant && CanReplayDequant(*weight)) {
+        MS_CHECK_TRUE_RET(node->op_parameter() != nullptr, RET_NULL_PTR);
+        weight->preferred_dim_ =
+          WeightDecoder::GetPreferredDim(inputs, node->op_parameter(), static_cast<int>(i), tensor->shape(),
+                                         model_version_);
+      }
+      // The weight shared by the kernels or the allocator is kept decoded.
+      if (consumer_num[tensor] != 1 || !IsLazyDecodeInput(static_cast<int>(node->type()), i, inputs.size()) ||
+          !tensor->IsConst() || !(weight->deferred_ || tensor->own_data()) || tensor->allocator() != nullptr ||
+          (need_dequant && !CanReplayDequant(*weight))) {
+        if (weight->deferred_) {
+          auto ret = DecodeDeferredWeight(weight.get());
+          if (ret != RET_OK) {
+            return ret;
+          }
+        }
+        (void)candidates_.erase(iter);
+        continue;
+      }
+      compressed_size_ += weight->src_tensor_->length();
+      // Release the decoded data, the data is decoded into the scratch memory when the kernel runs.
+      if (weight->deferred_) {
+        ResetDeferredTensor(tensor);
+      } else {
+        tensor->FreeData();
+      }
+      tensor->set_allocator(scratch_allocator_);
+      weight_kernel_index_[tensor] = kernel_weights_.size();
+      kernel_weights.push_back(weight.get());
+      weights_.push_back(std::move(weight));
+      (void)candidates_.erase(iter);
+    }
+    if (!kernel_weights.empty()) {
+      kernel_weights_.push_back(std::move(kernel_weights));
+    }
+  }
+  for (auto &item : candidates_) {
+    auto &weight = item.second;
+    if (!weight->deferred_) {
+      continue;
+    }
+    // The deferred weight must be read by a cpu kernel to know how it's dequantized.
+    if (consumer_num[weight->tensor_] != 0) {
+      MS_LOG(ERROR) << "The deferred weight " << weight->tensor_->tensor_name() << " is not read by a cpu kernel.";
+      return RET_NOT_SUPPORT;
+    }
+    ResetDeferredTensor(weight->tensor_);
+  }
+  candidates_.clear();
+  if (weights_.empty()) {
+    return RET_OK;
+  }
+  if (enable_prefetch_) {
+    prefetch_thread_ = std::thread(&LazyWeightDecoder::PrefetchLoop, this);
+  }
+  MS_LOG(INFO) << "Decode " << weights_.size() << " weights of " << kernel_weights_.size()
+               << " kernels lazily, compressed size: " << compressed_size_;
+  return RET_OK;
+}
+
+int LazyWeightDecoder::DecodeDeferredWeight(LazyWeight *weight) {
+  MS_ASSERT(weight != nullptr);
+  // The weight not decoded lazily is decoded into the memory owned by the tensor as it's done when loading the model.
+  ResetDeferredTensor(weight->tensor_);
+  auto ret = DecodeWeight(weight);
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "Decode the deferred weight " << weight->tensor_->tensor_name() << " failed: " << ret;
+    return ret;
+  }
+  return RET_OK;
+}
+
+int LazyWeightDecoder::DecodeWeight(LazyWeight *weight) {
+  MS_ASSERT(weight != nullptr);
+  auto tensor = weight->tensor_;
+  tensor->set_data_type(weight->decompressed_type_);
+  auto ret = WeightDecoder::DecompressTensor(*weight->src_tensor_, tensor);
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "Decompress the weight " << tensor->tensor_name() << " failed: " << ret;
+    ReleaseWeight(weight);
+    return RET_ERROR;
+  }
+  if (weight->data_type_ == weight->decompressed_type_) {
+    return RET_OK;
+  }
+#ifndef WEIGHT_DECODE_CLIP
+  // The dequantized data is allocated by the dequant, and freed to the os by the scratch allocator when released.
+  tensor->set_quant_params(weight->quant_params_);
+  tensor->set_quant_clusters(weight->quant_clusters_);
+  ret = WeightDecoder::DequantTensor(tensor, weight->preferred_dim_, weight->data_type_);
+  tensor->ClearQuantParam();
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "Dequant the weight " << tensor->tensor_name() << " failed: " << ret;
+    ReleaseWeight(weight);
+    return RET_ERROR;
+  }
+  return RET_OK;
+#else
+  ReleaseWeight(weight);
+  return RET_NOT_SUPPORT;
+#endif
+}
+
+void LazyWeightDecoder::ReleaseWeight(LazyWeight *weight) {
+  MS_ASSERT(weight != nullptr);
+  auto tensor = weight->tensor_;
+  tensor->FreeData();
+  tensor->set_data(nullptr);
+  tensor->set_data_type(weight->data_type_);
+}
+
+size_t LazyWeightDecoder::GetKernelIndex(const std::vector<Tensor *> &inputs) const {
+  for (auto tensor : inputs) {
+    auto iter = weight_kernel_index_.find(tensor);
+    if (iter != weight_kernel_index_.end()) {
+      return iter->second;
+    }
+  }
+  return kInvalidKernelIndex;
+}
+
+int LazyWeightDecoder::DecodeKernelWeights(size_t kernel_index) {
+  int ret = RET_OK;
+  for (auto weight : kernel_weights_[kernel_index]) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    decode_cond_.wait(lock, [weight] { return weight->state_ != LazyWeight::kDecoding; });
+    if (weight->state_ == LazyWeight::kDecoded) {
+      continue;
+    }
+    weight->state_ = LazyWeight::kDecoding;
+    lock.unlock();
+    auto decode_ret = DecodeWeight(weight);
+    lock.lock();
+    weight->state_ = decode_ret == RET_OK ? LazyWeight::kDecoded : LazyWeight::kCompressed;
+    lock.unlock();
+    decode_cond_.notify_all();
+    if (decode_ret != RET_OK) {
+      ret = decode_ret;
+    }
+  }
+  return ret;
+}
+
+int LazyWeightDecoder::Acquire(const std::vector<Tensor *> &inputs) {
+  auto kernel_index = GetKernelIndex(inputs);
+  if (kernel_index == kInvalidKernelIndex) {
+    return RET_OK;
+  }
+  if (enable_prefetch_) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The kernel is running, it's not prefetched any more so that the weights are not decoded again after released.
+    (void)prefetch_queue_.erase(std::remove(prefetch_queue_.begin(), prefetch_queue_.end(), kernel_index),
+                                prefetch_queue_.end());
+    if (kernel_index + 1 < kernel_weights_.size()) {
+      prefetch_queue_.push_back(kernel_index + 1);
+    }
+    prefetch_cond_.notify_one();
+  }
+  auto ret = DecodeKernelWeights(kernel_index);
+  if (ret != RET_OK) {
+    FillFailedWeights(kernel_index);
+  }
+  return ret;
+}
+
+void LazyWeightDecoder::FillFailedWeights(size_t kernel_index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto weight : kernel_weights_[kernel_index]) {
+    if (weight->state_ != LazyWeight::kCompressed) {
+      continue;
+    }
+    auto tensor = weight->tensor_;
+    if (tensor->MallocData() != RET_OK) {
+      MS_LOG(ERROR) << "Malloc the data of the weight " << tensor->tensor_name() << " failed.";
+      continue;
+    }
+    (void)memset(tensor->data(), 0, tensor->Size());
+    weight->state_ = LazyWeight::kDecoded;
+  }
+}
+
+void LazyWeightDecoder::Release(const std::vector<Tensor *> &inputs) {
+  auto kernel_index = GetKernelIndex(inputs);
+  if (kernel_index == kInvalidKernelIndex) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto weight : kernel_weights_[kernel_index]) {
+    if (weight->state_ == LazyWeight::kDecoded) {
+      ReleaseWeight(weight);
+      weight->state_ = LazyWeight::kCompressed;
+    }
+  }
+}
+
+void LazyWeightDecoder::PrefetchLoop() {
+  while (true) {
+    std::vector<LazyWeight *> weights;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      prefetch_cond_.wait(lock, [this] { return stop_ || !prefetch_queue_.empty(); });
+      if (stop_) {
+        return;
+      }
+      auto kernel_index = prefetch_queue_.front();
+      prefetch_queue_.pop_front();
+      // Mark the weights in the same critical section of popping, the kernel waits for them instead of decoding.
+      for (auto weight : kernel_weights_[kernel_index]) {
+        if (weight->state_ == LazyWeight::kCompressed) {
+          weight->state_ = LazyWeight::kDecoding;
+          weights.push_back(weight);
+        }
+      }
+    }
+    for (auto weight : weights) {
+      // The failure is reported by the kernel decoding the weight again.
+      auto ret = DecodeWeight(weight);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        weight->state_ = ret == RET_OK ? LazyWeight::kDecoded : LazyWeight::kCompressed;
+      }
+      decode_cond_.notify_all();
+    }
+  }
+}
+}  // namespace mindspore::lite
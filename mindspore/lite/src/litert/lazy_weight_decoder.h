@@ -0,0 +1,115 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_RUNTIME_LAZY_WEIGHT_DECODER_H_
+#define MINDSPORE_LITE_SRC_RUNTIME_LAZY_WEIGHT_DECODER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "src/tensor.h"
+#include "src/litert/kernel_exec.h"
+#include "src/litert/lite_model.h"
+
+namespace mindspore::lite {
+// The compressed weight which is decoded just before its kernel runs and released after it.
+struct LazyWeight {
+  Tensor *tensor_ = nullptr;
+  const SchemaTensorWrapper *src_tensor_ = nullptr;
+  // The data type decompressed from the model, and the one used by the kernel after dequant.
+  TypeId decompressed_type_ = kTypeUnknown;
+  TypeId data_type_ = kTypeUnknown;
+  int preferred_dim_ = 0;
+  std::vector<LiteQuantParam> quant_params_;
+  std::vector<float> quant_clusters_;
+  // The weight is kept compressed since it's converted, instead of being decoded and released by Init.
+  bool deferred_ = false;
+  enum State { kCompressed, kDecoding, kDecoded } state_ = kCompressed;
+};
+
+// Keep the compressed weights of the kernels reading the weights at run time, i.e. the embedding tables of gather, in
+// the model buffer instead of the decoded ones. The weights of a kernel are decoded into the scratch memory before the
+// kernel runs and released after it, and the weights of the next kernel are decoded by a helper thread while the
+// current kernel is running, so that only the weights of two kernels are decoded at the same time.
+// Only the inputs of Gather, GatherNd, GatherD and EmbeddingLookupFusion are decoded lazily, the weights of the other
+// kernels, e.g. conv and matmul, are packed when the kernels are prepared and are always kept decoded.
+// The weights selected by SelectDeferredWeights are not decoded when loading the model at all, their tensors reference
+// the compressed data with the compress type set until Init, the others are decoded when loading and released by Init.
+class LazyWeightDecoder {
+ public:
+  LazyWeightDecoder(const std::string &model_version, bool enable_prefetch)
+      : model_version_(model_version), enable_prefetch_(enable_prefetch) {}
+  ~LazyWeightDecoder();
+
+  // Select the compressed weights read only by a lazy decode input of a single node, which are not decoded when
+  // converting the tensors. It's only called when the weights are dequantized to the data type of cpu fp32 kernels.
+  void SelectDeferredWeights(const LiteGraph &graph);
+  bool IsDeferredWeight(size_t tensor_index) const { return deferred_indices_.count(tensor_index) != 0; }
+  // Record the weight decompressed or deferred when converting the tensors, together with its quant params which are
+  // cleared after the weight is dequantized.
+  void AddCompressedWeight(size_t tensor_index, Tensor *tensor, const SchemaTensorWrapper *src_tensor);
+  // Select the weights decoded lazily from the compressed ones and release their decoded data, called after the
+  // kernels are prepared. The deferred weights not selected are decoded here.
+  int Init(const std::vector<kernel::KernelExec *> &kernels);
+  // Make sure the lazy weights in the inputs are decoded and start decoding the weights of the next kernel.
+  int Acquire(const std::vector<Tensor *> &inputs);
+  // Release the decoded data of the lazy weights in the inputs.
+  void Release(const std::vector<Tensor *> &inputs);
+
+  size_t weight_num() const { return weights_.size(); }
+  size_t compressed_size() const { return compressed_size_; }
+
+ private:
+  static bool IsLazyDecodeInput(int op_type, size_t index, size_t input_num);
+  static bool CanReplayDequant(const LazyWeight &weight);
+  int DecodeDeferredWeight(LazyWeight *weight);
+  int DecodeWeight(LazyWeight *weight);
+  int DecodeKernelWeights(size_t kernel_index);
+  // The kernel runs even if its weights fail to be decoded, the weights are filled with zero and released as decoded.
+  void FillFailedWeights(size_t kernel_index);
+  size_t GetKernelIndex(const std::vector<Tensor *> &inputs) const;
+  void ReleaseWeight(LazyWeight *weight);
+  void PrefetchLoop();
+
+  std::string model_version_;
+  bool enable_prefetch_ = true;
+  std::unordered_set<size_t> deferred_indices_;
+  // The compressed weights recorded, which are decoded lazily if selected by Init.
+  std::unordered_map<Tensor *, std::unique_ptr<LazyWeight>> candidates_;
+  std::vector<std::unique_ptr<LazyWeight>> weights_;
+  // The lazy weights of the kernels in the execution order.
+  std::vector<std::vector<LazyWeight *>> kernel_weights_;
+  // tensor <=> the index of the kernel reading it in kernel_weights_
+  std::unordered_map<const Tensor *, size_t> weight_kernel_index_;
+  // The scratch memory of the decoded weights, the buffers freed are reused by the next decoding.
+  AllocatorPtr scratch_allocator_ = nullptr;
+  size_t compressed_size_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable decode_cond_;
+  std::condition_variable prefetch_cond_;
+  std::deque<size_t> prefetch_queue_;
+  std::thread prefetch_thread_;
+  bool stop_ = false;
+};
+}  // namespace mindspore::lite
+#endif  // MINDSPORE_LITE_SRC_RUNTIME_LAZY_WEIGHT_DECODER_H_
@@ -39,7 +39,11 @@ constexpr size_t kMaxModelBufferSize = static_cast<size_t>(1024) * 1024 * 1024 *
 
 void LiteModel::Free() {
   if (this->buf != nullptr) {
-    delete[](this->buf);
+    if (this->model_buf_mapped_) {
+      UnmapFile(this->buf, this->buf_size_);
+    } else {
+      delete[](this->buf);
+    }
     this->buf = nullptr;
   }
   auto nodes_size = this->graph_.all_nodes_.size();
@@ -539,25 +543,40 @@ SchemaTensorWrapper *LiteModel::GetSchemaTensor(const size_t &tensor_index) cons
   return this->inner_all_tensors_.at(tensor_index);
 }
 
-LiteModel *LiteImportFromPath(const char *model_path) {
+LiteModel *LiteImportFromPath(const char *model_path, bool use_mmap) {
   if (model_path == nullptr) {
     MS_LOG(ERROR) << "The model path is nullptr";
     return nullptr;
   }
   size_t size = 0;
-  auto buf = ReadFile(model_path, &size);
+  char *buf = nullptr;
+  bool buf_mapped = false;
+  if (use_mmap) {
+    buf = MapFile(model_path, &size);
+    buf_mapped = buf != nullptr;
+  }
+  if (buf == nullptr) {
+    buf = ReadFile(model_path, &size);
+  }
   if (buf == nullptr) {
     return nullptr;
   }
   auto *model = new (std::nothrow) LiteModel(model_path);
   if (model == nullptr) {
     MS_LOG(ERROR) << "new model fail!";
+    if (buf_mapped) {
+      UnmapFile(buf, size);
+    }
     return nullptr;
   }
+  model->set_model_buf_mapped(buf_mapped);
 
   auto status = model->ConstructModel(buf, size, true);
   if (status != RET_OK) {
     MS_LOG(ERROR) << "construct model failed.";
+    if (buf_mapped) {
+      UnmapFile(buf, size);
+    }
     delete model;
     return nullptr;
   }
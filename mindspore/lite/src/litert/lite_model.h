@@ -62,6 +62,11 @@ class LiteModel : public Model {
 
   void set_keep_model_buf(bool keep) { this->keep_model_buf_ = keep; }
 
+  bool model_buf_mapped() const { return this->model_buf_mapped_; }
+
+  // The model buf mapped from the file is released by munmap, and the const tensors reference it without copy.
+  void set_model_buf_mapped(bool mapped) { this->model_buf_mapped_ = mapped; }
+
   int GetSchemaVersion() const { return schema_version_; }
 
   SchemaTensorWrapper *GetSchemaTensor(const size_t &tensor_index) const;
@@ -336,6 +341,7 @@ class LiteModel : public Model {
  protected:
   std::vector<char *> attr_tensor_bufs_;
   bool keep_model_buf_ = false;
+  bool model_buf_mapped_ = false;
   int schema_version_ = SCHEMA_VERSION::SCHEMA_CUR;
   // tensor_index --- external_data
   std::vector<SchemaTensorWrapper *> inner_all_tensors_;
@@ -351,7 +357,7 @@ Model *ImportFromBuffer(const char *model_buf, size_t size, bool take_buf,
                         mindspore::ModelType model_type = mindspore::ModelType::kMindIR_Lite,
                         const std::string &path = "");
 #endif
-LiteModel *LiteImportFromPath(const char *model_path);
+LiteModel *LiteImportFromPath(const char *model_path, bool use_mmap = false);
 Model *ImportFromPath(const char *model_path);
 
 std::string ModelDebugString(Model *model);
@@ -15,6 +15,7 @@
  */
 
 #include "src/litert/lite_session.h"
+#include <algorithm>
 #include <set>
 #include <vector>
 #include <utility>
@@ -173,6 +174,13 @@ int LiteSession::ConvertTensorsData(const lite::LiteModel *model, size_t tensor_
   }
 
   int compress_type = src_tensor->handler()->weightQuantCompressType();
+  if (lazy_weight_decoder_ != nullptr && lazy_weight_decoder_->IsDeferredWeight(tensor_index)) {
+    // The tensor references the compressed data, which is decoded by the lazy weight decoder.
+    dst_tensor->set_data(const_cast<void *>(src_tensor->data()), false);
+    dst_tensor->set_compress_type(static_cast<CompressType>(compress_type));
+    dst_tensor->set_compressed_size(src_tensor->length());
+    return RET_OK;
+  }
   int ret = RET_NO_CHANGE;
   if (compress_type != kFSEInfer) {
     ret = WeightDecoder::DecompressTensor(*src_tensor, dst_tensor);
@@ -243,6 +251,11 @@ int LiteSession::ConvertTensors(const lite::Model *model) {
   uint32_t tensor_count = model->graph_.all_tensors_.size();
   auto model_input_indices = model->graph_.input_indices_;
   auto model_output_indices = model->graph_.output_indices_;
+  auto ret = CreateLazyWeightDecoder(model);
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "Create lazy weight decoder failed.";
+    return ret;
+  }
 
   for (uint32_t i = 0; i < tensor_count; ++i) {
     auto *src_tensor = model->graph_.all_tensors_[i];
@@ -255,13 +268,16 @@ int LiteSession::ConvertTensors(const lite::Model *model) {
       MS_LOG(ERROR) << "Convert new " << i << "th tensor failed!";
       return RET_NULL_PTR;
     }
-    auto ret = ConvertTensorsData(lite_model, i, dst_tensor);
+    ret = ConvertTensorsData(lite_model, i, dst_tensor);
     if (ret != RET_OK) {
       MS_LOG(ERROR) << "Convert data of " << i << "th tensor failed";
       delete dst_tensor;
       return ret;
     }
     ConvertTensorsQuantParam(src_tensor, dst_tensor);
+    if (lazy_weight_decoder_ != nullptr) {
+      lazy_weight_decoder_->AddCompressedWeight(i, dst_tensor, lite_model->GetSchemaTensor(i));
+    }
     if (IsContain(model_input_indices, i)) {
       dst_tensor->set_category(Category::GRAPH_INPUT);
     }
@@ -626,6 +642,20 @@ int LiteSession::CompileGraph(Model *model) {
     return ret;
   }
 
+  ret = InitResizePlanCache();
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "Init resize plan cache failed.";
+    is_running_.store(false);
+    return ret;
+  }
+
+  ret = InitLazyWeightDecoder();
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "Init lazy weight decoder failed.";
+    is_running_.store(false);
+    return ret;
+  }
+
   is_running_.store(false);
   return RET_OK;
 }
@@ -766,7 +796,11 @@ int LiteSession::RunGraph(const KernelCallBack &before, const KernelCallBack &af
     return ret;
   }
   MS_ASSERT(this->context_ != nullptr);
-  ret = executor_->Run(this->inputs_, this->outputs_, this->kernels_, before, after);
+  if (lazy_weight_decoder_ != nullptr) {
+    ret = RunGraphWithLazyWeights(before, after);
+  } else {
+    ret = executor_->Run(this->inputs_, this->outputs_, this->kernels_, before, after);
+  }
   if (MS_UNLIKELY(ret != RET_OK)) {
     MS_LOG(ERROR) << "RunGraph failed : " << ret;
   }
@@ -1015,6 +1049,8 @@ LiteSession::~LiteSession() {
     MS_LOG(ERROR) << "Not support multi-threading";
     return;
   }
+  // stop decoding the lazy weights before the tensors are released.
+  lazy_weight_decoder_.reset();
   for (auto *kernel : kernels_) {
     delete kernel;
     kernel = nullptr;
@@ -1284,7 +1320,13 @@ int LiteSession::Resize(const std::vector<mindspore::lite::Tensor *> &inputs,
     return ret;
   }
 
-  ret = ReSizeKernels(kernels_, isolate_input_map_);
+  // The plans are keyed by the shapes of all the inputs, since the inputs may be resized partly or in another order.
+  std::vector<std::vector<int>> input_shapes;
+  for (auto input : inputs_) {
+    input_shapes.push_back(input->shape());
+  }
+  ResizePlan *plan = resize_plan_cache_ == nullptr ? nullptr : resize_plan_cache_->Find(input_shapes);
+  ret = plan == nullptr ? ReSizeKernels(kernels_, isolate_input_map_) : ReSizeKernelsWithPlan(*plan);
   if (ret != RET_OK) {
     ResetInputsShape(old_dims);
     auto resize_ret = ReSizeKernels(kernels_);
@@ -1295,17 +1337,29 @@ int LiteSession::Resize(const std::vector<mindspore::lite::Tensor *> &inputs,
     return ret;
   }
 
-  if (RuntimeAllocatorInit() != RET_OK) {
+  ret = plan == nullptr ? RuntimeAllocatorInit() : RuntimeAllocatorAttach(plan->runtime_allocator_);
+  if (ret != RET_OK) {
     MS_LOG(ERROR) << "Runtime allocator in resize failed.";
     is_running_.store(false);
     return RET_ERROR;
   }
 
+  auto nodes_num = GetNodesNum();
   auto status = GraphOptimizePass(&kernels_);
   if (status != RET_OK) {
     MS_LOG(ERROR) << "GraphOptimizePass failed.";
     return RET_ERROR;
   }
+  if (resize_plan_cache_ != nullptr) {
+    if (GetNodesNum() != nodes_num) {
+      // the plans saved before don't match the graph optimized.
+      resize_plan_cache_->Clear();
+    } else if (plan == nullptr) {
+      SaveResizePlan(input_shapes);
+    }
+    MS_LOG(INFO) << "Resize plan cache " << (plan == nullptr ? "miss" : "hit")
+                 << ", hits: " << resize_plan_cache_->hit_count() << ", misses: " << resize_plan_cache_->miss_count();
+  }
 
   is_running_.store(false);
   ret = UpdateInputShapeMap();
@@ -1528,6 +1582,10 @@ int LiteSession::RuntimeAllocatorInit() {
   }
   if (runtime_allocator_ == nullptr) {
     runtime_allocator_ = std::shared_ptr<RuntimeAllocator>(new (std::nothrow) RuntimeAllocator());
+  } else if (resize_plan_cache_ != nullptr) {
+    // the allocator may be kept by the resize plan of the last input shapes.
+    RuntimeAllocatorDetach();
+    runtime_allocator_ = std::shared_ptr<RuntimeAllocator>(new (std::nothrow) RuntimeAllocator());
   } else {
     runtime_allocator_->Clear(context_->allocator);
   }
@@ -1567,6 +1625,209 @@ int LiteSession::RuntimeAllocatorSetData() {
   return RET_OK;
 }
 
+void LiteSession::RuntimeAllocatorDetach() {
+  if (runtime_allocator_ == nullptr) {
+    return;
+  }
+  AllocatorPtr default_allocator = context_->allocator;
+  runtime_allocator_->Detach(default_allocator);
+  for (auto graph_out : isolate_graph_output_map_) {
+    auto out_t = graph_out.second;
+    if (out_t->allocator() == runtime_allocator_) {
+      out_t->set_allocator(default_allocator);
+    }
+  }
+}
+
+int LiteSession::RuntimeAllocatorAttach(const RuntimeAllocatorPtr &runtime_allocator) {
+  if (runtime_allocator == nullptr || runtime_allocator == runtime_allocator_) {
+    return RET_OK;
+  }
+  RuntimeAllocatorDetach();
+  runtime_allocator_ = runtime_allocator;
+  for (auto &iter : runtime_allocator_->GetOffsetMap()) {
+    iter.first->set_allocator(runtime_allocator_);
+  }
+  AllocatorPtr default_allocator = context_->allocator;
+  for (auto graph_out : isolate_graph_output_map_) {
+    auto cal_t = graph_out.first;
+    auto out_t = graph_out.second;
+    if (cal_t->allocator() == runtime_allocator_ && out_t->allocator() == default_allocator) {
+      out_t->set_allocator(runtime_allocator_);
+    }
+  }
+  return RuntimeAllocatorSetData();
+}
+
+int LiteSession::InitResizePlanCache() {
+  if (config_info_ == nullptr) {
+    return RET_OK;
+  }
+  auto section_iter = config_info_->find(kResizePlanCacheSection);
+  if (section_iter == config_info_->end()) {
+    return RET_OK;
+  }
+  auto size_iter = section_iter->second.find(kResizePlanCacheSizeKey);
+  if (size_iter == section_iter->second.end()) {
+    return RET_OK;
+  }
+  auto cache_size_opt = GenericParseValue<size_t>(size_iter->second);
+  if (cache_size_opt.IsNone()) {
+    MS_LOG(ERROR) << "The " << kResizePlanCacheSizeKey << " " << size_iter->second << " is invalid.";
+    return RET_INPUT_PARAM_INVALID;
+  }
+  if (cache_size_opt.Get() == 0) {
+    return RET_OK;
+  }
+  resize_plan_cache_ = std::make_unique<ResizePlanCache>(cache_size_opt.Get());
+  std::vector<std::vector<int>> dims;
+  for (auto input : inputs_) {
+    auto shape = input->shape();
+    if (std::any_of(shape.begin(), shape.end(), [](int dim) { return dim < 0; })) {
+      return RET_OK;
+    }
+    dims.push_back(shape);
+  }
+  // save the plan of the shapes compiled, so that resizing back to them is a hit.
+  SaveResizePlan(dims);
+  return RET_OK;
+}
+
+void LiteSession::SaveResizePlan(const std::vector<std::vector<int>> &dims) {
+  ResizePlan plan;
+  plan.skip_infer_ = !is_control_flow_;
+  std::set<Tensor *> visited;
+  auto save_shapes = [&plan, &visited](const std::vector<Tensor *> &tensors) {
+    for (auto tensor : tensors) {
+      if (visited.insert(tensor).second) {
+        plan.tensor_shapes_.push_back({tensor, tensor->shape(), tensor->format()});
+      }
+    }
+  };
+  for (size_t i = 0; i < kernels_.size() && plan.skip_infer_; ++i) {
+    auto kernel = kernels_[i];
+    if (kernel->desc().arch != kernel::KERNEL_ARCH::kCPU || kernel->subgraph_type() == kernel::kNotSubGraph) {
+      plan.skip_infer_ = false;
+      break;
+    }
+    save_shapes(kernel->in_tensors());
+    for (auto node : reinterpret_cast<kernel::SubGraphKernel *>(kernel)->nodes()) {
+      // the outputs computed by the infer shape or not inferred must be inferred again.
+      plan.skip_infer_ = std::none_of(node->out_tensors().begin(), node->out_tensors().end(), [](Tensor *output) {
+        auto shape = output->shape();
+        return output->IsConst() || output->data_type() == kObjectTypeTensorType ||
+               std::any_of(shape.begin(), shape.end(), [](int dim) { return dim < 0; });
+      });
+      if (!plan.skip_infer_) {
+        break;
+      }
+      save_shapes(node->in_tensors());
+      save_shapes(node->out_tensors());
+    }
+  }
+  if (!plan.skip_infer_) {
+    plan.tensor_shapes_.clear();
+  }
+  plan.runtime_allocator_ = runtime_allocator_;
+  resize_plan_cache_->Insert(dims, std::move(plan));
+}
+
+int LiteSession::ReSizeKernelsWithPlan(const ResizePlan &plan) {
+  if (!plan.skip_infer_) {
+    return ReSizeKernels(kernels_, isolate_input_map_);
+  }
+  for (auto &tensor_shape : plan.tensor_shapes_) {
+    tensor_shape.tensor_->set_shape(tensor_shape.shape_);
+    tensor_shape.tensor_->set_format(tensor_shape.format_);
+  }
+  for (auto kernel : kernels_) {
+    auto ret = reinterpret_cast<kernel::SubGraphKernel *>(kernel)->ReSizeNodes();
+    if (ret != RET_OK) {
+      MS_LOG(ERROR) << "ReSize node " << kernel->name() << " failed";
+      return RET_ERROR;
+    }
+  }
+  return RET_OK;
+}
+
+size_t LiteSession::GetNodesNum() const {
+  size_t nodes_num = 0;
+  for (auto kernel : kernels_) {
+    if (kernel->subgraph_type() != kernel::kNotSubGraph) {
+      nodes_num += reinterpret_cast<kernel::SubGraphKernel *>(kernel)->nodes().size();
+    }
+  }
+  return nodes_num;
+}
+
+int LiteSession::CreateLazyWeightDecoder(const lite::Model *model) {
+  if (!IsLazyWeightDecodeEnabled() || is_train_session_ || is_prepare_session_ || is_shared_weight_) {
+    return RET_OK;
+  }
+  bool enable_prefetch = true;
+  auto model_file = config_info_->find(kConfigModelFileSection);
+  auto prefetch_iter = model_file->second.find(kConfigLazyWeightPrefetchKey);
+  if (prefetch_iter != model_file->second.end()) {
+    auto prefetch_opt = GenericParseValue<bool>(prefetch_iter->second);
+    if (prefetch_opt.IsNone()) {
+      MS_LOG(ERROR) << "The " << kConfigLazyWeightPrefetchKey << " " << prefetch_iter->second << " is invalid.";
+      return RET_INPUT_PARAM_INVALID;
+    }
+    enable_prefetch = prefetch_opt.Get();
+  }
+  lazy_weight_decoder_ = std::make_unique<LazyWeightDecoder>(model->graph_.version_, enable_prefetch);
+  // The weights are dequantized to the data type of the kernels selected when scheduling, the decoding is deferred
+  // only when all the kernels are fp32 cpu ones.
+  if (delegate_ == nullptr && execution_plan_ == nullptr && context_->device_list_.size() == 1 &&
+      context_->IsDeviceTypeEnabled(DT_CPU) && !context_->IsCpuFloat16Enabled()) {
+    lazy_weight_decoder_->SelectDeferredWeights(model->graph_);
+  }
+  return RET_OK;
+}
+
+int LiteSession::InitLazyWeightDecoder() {
+  if (lazy_weight_decoder_ == nullptr) {
+    return RET_OK;
+  }
+  auto ret = lazy_weight_decoder_->Init(kernels_);
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "Init the lazy weights failed.";
+    return ret;
+  }
+  if (lazy_weight_decoder_->weight_num() == 0) {
+    MS_LOG(INFO) << "No compressed weight is decoded lazily.";
+    lazy_weight_decoder_.reset();
+  }
+  return RET_OK;
+}
+
+int LiteSession::RunGraphWithLazyWeights(const KernelCallBack &before, const KernelCallBack &after) {
+  auto decoder = lazy_weight_decoder_.get();
+  // The kernel still runs when the callback fails, so the failure of decoding is recorded and returned after running.
+  std::atomic<bool> decode_failed(false);
+  KernelCallBack lazy_before = [decoder, &before, &decode_failed](const std::vector<Tensor *> &inputs,
+                                                                  const std::vector<Tensor *> &outputs,
+                                                                  const MSCallBackParam &info) {
+    if (decoder->Acquire(inputs) != RET_OK) {
+      MS_LOG(ERROR) << "Decode the weights of " << info.node_name << " failed.";
+      decode_failed.store(true);
+      return false;
+    }
+    return before == nullptr || before(inputs, outputs, info);
+  };
+  KernelCallBack lazy_after = [decoder, &after](const std::vector<Tensor *> &inputs,
+                                                const std::vector<Tensor *> &outputs, const MSCallBackParam &info) {
+    decoder->Release(inputs);
+    return after == nullptr || after(inputs, outputs, info);
+  };
+  auto ret = executor_->Run(this->inputs_, this->outputs_, this->kernels_, lazy_before, lazy_after);
+  if (decode_failed.load()) {
+    MS_LOG(ERROR) << "Decode the lazy weights failed, the outputs are invalid.";
+    return RET_ERROR;
+  }
+  return ret;
+}
+
 int LiteSession::InitGPURuntime() {
   if (context_->IsDeviceTypeEnabled(DT_CPU)) {
     CpuBindMode cpu_bind_mode = context_->GetDeviceInfo(DT_CPU).cpu_device_info_.cpu_bind_mode_;
@@ -1716,6 +1977,55 @@ std::string lite::LiteSession::ParseWeightPath() {
   return weight_path;
 }
 
+bool lite::LiteSession::IsLazyWeightDecodeEnabled() {
+  if (config_info_ == nullptr) {
+    return false;
+  }
+  auto model_file = config_info_->find(kConfigModelFileSection);
+  if (model_file == config_info_->end()) {
+    return false;
+  }
+  auto lazy_iter = model_file->second.find(kConfigLazyWeightDecodeKey);
+  return lazy_iter != model_file->second.end() && lazy_iter->second == "true";
+}
+
+bool lite::LiteSession::IsMmapModelEnabled() {
+  if (config_info_ == nullptr) {
+    return false;
+  }
+  auto model_file = config_info_->find(kConfigModelFileSection);
+  if (model_file == config_info_->end()) {
+    return false;
+  }
+  auto mmap_iter = model_file->second.find(kConfigMmapModelKey);
+  return mmap_iter != model_file->second.end() && mmap_iter->second == "true";
+}
+
+const char *lite::LiteSession::MapModelByPath(const std::string &file, mindspore::ModelType model_type, size_t *size) {
+  // Only the ms model references the file buffer. The other model types are converted at runtime or imported by the
+  // model loader, which copy the weights, so they are read instead of mapped.
+  if (model_type != mindspore::ModelType::kMindIR_Lite && model_type != mindspore::ModelType::kMindIR) {
+    MS_LOG(INFO) << "The model type " << static_cast<int>(model_type) << " of " << file << " is not mapped.";
+    return nullptr;
+  }
+  size_t buf_size = 0;
+  auto model_buf = lite::MapFile(file.c_str(), &buf_size);
+  if (model_buf == nullptr) {
+    return nullptr;
+  }
+  // The kMindIR file may be an ms model or a mindir model converted at runtime.
+  if (model_type == mindspore::ModelType::kMindIR) {
+    flatbuffers::Verifier verify(reinterpret_cast<const uint8_t *>(model_buf), buf_size, INT32_MAX, INT32_MAX);
+    if (lite::LiteModel::VersionVerify(&verify) == SCHEMA_INVALID) {
+      MS_LOG(INFO) << "The model " << file << " is not a mslite model, read it instead of mapping.";
+      lite::UnmapFile(model_buf, buf_size);
+      return nullptr;
+    }
+  }
+  *size = buf_size;
+  return model_buf;
+}
+
 #ifdef ENABLE_LITE_HELPER
 int lite::LiteSession::LoadModelAndCompileByBuf(const char *model_buf, mindspore::ModelType model_type,
                                                 const size_t &buf_size,
@@ -1744,10 +2054,12 @@ int lite::LiteSession::LoadModelAndCompileByBuf(const char *model_buf, mindspore
     return RET_ERROR;
   }
   auto weight_path = ParseWeightPath();
+  // The compressed weights decoded lazily reference the model buffer, so the model keeps a copy of the buffer.
+  bool take_buf = !IsLazyWeightDecodeEnabled() || is_shared_weight_;
 #ifdef ENABLE_LITE_HELPER
-  auto *model = lite::ImportFromBuffer(lite_buf, lite_buf_size, true, model_type, weight_path, infer_helpers);
+  auto *model = lite::ImportFromBuffer(lite_buf, lite_buf_size, take_buf, model_type, weight_path, infer_helpers);
 #else
-  auto *model = lite::ImportFromBuffer(lite_buf, lite_buf_size, true, model_type, weight_path);
+  auto *model = lite::ImportFromBuffer(lite_buf, lite_buf_size, take_buf, model_type, weight_path);
 #endif
   if (model == nullptr) {
     MS_LOG(ERROR) << "Import model failed";
@@ -1755,7 +2067,9 @@ int lite::LiteSession::LoadModelAndCompileByBuf(const char *model_buf, mindspore
   }
   (reinterpret_cast<lite::LiteModel *>(model))->set_keep_model_buf(keep_model_buf_);
   auto ret = CompileGraph(model);
-  model->buf = nullptr;
+  if (take_buf) {
+    model->buf = nullptr;
+  }
   if (ret != lite::RET_OK) {
     MS_LOG(ERROR) << "Compile model failed";
     delete model;
@@ -1767,7 +2081,15 @@ int lite::LiteSession::LoadModelAndCompileByBuf(const char *model_buf, mindspore
 
 int lite::LiteSession::LoadModelAndCompileByPath(const std::string &model_path, mindspore::ModelType model_type) {
   size_t model_size;
-  auto model_buf = LoadModelByPath(model_path, model_type, &model_size);
+  const char *model_buf = nullptr;
+  bool model_buf_mapped = false;
+  if (IsMmapModelEnabled()) {
+    model_buf = MapModelByPath(model_path, model_type, &model_size);
+    model_buf_mapped = model_buf != nullptr;
+  }
+  if (model_buf == nullptr) {
+    model_buf = LoadModelByPath(model_path, model_type, &model_size);
+  }
   if (model_buf == nullptr) {
     MS_LOG(ERROR) << "Read model file failed";
     return RET_ERROR;
@@ -1785,19 +2107,31 @@ int lite::LiteSession::LoadModelAndCompileByPath(const std::string &model_path,
     return RET_ERROR;
   }
   if (is_shared_weight_) {
-    delete[] model_buf;
+    if (model_buf_mapped) {
+      lite::UnmapFile(const_cast<char *>(model_buf), model_size);
+      model_buf_mapped = false;
+    } else {
+      delete[] model_buf;
+    }
     model_buf = nullptr;
   }
   auto *model = lite::ImportFromBuffer(new_model_buf, model_size, true, model_type, model_path);
   if (model == nullptr) {
     MS_LOG(ERROR) << "Import model failed";
+    if (model_buf_mapped) {
+      lite::UnmapFile(const_cast<char *>(model_buf), model_size);
+    }
     return RET_ERROR;
   }
   (reinterpret_cast<lite::LiteModel *>(model))->set_keep_model_buf(true);
+  (reinterpret_cast<lite::LiteModel *>(model))->set_model_buf_mapped(model_buf_mapped);
   auto ret = CompileGraph(model);
   if (ret != lite::RET_OK) {
     MS_LOG(ERROR) << "Compile model failed";
-    model->buf = nullptr;
+    // The mapped model buf is released with the model.
+    if (!model_buf_mapped) {
+      model->buf = nullptr;
+    }
     delete model;
     return RET_ERROR;
   }
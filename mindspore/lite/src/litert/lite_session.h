@@ -27,6 +27,8 @@
 #include "src/litert/lite_model.h"
 #include "src/litert/inner_context.h"
 #include "src/litert/runtime_allocator.h"
+#include "src/litert/resize_plan_cache.h"
+#include "src/litert/lazy_weight_decoder.h"
 #include "schema/model_generated.h"
 #include "src/litert/executor.h"
 #include "src/tensor.h"
@@ -77,6 +79,7 @@ class LiteSession {
   void set_model(Model *model) { this->model_ = model; }
   const std::vector<kernel::KernelExec *> &get_kernels() const { return this->kernels_; }
   const Delegate *get_delegate() const { return this->delegate_.get(); }
+  const ResizePlanCache *get_resize_plan_cache() const { return this->resize_plan_cache_.get(); }
   void SetConfigInfo(const std::map<std::string, std::map<std::string, std::string>> *config_info) {
     config_info_ = config_info;
   }
@@ -158,6 +161,9 @@ class LiteSession {
   static void FreePackOpWeight(const std::vector<kernel::KernelExec *> &kernels);
   static void MarkSharedWeight(const std::vector<kernel::KernelExec *> &kernels);
   std::string ParseWeightPath();
+  bool IsMmapModelEnabled();
+  bool IsLazyWeightDecodeEnabled();
+  const char *MapModelByPath(const std::string &file, mindspore::ModelType model_type, size_t *size);
 
  private:
   int PreCheck(Model *model);
@@ -186,8 +192,23 @@ class LiteSession {
   void RuntimeAllocatorInitGraphOutput();
   void RuntimeAllocatorInitSubgraph();
   virtual int RuntimeAllocatorValid();
+  void RuntimeAllocatorDetach();
+  int RuntimeAllocatorAttach(const RuntimeAllocatorPtr &runtime_allocator);
   RuntimeAllocatorPtr runtime_allocator_ = nullptr;
 
+ private:
+  int InitResizePlanCache();
+  void SaveResizePlan(const std::vector<std::vector<int>> &dims);
+  int ReSizeKernelsWithPlan(const ResizePlan &plan);
+  size_t GetNodesNum() const;
+  std::unique_ptr<ResizePlanCache> resize_plan_cache_ = nullptr;
+
+ private:
+  int CreateLazyWeightDecoder(const lite::Model *model);
+  int InitLazyWeightDecoder();
+  int RunGraphWithLazyWeights(const KernelCallBack &before, const KernelCallBack &after);
+  std::unique_ptr<LazyWeightDecoder> lazy_weight_decoder_ = nullptr;
+
  private:
   int AscendInit(const std::shared_ptr<InnerContext> &context);
 
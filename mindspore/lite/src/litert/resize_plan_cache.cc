@@ -0,0 +1,55 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/litert/resize_plan_cache.h"
+#include "src/common/log_adapter.h"
+
+namespace mindspore::lite {
+ResizePlan *ResizePlanCache::Find(const std::vector<std::vector<int>> &input_shapes) {
+  auto iter = plan_map_.find(input_shapes);
+  if (iter == plan_map_.end()) {
+    miss_count_++;
+    return nullptr;
+  }
+  hit_count_++;
+  plans_.splice(plans_.begin(), plans_, iter->second);
+  return &(iter->second->second);
+}
+
+void ResizePlanCache::Insert(const std::vector<std::vector<int>> &input_shapes, ResizePlan &&plan) {
+  if (capacity_ == 0) {
+    return;
+  }
+  auto iter = plan_map_.find(input_shapes);
+  if (iter != plan_map_.end()) {
+    iter->second->second = std::move(plan);
+    plans_.splice(plans_.begin(), plans_, iter->second);
+    return;
+  }
+  while (plans_.size() >= capacity_) {
+    MS_LOG(DEBUG) << "Evict the least recently used resize plan.";
+    (void)plan_map_.erase(plans_.back().first);
+    plans_.pop_back();
+  }
+  plans_.emplace_front(input_shapes, std::move(plan));
+  plan_map_[input_shapes] = plans_.begin();
+}
+
+void ResizePlanCache::Clear() {
+  plan_map_.clear();
+  plans_.clear();
+}
+}  // namespace mindspore::lite
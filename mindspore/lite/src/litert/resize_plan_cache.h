@@ -0,0 +1,72 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_SRC_RUNTIME_RESIZE_PLAN_CACHE_H_
+#define MINDSPORE_LITE_SRC_RUNTIME_RESIZE_PLAN_CACHE_H_
+
+#include <list>
+#include <map>
+#include <utility>
+#include <vector>
+#include "src/tensor.h"
+#include "src/litert/runtime_allocator.h"
+
+namespace mindspore::lite {
+struct TensorShapePlan {
+  Tensor *tensor_ = nullptr;
+  std::vector<int> shape_;
+  mindspore::Format format_ = mindspore::NHWC;
+};
+
+// The execution plan of one group of input shapes, which is saved after the graph is resized to the shapes.
+struct ResizePlan {
+  // The inferred shapes of all the tensors, which are restored instead of inferring the shapes again when
+  // skip_infer_ is true, i.e. all the subgraphs are cpu subgraphs and no output is computed by the infer shape.
+  std::vector<TensorShapePlan> tensor_shapes_;
+  bool skip_infer_ = false;
+  // The memory offsets and the buffer of the runtime allocator, nullptr when the runtime allocator is not used.
+  RuntimeAllocatorPtr runtime_allocator_ = nullptr;
+};
+
+// The LRU cache of the resize plans keyed by the input shapes, so that the session switching back to the input shapes
+// resized before only restores the plan.
+class ResizePlanCache {
+ public:
+  explicit ResizePlanCache(size_t capacity) : capacity_(capacity) {}
+  ~ResizePlanCache() = default;
+
+  // Return the plan of the input shapes and mark it as the most recently used one, nullptr if not cached.
+  ResizePlan *Find(const std::vector<std::vector<int>> &input_shapes);
+  // Save the plan of the input shapes and evict the least recently used plan when the cache is full.
+  void Insert(const std::vector<std::vector<int>> &input_shapes, ResizePlan &&plan);
+  void Clear();
+
+  size_t size() const { return plans_.size(); }
+  size_t capacity() const { return capacity_; }
+  size_t hit_count() const { return hit_count_; }
+  size_t miss_count() const { return miss_count_; }
+
+ private:
+  using PlanList = std::list<std::pair<std::vector<std::vector<int>>, ResizePlan>>;
+  size_t capacity_ = 0;
+  // the most recently used plan is at the front
+  PlanList plans_;
+  std::map<std::vector<std::vector<int>>, PlanList::iterator> plan_map_;
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+};
+}  // namespace mindspore::lite
+#endif  // MINDSPORE_LITE_SRC_RUNTIME_RESIZE_PLAN_CACHE_H_
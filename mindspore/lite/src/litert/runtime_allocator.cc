@@ -79,12 +79,16 @@ void RuntimeAllocator::SetDataOffset(lite::Tensor *tensor, size_t offset) {
   return;
 }
 
-void RuntimeAllocator::Clear(AllocatorPtr default_allocator) {
-  total_size_ = 0;
+void RuntimeAllocator::Detach(const AllocatorPtr &default_allocator) {
   for (auto iter : offset_map_) {
     iter.first->set_allocator(default_allocator);
     iter.first->set_data(nullptr);
   }
+}
+
+void RuntimeAllocator::Clear(AllocatorPtr default_allocator) {
+  total_size_ = 0;
+  Detach(default_allocator);
   if (data_ != nullptr) {
     free(data_);
     data_ = nullptr;
@@ -45,6 +45,8 @@ class RuntimeAllocator : public Allocator {
   void *MallocOptData();
   const std::unordered_map<lite::Tensor *, size_t> &GetOffsetMap() const { return offset_map_; }
   void Clear(AllocatorPtr default_allocator);
+  // Return the tensors to the default allocator but keep the offsets and the buffer, so that they can be restored.
+  void Detach(const AllocatorPtr &default_allocator);
 
  private:
   size_t FindMinFree(size_t size);
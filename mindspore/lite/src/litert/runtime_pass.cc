@@ -15,12 +15,20 @@
  */
 
 #include "src/litert/runtime_pass.h"
+#include <algorithm>
+#include <string>
+#include "src/litert/kernel_exec_util.h"
+#include "src/litert/kernel_registry.h"
+#include "src/common/common.h"
 #include "nnacl/conv_parameter.h"
+#include "nnacl/activation_parameter.h"
+#include "nnacl/arithmetic.h"
 
 namespace mindspore::lite {
 #ifndef RUNTIME_PASS_CLIP
 namespace {
 const constexpr int kMaxDepth = 2048;
+const constexpr size_t kMinElementwiseFusionKernels = 2;
 }
 
 void ChangeTensorDesc(Tensor *tensor, Format specified_format) {
@@ -320,10 +328,264 @@ STATUS DeleteRedundantTrans(std::vector<kernel::KernelExec *> *kernels, bool *ch
   }
   return RET_OK;
 }
+
+bool ElementwiseFusionKernelValid(const kernel::KernelExec *kernel) {
+  /* the train session keeps the intermediate tensors for the gradient kernels */
+  if (kernel->subgraph_type() != kernel::kNotSubGraph || kernel->op_parameter() == nullptr ||
+      kernel->op_parameter()->is_train_session_ || kernel->desc().arch != kernel::KERNEL_ARCH::kCPU ||
+      kernel->desc().provider != kernel::kBuiltin || kernel->desc().data_type != kNumberTypeFloat32 ||
+      kernel->out_tensors().size() != 1) {
+    return false;
+  }
+  auto out_tensor = kernel->out_tensors().front();
+  if (out_tensor->data_type() != kNumberTypeFloat32 || out_tensor->ElementsNum() <= 0) {
+    return false;
+  }
+  auto shape = out_tensor->shape();
+  return std::all_of(shape.begin(), shape.end(), [](int dim) { return dim > 0; });
+}
+
+bool ElementwiseFusionOperandValid(const Tensor *operand, const Tensor *value) {
+  if (operand->data_type() != kNumberTypeFloat32 || operand->ElementsNum() <= 0) {
+    return false;
+  }
+  if (operand->ElementsNum() == 1 || operand->shape() == value->shape()) {
+    return true;
+  }
+  /* last-axis vector : [C] or [1, ..., 1, C] */
+  auto operand_shape = operand->shape();
+  auto value_shape = value->shape();
+  return !value_shape.empty() && operand_shape.size() <= value_shape.size() &&
+         operand_shape.back() == value_shape.back() && operand->ElementsNum() == value_shape.back();
+}
+
+/* append the ops of kernel taking the fused value, the other operand is appended to the fused inputs */
+bool ElementwiseFusionConvert(const kernel::KernelExec *kernel, const Tensor *value, std::vector<Tensor *> *inputs,
+                              std::vector<EltwiseFusionOp> *ops) {
+  auto out_tensor = kernel->out_tensors().front();
+  if (out_tensor->shape() != value->shape()) {
+    return false;
+  }
+  EltwiseFusionOp op = {0, -1, false, 0.0f, 0.0f, 0.0f};
+  auto type = static_cast<schema::PrimitiveType>(kernel->type());
+  if (type == schema::PrimitiveType_Activation) {
+    auto act_param = reinterpret_cast<ActivationParameter *>(kernel->op_parameter());
+    auto iter = ElementwiseFusionActivationOps.find(act_param->type_);
+    if (kernel->in_tensors().size() != 1 || iter == ElementwiseFusionActivationOps.end()) {
+      return false;
+    }
+    op.type_ = iter->second;
+    op.alpha_ = act_param->alpha_;
+    op.min_val_ = act_param->min_val_;
+    op.max_val_ = act_param->max_val_;
+    ops->push_back(op);
+    return true;
+  }
+  auto unary_iter = ElementwiseFusionUnaryOps.find(type);
+  if (unary_iter != ElementwiseFusionUnaryOps.end()) {
+    if (kernel->in_tensors().size() != 1) {
+      return false;
+    }
+    op.type_ = unary_iter->second;
+    ops->push_back(op);
+    return true;
+  }
+  auto binary_iter = ElementwiseFusionBinaryOps.find(type);
+  if (binary_iter == ElementwiseFusionBinaryOps.end() || kernel->in_tensors().size() != C2NUM) {
+    return false;
+  }
+  auto in0 = kernel->in_tensors().at(0);
+  auto in1 = kernel->in_tensors().at(1);
+  if (in0 == in1 || (in0 != value && in1 != value)) {
+    return false;
+  }
+  op.type_ = binary_iter->second;
+  op.reversed_ = in1 == value;
+  auto operand = op.reversed_ ? in0 : in1;
+  if (!ElementwiseFusionOperandValid(operand, value)) {
+    return false;
+  }
+  EltwiseFusionOp act_op = {0, -1, false, 0.0f, 0.0f, 0.0f};
+  auto act_type = reinterpret_cast<ArithmeticParameter *>(kernel->op_parameter())->activation_type_;
+  if (act_type == ActType_Relu) {
+    act_op.type_ = EltwiseFusion_Relu;
+  } else if (act_type == ActType_Relu6) {
+    act_op.type_ = EltwiseFusion_Relu6;
+  } else if (act_type != ActType_No) {
+    return false;
+  }
+  auto iter = std::find(inputs->begin(), inputs->end(), operand);
+  op.operand_ = static_cast<int>(std::distance(inputs->begin(), iter));
+  if (iter == inputs->end()) {
+    inputs->push_back(operand);
+  }
+  ops->push_back(op);
+  if (act_type != ActType_No) {
+    ops->push_back(act_op);
+  }
+  return true;
+}
+
+kernel::KernelExec *ElementwiseFusionCreate(const std::vector<kernel::KernelExec *> &chain,
+                                            const std::vector<Tensor *> &inputs,
+                                            const std::vector<EltwiseFusionOp> &ops) {
+  auto param = reinterpret_cast<ElementwiseFusionParameter *>(malloc(sizeof(ElementwiseFusionParameter)));
+  if (param == nullptr) {
+    MS_LOG(ERROR) << "Malloc ElementwiseFusionParameter failed.";
+    return nullptr;
+  }
+  (void)memset(param, 0, sizeof(ElementwiseFusionParameter));
+  param->op_parameter_.type_ = static_cast<int>(PrimType_Inner_ElementwiseFusion);
+  param->op_parameter_.thread_num_ = chain.back()->op_parameter()->thread_num_;
+  param->op_num_ = static_cast<int>(ops.size());
+  for (size_t i = 0; i < ops.size(); i++) {
+    param->ops_[i] = ops[i];
+  }
+  kernel::KernelKey fusion_key = chain.back()->desc();
+  fusion_key.type = PrimType_Inner_ElementwiseFusion;
+  kernel::KernelExec *fusion_kernel = nullptr;
+  auto ret = KernelRegistry::GetInstance()->GetKernelExec(inputs, chain.back()->out_tensors(), chain.back()->Context(),
+                                                          nullptr, fusion_key, reinterpret_cast<OpParameter *>(param),
+                                                          &fusion_kernel);
+  if (ret != RET_OK || fusion_kernel == nullptr) {
+    free(param);
+    return nullptr;
+  }
+  fusion_kernel->set_name(chain.front()->name() + "_" + chain.back()->name() + "_elementwise_fusion");
+  return fusion_kernel;
+}
+
+void ElementwiseFusionPassReplace(std::vector<kernel::KernelExec *> *kernels, std::vector<Tensor *> *tensors,
+                                  const std::vector<kernel::KernelExec *> &chain, kernel::KernelExec *fusion_kernel) {
+  /* kernel */
+  std::vector<kernel::KernelExec *> in_kernels;
+  for (auto kernel : chain) {
+    for (auto in_kernel : kernel->in_kernels()) {
+      if (IsContain(chain, in_kernel) || IsContain(in_kernels, in_kernel)) {
+        continue;
+      }
+      in_kernels.push_back(in_kernel);
+      std::vector<kernel::KernelExec *> out_kernels;
+      for (auto out_kernel : in_kernel->out_kernels()) {
+        auto replace_kernel = IsContain(chain, out_kernel) ? fusion_kernel : out_kernel;
+        if (!IsContain(out_kernels, replace_kernel)) {
+          out_kernels.push_back(replace_kernel);
+        }
+      }
+      in_kernel->set_out_kernels(out_kernels);
+    }
+  }
+  fusion_kernel->set_in_kernels(in_kernels);
+  auto tail_kernel = chain.back();
+  fusion_kernel->set_out_kernels(tail_kernel->out_kernels());
+  for (auto out_kernel : tail_kernel->out_kernels()) {
+    auto out_in_kernels = out_kernel->in_kernels();
+    std::replace(out_in_kernels.begin(), out_in_kernels.end(), tail_kernel, fusion_kernel);
+    out_kernel->set_in_kernels(out_in_kernels);
+  }
+  /* the fused kernel runs at the place of the last kernel, after all the inputs are ready */
+  std::replace(kernels->begin(), kernels->end(), tail_kernel, fusion_kernel);
+
+  /* tensor */
+  for (size_t i = 0; i + 1 < chain.size(); i++) {
+    Tensor *value = chain[i]->out_tensors().front();
+    (void)VectorSetNull(tensors, value);
+    delete value;
+  }
+  for (auto kernel : chain) {
+    if (kernel != tail_kernel) {
+      (void)VectorErase(kernels, kernel);
+    }
+    delete kernel;
+  }
+}
+
+bool ElementwiseFusionPassActIndex(std::vector<kernel::KernelExec *> *kernels, std::vector<Tensor *> *tensors,
+                                   size_t index) {
+  kernel::KernelExec *head_kernel = kernels->at(index);
+  if (!ElementwiseFusionKernelValid(head_kernel)) {
+    return false;
+  }
+  /* the fused value is the input of the same shape as the output */
+  auto in_tensors = head_kernel->in_tensors();
+  auto value_iter = std::find_if(in_tensors.begin(), in_tensors.end(), [head_kernel](const Tensor *tensor) {
+    return tensor->shape() == head_kernel->out_tensors().front()->shape();
+  });
+  if (value_iter == in_tensors.end() || (*value_iter)->data_type() != kNumberTypeFloat32) {
+    return false;
+  }
+  std::vector<Tensor *> inputs = {*value_iter};
+  std::vector<EltwiseFusionOp> ops;
+  if (!ElementwiseFusionConvert(head_kernel, *value_iter, &inputs, &ops)) {
+    return false;
+  }
+  std::vector<kernel::KernelExec *> chain = {head_kernel};
+  while (true) {
+    auto cur_kernel = chain.back();
+    auto value = cur_kernel->out_tensors().front();
+    if (cur_kernel->out_kernels().size() != 1 || cur_kernel->is_model_output() || value->IsGraphOutput()) {
+      break;
+    }
+    auto next_kernel = cur_kernel->out_kernels().front();
+    if (!ElementwiseFusionKernelValid(next_kernel) || !IsContain(*kernels, next_kernel)) {
+      break;
+    }
+    auto next_inputs = inputs;
+    auto next_ops = ops;
+    if (!ElementwiseFusionConvert(next_kernel, value, &next_inputs, &next_ops) ||
+        next_ops.size() > ELEMENTWISE_FUSION_MAX_OPS) {
+      break;
+    }
+    inputs = next_inputs;
+    ops = next_ops;
+    chain.push_back(next_kernel);
+  }
+  if (chain.size() < kMinElementwiseFusionKernels) {
+    return false;
+  }
+  auto fusion_kernel = ElementwiseFusionCreate(chain, inputs, ops);
+  if (fusion_kernel == nullptr) {
+    MS_LOG(WARNING) << "Create the elementwise fusion kernel of " << head_kernel->name() << " failed.";
+    return false;
+  }
+  MS_LOG(INFO) << "Fuse " << chain.size() << " elementwise kernels from " << head_kernel->name() << " to "
+               << chain.back()->name() << ", " << (chain.size() - 1) << " intermediate tensors are removed.";
+  fusion_kernel->set_is_model_output(chain.back()->is_model_output());
+  ElementwiseFusionPassReplace(kernels, tensors, chain, fusion_kernel);
+  return true;
+}
+
+bool ElementwiseFusionPassAct(std::vector<kernel::KernelExec *> *kernels, std::vector<Tensor *> *tensors) {
+  bool changed = false;
+  size_t index = 0;
+  while (index < kernels->size()) {
+    /* the kernel at index is replaced after fusion, check the next kernel moved to it */
+    if (ElementwiseFusionPassActIndex(kernels, tensors, index)) {
+      changed = true;
+      continue;
+    }
+    index++;
+  }
+  return changed;
+}
+
+bool ElementwiseFusionEnabled(const std::map<std::string, std::map<std::string, std::string>> *config_info) {
+  if (config_info == nullptr) {
+    return true;
+  }
+  auto section_iter = config_info->find(kRuntimePassSection);
+  if (section_iter == config_info->end()) {
+    return true;
+  }
+  auto iter = section_iter->second.find(kEnableElementwiseFusionKey);
+  return iter == section_iter->second.end() || iter->second != "false";
+}
 #endif
 
-STATUS RuntimePass(std::vector<kernel::KernelExec *> *subgraphs, std::vector<Tensor *> *tensors) {
+STATUS RuntimePass(std::vector<kernel::KernelExec *> *subgraphs, std::vector<Tensor *> *tensors,
+                   const std::map<std::string, std::map<std::string, std::string>> *config_info) {
 #ifndef RUNTIME_PASS_CLIP
+  auto elementwise_fusion = ElementwiseFusionEnabled(config_info);
   for (auto subgraph : *subgraphs) {
     auto sub = reinterpret_cast<kernel::SubGraphKernel *>(subgraph);
     if (RuntimePassValid(sub) == false) {
@@ -339,6 +601,10 @@ STATUS RuntimePass(std::vector<kernel::KernelExec *> *subgraphs, std::vector<Ten
       MS_LOG(ERROR) << "DeleteRedundantTrans failed.";
       return RET_ERROR;
     }
+    if (elementwise_fusion && ElementwiseFusionPassAct(&kernels, tensors)) {
+      sub->SetInNodes(kernel::KernelExecUtil::SubgraphInputNodes(kernels));
+      sub->SetOutNodes(kernel::KernelExecUtil::SubgraphOutputNodes(kernels));
+    }
   }
 #endif
   return RET_OK;
@@ -17,14 +17,18 @@
 #ifndef MINDSPORE_LITE_SRC_RUNTIME_RUNTIME_PASS_H_
 #define MINDSPORE_LITE_SRC_RUNTIME_RUNTIME_PASS_H_
 
+#include <map>
+#include <string>
 #include <vector>
 #include "src/litert/kernel_exec.h"
 #include "src/litert/sub_graph_kernel.h"
 #include "schema/ops_generated.h"
 #include "schema/model_generated.h"
+#include "nnacl/elementwise_fusion_parameter.h"
 
 namespace mindspore::lite {
-STATUS RuntimePass(std::vector<kernel::KernelExec *> *subgraphs, std::vector<Tensor *> *tensors);
+STATUS RuntimePass(std::vector<kernel::KernelExec *> *subgraphs, std::vector<Tensor *> *tensors,
+                   const std::map<std::string, std::map<std::string, std::string>> *config_info = nullptr);
 STATUS GraphOptimizePass(std::vector<kernel::KernelExec *> *sub_graphs);
 #ifndef RUNTIME_PASS_CLIP
 /* Nc4hw4 PASS
@@ -46,6 +50,35 @@ static const std::vector<schema::PrimitiveType> Nc4hw4FormatInOpList = {schema::
 static const schema::PrimitiveType ConvNormC4OpConv2DFusion = schema::PrimitiveType_Conv2DFusion;
 static const schema::PrimitiveType ConvNormC4OpActivation = schema::PrimitiveType_Activation;
 static const schema::PrimitiveType ConvNormC4OpInstanceNorm = schema::PrimitiveType_InstanceNorm;
+
+/*
+ * ElementwiseFusion PASS
+ * before  : --(x)-- ADD(bias) --(y0)-- ACT --(y1)-- MUL(scale) --(y2)--
+ * after   : --(x)-- ELEMENTWISE_FUSION(bias, scale) --(y2)--
+ *
+ * The fp32 chain of arithmetic, arithmetic-self and activation ops is fused when each intermediate value has only
+ * one consumer and the other operand of binary op is a scalar, a last-axis vector or a tensor of the same shape.
+ * It is turned off by "enable_elementwise_fusion=false" in the "runtime_pass" section of the config.
+ * */
+static const std::map<schema::PrimitiveType, int> ElementwiseFusionBinaryOps = {
+  {schema::PrimitiveType_AddFusion, EltwiseFusion_Add}, {schema::PrimitiveType_SubFusion, EltwiseFusion_Sub},
+  {schema::PrimitiveType_MulFusion, EltwiseFusion_Mul}, {schema::PrimitiveType_DivFusion, EltwiseFusion_Div},
+  {schema::PrimitiveType_Maximum, EltwiseFusion_Maximum}, {schema::PrimitiveType_Minimum, EltwiseFusion_Minimum}};
+static const std::map<schema::PrimitiveType, int> ElementwiseFusionUnaryOps = {
+  {schema::PrimitiveType_Abs, EltwiseFusion_Abs},       {schema::PrimitiveType_Neg, EltwiseFusion_Neg},
+  {schema::PrimitiveType_Square, EltwiseFusion_Square}, {schema::PrimitiveType_Sqrt, EltwiseFusion_Sqrt},
+  {schema::PrimitiveType_Rsqrt, EltwiseFusion_Rsqrt}};
+static const std::map<int, int> ElementwiseFusionActivationOps = {
+  {schema::ActivationType_RELU, EltwiseFusion_Relu},
+  {schema::ActivationType_RELU6, EltwiseFusion_Relu6},
+  {schema::ActivationType_LEAKY_RELU, EltwiseFusion_LeakyRelu},
+  {schema::ActivationType_SIGMOID, EltwiseFusion_Sigmoid},
+  {schema::ActivationType_TANH, EltwiseFusion_Tanh},
+  {schema::ActivationType_SWISH, EltwiseFusion_Swish},
+  {schema::ActivationType_HSWISH, EltwiseFusion_HSwish},
+  {schema::ActivationType_HSIGMOID, EltwiseFusion_HSigmoid},
+  {schema::ActivationType_HARD_TANH, EltwiseFusion_HardTanh},
+};
 #endif
 }  // namespace mindspore::lite
 #endif  // MINDSPORE_LITE_SRC_RUNTIME_RUNTIME_PASS_H_
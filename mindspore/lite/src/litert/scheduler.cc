@@ -491,7 +491,7 @@ int Scheduler::Schedule(std::vector<kernel::KernelExec *> *dst_kernels) {
     MS_CHECK_TRUE_MSG(ret == RET_OK, ret, "control flow schedule failed.");
   }
 
-  auto status = RuntimePass(dst_kernels, src_tensors_);
+  auto status = RuntimePass(dst_kernels, src_tensors_, config_info_);
   if (status != RET_OK) {
     MS_LOG(ERROR) << "runtime pass failed.";
     return RET_ERROR;
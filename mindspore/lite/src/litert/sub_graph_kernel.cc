@@ -128,6 +128,21 @@ int SubGraphKernel::ReSize() {
   return RET_OK;
 }
 
+int SubGraphKernel::ReSizeNodes() {
+  for (auto kernel : nodes_) {
+    MS_CHECK_FALSE_MSG(kernel == nullptr, RET_ERROR, "input kernel is nullptr.");
+    for (auto &output : kernel->out_tensors()) {
+      output->FreeData();
+    }
+    auto ret = kernel->ReSize();
+    if (ret != RET_OK) {
+      MS_LOG(ERROR) << "kernel " << kernel->name() << " resize fail!ret = " << ret;
+      return ret;
+    }
+  }
+  return RET_OK;
+}
+
 int SubGraphKernel::MallocNodesOutputSpace() {
   for (auto node : nodes_) {
     MS_CHECK_FALSE_MSG(node == nullptr, RET_ERROR, "input kernel is nullptr.");
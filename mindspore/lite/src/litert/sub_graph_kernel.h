@@ -100,6 +100,9 @@ class SubGraphKernel : public KernelExec {
 
   int ReSize() override;
 
+  // resize the nodes whose output shapes have been set, without inferring the shapes again.
+  int ReSizeNodes();
+
   virtual int MallocNodesOutputSpace();
 
   virtual int MallocSubgraphInputs();
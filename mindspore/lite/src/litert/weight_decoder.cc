@@ -382,12 +382,21 @@ int WeightDecoder::DequantTensor(Tensor *tensor, int preferred_dim, TypeId dst_d
     if (!need_dequant) {
       return RET_NO_CHANGE;
     }
+    if (tensor->get_compress_type() != kNoCompression) {
+      // The data kept compressed, e.g. by the lazy weight decoder, is dequantized when it's decompressed.
+      tensor->set_data_type(dst_data_type);
+      return RET_OK;
+    }
     auto ret = WeightDecoder::DequantWeight(tensor, preferred_dim, dst_data_type);
     if (ret != RET_OK) {
       MS_LOG(ERROR) << tensor->tensor_name() << " Dequant data failed: " << ret;
       return ret;
     }
   } else if (!tensor->quant_clusters().empty()) {
+    if (tensor->get_compress_type() != kNoCompression) {
+      tensor->set_data_type(dst_data_type);
+      return RET_OK;
+    }
     auto ret = DecodeKMeansWeight(tensor, dst_data_type);
     if (ret != RET_OK) {
       MS_LOG(ERROR) << tensor->tensor_name() << " Decode KMeans weight failed: " << ret;
@@ -45,6 +45,9 @@ class WeightDecoder {
   static int DequantNode(const OpParameter *op_parameter, const std::vector<Tensor *> &in_tensors, TypeId dst_data_type,
                          const std::string &model_version, bool float_mode);
   static int DecompressTensor(const SchemaTensorWrapper &src_tensor, lite::Tensor *dst_tensor);
+#ifndef WEIGHT_DECODE_CLIP
+  static int DequantTensor(Tensor *tensor, int preferred_dim, TypeId dst_data_type = kNumberTypeFloat32);
+#endif
 
   static int CompareVersion(const std::string &version1, const std::string &version2) {
     std::istringstream iss1(version1);
@@ -112,8 +115,6 @@ class WeightDecoder {
 #ifndef WEIGHT_DECODE_CLIP
 
  private:
-  static int DequantTensor(Tensor *tensor, int preferred_dim, TypeId dst_data_type = kNumberTypeFloat32);
-
   static int UnPackToInt(const SchemaTensorWrapper &src_tensor, lite::Tensor *dst_tensor);
 
   static int DecodeHuffmanCode(const SchemaTensorWrapper &src_tensor, lite::Tensor *dst_tensor);
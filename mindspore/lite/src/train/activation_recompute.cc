@@ -0,0 +1,325 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "src/train/activation_recompute.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include "include/errorcode.h"
+#include "src/common/log_adapter.h"
+#include "src/train/opt_allocator.h"
+
+namespace mindspore {
+namespace lite {
+namespace {
+constexpr size_t kNoPosition = std::numeric_limits<size_t>::max();
+}  // namespace
+
+ActivationRecompute::ActivationRecompute(const std::vector<kernel::KernelExec *> &train_kernels,
+                                         const std::function<RecomputeRole(kernel::KernelExec *)> &get_role,
+                                         const std::function<bool(kernel::KernelExec *)> &is_in_place_kernel)
+    : train_kernels_(train_kernels), is_in_place_kernel_(is_in_place_kernel) {
+  weight_update_pos_ = train_kernels_.size();
+  for (size_t i = 0; i < train_kernels_.size(); i++) {
+    auto kernel = train_kernels_[i];
+    auto role = get_role(kernel);
+    roles_[kernel] = role;
+    if (role == kRecomputeWeightUpdate) {
+      weight_update_pos_ = std::min(weight_update_pos_, i);
+    }
+    for (auto tensor : kernel->out_tensors()) {
+      producers_[tensor] = kernel;
+    }
+  }
+  for (auto kernel : train_kernels_) {
+    auto role = roles_[kernel];
+    if (role == kRecomputeForward || role == kRecomputeRecomputable) {
+      continue;
+    }
+    std::unordered_set<lite::Tensor *> saved_tensors;
+    for (auto tensor : kernel->in_tensors()) {
+      auto producer = producers_.find(tensor);
+      if (producer != producers_.end() && roles_[producer->second] == kRecomputeRecomputable &&
+          saved_tensors.insert(tensor).second) {
+        saved_sizes_[producer->second] += tensor->Size();
+      }
+    }
+  }
+}
+
+std::unordered_set<kernel::KernelExec *> ActivationRecompute::SelectCheckpoints(size_t segment_size) const {
+  std::unordered_set<kernel::KernelExec *> checkpoints;
+  size_t size = 0;
+  for (auto kernel : train_kernels_) {
+    if (roles_.at(kernel) != kRecomputeRecomputable) {
+      size = 0;
+      continue;
+    }
+    auto iter = saved_sizes_.find(kernel);
+    size += iter == saved_sizes_.end() ? 0 : iter->second;
+    if (size >= segment_size) {
+      (void)checkpoints.insert(kernel);
+      size = 0;
+    }
+  }
+  return checkpoints;
+}
+
+std::vector<kernel::KernelExec *> ActivationRecompute::MakeRunKernels(
+  std::unordered_set<kernel::KernelExec *> *checkpoints, std::vector<bool> *is_recompute) const {
+  std::vector<std::vector<kernel::KernelExec *>> segments;
+  std::vector<size_t> recompute_pos;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    segments.clear();
+    std::unordered_map<kernel::KernelExec *, size_t> segment_ids;
+    bool in_segment = false;
+    for (auto kernel : train_kernels_) {
+      if (roles_.at(kernel) != kRecomputeRecomputable || checkpoints->count(kernel) != 0) {
+        in_segment = false;
+        continue;
+      }
+      if (!in_segment) {
+        segments.emplace_back();
+        in_segment = true;
+      }
+      segment_ids[kernel] = segments.size() - 1;
+      segments.back().push_back(kernel);
+    }
+    // The segment is recomputed from the kept tensors only, so that the kernel read by another segment is kept.
+    for (const auto &segment : segments) {
+      for (auto kernel : segment) {
+        for (auto tensor : kernel->in_tensors()) {
+          auto producer = producers_.find(tensor);
+          if (producer == producers_.end()) {
+            continue;
+          }
+          auto iter = segment_ids.find(producer->second);
+          if (iter != segment_ids.end() && iter->second != segment_ids[kernel]) {
+            changed = checkpoints->insert(producer->second).second || changed;
+          }
+        }
+      }
+    }
+    if (changed) {
+      continue;
+    }
+    // The segment is run again before the first backward kernel reading it.
+    recompute_pos.assign(segments.size(), kNoPosition);
+    for (size_t i = 0; i < train_kernels_.size(); i++) {
+      auto role = roles_.at(train_kernels_[i]);
+      if (role == kRecomputeForward || role == kRecomputeRecomputable) {
+        continue;
+      }
+      for (auto tensor : train_kernels_[i]->in_tensors()) {
+        auto producer = producers_.find(tensor);
+        if (producer == producers_.end()) {
+          continue;
+        }
+        auto iter = segment_ids.find(producer->second);
+        if (iter != segment_ids.end() && recompute_pos[iter->second] == kNoPosition) {
+          recompute_pos[iter->second] = i;
+        }
+      }
+    }
+    // The weights read by the segment are changed after they are updated.
+    for (size_t i = 0; i < segments.size(); i++) {
+      if (recompute_pos[i] != kNoPosition && recompute_pos[i] > weight_update_pos_) {
+        checkpoints->insert(segments[i].begin(), segments[i].end());
+        changed = true;
+      }
+    }
+  }
+  std::vector<kernel::KernelExec *> run_kernels;
+  is_recompute->clear();
+  for (size_t i = 0; i < train_kernels_.size(); i++) {
+    for (size_t j = 0; j < segments.size(); j++) {
+      if (recompute_pos[j] == i) {
+        run_kernels.insert(run_kernels.end(), segments[j].begin(), segments[j].end());
+        is_recompute->insert(is_recompute->end(), segments[j].size(), true);
+      }
+    }
+    run_kernels.push_back(train_kernels_[i]);
+    is_recompute->push_back(false);
+  }
+  return run_kernels;
+}
+
+int ActivationRecompute::FindInPlaceInput(kernel::KernelExec *kernel, const lite::Tensor *out_tensor,
+                                          const std::unordered_map<lite::Tensor *, int> &ref_count) const {
+  if (!is_in_place_kernel_(kernel)) {
+    return -1;
+  }
+  const auto &in_tensors = kernel->in_tensors();
+  for (size_t i = 0; i < in_tensors.size(); i++) {
+    auto tensor = in_tensors[i];
+    auto iter = ref_count.find(tensor);
+    // The output takes over the buffer of the input read by the kernel only.
+    if (tensor->category() == lite::Category::VAR && iter != ref_count.end() && iter->second == 1 &&
+        out_tensor->Size() == tensor->Size()) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+void ActivationRecompute::PlanMemory(const std::vector<kernel::KernelExec *> &run_kernels,
+                                     const std::vector<bool> &is_recompute, RecomputePlan *plan) const {
+  // The reads of each output of the steps until the tensor is computed again.
+  std::vector<std::vector<int>> life_refs(run_kernels.size());
+  std::unordered_map<lite::Tensor *, std::pair<size_t, size_t>> last_outputs;
+  std::unordered_map<lite::Tensor *, int> inner_refs;
+  for (size_t i = 0; i < run_kernels.size(); i++) {
+    for (auto tensor : run_kernels[i]->in_tensors()) {
+      auto iter = last_outputs.find(tensor);
+      if (iter != last_outputs.end()) {
+        life_refs[iter->second.first][iter->second.second]++;
+      }
+    }
+    const auto &out_tensors = run_kernels[i]->out_tensors();
+    for (size_t j = 0; j < out_tensors.size(); j++) {
+      life_refs[i].push_back(0);
+      last_outputs[out_tensors[j]] = {i, j};
+    }
+  }
+  for (auto kernel : train_kernels_) {
+    for (auto tensor : kernel->in_tensors()) {
+      inner_refs[tensor]++;
+    }
+  }
+  // The graph outputs and the outputs read by the user are kept after the last computation.
+  for (const auto &last_output : last_outputs) {
+    auto tensor = last_output.first;
+    auto outer_refs = std::max(tensor->init_ref_count() - inner_refs[tensor], 0);
+    life_refs[last_output.second.first][last_output.second.second] += outer_refs;
+  }
+
+  OptAllocator allocator;
+  std::unordered_map<lite::Tensor *, int> ref_count;
+  std::unordered_map<lite::Tensor *, size_t> offset_map;
+  plan->steps_.clear();
+  plan->recompute_num_ = 0;
+  for (size_t i = 0; i < run_kernels.size(); i++) {
+    auto kernel = run_kernels[i];
+    RecomputeStep step;
+    step.kernel_ = kernel;
+    step.is_recompute_ = is_recompute[i];
+    plan->recompute_num_ += is_recompute[i] ? 1 : 0;
+    const auto &out_tensors = kernel->out_tensors();
+    for (size_t j = 0; j < out_tensors.size(); j++) {
+      auto tensor = out_tensors[j];
+      size_t offset;
+      auto input_idx = FindInPlaceInput(kernel, tensor, ref_count);
+      if (input_idx >= 0) {
+        auto input = kernel->in_tensors().at(input_idx);
+        offset = offset_map[input];
+        (void)ref_count.erase(input);
+      } else {
+        offset = allocator.Malloc(tensor->Size());
+      }
+      offset_map[tensor] = offset;
+      ref_count[tensor] = life_refs[i][j];
+      step.out_offsets_.push_back(offset);
+    }
+    for (auto tensor : kernel->in_tensors()) {
+      auto iter = ref_count.find(tensor);
+      if (tensor->category() != lite::Category::VAR || iter == ref_count.end()) {
+        continue;
+      }
+      if (--iter->second == 0) {
+        allocator.Free(offset_map[tensor]);
+        (void)ref_count.erase(iter);
+      }
+    }
+    // The recomputed output which is not read in backprop is freed at once.
+    for (auto tensor : out_tensors) {
+      auto iter = ref_count.find(tensor);
+      if (is_recompute[i] && iter != ref_count.end() && iter->second == 0) {
+        allocator.Free(offset_map[tensor]);
+        (void)ref_count.erase(iter);
+      }
+    }
+    plan->steps_.push_back(std::move(step));
+  }
+  plan->buffer_size_ = allocator.total_size();
+}
+
+ActivationRecompute::RecomputePlan ActivationRecompute::MakePlan(
+  std::unordered_set<kernel::KernelExec *> checkpoints) const {
+  RecomputePlan plan;
+  std::vector<bool> is_recompute;
+  auto run_kernels = MakeRunKernels(&checkpoints, &is_recompute);
+  PlanMemory(run_kernels, is_recompute, &plan);
+  return plan;
+}
+
+int ActivationRecompute::Build(const std::vector<std::string> &checkpoint_names, size_t memory_budget) {
+  std::unordered_set<kernel::KernelExec *> all_kernels(train_kernels_.begin(), train_kernels_.end());
+  auto best = MakePlan(all_kernels);
+  auto origin_size = best.buffer_size_;
+  if (!checkpoint_names.empty()) {
+    std::unordered_set<kernel::KernelExec *> checkpoints;
+    for (auto kernel : train_kernels_) {
+      if (std::any_of(checkpoint_names.begin(), checkpoint_names.end(),
+                      [kernel](const std::string &name) { return kernel->name().find(name) != std::string::npos; })) {
+        (void)checkpoints.insert(kernel);
+      }
+    }
+    best = MakePlan(checkpoints);
+  } else {
+    size_t total_size = 0;
+    size_t min_size = std::numeric_limits<size_t>::max();
+    for (const auto &saved_size : saved_sizes_) {
+      total_size += saved_size.second;
+      if (saved_size.second > 0) {
+        min_size = std::min(min_size, saved_size.second);
+      }
+    }
+    // The plan fitting the budget with the least recomputation, or the plan of the least memory.
+    auto is_better = [memory_budget](const RecomputePlan &a, const RecomputePlan &b) {
+      if (memory_budget == 0) {
+        return a.buffer_size_ != b.buffer_size_ ? a.buffer_size_ < b.buffer_size_ : a.recompute_num_ < b.recompute_num_;
+      }
+      bool a_fit = a.buffer_size_ <= memory_budget;
+      bool b_fit = b.buffer_size_ <= memory_budget;
+      if (a_fit != b_fit) {
+        return a_fit;
+      }
+      if (a_fit && a.recompute_num_ != b.recompute_num_) {
+        return a.recompute_num_ < b.recompute_num_;
+      }
+      return a.buffer_size_ < b.buffer_size_;
+    };
+    // The segments of half size are tried in turn, down to one kernel for each segment.
+    for (auto segment_size = total_size / 2; segment_size >= min_size && segment_size > 0; segment_size /= 2) {
+      auto plan = MakePlan(SelectCheckpoints(segment_size));
+      if (is_better(plan, best)) {
+        best = std::move(plan);
+      }
+    }
+    if (memory_budget != 0 && best.buffer_size_ > memory_budget) {
+      MS_LOG(WARNING) << "The tensor memory " << best.buffer_size_ << " exceeds the recompute budget " << memory_budget;
+    }
+  }
+  MS_LOG(INFO) << "Recompute " << best.recompute_num_ << " kernels in backprop, the tensor memory is "
+               << best.buffer_size_ << " bytes, " << origin_size << " bytes without recompute.";
+  steps_ = std::move(best.steps_);
+  buffer_size_ = best.buffer_size_;
+  recompute_num_ = best.recompute_num_;
+  return RET_OK;
+}
+}  // namespace lite
+}  // namespace mindspore
@@ -0,0 +1,90 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MINDSPORE_LITE_SRC_TRAIN_ACTIVATION_RECOMPUTE_H_
+#define MINDSPORE_LITE_SRC_TRAIN_ACTIVATION_RECOMPUTE_H_
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "src/tensor.h"
+#include "src/litert/kernel_exec.h"
+
+namespace mindspore {
+namespace lite {
+enum RecomputeRole {
+  kRecomputeBackward = 0,  // the loss and the gradient kernels
+  kRecomputeForward,       // the forward kernel which is not recomputed, e.g. the kernel with random outputs
+  kRecomputeRecomputable,  // the forward kernel which can be run again in backprop
+  kRecomputeWeightUpdate,  // the kernel writing the weights, e.g. the optimizer
+};
+
+// One kernel execution of the train run, the output tensors of the step are placed at the offsets of tensor buffer.
+struct RecomputeStep {
+  kernel::KernelExec *kernel_ = nullptr;
+  bool is_recompute_ = false;
+  std::vector<size_t> out_offsets_;
+};
+
+// The activation recomputation of the train session. The recomputable forward kernels are split into segments by
+// the checkpoint kernels whose outputs are kept until backprop. The activations inside a segment are freed after
+// their last use in forward, and the segment is run again right before the first backward kernel reading them.
+// The checkpoints are the configured kernels, or are chosen to fit the tensor memory in the budget.
+class ActivationRecompute {
+ public:
+  ActivationRecompute(const std::vector<kernel::KernelExec *> &train_kernels,
+                      const std::function<RecomputeRole(kernel::KernelExec *)> &get_role,
+                      const std::function<bool(kernel::KernelExec *)> &is_in_place_kernel);
+  ~ActivationRecompute() = default;
+
+  // Plan the train run with the checkpoints named, or the ones chosen under the memory budget if there is no name.
+  // The budget of 0 means the least memory.
+  int Build(const std::vector<std::string> &checkpoint_names, size_t memory_budget);
+  bool HasRecompute() const { return recompute_num_ > 0; }
+  const std::vector<RecomputeStep> &steps() const { return steps_; }
+  size_t buffer_size() const { return buffer_size_; }
+
+ private:
+  struct RecomputePlan {
+    std::vector<RecomputeStep> steps_;
+    size_t buffer_size_ = 0;
+    size_t recompute_num_ = 0;
+  };
+  std::unordered_set<kernel::KernelExec *> SelectCheckpoints(size_t segment_size) const;
+  RecomputePlan MakePlan(std::unordered_set<kernel::KernelExec *> checkpoints) const;
+  std::vector<kernel::KernelExec *> MakeRunKernels(std::unordered_set<kernel::KernelExec *> *checkpoints,
+                                                   std::vector<bool> *is_recompute) const;
+  void PlanMemory(const std::vector<kernel::KernelExec *> &run_kernels, const std::vector<bool> &is_recompute,
+                  RecomputePlan *plan) const;
+  int FindInPlaceInput(kernel::KernelExec *kernel, const lite::Tensor *out_tensor,
+                       const std::unordered_map<lite::Tensor *, int> &ref_count) const;
+
+  const std::vector<kernel::KernelExec *> &train_kernels_;
+  std::function<bool(kernel::KernelExec *)> is_in_place_kernel_;
+  std::unordered_map<kernel::KernelExec *, RecomputeRole> roles_;
+  std::unordered_map<lite::Tensor *, kernel::KernelExec *> producers_;
+  // The size of the outputs of each recomputable kernel read in backprop.
+  std::unordered_map<kernel::KernelExec *, size_t> saved_sizes_;
+  // The position of first kernel updating the weights, no segment is recomputed after it.
+  size_t weight_update_pos_ = 0;
+  std::vector<RecomputeStep> steps_;
+  size_t buffer_size_ = 0;
+  size_t recompute_num_ = 0;
+};
+}  // namespace lite
+}  // namespace mindspore
+#endif  // MINDSPORE_LITE_SRC_TRAIN_ACTIVATION_RECOMPUTE_H_
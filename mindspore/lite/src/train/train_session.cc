@@ -37,6 +37,7 @@
 #include "src/train/train_utils.h"
 #include "src/train/train_export.h"
 #include "src/train/opt_allocator.h"
+#include "src/train/activation_recompute.h"
 #include "src/train/static_allocator.h"
 #include "src/train/train_populate_parameter.h"
 #include "src/train/train_populate_parameter_v0.h"
@@ -325,7 +326,22 @@ int TrainSession::AllocTensors(const std::vector<kernel::KernelExec *> &kernels)
     }
   }
   // Set Tensor data
-  auto size = allocator.total_size();
+  auto ret = ReserveTensorsData(allocator.total_size());
+  if (ret != RET_OK) {
+    return ret;
+  }
+  for (auto kernel : train_kernels_) {
+    for (auto tensor : kernel->out_tensors()) {
+      auto it = offset_map.find(tensor);
+      if (it != offset_map.end()) {
+        tensor->set_data(reinterpret_cast<void *>(reinterpret_cast<uint8_t *>(tensors_data_) + it->second));
+      }
+    }
+  }
+  return RET_OK;
+}
+
+int TrainSession::ReserveTensorsData(size_t size) {
   if (size > tensors_data_size_) {
     free(tensors_data_);
     tensors_data_ = nullptr;
@@ -341,12 +357,60 @@ int TrainSession::AllocTensors(const std::vector<kernel::KernelExec *> &kernels)
     tensors_data_ = buf;
     tensors_data_size_ = size;
   }
-  for (auto kernel : train_kernels_) {
-    for (auto tensor : kernel->out_tensors()) {
-      auto it = offset_map.find(tensor);
-      if (it != offset_map.end()) {
-        tensor->set_data(reinterpret_cast<void *>(reinterpret_cast<uint8_t *>(tensors_data_) + it->second));
-      }
+  return RET_OK;
+}
+
+RecomputeRole TrainSession::GetRecomputeRole(kernel::KernelExec *kernel) const {
+  static const std::set<schema::PrimitiveType> kNotRecomputableOps = {
+    schema::PrimitiveType_Dropout,      schema::PrimitiveType_LSTM,        schema::PrimitiveType_RandomNormal,
+    schema::PrimitiveType_UniformReal,  schema::PrimitiveType_AssignAdd,   schema::PrimitiveType_RandomStandardNormal};
+  if (IsLossKernel(kernel) || IsGradKernel(kernel)) {
+    return kRecomputeBackward;
+  }
+  if (IsMaskOutput(kernel)) {
+    return kRecomputeWeightUpdate;
+  }
+  // The kernel with the random or the stateful outputs gives a different result when it is run again.
+  if (IsBN(kernel) || kNotRecomputableOps.find(kernel->type()) != kNotRecomputableOps.end()) {
+    return kRecomputeForward;
+  }
+  for (auto tensor : kernel->out_tensors()) {
+    if (tensor->category() != lite::Category::VAR || tensor->IsGraphOutput()) {
+      return kRecomputeForward;
+    }
+  }
+  return kRecomputeRecomputable;
+}
+
+int TrainSession::AllocTrainTensors() {
+  recompute_steps_.clear();
+  if (!cfg_.enable_recompute_ || !IS_STATIC_ALLOCATOR(allocator_)) {
+    return AllocTensors(train_kernels_);
+  }
+  if (context_->IsCpuFloat16Enabled()) {
+    MS_LOG(WARNING) << "The recompute is not supported in the mix precision training.";
+    return AllocTensors(train_kernels_);
+  }
+  ActivationRecompute recompute(
+    train_kernels_, [this](kernel::KernelExec *kernel) { return GetRecomputeRole(kernel); },
+    [this](kernel::KernelExec *kernel) { return IsInPlaceKernel(kernel); });
+  auto ret = recompute.Build(cfg_.recompute_checkpoints_, cfg_.recompute_memory_budget_);
+  if (ret != RET_OK) {
+    MS_LOG(ERROR) << "Build the recompute of train kernels failed.";
+    return ret;
+  }
+  if (!recompute.HasRecompute()) {
+    return AllocTensors(train_kernels_);
+  }
+  ret = ReserveTensorsData(recompute.buffer_size());
+  if (ret != RET_OK) {
+    return ret;
+  }
+  recompute_steps_ = recompute.steps();
+  for (const auto &step : recompute_steps_) {
+    const auto &out_tensors = step.kernel_->out_tensors();
+    for (size_t i = 0; i < out_tensors.size(); i++) {
+      out_tensors[i]->set_data(static_cast<uint8_t *>(tensors_data_) + step.out_offsets_[i]);
     }
   }
   return RET_OK;
@@ -392,7 +456,8 @@ int TrainSession::CompileTrainGraph(std::shared_ptr<Model> model) {
     MS_LOG(ERROR) << "failed to allocate space";
     return RET_ERROR;
   }
-  ret = AllocTensors(train_kernels_);
+  // The tensor buffer is never shrunk, so that it is reserved with the recompute plan at first.
+  ret = AllocTrainTensors();
   if (ret != RET_OK) {
     MS_LOG(ERROR) << "failed to allocate space";
     return RET_ERROR;
@@ -421,6 +486,24 @@ int TrainSession::ExecKernels(const KernelCallBack &before, const KernelCallBack
   return RET_OK;
 }
 
+int TrainSession::ExecRecomputeSteps(const KernelCallBack &before, const KernelCallBack &after) {
+  for (const auto &step : recompute_steps_) {
+    // The recomputed outputs are placed apart from the ones of forward.
+    const auto &out_tensors = step.kernel_->out_tensors();
+    for (size_t i = 0; i < out_tensors.size(); i++) {
+      out_tensors[i]->set_data(static_cast<uint8_t *>(tensors_data_) + step.out_offsets_[i]);
+    }
+    // The callbacks see every kernel once as without recompute, the kernels recomputed in backprop skip them.
+    auto ret = step.is_recompute_ ? step.kernel_->Execute(nullptr, nullptr) : step.kernel_->Execute(before, after);
+    if (RET_OK != ret) {
+      MS_LOG(ERROR) << "Execute kernel failed, name: " << step.kernel_->name()
+                    << (step.is_recompute_ ? " in recompute." : ".");
+      return ret;
+    }
+  }
+  return RET_OK;
+}
+
 void TrainSession::RestoreTensorData() {
   for (auto &restored_origin_tensor : restored_origin_tensors_) {
     auto *origin_tensor = restored_origin_tensor.first;
@@ -594,7 +677,9 @@ int TrainSession::RunGraph(const KernelCallBack &before, const KernelCallBack &a
     return lite::RET_NULL_PTR;
   }
   auto &run_kernels = (train_mode_) ? train_kernels_ : inference_kernels_;
-  if (context_->IsCpuFloat16Enabled()) {
+  if (train_mode_ && !recompute_steps_.empty()) {
+    ret = ExecRecomputeSteps(before, after);
+  } else if (context_->IsCpuFloat16Enabled()) {
     ret = MixPrecisionExecKernels(before, after, run_kernels);
   } else {
     ret = ExecKernels(before, after, run_kernels);
@@ -642,7 +727,7 @@ int TrainSession::Train() {
     }
   }
   // allocate tensors
-  auto ret = AllocTensors(train_kernels_);
+  auto ret = AllocTrainTensors();
   if (ret != RET_OK) {
     MS_LOG(ERROR) << "failed to allocate tensor space";
     return RET_ERROR;
@@ -1137,7 +1222,7 @@ int TrainSession::Resize(const std::vector<lite::Tensor *> &inputs, const std::v
     MS_LOG(ERROR) << "failed to allocate space";
     return RET_ERROR;
   }
-  ret = AllocTensors(train_kernels_);
+  ret = train_mode_ ? AllocTrainTensors() : AllocTensors(train_kernels_);
   if (ret != RET_OK) {
     MS_LOG(ERROR) << "train alloc failed after resize.";
     return RET_ERROR;
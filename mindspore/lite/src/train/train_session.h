@@ -23,6 +23,7 @@
 #include <map>
 #include "include/train/train_cfg.h"
 #include "src/litert/lite_session.h"
+#include "src/train/activation_recompute.h"
 
 /*
        Inheritance Diagram
@@ -163,6 +164,10 @@ class TrainSession : virtual public lite::LiteSession {
   bool AllInputsNeedScale(kernel::KernelExec *kernel);
   void FreeWorkSpace();
   int AllocTensors(const std::vector<kernel::KernelExec *> &kernels);
+  int ReserveTensorsData(size_t size);
+  int AllocTrainTensors();
+  RecomputeRole GetRecomputeRole(kernel::KernelExec *kernel) const;
+  int ExecRecomputeSteps(const KernelCallBack &before, const KernelCallBack &after);
   bool IsInPlaceKernel(kernel::KernelExec *kernel);
   bool IsInPlaceTensor(kernel::KernelExec *kernel, uint32_t idx,
                        const std::unordered_map<lite::Tensor *, int> &ref_count, uint32_t *input_idx);
@@ -187,6 +192,8 @@ class TrainSession : virtual public lite::LiteSession {
   void *tensors_data_ = nullptr;
   size_t tensors_data_size_ = 0;
   std::shared_ptr<Allocator> allocator_;
+  // The run of train kernels with the forward kernels recomputed in backprop, empty if there is no recompute.
+  std::vector<RecomputeStep> recompute_steps_;
 };
 
 }  // namespace lite
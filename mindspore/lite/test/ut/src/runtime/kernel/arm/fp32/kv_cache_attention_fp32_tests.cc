@@ -0,0 +1,200 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "nnacl/attention_parameter.h"
+#include "mindspore/lite/src/litert/kernel_registry.h"
+#include "mindspore/lite/src/common/common.h"
+
+namespace mindspore {
+class TestKVCacheAttentionFp32 : public mindspore::CommonTest {
+ public:
+  TestKVCacheAttentionFp32() {}
+};
+
+namespace {
+// The attention of one head over the tokens [begin, end) of the whole sequence.
+std::vector<float> RefAttention(const float *q, const std::vector<float> &k, const std::vector<float> &v, int begin,
+                                int end, int head_size) {
+  std::vector<float> scores;
+  float max_score = -INFINITY;
+  for (int pos = begin; pos < end; ++pos) {
+    float dot = 0.0f;
+    for (int d = 0; d < head_size; ++d) {
+      dot += q[d] * k[pos * head_size + d];
+    }
+    scores.push_back(dot / std::sqrt(static_cast<float>(head_size)));
+    max_score = std::max(max_score, scores.back());
+  }
+  float sum = 0.0f;
+  for (auto &score : scores) {
+    score = std::exp(score - max_score);
+    sum += score;
+  }
+  std::vector<float> out(head_size, 0.0f);
+  for (int pos = begin; pos < end; ++pos) {
+    for (int d = 0; d < head_size; ++d) {
+      out[d] += scores[pos - begin] / sum * v[pos * head_size + d];
+    }
+  }
+  return out;
+}
+
+kernel::LiteKernel *CreateKernel(const std::vector<lite::Tensor *> &inputs, const std::vector<lite::Tensor *> &outputs,
+                                 int max_seq_len, lite::InnerContext *ctx) {
+  auto param = reinterpret_cast<KVCacheAttentionParameter *>(malloc(sizeof(KVCacheAttentionParameter)));
+  memset(param, 0, sizeof(KVCacheAttentionParameter));
+  param->op_parameter_.type_ = PrimType_Inner_KVCacheAttention;
+  param->op_parameter_.thread_num_ = ctx->thread_num_;
+  param->max_seq_len_ = max_seq_len;
+  kernel::KernelKey desc = {kernel::KERNEL_ARCH::kCPU, kNumberTypeFloat32, NHWC, PrimType_Inner_KVCacheAttention};
+  auto creator = lite::KernelRegistry::GetInstance()->GetCreator(desc);
+  if (creator == nullptr) {
+    free(param);
+    return nullptr;
+  }
+  return creator(inputs, outputs, reinterpret_cast<OpParameter *>(param), ctx, desc);
+}
+}  // namespace
+
+/// Feature: KVCacheAttention fp32 kernel.
+/// Description: run the prompt of 2 tokens and then decode 3 tokens one by one with a cache of 4 tokens.
+/// Expectation: each step equals the causal attention over the whole sequence within the last 4 tokens.
+TEST_F(TestKVCacheAttentionFp32, DecodeWithRingCache) {
+  constexpr int kHeadSize = 2;
+  constexpr int kMaxSeqLen = 4;
+  constexpr int kSeqLen = 5;
+  std::vector<float> q_all = {0.1, 0.2, 0.3, -0.4, 0.5, 0.6, -0.7, 0.8, 0.9, 1.0};
+  std::vector<float> k_all = {1.0, 0.5, -0.5, 0.2, 0.3, 0.7, 0.9, -0.1, 0.4, 0.4};
+  std::vector<float> v_all = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0};
+
+  lite::Tensor q_tensor(kNumberTypeFloat32, {1, 1, 2, kHeadSize});
+  lite::Tensor k_tensor(kNumberTypeFloat32, {1, 1, 2, kHeadSize});
+  lite::Tensor v_tensor(kNumberTypeFloat32, {1, 1, 2, kHeadSize});
+  lite::Tensor pos_tensor(kNumberTypeInt32, {1});
+  lite::Tensor out_tensor(kNumberTypeFloat32, {1, 1, 2, kHeadSize});
+  int position[1] = {0};
+  float output[2 * kHeadSize] = {0};
+  q_tensor.set_data(q_all.data());
+  k_tensor.set_data(k_all.data());
+  v_tensor.set_data(v_all.data());
+  pos_tensor.set_data(position);
+  out_tensor.set_data(output);
+  std::vector<lite::Tensor *> inputs = {&q_tensor, &k_tensor, &v_tensor, &pos_tensor};
+  std::vector<lite::Tensor *> outputs = {&out_tensor};
+
+  auto ctx = std::make_shared<lite::InnerContext>();
+  ctx->thread_num_ = 1;
+  ASSERT_EQ(lite::RET_OK, ctx->Init());
+  auto kernel = CreateKernel(inputs, outputs, kMaxSeqLen, ctx.get());
+  ASSERT_NE(kernel, nullptr);
+  ASSERT_EQ(lite::RET_OK, kernel->Prepare());
+  ASSERT_EQ(lite::RET_OK, kernel->Run());
+  for (int i = 0; i < 2; ++i) {
+    auto expect = RefAttention(q_all.data() + i * kHeadSize, k_all, v_all, 0, i + 1, kHeadSize);
+    ASSERT_EQ(0, CompareOutputData(output + i * kHeadSize, expect.data(), kHeadSize, 0.0001));
+  }
+
+  for (auto tensor : {&q_tensor, &k_tensor, &v_tensor, &out_tensor}) {
+    tensor->set_shape({1, 1, 1, kHeadSize});
+  }
+  ASSERT_EQ(lite::RET_OK, kernel->ReSize());
+  for (int i = 2; i < kSeqLen; ++i) {
+    q_tensor.set_data(q_all.data() + i * kHeadSize);
+    k_tensor.set_data(k_all.data() + i * kHeadSize);
+    v_tensor.set_data(v_all.data() + i * kHeadSize);
+    position[0] = i;
+    ASSERT_EQ(lite::RET_OK, kernel->Run());
+    auto begin = std::max(0, i + 1 - kMaxSeqLen);
+    auto expect = RefAttention(q_all.data() + i * kHeadSize, k_all, v_all, begin, i + 1, kHeadSize);
+    ASSERT_EQ(0, CompareOutputData(output, expect.data(), kHeadSize, 0.0001));
+  }
+
+  // The position beyond the cached tokens is rejected.
+  position[0] = kSeqLen + 1;
+  ASSERT_NE(lite::RET_OK, kernel->Run());
+
+  delete kernel;
+  for (auto tensor : {&q_tensor, &k_tensor, &v_tensor, &pos_tensor, &out_tensor}) {
+    tensor->set_data(nullptr);
+  }
+}
+
+/// Feature: KVCacheAttention fp32 kernel.
+/// Description: decode the steps of two sequences interleaved in one kernel, and create the kernel in a model pool.
+/// Expectation: the step continuing another sequence is rejected, a new sequence is accepted; the pool is rejected.
+TEST_F(TestKVCacheAttentionFp32, OneSequencePerSession) {
+  constexpr int kHeadSize = 2;
+  constexpr int kMaxSeqLen = 4;
+  std::vector<float> qkv = {0.1, 0.2};
+  lite::Tensor q_tensor(kNumberTypeFloat32, {1, 1, 1, kHeadSize});
+  lite::Tensor k_tensor(kNumberTypeFloat32, {1, 1, 1, kHeadSize});
+  lite::Tensor v_tensor(kNumberTypeFloat32, {1, 1, 1, kHeadSize});
+  lite::Tensor pos_tensor(kNumberTypeInt32, {1});
+  lite::Tensor seq_tensor(kNumberTypeInt32, {1});
+  lite::Tensor out_tensor(kNumberTypeFloat32, {1, 1, 1, kHeadSize});
+  int position[1] = {0};
+  int seq_id[1] = {1};
+  float output[kHeadSize] = {0};
+  for (auto tensor : {&q_tensor, &k_tensor, &v_tensor}) {
+    tensor->set_data(qkv.data());
+  }
+  pos_tensor.set_data(position);
+  seq_tensor.set_data(seq_id);
+  out_tensor.set_data(output);
+  std::vector<lite::Tensor *> inputs = {&q_tensor, &k_tensor, &v_tensor, &pos_tensor, &seq_tensor};
+  std::vector<lite::Tensor *> outputs = {&out_tensor};
+
+  auto ctx = std::make_shared<lite::InnerContext>();
+  ctx->thread_num_ = 1;
+  ASSERT_EQ(lite::RET_OK, ctx->Init());
+  auto kernel = CreateKernel(inputs, outputs, kMaxSeqLen, ctx.get());
+  ASSERT_NE(kernel, nullptr);
+  ASSERT_EQ(lite::RET_OK, kernel->Prepare());
+  ASSERT_EQ(lite::RET_OK, kernel->Run());
+  position[0] = 1;
+  ASSERT_EQ(lite::RET_OK, kernel->Run());
+  // The step of sequence 2 can't continue the cached tokens of sequence 1.
+  seq_id[0] = 2;
+  position[0] = 2;
+  ASSERT_NE(lite::RET_OK, kernel->Run());
+  // Sequence 2 starts a new sequence and owns the cache, then sequence 1 can't continue.
+  position[0] = 0;
+  ASSERT_EQ(lite::RET_OK, kernel->Run());
+  seq_id[0] = 1;
+  position[0] = 1;
+  ASSERT_NE(lite::RET_OK, kernel->Run());
+  delete kernel;
+
+  // The workers of the model pool don't share the cache of a sequence.
+  std::map<std::string, std::map<std::string, std::string>> config = {
+    {lite::kInnerModelParallelRunnerSection, {{lite::kInnerRunnerIDKey, "1"}}}};
+  kernel = CreateKernel(inputs, outputs, kMaxSeqLen, ctx.get());
+  ASSERT_NE(kernel, nullptr);
+  kernel->SetConfig(&config);
+  ASSERT_EQ(lite::RET_NOT_SUPPORT, kernel->Prepare());
+  delete kernel;
+  for (auto tensor : {&q_tensor, &k_tensor, &v_tensor, &pos_tensor, &seq_tensor, &out_tensor}) {
+    tensor->set_data(nullptr);
+  }
+}
+}  // namespace mindspore
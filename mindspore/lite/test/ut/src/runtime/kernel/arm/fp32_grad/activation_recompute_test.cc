@@ -0,0 +1,218 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "include/errorcode.h"
+#include "include/train/train_cfg.h"
+#include "src/common/file_utils.h"
+#include "src/train/static_allocator.h"
+#define private public
+#include "src/train/train_session.h"
+#undef private
+
+namespace mindspore {
+namespace {
+constexpr int kTrainSteps = 3;
+
+struct TrainResult {
+  std::vector<std::vector<float>> losses;
+  std::vector<std::vector<float>> weights;
+};
+
+std::vector<float> TensorValues(lite::Tensor *tensor) {
+  if (tensor->data_type() != kNumberTypeFloat32 || tensor->data() == nullptr) {
+    return {};
+  }
+  auto data = reinterpret_cast<float *>(tensor->data());
+  return std::vector<float>(data, data + tensor->ElementsNum());
+}
+}  // namespace
+
+class ActivationRecomputeTest : public mindspore::CommonTest {
+ public:
+  ActivationRecomputeTest() = default;
+
+  std::unique_ptr<lite::TrainSession> CreateSession(const lite::TrainCfg &cfg) {
+    size_t size = 0;
+    char *buf = lite::ReadFile("./nets/conv_train_model.ms", &size);
+    if (buf == nullptr) {
+      return nullptr;
+    }
+    std::shared_ptr<lite::Model> model(lite::Model::Import(buf, size));
+    delete[] buf;
+    auto context = std::make_shared<lite::InnerContext>();
+    context->thread_num_ = 1;
+    context->allocator = std::make_shared<StaticAllocator>();
+    auto session = std::make_unique<lite::TrainSession>();
+    if (model == nullptr || session->TrainInit(context, &cfg) != lite::RET_OK ||
+        session->CompileTrainGraph(model) != lite::RET_OK || session->Train() != lite::RET_OK) {
+      return nullptr;
+    }
+    return session;
+  }
+
+  // Trains the same inputs for a few steps, and keeps the losses of every step and the weights at last.
+  TrainResult TrainSteps(lite::TrainSession *session, const lite::KernelCallBack &before = nullptr,
+                         const lite::KernelCallBack &after = nullptr) {
+    TrainResult result;
+    for (int step = 0; step < kTrainSteps; step++) {
+      for (auto input : session->GetInputs()) {
+        auto data = input->MutableData();
+        EXPECT_NE(data, nullptr);
+        if (input->data_type() == kNumberTypeFloat32) {
+          auto float_data = reinterpret_cast<float *>(data);
+          for (int i = 0; i < input->ElementsNum(); i++) {
+            float_data[i] = static_cast<float>(i % 17) / 17.0f;
+          }
+        } else if (input->data_type() == kNumberTypeInt32) {
+          auto int_data = reinterpret_cast<int32_t *>(data);
+          for (int i = 0; i < input->ElementsNum(); i++) {
+            int_data[i] = i % 2;
+          }
+        }
+      }
+      EXPECT_EQ(session->RunGraph(before, after), lite::RET_OK);
+      for (const auto &name : session->GetOutputTensorNames()) {
+        result.losses.push_back(TensorValues(session->GetOutputByTensorName(name)));
+      }
+    }
+    for (auto tensor : session->GetFeatureMaps()) {
+      result.weights.push_back(TensorValues(tensor));
+    }
+    return result;
+  }
+
+  std::vector<kernel::KernelExec *> RecomputableKernels(lite::TrainSession *session) {
+    std::vector<kernel::KernelExec *> kernels;
+    for (auto kernel : session->train_kernels_) {
+      if (session->GetRecomputeRole(kernel) == lite::kRecomputeRecomputable) {
+        kernels.push_back(kernel);
+      }
+    }
+    return kernels;
+  }
+
+  lite::ActivationRecompute MakeRecompute(lite::TrainSession *session) {
+    return lite::ActivationRecompute(
+      session->train_kernels_, [session](kernel::KernelExec *kernel) { return session->GetRecomputeRole(kernel); },
+      [session](kernel::KernelExec *kernel) { return session->IsInPlaceKernel(kernel); });
+  }
+};
+
+TEST_F(ActivationRecomputeTest, TrainSameWithRecompute) {
+  lite::TrainCfg cfg;
+  auto session = CreateSession(cfg);
+  ASSERT_NE(session, nullptr);
+  ASSERT_TRUE(session->recompute_steps_.empty());
+  auto expect = TrainSteps(session.get());
+
+  cfg.enable_recompute_ = true;
+  auto recompute_session = CreateSession(cfg);
+  ASSERT_NE(recompute_session, nullptr);
+  ASSERT_FALSE(recompute_session->recompute_steps_.empty());
+  ASSERT_LT(recompute_session->tensors_data_size_, session->tensors_data_size_);
+  auto result = TrainSteps(recompute_session.get());
+
+  ASSERT_FALSE(expect.losses.empty());
+  ASSERT_EQ(result.losses, expect.losses);
+  ASSERT_FALSE(expect.weights.empty());
+  ASSERT_EQ(result.weights, expect.weights);
+}
+
+TEST_F(ActivationRecomputeTest, CallbackOncePerKernel) {
+  lite::TrainCfg cfg;
+  cfg.enable_recompute_ = true;
+  auto session = CreateSession(cfg);
+  ASSERT_NE(session, nullptr);
+  ASSERT_GT(session->recompute_steps_.size(), session->train_kernels_.size());
+
+  std::map<std::string, int> before_counts;
+  std::map<std::string, int> after_counts;
+  lite::KernelCallBack before = [&before_counts](std::vector<lite::Tensor *>, std::vector<lite::Tensor *>,
+                                                 const MSCallBackParam &param) {
+    before_counts[param.node_name]++;
+    return true;
+  };
+  lite::KernelCallBack after = [&after_counts](std::vector<lite::Tensor *>, std::vector<lite::Tensor *>,
+                                               const MSCallBackParam &param) {
+    after_counts[param.node_name]++;
+    return true;
+  };
+  TrainSteps(session.get(), before, after);
+  for (auto kernel : session->train_kernels_) {
+    ASSERT_EQ(before_counts[kernel->name()], kTrainSteps);
+    ASSERT_EQ(after_counts[kernel->name()], kTrainSteps);
+  }
+}
+
+TEST_F(ActivationRecomputeTest, CheckpointNames) {
+  lite::TrainCfg cfg;
+  cfg.enable_recompute_ = true;
+  auto session = CreateSession(cfg);
+  ASSERT_NE(session, nullptr);
+  auto kernels = RecomputableKernels(session.get());
+  ASSERT_GT(kernels.size(), 1);
+
+  // The outputs of the kernel named are kept, so that it is never run again.
+  auto checkpoint = kernels.front();
+  auto recompute = MakeRecompute(session.get());
+  ASSERT_EQ(recompute.Build({checkpoint->name()}, 0), lite::RET_OK);
+  ASSERT_TRUE(recompute.HasRecompute());
+  for (const auto &step : recompute.steps()) {
+    ASSERT_FALSE(step.is_recompute_ && step.kernel_ == checkpoint);
+  }
+
+  // All the recomputable kernels are kept when they are all named.
+  std::vector<std::string> names;
+  for (auto kernel : kernels) {
+    names.push_back(kernel->name());
+  }
+  auto keep_all = MakeRecompute(session.get());
+  ASSERT_EQ(keep_all.Build(names, 0), lite::RET_OK);
+  ASSERT_FALSE(keep_all.HasRecompute());
+  ASSERT_EQ(keep_all.steps().size(), session->train_kernels_.size());
+}
+
+TEST_F(ActivationRecomputeTest, MemoryBudget) {
+  lite::TrainCfg cfg;
+  auto session = CreateSession(cfg);
+  ASSERT_NE(session, nullptr);
+
+  // The budget of 0 takes the plan of the least memory.
+  auto least = MakeRecompute(session.get());
+  ASSERT_EQ(least.Build({}, 0), lite::RET_OK);
+  ASSERT_TRUE(least.HasRecompute());
+  ASSERT_LT(least.buffer_size(), session->tensors_data_size_);
+  auto least_recompute_num = least.steps().size() - session->train_kernels_.size();
+
+  // Nothing is recomputed when the plan without recompute fits the budget.
+  auto enough = MakeRecompute(session.get());
+  ASSERT_EQ(enough.Build({}, std::numeric_limits<size_t>::max()), lite::RET_OK);
+  ASSERT_FALSE(enough.HasRecompute());
+
+  // The budget between the two takes a plan fitting it with no more recomputation than the least memory.
+  auto budget = (least.buffer_size() + session->tensors_data_size_) / 2;
+  auto middle = MakeRecompute(session.get());
+  ASSERT_EQ(middle.Build({}, budget), lite::RET_OK);
+  ASSERT_LE(middle.buffer_size(), budget);
+  ASSERT_LE(middle.steps().size() - session->train_kernels_.size(), least_recompute_num);
+}
+}  // namespace mindspore
@@ -23,6 +23,11 @@
 #include "nnacl/int8/matmul_int8.h"
 #include "mindspore/lite/src/litert/kernel_registry.h"
 #include "mindspore/lite/src/litert/kernel_exec.h"
+#ifdef ENABLE_AVX512
+#include "src/common/utils.h"
+#include "nnacl/int8/matmul_avx512_vnni_int8.h"
+#include "nnacl/intrinsics/ms_simd_cpu_info.h"
+#endif
 
 namespace mindspore {
 class TestMatmulInt8 : public mindspore::CommonTest {
@@ -260,4 +265,76 @@ TEST_F(TestMatmulInt8, mmtest2) {
   delete[] out;
 }
 
+#ifdef ENABLE_AVX512
+TEST_F(TestMatmulInt8, mm_avx512_vnni) {
+  IntelX86CpuInfoInit();
+  if (!X86_Avx512Vnni_Support()) {
+    MS_LOG(WARNING) << "The cpu doesn't support avx512 vnni, skip the test.";
+    return;
+  }
+  const int row = 13;
+  const int col = 37;
+  const int deep = 70;
+  const int row4 = UP_ROUND(row, C4NUM);
+  const int col16 = UP_ROUND(col, C16NUM);
+  const int deep4 = UP_ROUND(deep, C4NUM);
+  std::vector<int8_t> a(row * deep);
+  std::vector<int8_t> b(deep * col);
+  for (size_t i = 0; i < a.size(); i++) {
+    a[i] = static_cast<int8_t>(i * 37 % 256 - 128);
+  }
+  for (size_t i = 0; i < b.size(); i++) {
+    b[i] = static_cast<int8_t>(i * 91 % 256 - 128);
+  }
+  std::vector<int8_t> pack_a(row4 * deep4, 0);
+  std::vector<int8_t> pack_b(col16 * deep4, 0);
+  RowMajor2Row4x4MajorInt8(a.data(), pack_a.data(), row, deep);
+  RowMajor2Col4x16MajorInt8(b.data(), pack_b.data(), deep, col);
+
+  std::vector<int32_t> input_sum(row4, 0);
+  std::vector<int32_t> bias(col16, 0);
+  std::vector<int32_t> left_shift(col16, 0);
+  std::vector<int32_t> right_shift(col16, 0);
+  std::vector<int32_t> multiplier(col16, 0);
+  std::vector<int32_t> filter_zp(col16, 0);
+  for (int i = 0; i < row; i++) {
+    input_sum[i] = i * 17 - 100;
+  }
+  for (int i = 0; i < col; i++) {
+    bias[i] = i * 29 - 500;
+    right_shift[i] = -(C8NUM + i % C4NUM);
+    multiplier[i] = (1 << 30) + i * 1000;
+    filter_zp[i] = i % 5 - 2;
+  }
+  std::vector<int8_t> expect(row * col, 0);
+  std::vector<int8_t> output(row * col, 0);
+  for (size_t per_channel = 0; per_channel <= 1; per_channel++) {
+    MatMulInt8_4x16_r(pack_a.data(), pack_b.data(), expect.data(), row, col, deep4, col, input_sum.data(), bias.data(),
+                      left_shift.data(), right_shift.data(), multiplier.data(), 3, -128, 127, per_channel,
+                      filter_zp.data());
+    MatMulInt8Avx512Vnni(pack_a.data(), pack_b.data(), output.data(), row, col, deep4, col, input_sum.data(),
+                         bias.data(), left_shift.data(), right_shift.data(), multiplier.data(), 3, -128, 127,
+                         per_channel, filter_zp.data());
+    ASSERT_EQ(expect, output);
+  }
+
+  /* running time cost */
+  const int loop_count = 100;
+  auto time_start = lite::GetTimeUs();
+  for (int i = 0; i < loop_count; i++) {
+    MatMulInt8_4x16_r(pack_a.data(), pack_b.data(), expect.data(), row, col, deep4, col, input_sum.data(), bias.data(),
+                      left_shift.data(), right_shift.data(), multiplier.data(), 3, -128, 127, 1, filter_zp.data());
+  }
+  auto time_mid = lite::GetTimeUs();
+  for (int i = 0; i < loop_count; i++) {
+    MatMulInt8Avx512Vnni(pack_a.data(), pack_b.data(), output.data(), row, col, deep4, col, input_sum.data(),
+                         bias.data(), left_shift.data(), right_shift.data(), multiplier.data(), 3, -128, 127, 1,
+                         filter_zp.data());
+  }
+  auto time_end = lite::GetTimeUs();
+  printf("Matmul int8 c average time : %f us, avx512 vnni average time : %f us\n",
+         static_cast<float>(time_mid - time_start) / loop_count, static_cast<float>(time_end - time_mid) / loop_count);
+}
+#endif
+
 }  // namespace mindspore
@@ -0,0 +1,274 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "schema/inner/model_generated.h"
+#include "common/common_test.h"
+#include "include/errorcode.h"
+#include "src/common/common.h"
+#define private public
+#include "src/litert/lite_session.h"
+#undef private
+
+namespace mindspore {
+namespace {
+constexpr int kTableRows = 8;
+constexpr int kTableCols = 4;
+constexpr int kQuantBit = 4;
+constexpr float kQuantScale = 0.5f;
+const std::vector<int> kIndices = {5, 0, 7};
+using ConfigInfo = std::map<std::string, std::map<std::string, std::string>>;
+
+int8_t TableValue(int table, int index) { return static_cast<int8_t>((index * (table + 1)) % 15 - 7); }
+
+// The int8 table quantized to 4 bits and packed from the low bits, two values in a byte.
+std::unique_ptr<schema::TensorT> BuildPackedTable(int table) {
+  auto tensor = std::make_unique<schema::TensorT>();
+  tensor->nodeType = lite::NodeType_ValueNode;
+  tensor->format = schema::Format_NHWC;
+  tensor->dataType = TypeId::kNumberTypeInt8;
+  tensor->dims = {kTableRows, kTableCols};
+  tensor->offset = -1;
+  tensor->weightQuantCompressType = schema::WeightQuantCompressType_BITPACKING;
+  auto quant_param = std::make_unique<schema::QuantParamT>();
+  quant_param->scale = kQuantScale;
+  quant_param->zeroPoint = 0;
+  quant_param->numBits = kQuantBit;
+  quant_param->inited = true;
+  tensor->quantParams.emplace_back(std::move(quant_param));
+  const int offset = 1 << (kQuantBit - 1);
+  for (int i = 0; i < kTableRows * kTableCols; i += 2) {
+    auto low = static_cast<uint8_t>(TableValue(table, i) + offset);
+    auto high = static_cast<uint8_t>(TableValue(table, i + 1) + offset);
+    tensor->data.push_back(static_cast<uint8_t>(low | (high << kQuantBit)));
+  }
+  return tensor;
+}
+
+std::unique_ptr<schema::TensorT> BuildTensor(TypeId data_type, const std::vector<int> &dims) {
+  auto tensor = std::make_unique<schema::TensorT>();
+  tensor->nodeType = lite::NodeType_Parameter;
+  tensor->format = schema::Format_NHWC;
+  tensor->dataType = data_type;
+  tensor->dims = dims;
+  tensor->offset = -1;
+  return tensor;
+}
+
+/* GATHER(table0, indices) and GATHER(table1, indices), the tables are bit packed weights */
+std::vector<char> BuildGatherModel() {
+  auto meta_graph = std::make_shared<schema::MetaGraphT>();
+  meta_graph->name = "graph";
+  // indices, table0, table1, axis, output0, output1
+  meta_graph->allTensors.emplace_back(BuildTensor(kNumberTypeInt32, {static_cast<int>(kIndices.size())}));
+  meta_graph->allTensors.emplace_back(BuildPackedTable(0));
+  meta_graph->allTensors.emplace_back(BuildPackedTable(1));
+  auto axis = BuildTensor(kNumberTypeInt32, {1});
+  axis->nodeType = lite::NodeType_ValueNode;
+  axis->data.resize(sizeof(int), 0);
+  meta_graph->allTensors.emplace_back(std::move(axis));
+  for (size_t i = 0; i < 2; i++) {
+    meta_graph->allTensors.emplace_back(
+      BuildTensor(kNumberTypeFloat32, {static_cast<int>(kIndices.size()), kTableCols}));
+  }
+  for (uint32_t i = 0; i < 2; i++) {
+    auto node = std::make_unique<schema::CNodeT>();
+    node->name = "Gather" + std::to_string(i);
+    node->inputIndex = {1 + i, 0, 3};
+    node->outputIndex = {4 + i};
+    node->quantType = schema::QuantType_QUANT_WEIGHT;
+    node->primitive = std::make_unique<schema::PrimitiveT>();
+    node->primitive->value.type = schema::PrimitiveType_Gather;
+    node->primitive->value.value = new schema::GatherT;
+    meta_graph->nodes.emplace_back(std::move(node));
+  }
+  meta_graph->inputIndex = {0};
+  meta_graph->outputIndex = {4, 5};
+
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto offset = schema::MetaGraph::Pack(builder, meta_graph.get());
+  builder.Finish(offset);
+  auto content = reinterpret_cast<char *>(builder.GetBufferPointer());
+  return std::vector<char>(content, content + builder.GetSize());
+}
+
+std::shared_ptr<lite::LiteSession> CreateSession(std::vector<char> *model_buf, const ConfigInfo *config_info) {
+  auto context = std::make_shared<lite::InnerContext>();
+  context->thread_num_ = 1;
+  if (context->Init() != lite::RET_OK) {
+    return nullptr;
+  }
+  auto session = std::shared_ptr<lite::LiteSession>(lite::LiteSession::CreateSession(context));
+  if (session == nullptr) {
+    return nullptr;
+  }
+  session->SetConfigInfo(config_info);
+  if (session->LoadModelAndCompileByBuf(model_buf->data(), mindspore::ModelType::kMindIR_Lite, model_buf->size()) !=
+      lite::RET_OK) {
+    return nullptr;
+  }
+  return session;
+}
+
+std::vector<float> RunSession(lite::LiteSession *session, const lite::KernelCallBack &before = nullptr,
+                              const lite::KernelCallBack &after = nullptr) {
+  auto inputs = session->GetInputs();
+  if (inputs.size() != 1) {
+    return {};
+  }
+  auto indices = reinterpret_cast<int *>(inputs.front()->MutableData());
+  std::copy(kIndices.begin(), kIndices.end(), indices);
+  if (session->RunGraph(before, after) != lite::RET_OK) {
+    return {};
+  }
+  std::vector<float> result;
+  for (auto &name : session->GetOutputTensorNames()) {
+    auto output = session->GetOutputByTensorName(name);
+    auto data = reinterpret_cast<float *>(output->data());
+    result.insert(result.end(), data, data + output->ElementsNum());
+  }
+  return result;
+}
+
+std::vector<float> ExpectOutputs() {
+  std::vector<float> expect;
+  for (int table = 0; table < 2; table++) {
+    for (auto index : kIndices) {
+      for (int j = 0; j < kTableCols; j++) {
+        expect.push_back(kQuantScale * TableValue(table, index * kTableCols + j));
+      }
+    }
+  }
+  return expect;
+}
+}  // namespace
+
+class LazyWeightDecoderTest : public mindspore::CommonTest {
+ public:
+  LazyWeightDecoderTest() = default;
+};
+
+TEST_F(LazyWeightDecoderTest, LazyDecodeOutputs) {
+  auto model_buf = BuildGatherModel();
+  ConfigInfo config_info;
+  auto session = CreateSession(&model_buf, &config_info);
+  ASSERT_NE(session, nullptr);
+  ASSERT_EQ(session->lazy_weight_decoder_, nullptr);
+  auto outputs = RunSession(session.get());
+  ASSERT_EQ(outputs, ExpectOutputs());
+
+  for (auto prefetch : {"true", "false"}) {
+    ConfigInfo lazy_config_info = {
+      {lite::kConfigModelFileSection,
+       {{lite::kConfigLazyWeightDecodeKey, "true"}, {lite::kConfigLazyWeightPrefetchKey, prefetch}}}};
+    auto lazy_session = CreateSession(&model_buf, &lazy_config_info);
+    ASSERT_NE(lazy_session, nullptr);
+    ASSERT_NE(lazy_session->lazy_weight_decoder_, nullptr);
+    ASSERT_EQ(lazy_session->lazy_weight_decoder_->weight_num(), 2);
+    // The tables are not decoded when loading the model.
+    ASSERT_EQ(lazy_session->lazy_weight_decoder_->deferred_indices_.size(), 2);
+    for (auto &weight : lazy_session->lazy_weight_decoder_->weights_) {
+      ASSERT_TRUE(weight->deferred_);
+    }
+    ASSERT_EQ(RunSession(lazy_session.get()), outputs);
+    // The weights are decoded again by the next run.
+    ASSERT_EQ(RunSession(lazy_session.get()), outputs);
+  }
+}
+
+TEST_F(LazyWeightDecoderTest, ReleaseAfterKernel) {
+  auto model_buf = BuildGatherModel();
+  for (auto prefetch : {"true", "false"}) {
+    ConfigInfo config_info = {
+      {lite::kConfigModelFileSection,
+       {{lite::kConfigLazyWeightDecodeKey, "true"}, {lite::kConfigLazyWeightPrefetchKey, prefetch}}}};
+    auto session = CreateSession(&model_buf, &config_info);
+    ASSERT_NE(session, nullptr);
+    ASSERT_NE(session->lazy_weight_decoder_, nullptr);
+    ASSERT_EQ(session->lazy_weight_decoder_->enable_prefetch_, std::string(prefetch) == "true");
+    // The tables are released after compiling.
+    std::vector<lite::Tensor *> tables;
+    for (auto &weight : session->lazy_weight_decoder_->weights_) {
+      ASSERT_EQ(weight->tensor_->data(), nullptr);
+      tables.push_back(weight->tensor_);
+    }
+    int before_num = 0;
+    int after_num = 0;
+    lite::KernelCallBack before = [&before_num](const std::vector<lite::Tensor *> &inputs,
+                                                const std::vector<lite::Tensor *> &outputs,
+                                                const MSCallBackParam &info) {
+      // The table is decoded before the kernel runs.
+      before_num++;
+      return inputs.front()->data() != nullptr;
+    };
+    lite::KernelCallBack after = [&after_num](const std::vector<lite::Tensor *> &inputs,
+                                              const std::vector<lite::Tensor *> &outputs,
+                                              const MSCallBackParam &info) {
+      // The table is released after the kernel runs.
+      after_num++;
+      return inputs.front()->data() == nullptr;
+    };
+    auto outputs = RunSession(session.get(), before, after);
+    ASSERT_EQ(outputs, ExpectOutputs());
+    ASSERT_EQ(before_num, 2);
+    ASSERT_EQ(after_num, 2);
+    for (auto table : tables) {
+      ASSERT_EQ(table->data(), nullptr);
+    }
+  }
+}
+
+TEST_F(LazyWeightDecoderTest, DecodeFailed) {
+  auto model_buf = BuildGatherModel();
+  for (auto prefetch : {"true", "false"}) {
+    ConfigInfo config_info = {
+      {lite::kConfigModelFileSection,
+       {{lite::kConfigLazyWeightDecodeKey, "true"}, {lite::kConfigLazyWeightPrefetchKey, prefetch}}}};
+    auto session = CreateSession(&model_buf, &config_info);
+    ASSERT_NE(session, nullptr);
+    ASSERT_NE(session->lazy_weight_decoder_, nullptr);
+    // The dequant fails without the quant params inited.
+    auto &weight = session->lazy_weight_decoder_->weights_.front();
+    ASSERT_FALSE(weight->quant_params_.empty());
+    weight->quant_params_.front().inited = false;
+    auto inputs = session->GetInputs();
+    ASSERT_EQ(inputs.size(), 1);
+    auto indices = reinterpret_cast<int *>(inputs.front()->MutableData());
+    std::copy(kIndices.begin(), kIndices.end(), indices);
+    ASSERT_NE(session->RunGraph(), lite::RET_OK);
+    ASSERT_EQ(weight->tensor_->data(), nullptr);
+    // The session runs again after the weight is recovered.
+    weight->quant_params_.front().inited = true;
+    ASSERT_EQ(RunSession(session.get()), ExpectOutputs());
+  }
+}
+
+TEST_F(LazyWeightDecoderTest, ModelBufCopied) {
+  auto model_buf = BuildGatherModel();
+  ConfigInfo config_info = {{lite::kConfigModelFileSection, {{lite::kConfigLazyWeightDecodeKey, "true"}}}};
+  auto session = CreateSession(&model_buf, &config_info);
+  ASSERT_NE(session, nullptr);
+  ASSERT_NE(session->lazy_weight_decoder_, nullptr);
+  // The compressed weights are decoded from the copy of the model buffer, the buffer of the user can be released.
+  std::fill(model_buf.begin(), model_buf.end(), 0);
+  std::vector<char>().swap(model_buf);
+  auto outputs = RunSession(session.get());
+  ASSERT_EQ(outputs, ExpectOutputs());
+}
+}  // namespace mindspore
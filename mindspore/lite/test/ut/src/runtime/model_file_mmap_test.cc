@@ -0,0 +1,218 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "schema/inner/model_generated.h"
+#include "common/common_test.h"
+#include "include/errorcode.h"
+#include "src/common/common.h"
+#include "src/common/file_utils.h"
+#define private public
+#include "src/litert/lite_model.h"
+#include "src/litert/lite_session.h"
+#undef private
+
+namespace mindspore {
+namespace {
+constexpr int kDataSize = 1024;
+constexpr float kWeightValue = 1.0f;
+constexpr float kInputValue = 2.0f;
+const char *const kModelPath = "./model_file_mmap_test.ms";
+using ConfigInfo = std::map<std::string, std::map<std::string, std::string>>;
+
+std::unique_ptr<schema::TensorT> BuildTensor(int node_type) {
+  auto tensor = std::make_unique<schema::TensorT>();
+  tensor->nodeType = node_type;
+  tensor->format = schema::Format_NHWC;
+  tensor->dataType = kNumberTypeFloat32;
+  tensor->dims = {kDataSize};
+  tensor->offset = -1;
+  return tensor;
+}
+
+/* ADD(input, weight), the weight is a const tensor referencing the model buffer */
+std::vector<char> BuildAddModel() {
+  auto meta_graph = std::make_shared<schema::MetaGraphT>();
+  meta_graph->name = "graph";
+  meta_graph->allTensors.emplace_back(BuildTensor(lite::NodeType_Parameter));
+  auto weight = BuildTensor(lite::NodeType_ValueNode);
+  std::vector<float> weight_data(kDataSize, kWeightValue);
+  auto weight_bytes = reinterpret_cast<const uint8_t *>(weight_data.data());
+  weight->data.assign(weight_bytes, weight_bytes + weight_data.size() * sizeof(float));
+  meta_graph->allTensors.emplace_back(std::move(weight));
+  meta_graph->allTensors.emplace_back(BuildTensor(lite::NodeType_Parameter));
+  auto node = std::make_unique<schema::CNodeT>();
+  node->name = "Add";
+  node->inputIndex = {0, 1};
+  node->outputIndex = {2};
+  node->primitive = std::make_unique<schema::PrimitiveT>();
+  node->primitive->value.type = schema::PrimitiveType_AddFusion;
+  node->primitive->value.value = new schema::AddFusionT;
+  meta_graph->nodes.emplace_back(std::move(node));
+  meta_graph->inputIndex = {0};
+  meta_graph->outputIndex = {2};
+
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto offset = schema::MetaGraph::Pack(builder, meta_graph.get());
+  builder.Finish(offset);
+  auto content = reinterpret_cast<char *>(builder.GetBufferPointer());
+  return std::vector<char>(content, content + builder.GetSize());
+}
+
+bool WriteModelFile(const std::string &path, const std::vector<char> &model_buf) {
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  if (!ofs.is_open()) {
+    return false;
+  }
+  (void)ofs.write(model_buf.data(), static_cast<std::streamsize>(model_buf.size()));
+  return ofs.good();
+}
+
+std::shared_ptr<lite::LiteSession> CreateSession(const ConfigInfo *config_info) {
+  auto context = std::make_shared<lite::InnerContext>();
+  context->thread_num_ = 1;
+  if (context->Init() != lite::RET_OK) {
+    return nullptr;
+  }
+  auto session = std::shared_ptr<lite::LiteSession>(lite::LiteSession::CreateSession(context));
+  if (session == nullptr) {
+    return nullptr;
+  }
+  session->SetConfigInfo(config_info);
+  return session;
+}
+
+bool RunAndCheck(lite::LiteSession *session) {
+  auto inputs = session->GetInputs();
+  if (inputs.size() != 1) {
+    return false;
+  }
+  auto input_data = static_cast<float *>(inputs.front()->MutableData());
+  std::fill(input_data, input_data + kDataSize, kInputValue);
+  if (session->RunGraph() != lite::RET_OK) {
+    return false;
+  }
+  auto output = session->GetOutputs().begin()->second;
+  auto output_data = static_cast<float *>(output->data());
+  return std::all_of(output_data, output_data + kDataSize,
+                     [](float value) { return value == kInputValue + kWeightValue; });
+}
+}  // namespace
+
+class ModelFileMmapTest : public mindspore::CommonTest {
+ public:
+  ModelFileMmapTest() = default;
+  void TearDown() override { (void)std::remove(kModelPath); }
+};
+
+TEST_F(ModelFileMmapTest, MapAndUnmapFile) {
+  auto model_buf = BuildAddModel();
+  ASSERT_TRUE(WriteModelFile(kModelPath, model_buf));
+  size_t size = 0;
+  auto buf = lite::MapFile(kModelPath, &size);
+  ASSERT_NE(buf, nullptr);
+  ASSERT_EQ(size, model_buf.size());
+  ASSERT_TRUE(std::equal(model_buf.begin(), model_buf.end(), buf));
+  // The mapping is private, writing the buffer doesn't change the file.
+  buf[0] = static_cast<char>(~model_buf[0]);
+  lite::UnmapFile(buf, size);
+  size_t read_size = 0;
+  auto read_buf = lite::ReadFile(kModelPath, &read_size);
+  ASSERT_NE(read_buf, nullptr);
+  ASSERT_EQ(read_size, model_buf.size());
+  ASSERT_EQ(read_buf[0], model_buf[0]);
+  delete[] read_buf;
+
+  size_t missing_size = 0;
+  ASSERT_EQ(lite::MapFile("./model_file_mmap_test_missing.ms", &missing_size), nullptr);
+  ASSERT_EQ(missing_size, 0);
+  ASSERT_EQ(lite::MapFile(kModelPath, nullptr), nullptr);
+  // Unmapping the null buffer is ignored.
+  lite::UnmapFile(nullptr, 0);
+}
+
+TEST_F(ModelFileMmapTest, SessionRunMappedModel) {
+  ASSERT_TRUE(WriteModelFile(kModelPath, BuildAddModel()));
+  ConfigInfo config_info = {{lite::kConfigModelFileSection, {{lite::kConfigMmapModelKey, "true"}}}};
+  // The kMindIR model is verified to be an ms model before it is mapped.
+  for (auto model_type : {mindspore::ModelType::kMindIR_Lite, mindspore::ModelType::kMindIR}) {
+    auto session = CreateSession(&config_info);
+    ASSERT_NE(session, nullptr);
+    ASSERT_TRUE(session->IsMmapModelEnabled());
+    ASSERT_EQ(session->LoadModelAndCompileByPath(kModelPath, model_type), lite::RET_OK);
+    auto model = reinterpret_cast<lite::LiteModel *>(session->model_);
+    ASSERT_NE(model, nullptr);
+    ASSERT_TRUE(model->model_buf_mapped());
+    ASSERT_TRUE(RunAndCheck(session.get()));
+    // The model runs again with the weights paged in.
+    ASSERT_TRUE(RunAndCheck(session.get()));
+  }
+
+  // The model is read without the config.
+  ConfigInfo read_config_info;
+  auto read_session = CreateSession(&read_config_info);
+  ASSERT_NE(read_session, nullptr);
+  ASSERT_FALSE(read_session->IsMmapModelEnabled());
+  ASSERT_EQ(read_session->LoadModelAndCompileByPath(kModelPath, mindspore::ModelType::kMindIR_Lite), lite::RET_OK);
+  ASSERT_FALSE(reinterpret_cast<lite::LiteModel *>(read_session->model_)->model_buf_mapped());
+  ASSERT_TRUE(RunAndCheck(read_session.get()));
+}
+
+TEST_F(ModelFileMmapTest, MapOnlyMsModel) {
+  ConfigInfo config_info = {{lite::kConfigModelFileSection, {{lite::kConfigMmapModelKey, "true"}}}};
+  auto session = CreateSession(&config_info);
+  ASSERT_NE(session, nullptr);
+  ASSERT_TRUE(WriteModelFile(kModelPath, BuildAddModel()));
+  size_t size = 0;
+  // The other model types are not mapped even if the file is an ms model.
+  for (auto model_type : {mindspore::ModelType::kAIR, mindspore::ModelType::kOM, mindspore::ModelType::kONNX,
+                          mindspore::ModelType::kUnknownType}) {
+    ASSERT_EQ(session->MapModelByPath(kModelPath, model_type, &size), nullptr);
+    ASSERT_EQ(size, 0);
+  }
+  // The kMindIR file that is not an ms model is converted at runtime, so it is read instead of mapped.
+  std::vector<char> invalid_buf(kDataSize, 0);
+  ASSERT_TRUE(WriteModelFile(kModelPath, invalid_buf));
+  ASSERT_EQ(session->MapModelByPath(kModelPath, mindspore::ModelType::kMindIR, &size), nullptr);
+  ASSERT_EQ(size, 0);
+}
+
+TEST_F(ModelFileMmapTest, ImportFromPathMapped) {
+  ASSERT_TRUE(WriteModelFile(kModelPath, BuildAddModel()));
+  for (auto use_mmap : {true, false}) {
+    auto model = lite::LiteImportFromPath(kModelPath, use_mmap);
+    ASSERT_NE(model, nullptr);
+    ASSERT_EQ(model->model_buf_mapped(), use_mmap);
+    ASSERT_EQ(model->graph_.all_nodes_.size(), 1);
+    ASSERT_EQ(model->graph_.all_tensors_.size(), 3);
+    // The const weight references the mapped buffer without a copy.
+    auto weight = model->graph_.all_tensors_.at(1);
+    ASSERT_NE(weight->data(), nullptr);
+    auto weight_data = reinterpret_cast<const float *>(weight->data()->data());
+    ASSERT_GE(reinterpret_cast<const char *>(weight_data), model->buf);
+    ASSERT_LT(reinterpret_cast<const char *>(weight_data), model->buf + model->buf_size_);
+    ASSERT_EQ(weight_data[kDataSize - 1], kWeightValue);
+    // The mapped buffer is unmapped with the model.
+    delete model;
+  }
+  ASSERT_EQ(lite::LiteImportFromPath("./model_file_mmap_test_missing.ms", true), nullptr);
+}
+}  // namespace mindspore
@@ -0,0 +1,115 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#define private public
+#include "src/extendrt/cxx_api/model_pool/model_worker.h"
+#include "src/extendrt/cxx_api/model_pool/predict_task_queue.h"
+#undef private
+
+namespace mindspore {
+namespace {
+constexpr int kNodeId = 0;
+constexpr size_t kMaxQueueSize = 16;
+constexpr size_t kMaxBatchSize = 4;
+constexpr int64_t kBatchTimeoutUs = 1000;
+
+class BatchTask {
+ public:
+  explicit BatchTask(const std::vector<int64_t> &shape) {
+    int64_t elem_num = 1;
+    for (auto dim : shape) {
+      elem_num *= dim;
+    }
+    data_.resize(static_cast<size_t>(elem_num), 1.0f);
+    inputs_.emplace_back("input", DataType::kNumberTypeFloat32, shape, data_.data(), data_.size() * sizeof(float));
+    task_ = std::make_shared<PredictTask>(&inputs_, &outputs_);
+  }
+  PredictTask *task() const { return task_.get(); }
+
+ private:
+  std::vector<float> data_;
+  std::vector<MSTensor> inputs_;
+  std::vector<MSTensor> outputs_;
+  std::shared_ptr<PredictTask> task_;
+};
+}  // namespace
+
+class PredictTaskQueueTest : public mindspore::CommonTest {
+ public:
+  PredictTaskQueueTest() = default;
+  void SetUp() override {
+    task_queue_ = std::make_shared<PredictTaskQueue>();
+    ASSERT_EQ(task_queue_->InitTaskQueue(1, kMaxQueueSize), kSuccess);
+    task_queue_->EnableDynamicBatch(kMaxBatchSize, kBatchTimeoutUs);
+  }
+
+ protected:
+  std::shared_ptr<PredictTaskQueue> task_queue_;
+};
+
+TEST_F(PredictTaskQueueTest, BatchedPop) {
+  BatchTask task1({1, 3});
+  BatchTask task2({1, 3});
+  BatchTask task3({1, 5});
+  BatchTask task4({2, 3});
+  BatchTask task5({1, 3});
+  for (auto task : {task1.task(), task2.task(), task3.task(), task4.task(), task5.task()}) {
+    task_queue_->PushPredictTask(task, kNodeId);
+  }
+  ModelWorker worker;
+  // The tasks of the same shapes except the first dim are batched up to the max batch size, in the push order.
+  auto tasks = task_queue_->GetPredictTasks(kNodeId, &worker);
+  ASSERT_EQ(tasks, std::vector<PredictTask *>({task1.task(), task2.task(), task5.task()}));
+  // The tasks not batched keep their order for the next pops.
+  worker.available_ = true;
+  tasks = task_queue_->GetPredictTasks(kNodeId, &worker);
+  ASSERT_EQ(tasks, std::vector<PredictTask *>({task3.task()}));
+  worker.available_ = true;
+  tasks = task_queue_->GetPredictTasks(kNodeId, &worker);
+  ASSERT_EQ(tasks, std::vector<PredictTask *>({task4.task()}));
+  task_queue_->SetPredictTaskDone();
+}
+
+TEST_F(PredictTaskQueueTest, LeftoverTaskWakeUpWorker) {
+  BatchTask task1({1, 3});
+  BatchTask task2({1, 5});
+  ModelWorker workers[2];
+  std::vector<PredictTask *> tasks[2];
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 2; i++) {
+    threads.emplace_back(
+      [this, &workers, &tasks, i]() { tasks[i] = task_queue_->GetPredictTasks(kNodeId, &workers[i]); });
+  }
+  task_queue_->PushPredictTask(task1.task(), kNodeId);
+  task_queue_->PushPredictTask(task2.task(), kNodeId);
+  // The task left by the worker batching the other one is run by the other waiting worker.
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(tasks[0].size(), 1);
+  ASSERT_EQ(tasks[1].size(), 1);
+  std::vector<PredictTask *> all_tasks = {tasks[0].front(), tasks[1].front()};
+  std::sort(all_tasks.begin(), all_tasks.end());
+  std::vector<PredictTask *> expect_tasks = {task1.task(), task2.task()};
+  std::sort(expect_tasks.begin(), expect_tasks.end());
+  ASSERT_EQ(all_tasks, expect_tasks);
+  task_queue_->SetPredictTaskDone();
+}
+}  // namespace mindspore
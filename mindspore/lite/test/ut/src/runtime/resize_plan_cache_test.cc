@@ -0,0 +1,174 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include "schema/inner/model_generated.h"
+#include "common/common_test.h"
+#include "include/errorcode.h"
+#include "src/common/common.h"
+#include "src/litert/resize_plan_cache.h"
+#define private public
+#include "src/litert/lite_session.h"
+#undef private
+
+namespace mindspore {
+namespace {
+constexpr int kChannel = 4;
+
+/* ADD(x, y), y is broadcast to x when only x is resized */
+lite::Model *BuildAddModel() {
+  auto meta_graph = std::make_shared<schema::MetaGraphT>();
+  meta_graph->name = "graph";
+  auto node = std::make_unique<schema::CNodeT>();
+  node->inputIndex = {0, 1};
+  node->outputIndex = {2};
+  node->primitive = std::make_unique<schema::PrimitiveT>();
+  node->primitive->value.type = schema::PrimitiveType_AddFusion;
+  node->primitive->value.value = new schema::AddFusionT;
+  node->name = "Add";
+  meta_graph->nodes.emplace_back(std::move(node));
+  meta_graph->inputIndex = {0, 1};
+  meta_graph->outputIndex = {2};
+  for (size_t i = 0; i < 3; i++) {
+    auto tensor = std::make_unique<schema::TensorT>();
+    tensor->nodeType = lite::NodeType_Parameter;
+    tensor->format = schema::Format_NHWC;
+    tensor->dataType = TypeId::kNumberTypeFloat32;
+    tensor->dims = {1, kChannel};
+    tensor->offset = -1;
+    meta_graph->allTensors.emplace_back(std::move(tensor));
+  }
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto offset = schema::MetaGraph::Pack(builder, meta_graph.get());
+  builder.Finish(offset);
+  return lite::Model::Import(reinterpret_cast<char *>(builder.GetBufferPointer()), builder.GetSize());
+}
+
+void RunAndCheck(lite::LiteSession *session, const std::vector<int> &x_shape, const std::vector<int> &y_shape) {
+  auto inputs = session->GetInputs();
+  ASSERT_EQ(inputs.size(), 2);
+  ASSERT_EQ(inputs[0]->shape(), x_shape);
+  ASSERT_EQ(inputs[1]->shape(), y_shape);
+  auto x_data = reinterpret_cast<float *>(inputs[0]->MutableData());
+  auto y_data = reinterpret_cast<float *>(inputs[1]->MutableData());
+  ASSERT_NE(x_data, nullptr);
+  ASSERT_NE(y_data, nullptr);
+  for (int i = 0; i < inputs[0]->ElementsNum(); i++) {
+    x_data[i] = static_cast<float>(i);
+  }
+  for (int i = 0; i < inputs[1]->ElementsNum(); i++) {
+    y_data[i] = static_cast<float>(i) * 10.0f;
+  }
+  ASSERT_EQ(session->RunGraph(), lite::RET_OK);
+  auto outputs = session->GetOutputs();
+  ASSERT_EQ(outputs.size(), 1);
+  auto output = outputs.begin()->second;
+  ASSERT_EQ(output->shape(), std::vector<int>({std::max(x_shape[0], y_shape[0]), kChannel}));
+  auto out_data = reinterpret_cast<float *>(output->data());
+  ASSERT_NE(out_data, nullptr);
+  for (int i = 0; i < output->ElementsNum(); i++) {
+    auto x = x_data[i % inputs[0]->ElementsNum()];
+    auto y = y_data[i % inputs[1]->ElementsNum()];
+    ASSERT_EQ(out_data[i], x + y);
+  }
+}
+}  // namespace
+
+class ResizePlanCacheTest : public mindspore::CommonTest {
+ public:
+  ResizePlanCacheTest() = default;
+};
+
+TEST_F(ResizePlanCacheTest, FindAndEvict) {
+  lite::ResizePlanCache cache(2);
+  std::vector<std::vector<int>> shape1 = {{1, 32, 32, 3}};
+  std::vector<std::vector<int>> shape2 = {{1, 64, 64, 3}};
+  std::vector<std::vector<int>> shape3 = {{2, 32, 32, 3}};
+  ASSERT_EQ(cache.Find(shape1), nullptr);
+  lite::ResizePlan plan1;
+  plan1.skip_infer_ = true;
+  cache.Insert(shape1, std::move(plan1));
+  cache.Insert(shape2, lite::ResizePlan());
+  auto plan = cache.Find(shape1);
+  ASSERT_NE(plan, nullptr);
+  ASSERT_TRUE(plan->skip_infer_);
+  // shape2 is the least recently used one and is evicted.
+  cache.Insert(shape3, lite::ResizePlan());
+  ASSERT_EQ(cache.size(), 2);
+  ASSERT_EQ(cache.Find(shape2), nullptr);
+  ASSERT_NE(cache.Find(shape1), nullptr);
+  ASSERT_NE(cache.Find(shape3), nullptr);
+  ASSERT_EQ(cache.hit_count(), 3);
+  ASSERT_EQ(cache.miss_count(), 2);
+
+  cache.Clear();
+  ASSERT_EQ(cache.size(), 0);
+  ASSERT_EQ(cache.Find(shape1), nullptr);
+}
+
+TEST_F(ResizePlanCacheTest, SessionResizeWithPlan) {
+  auto model = BuildAddModel();
+  ASSERT_NE(model, nullptr);
+  auto context = std::make_shared<lite::InnerContext>();
+  context->thread_num_ = 1;
+  ASSERT_EQ(lite::RET_OK, context->Init());
+  std::map<std::string, std::map<std::string, std::string>> config_info = {
+    {lite::kResizePlanCacheSection, {{lite::kResizePlanCacheSizeKey, "4"}}}};
+  auto session = std::shared_ptr<lite::LiteSession>(lite::LiteSession::CreateSession(context));
+  ASSERT_NE(session, nullptr);
+  session->SetConfigInfo(&config_info);
+  ASSERT_EQ(session->CompileGraph(model), lite::RET_OK);
+  auto cache = session->get_resize_plan_cache();
+  ASSERT_NE(cache, nullptr);
+  ASSERT_EQ(cache->size(), 1);
+  auto compiled_allocator = session->runtime_allocator_;
+  RunAndCheck(session.get(), {1, kChannel}, {1, kChannel});
+
+  auto inputs = session->GetInputs();
+  auto x = inputs[0];
+  auto y = inputs[1];
+  // Resizing only x is keyed by the shapes of all the inputs.
+  ASSERT_EQ(session->Resize({x}, {{2, kChannel}}), lite::RET_OK);
+  ASSERT_EQ(cache->miss_count(), 1);
+  auto resized_allocator = session->runtime_allocator_;
+  RunAndCheck(session.get(), {2, kChannel}, {1, kChannel});
+
+  // Resizing back to the compiled shapes restores the shapes and attaches the allocator of the plan.
+  ASSERT_EQ(session->Resize({x, y}, {{1, kChannel}, {1, kChannel}}), lite::RET_OK);
+  ASSERT_EQ(cache->hit_count(), 1);
+  ASSERT_EQ(session->runtime_allocator_, compiled_allocator);
+  if (compiled_allocator != nullptr) {
+    ASSERT_NE(compiled_allocator, resized_allocator);
+  }
+  RunAndCheck(session.get(), {1, kChannel}, {1, kChannel});
+
+  ASSERT_EQ(session->Resize({x}, {{2, kChannel}}), lite::RET_OK);
+  ASSERT_EQ(cache->hit_count(), 2);
+  ASSERT_EQ(session->runtime_allocator_, resized_allocator);
+  RunAndCheck(session.get(), {2, kChannel}, {1, kChannel});
+
+  // The same dims of the other input are a different plan.
+  ASSERT_EQ(session->Resize({y}, {{2, kChannel}}), lite::RET_OK);
+  ASSERT_EQ(cache->hit_count(), 2);
+  ASSERT_EQ(cache->miss_count(), 2);
+  ASSERT_EQ(cache->size(), 3);
+  RunAndCheck(session.get(), {2, kChannel}, {2, kChannel});
+  session = nullptr;
+  delete model;
+}
+}  // namespace mindspore
@@ -13,19 +13,27 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
+#include <cmath>
 #include "common/common_test.h"
+#include "src/common/utils.h"
 #include "src/litert/kernel_exec.h"
 #include "src/litert/kernel_registry.h"
 #include "src/litert/runtime_pass.h"
+#include "src/litert/infer_manager.h"
 #include "nnacl/conv_parameter.h"
 #include "nnacl/instance_norm_parameter.h"
 #include "nnacl/fp32/activation_fp32.h"
 #include "nnacl/transpose.h"
+#include "nnacl/arithmetic.h"
+#include "nnacl/fp32/add_fp32.h"
+#include "nnacl/fp32/mul_fp32.h"
 
 namespace mindspore {
 namespace lite {
 extern void Nc4hw4PassAct(std::vector<kernel::KernelExec *> *kernels, std::vector<Tensor *> *tensors, int i);
 extern void ConvNormC4PassAct(std::vector<kernel::KernelExec *> *kernels);
+extern bool ElementwiseFusionPassAct(std::vector<kernel::KernelExec *> *kernels, std::vector<Tensor *> *tensors);
 }  // namespace lite
 
 class RuntimePass : public mindspore::CommonTest {
@@ -289,4 +297,263 @@ TEST_F(RuntimePass, ConvNormC4Pass1) {
     kernel = nullptr;
   }
 }
+kernel::KernelExec *ElementwiseFusionConstructKernel(const std::vector<lite::Tensor *> &in_tensors,
+                                                     lite::Tensor *out_tensor, OpParameter *param,
+                                                     lite::InnerContext *ctx) {
+  kernel::KernelKey desc{kernel::kCPU, kNumberTypeFloat32, NHWC, param->type_};
+  kernel::KernelExec *kernel = nullptr;
+  lite::KernelRegistry::GetInstance()->GetKernelExec(in_tensors, {out_tensor}, ctx, nullptr, desc, param, &kernel,
+                                                      nullptr);
+  return kernel;
+}
+
+/* ADD(bias) -- ACT(relu) -- MUL(scale) */
+void ElementwiseFusionPassConstruct(std::vector<kernel::KernelExec *> *kernels, std::vector<lite::Tensor *> *tensors,
+                                    const std::vector<int> &shape, const std::vector<int> &bias_shape,
+                                    lite::InnerContext *ctx) {
+  auto in_tensor = new lite::Tensor(kNumberTypeFloat32, shape, NHWC, lite::Category::GRAPH_INPUT);
+  auto bias_tensor = new lite::Tensor(kNumberTypeFloat32, bias_shape, NHWC, lite::Category::CONST_TENSOR);
+  auto add_out_tensor = new lite::Tensor(kNumberTypeFloat32, shape, NHWC);
+  auto act_out_tensor = new lite::Tensor(kNumberTypeFloat32, shape, NHWC);
+  auto scale_tensor = new lite::Tensor(kNumberTypeFloat32, {1}, NHWC, lite::Category::CONST_SCALAR);
+  auto mul_out_tensor = new lite::Tensor(kNumberTypeFloat32, shape, NHWC, lite::Category::GRAPH_OUTPUT);
+  *tensors = {in_tensor, bias_tensor, add_out_tensor, act_out_tensor, scale_tensor, mul_out_tensor};
+
+  auto *add_param = reinterpret_cast<ArithmeticParameter *>(malloc(sizeof(ArithmeticParameter)));
+  ASSERT_NE(add_param, nullptr);
+  memset(add_param, 0, sizeof(ArithmeticParameter));
+  add_param->op_parameter_.type_ = schema::PrimitiveType_AddFusion;
+  auto add_kernel = ElementwiseFusionConstructKernel({in_tensor, bias_tensor}, add_out_tensor,
+                                                     reinterpret_cast<OpParameter *>(add_param), ctx);
+  ASSERT_NE(add_kernel, nullptr);
+  kernels->push_back(add_kernel);
+
+  auto *act_param = reinterpret_cast<ActivationParameter *>(malloc(sizeof(ActivationParameter)));
+  ASSERT_NE(act_param, nullptr);
+  memset(act_param, 0, sizeof(ActivationParameter));
+  act_param->op_parameter_.type_ = schema::PrimitiveType_Activation;
+  act_param->type_ = schema::ActivationType_RELU;
+  auto act_kernel = ElementwiseFusionConstructKernel({add_out_tensor}, act_out_tensor,
+                                                     reinterpret_cast<OpParameter *>(act_param), ctx);
+  ASSERT_NE(act_kernel, nullptr);
+  kernels->push_back(act_kernel);
+
+  auto *mul_param = reinterpret_cast<ArithmeticParameter *>(malloc(sizeof(ArithmeticParameter)));
+  ASSERT_NE(mul_param, nullptr);
+  memset(mul_param, 0, sizeof(ArithmeticParameter));
+  mul_param->op_parameter_.type_ = schema::PrimitiveType_MulFusion;
+  auto mul_kernel = ElementwiseFusionConstructKernel({act_out_tensor, scale_tensor}, mul_out_tensor,
+                                                     reinterpret_cast<OpParameter *>(mul_param), ctx);
+  ASSERT_NE(mul_kernel, nullptr);
+  kernels->push_back(mul_kernel);
+
+  add_kernel->set_out_kernels({act_kernel});
+  act_kernel->set_in_kernels({add_kernel});
+  act_kernel->set_out_kernels({mul_kernel});
+  mul_kernel->set_in_kernels({act_kernel});
+  return;
+}
+
+TEST_F(RuntimePass, ElementwiseFusionPass1) {
+  auto ctx = std::make_shared<lite::InnerContext>();
+  ctx->thread_num_ = 1;
+  ASSERT_EQ(lite::RET_OK, ctx->Init());
+  std::vector<kernel::KernelExec *> kernels;
+  std::vector<lite::Tensor *> tensors;
+  const std::vector<int> shape = {1, 64, 64, 64};
+  ElementwiseFusionPassConstruct(&kernels, &tensors, shape, {shape.back()}, ctx.get());
+  ASSERT_EQ(kernels.size(), 3);
+  auto in_tensor = tensors[0];
+  auto bias_tensor = tensors[1];
+  auto scale_tensor = tensors[4];
+  auto out_tensor = tensors[5];
+
+  /* runtime pass */
+  ASSERT_TRUE(lite::ElementwiseFusionPassAct(&kernels, &tensors));
+
+  ASSERT_EQ(kernels.size(), 1);
+  ASSERT_EQ(kernels[0]->type(), PrimType_Inner_ElementwiseFusion);
+  ASSERT_EQ(kernels[0]->in_tensors().size(), 3);
+  ASSERT_EQ(kernels[0]->out_tensors().front(), out_tensor);
+  ASSERT_EQ(std::count(tensors.begin(), tensors.end(), nullptr), 2); /* add_out, act_out */
+
+  ASSERT_EQ(in_tensor->MallocData(), lite::RET_OK);
+  ASSERT_EQ(bias_tensor->MallocData(), lite::RET_OK);
+  ASSERT_EQ(scale_tensor->MallocData(), lite::RET_OK);
+  ASSERT_EQ(out_tensor->MallocData(), lite::RET_OK);
+  auto element_num = in_tensor->ElementsNum();
+  auto channel = shape.back();
+  auto in_data = reinterpret_cast<float *>(in_tensor->data());
+  auto bias_data = reinterpret_cast<float *>(bias_tensor->data());
+  auto scale_data = reinterpret_cast<float *>(scale_tensor->data());
+  for (int i = 0; i < element_num; i++) {
+    in_data[i] = static_cast<float>(i % 17) - 8.0f;
+  }
+  for (int i = 0; i < channel; i++) {
+    bias_data[i] = static_cast<float>(i % 5) - 2.0f;
+  }
+  scale_data[0] = 0.5f;
+
+  /* the ops run one by one over the whole tensor */
+  std::vector<float> expect(element_num);
+  ArithmeticParameter scale_param = {};
+  scale_param.in_elements_num0_ = element_num;
+  scale_param.in_elements_num1_ = 1;
+  auto run_unfused = [&]() {
+    for (int i = 0; i < element_num; i += channel) {
+      ElementAdd(in_data + i, bias_data, expect.data() + i, channel);
+    }
+    Fp32Relu(expect.data(), element_num, expect.data());
+    ElementOptMul(expect.data(), scale_data, expect.data(), element_num, &scale_param);
+  };
+  run_unfused();
+
+  auto fusion_kernel = std::static_pointer_cast<kernel::LiteKernel>(kernels[0]->kernel());
+  ASSERT_EQ(kernels[0]->Prepare(), lite::RET_OK);
+  ASSERT_EQ(fusion_kernel->Run(), lite::RET_OK);
+  auto out_data = reinterpret_cast<float *>(out_tensor->data());
+  for (int i = 0; i < element_num; i++) {
+    ASSERT_EQ(out_data[i], expect[i]);
+  }
+
+  constexpr int kLoopCount = 100;
+  auto time_start = lite::GetTimeUs();
+  for (int i = 0; i < kLoopCount; i++) {
+    run_unfused();
+  }
+  auto time_mid = lite::GetTimeUs();
+  for (int i = 0; i < kLoopCount; i++) {
+    fusion_kernel->Run();
+  }
+  auto time_end = lite::GetTimeUs();
+  printf("Elementwise ops one by one average time : %f us, fused average time : %f us\n",
+         static_cast<float>(time_mid - time_start) / kLoopCount, static_cast<float>(time_end - time_mid) / kLoopCount);
+
+  for (auto tensor : tensors) {
+    delete tensor;
+    tensor = nullptr;
+  }
+  for (auto kernel : kernels) {
+    delete kernel;
+    kernel = nullptr;
+  }
+}
+
+TEST_F(RuntimePass, ElementwiseFusionPass2) {
+  auto ctx = std::make_shared<lite::InnerContext>();
+  ctx->thread_num_ = 1;
+  ASSERT_EQ(lite::RET_OK, ctx->Init());
+  std::vector<kernel::KernelExec *> kernels;
+  std::vector<lite::Tensor *> tensors;
+  /* the bias of the same shape, whose element num is also the size of the last axis */
+  const std::vector<int> shape = {1, 4096};
+  ElementwiseFusionPassConstruct(&kernels, &tensors, shape, shape, ctx.get());
+  ASSERT_EQ(kernels.size(), 3);
+  auto in_tensor = tensors[0];
+  auto bias_tensor = tensors[1];
+  auto scale_tensor = tensors[4];
+  auto out_tensor = tensors[5];
+
+  /* runtime pass */
+  ASSERT_TRUE(lite::ElementwiseFusionPassAct(&kernels, &tensors));
+  ASSERT_EQ(kernels.size(), 1);
+  ASSERT_EQ(kernels[0]->type(), PrimType_Inner_ElementwiseFusion);
+
+  ASSERT_EQ(in_tensor->MallocData(), lite::RET_OK);
+  ASSERT_EQ(bias_tensor->MallocData(), lite::RET_OK);
+  ASSERT_EQ(scale_tensor->MallocData(), lite::RET_OK);
+  ASSERT_EQ(out_tensor->MallocData(), lite::RET_OK);
+  auto element_num = in_tensor->ElementsNum();
+  auto in_data = reinterpret_cast<float *>(in_tensor->data());
+  auto bias_data = reinterpret_cast<float *>(bias_tensor->data());
+  auto scale_data = reinterpret_cast<float *>(scale_tensor->data());
+  for (int i = 0; i < element_num; i++) {
+    in_data[i] = static_cast<float>(i % 17) - 8.0f;
+    bias_data[i] = static_cast<float>(i % 5) - 2.0f;
+  }
+  scale_data[0] = 0.5f;
+
+  auto fusion_kernel = std::static_pointer_cast<kernel::LiteKernel>(kernels[0]->kernel());
+  ASSERT_EQ(kernels[0]->Prepare(), lite::RET_OK);
+  ASSERT_EQ(fusion_kernel->Run(), lite::RET_OK);
+  auto out_data = reinterpret_cast<float *>(out_tensor->data());
+  for (int i = 0; i < element_num; i++) {
+    auto expect = std::max(in_data[i] + bias_data[i], 0.0f) * scale_data[0];
+    ASSERT_EQ(out_data[i], expect);
+  }
+
+  for (auto tensor : tensors) {
+    delete tensor;
+    tensor = nullptr;
+  }
+  for (auto kernel : kernels) {
+    delete kernel;
+    kernel = nullptr;
+  }
+}
+
+TEST_F(RuntimePass, ElementwiseFusionPassResize) {
+  auto ctx = std::make_shared<lite::InnerContext>();
+  ctx->thread_num_ = 1;
+  ASSERT_EQ(lite::RET_OK, ctx->Init());
+  std::vector<kernel::KernelExec *> kernels;
+  std::vector<lite::Tensor *> tensors;
+  /* the [N, 1] bias is fused as a tensor of the same shape, then the input is resized to [N, C] with N == C */
+  constexpr int kDim = 64;
+  const std::vector<int> shape = {kDim, 1};
+  ElementwiseFusionPassConstruct(&kernels, &tensors, shape, shape, ctx.get());
+  ASSERT_EQ(kernels.size(), 3);
+  auto in_tensor = tensors[0];
+  auto bias_tensor = tensors[1];
+  auto scale_tensor = tensors[4];
+  auto out_tensor = tensors[5];
+
+  /* runtime pass */
+  ASSERT_TRUE(lite::ElementwiseFusionPassAct(&kernels, &tensors));
+  ASSERT_EQ(kernels.size(), 1);
+  ASSERT_EQ(kernels[0]->type(), PrimType_Inner_ElementwiseFusion);
+  ASSERT_EQ(kernels[0]->Prepare(), lite::RET_OK);
+
+  /* resize */
+  in_tensor->set_shape({kDim, kDim});
+  ASSERT_EQ(lite::KernelInferShape(kernels[0]->in_tensors(), kernels[0]->out_tensors(), kernels[0]->op_parameter()),
+            lite::RET_OK);
+  ASSERT_EQ(out_tensor->shape(), std::vector<int>({kDim, kDim}));
+  ASSERT_EQ(kernels[0]->ReSize(), lite::RET_OK);
+
+  ASSERT_EQ(in_tensor->MallocData(), lite::RET_OK);
+  ASSERT_EQ(bias_tensor->MallocData(), lite::RET_OK);
+  ASSERT_EQ(scale_tensor->MallocData(), lite::RET_OK);
+  ASSERT_EQ(out_tensor->MallocData(), lite::RET_OK);
+  auto in_data = reinterpret_cast<float *>(in_tensor->data());
+  auto bias_data = reinterpret_cast<float *>(bias_tensor->data());
+  auto scale_data = reinterpret_cast<float *>(scale_tensor->data());
+  for (int i = 0; i < kDim * kDim; i++) {
+    in_data[i] = static_cast<float>(i % 17) - 8.0f;
+  }
+  for (int i = 0; i < kDim; i++) {
+    bias_data[i] = static_cast<float>(i % 5) - 2.0f;
+  }
+  scale_data[0] = 0.5f;
+
+  auto fusion_kernel = std::static_pointer_cast<kernel::LiteKernel>(kernels[0]->kernel());
+  ASSERT_EQ(fusion_kernel->Run(), lite::RET_OK);
+  auto out_data = reinterpret_cast<float *>(out_tensor->data());
+  /* the bias broadcasts along the last axis, as the unfused add does */
+  for (int n = 0; n < kDim; n++) {
+    for (int c = 0; c < kDim; c++) {
+      auto expect = std::max(in_data[n * kDim + c] + bias_data[n], 0.0f) * scale_data[0];
+      ASSERT_EQ(out_data[n * kDim + c], expect);
+    }
+  }
+
+  for (auto tensor : tensors) {
+    delete tensor;
+    tensor = nullptr;
+  }
+  for (auto kernel : kernels) {
+    delete kernel;
+    kernel = nullptr;
+  }
+}
 }  // namespace mindspore
@@ -0,0 +1,215 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "ir/func_graph.h"
+#include "ir/tensor.h"
+#include "schema/inner/model_generated.h"
+#include "src/common/helper/infer_helpers.h"
+#define private public
+#include "src/extendrt/shared_weight_store.h"
+#include "src/litert/lite_session.h"
+#undef private
+
+namespace mindspore {
+namespace {
+constexpr size_t kWeightNum = 3;
+constexpr int64_t kWeightSize = 1024;
+
+FuncGraphPtr BuildWeightGraph(float value) {
+  auto func_graph = std::make_shared<FuncGraph>();
+  for (size_t i = 0; i < kWeightNum; i++) {
+    auto parameter = func_graph->add_parameter();
+    parameter->set_name("weight_" + std::to_string(i));
+    auto tensor = std::make_shared<tensor::Tensor>(kNumberTypeFloat32, ShapeVector{kWeightSize});
+    auto data = static_cast<float *>(tensor->data_c());
+    for (int64_t j = 0; j < kWeightSize; j++) {
+      data[j] = value + static_cast<float>(i);
+    }
+    parameter->set_default_param(tensor);
+  }
+  return func_graph;
+}
+
+tensor::TensorPtr GetWeight(const FuncGraphPtr &func_graph, size_t index) {
+  auto parameter = func_graph->parameters()[index]->cast<ParameterPtr>();
+  return parameter->default_param()->cast<tensor::TensorPtr>();
+}
+
+SharedWeightTensorData *GetSharedData(const FuncGraphPtr &func_graph, size_t index) {
+  return dynamic_cast<SharedWeightTensorData *>(GetWeight(func_graph, index)->data_ptr().get());
+}
+
+std::unique_ptr<schema::TensorT> BuildTensor(const std::string &name, int node_type) {
+  auto tensor = std::make_unique<schema::TensorT>();
+  tensor->name = name;
+  tensor->nodeType = node_type;
+  tensor->format = schema::Format_NHWC;
+  tensor->dataType = kNumberTypeFloat32;
+  tensor->dims = {kWeightSize};
+  tensor->offset = -1;
+  return tensor;
+}
+
+/* ADD(input, weight_0), the meta graph converted from the func graph by the LiteRT executor */
+std::unique_ptr<schema::MetaGraphT> BuildMetaGraph(const FuncGraphPtr &func_graph) {
+  auto meta_graph = std::make_unique<schema::MetaGraphT>();
+  meta_graph->name = "graph";
+  meta_graph->allTensors.emplace_back(BuildTensor("input", lite::NodeType_Parameter));
+  auto weight = BuildTensor("weight_0", lite::NodeType_ValueNode);
+  auto weight_tensor = GetWeight(func_graph, 0);
+  auto weight_data = static_cast<const uint8_t *>(weight_tensor->data().const_data());
+  weight->data.assign(weight_data, weight_data + weight_tensor->data().nbytes());
+  meta_graph->allTensors.emplace_back(std::move(weight));
+  meta_graph->allTensors.emplace_back(BuildTensor("output", lite::NodeType_Parameter));
+  auto node = std::make_unique<schema::CNodeT>();
+  node->name = "Add";
+  node->inputIndex = {0, 1};
+  node->outputIndex = {2};
+  node->primitive = std::make_unique<schema::PrimitiveT>();
+  node->primitive->value.type = schema::PrimitiveType_AddFusion;
+  node->primitive->value.value = new schema::AddFusionT;
+  meta_graph->nodes.emplace_back(std::move(node));
+  meta_graph->inputIndex = {0};
+  meta_graph->outputIndex = {2};
+  return meta_graph;
+}
+
+std::vector<char> PackMetaGraph(const schema::MetaGraphT &meta_graph) {
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto offset = schema::MetaGraph::Pack(builder, &meta_graph);
+  builder.Finish(offset);
+  auto content = reinterpret_cast<char *>(builder.GetBufferPointer());
+  return std::vector<char>(content, content + builder.GetSize());
+}
+}  // namespace
+
+class SharedWeightStoreTest : public mindspore::CommonTest {
+ public:
+  SharedWeightStoreTest() = default;
+};
+
+TEST_F(SharedWeightStoreTest, ShareAndRelease) {
+  const std::string model_buf = "shared_weight_model";
+  auto model_key = SharedWeightStore::GenModelKey(model_buf.data(), model_buf.size(), "");
+  ASSERT_FALSE(model_key.empty());
+  auto store = SharedWeightStore::GetInstance();
+  auto func_graph1 = BuildWeightGraph(1.0f);
+  auto func_graph2 = BuildWeightGraph(1.0f);
+  ASSERT_EQ(store->ShareWeights(func_graph1, model_key), kSuccess);
+  ASSERT_EQ(store->ShareWeights(func_graph2, model_key), kSuccess);
+
+  // The weights of the two models are backed by one shared weight file.
+  ASSERT_EQ(store->files_.count(model_key), 1);
+  std::weak_ptr<SharedWeightFile> file = store->files_[model_key];
+  ASSERT_NE(file.lock(), nullptr);
+  for (size_t i = 0; i < kWeightNum; i++) {
+    auto shared_data1 = GetSharedData(func_graph1, i);
+    auto shared_data2 = GetSharedData(func_graph2, i);
+    ASSERT_NE(shared_data1, nullptr);
+    ASSERT_NE(shared_data2, nullptr);
+    ASSERT_EQ(shared_data1->view_->file_, file.lock());
+    ASSERT_EQ(shared_data2->view_->file_, file.lock());
+    ASSERT_EQ(static_cast<float *>(shared_data1->data())[kWeightSize - 1], 1.0f + static_cast<float>(i));
+    ASSERT_EQ(static_cast<float *>(shared_data2->data())[kWeightSize - 1], 1.0f + static_cast<float>(i));
+  }
+  // The weight written by one model is copied on write and the other model keeps the shared one.
+  static_cast<float *>(GetWeight(func_graph1, 0)->data_c())[0] = -1.0f;
+  ASSERT_EQ(static_cast<float *>(GetWeight(func_graph2, 0)->data_c())[0], 1.0f);
+
+  // The file is released with the last model using it.
+  func_graph1 = nullptr;
+  ASSERT_NE(file.lock(), nullptr);
+  func_graph2 = nullptr;
+  ASSERT_EQ(file.lock(), nullptr);
+
+  // The next model of the same key creates a new file.
+  auto func_graph3 = BuildWeightGraph(1.0f);
+  ASSERT_EQ(store->ShareWeights(func_graph3, model_key), kSuccess);
+  auto shared_data3 = GetSharedData(func_graph3, 0);
+  ASSERT_NE(shared_data3, nullptr);
+  ASSERT_EQ(static_cast<float *>(shared_data3->data())[0], 1.0f);
+}
+
+TEST_F(SharedWeightStoreTest, DifferentWeightKeepPrivate) {
+  const std::string model_buf = "private_weight_model";
+  auto model_key = SharedWeightStore::GenModelKey(model_buf.data(), model_buf.size(), "");
+  auto store = SharedWeightStore::GetInstance();
+  auto func_graph1 = BuildWeightGraph(1.0f);
+  auto func_graph2 = BuildWeightGraph(2.0f);
+  ASSERT_EQ(store->ShareWeights(func_graph1, model_key), kSuccess);
+  ASSERT_EQ(store->ShareWeights(func_graph2, model_key), kSuccess);
+  for (size_t i = 0; i < kWeightNum; i++) {
+    ASSERT_NE(GetSharedData(func_graph1, i), nullptr);
+    ASSERT_EQ(GetSharedData(func_graph2, i), nullptr);
+    ASSERT_EQ(static_cast<float *>(GetWeight(func_graph2, i)->data_c())[0], 2.0f + static_cast<float>(i));
+  }
+}
+
+#ifdef ENABLE_LITE_HELPER
+TEST_F(SharedWeightStoreTest, LiteSessionReferenceSharedWeights) {
+  const std::string model_buf = "litert_shared_weight_model";
+  auto model_key = SharedWeightStore::GenModelKey(model_buf.data(), model_buf.size(), "");
+  auto store = SharedWeightStore::GetInstance();
+  std::vector<FuncGraphPtr> func_graphs;
+  std::vector<std::shared_ptr<infer::helper::InferHelpers>> helpers_list;
+  std::vector<std::shared_ptr<lite::LiteSession>> sessions;
+  for (size_t i = 0; i < 2; i++) {
+    auto func_graph = BuildWeightGraph(1.0f);
+    ASSERT_EQ(store->ShareWeights(func_graph, model_key), kSuccess);
+    // The meta graph references the shared weight instead of serializing it, as done by the LiteRT executor.
+    auto meta_graph = BuildMetaGraph(func_graph);
+    auto tensor_helper = new SharedWeightTensorHelper();
+    auto helpers = std::make_shared<infer::helper::InferHelpers>(tensor_helper);
+    ASSERT_EQ(SharedWeightStore::ReferenceSharedWeights(func_graph, meta_graph.get(), tensor_helper),
+              kWeightSize * sizeof(float));
+    ASSERT_TRUE(meta_graph->allTensors[1]->data.empty());
+    auto fb_model_buf = PackMetaGraph(*meta_graph);
+
+    auto context = std::make_shared<lite::InnerContext>();
+    context->thread_num_ = 1;
+    ASSERT_EQ(context->Init(), lite::RET_OK);
+    auto session = std::make_shared<lite::LiteSession>();
+    session->SetKeepModelBuf(true);
+    ASSERT_EQ(session->Init(context), lite::RET_OK);
+    ASSERT_EQ(session->LoadModelAndCompileByBuf(fb_model_buf.data(), mindspore::ModelType::kMindIR_Lite,
+                                                fb_model_buf.size(), helpers.get()),
+              lite::RET_OK);
+    // The weight of the session is the shared one of the func graph, not a copy.
+    auto weight_iter = std::find_if(session->tensors_.begin(), session->tensors_.end(),
+                                    [](lite::Tensor *tensor) { return tensor->tensor_name() == "weight_0"; });
+    ASSERT_NE(weight_iter, session->tensors_.end());
+    ASSERT_EQ((*weight_iter)->data(), GetSharedData(func_graph, 0)->data());
+
+    auto input = session->GetInputs().front();
+    auto input_data = static_cast<float *>(input->MutableData());
+    std::fill(input_data, input_data + kWeightSize, 1.0f);
+    ASSERT_EQ(session->RunGraph(), lite::RET_OK);
+    auto output = session->GetOutputs().begin()->second;
+    ASSERT_EQ(static_cast<float *>(output->data())[kWeightSize - 1], 2.0f);
+    // The helpers keep the shared weights alive as long as the session, as the executor does.
+    func_graphs.push_back(func_graph);
+    helpers_list.push_back(helpers);
+    sessions.push_back(session);
+  }
+  // The weights of the two sessions are the pages of one shared weight file.
+  ASSERT_EQ(GetSharedData(func_graphs[0], 0)->view_->file_, GetSharedData(func_graphs[1], 0)->view_->file_);
+}
+#endif
+}  // namespace mindspore
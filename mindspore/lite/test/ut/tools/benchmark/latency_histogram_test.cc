@@ -0,0 +1,122 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "common/common_test.h"
+#include "tools/benchmark/latency_histogram.h"
+
+namespace mindspore {
+namespace lite {
+namespace {
+constexpr int kSubBucketBits = 7;
+constexpr uint64_t kExactValueNum = 1ULL << kSubBucketBits;
+
+// The value at the percentile of the sorted values, by the nearest rank.
+uint64_t ExpectPercentile(const std::vector<uint64_t> &sorted_values, double percentile) {
+  auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sorted_values.size()));
+  rank = rank == 0 ? 1 : rank;
+  return sorted_values[rank - 1];
+}
+}  // namespace
+
+class LatencyHistogramTest : public mindspore::CommonTest {
+ public:
+  LatencyHistogramTest() = default;
+};
+
+TEST_F(LatencyHistogramTest, EmptyHistogram) {
+  LatencyHistogram histogram(kSubBucketBits);
+  ASSERT_EQ(histogram.count(), 0);
+  ASSERT_EQ(histogram.min(), 0);
+  ASSERT_EQ(histogram.max(), 0);
+  ASSERT_EQ(histogram.mean(), 0);
+  ASSERT_EQ(histogram.Percentile(50), 0);
+}
+
+TEST_F(LatencyHistogramTest, ExactSmallValues) {
+  // The values less than 2^sub_bucket_bits are counted exactly.
+  LatencyHistogram histogram(kSubBucketBits);
+  for (uint64_t value = 100; value >= 1; value--) {
+    histogram.Record(value);
+  }
+  ASSERT_EQ(histogram.count(), 100);
+  ASSERT_EQ(histogram.min(), 1);
+  ASSERT_EQ(histogram.max(), 100);
+  ASSERT_DOUBLE_EQ(histogram.mean(), 50.5);
+  ASSERT_EQ(histogram.Percentile(50), 50);
+  ASSERT_EQ(histogram.Percentile(90), 90);
+  ASSERT_EQ(histogram.Percentile(99), 99);
+  ASSERT_EQ(histogram.Percentile(99.9), 100);
+  ASSERT_EQ(histogram.Percentile(100), 100);
+  // The percentile is clamped to (0, 100].
+  ASSERT_EQ(histogram.Percentile(0), 1);
+  ASSERT_EQ(histogram.Percentile(200), 100);
+}
+
+TEST_F(LatencyHistogramTest, BoundedRelativeError) {
+  // The latencies from 1us to 1s, denser in the low values like the real latencies.
+  std::vector<uint64_t> values;
+  for (uint64_t value = 1; value <= 1000000; value = value * 11 / 10 + 1) {
+    for (uint64_t i = 0; i < 3; i++) {
+      values.push_back(value + i);
+    }
+  }
+  std::sort(values.begin(), values.end());
+  LatencyHistogram histogram(kSubBucketBits);
+  for (auto iter = values.rbegin(); iter != values.rend(); ++iter) {
+    histogram.Record(*iter);
+  }
+  ASSERT_EQ(histogram.count(), values.size());
+  ASSERT_EQ(histogram.min(), values.front());
+  ASSERT_EQ(histogram.max(), values.back());
+  for (auto percentile : {1.0, 10.0, 25.0, 50.0, 75.0, 90.0, 99.0, 99.9, 100.0}) {
+    auto expect = ExpectPercentile(values, percentile);
+    auto result = histogram.Percentile(percentile);
+    // The highest value equivalent to the expected one, within 2^-sub_bucket_bits of it.
+    ASSERT_GE(result, expect);
+    ASSERT_LE(result - expect, expect < kExactValueNum ? 0 : expect / kExactValueNum);
+    ASSERT_LE(result, histogram.max());
+  }
+}
+
+TEST_F(LatencyHistogramTest, MergeHistograms) {
+  LatencyHistogram merged(kSubBucketBits);
+  LatencyHistogram low(kSubBucketBits);
+  LatencyHistogram high(kSubBucketBits);
+  for (uint64_t value = 1; value <= 1000; value++) {
+    merged.Record(value);
+    (value <= 500 ? low : high).Record(value);
+  }
+  LatencyHistogram result(kSubBucketBits);
+  result.Merge(low);
+  result.Merge(high);
+  ASSERT_EQ(result.count(), merged.count());
+  ASSERT_EQ(result.min(), 1);
+  ASSERT_EQ(result.max(), 1000);
+  ASSERT_DOUBLE_EQ(result.mean(), merged.mean());
+  for (auto percentile : {50.0, 90.0, 99.0, 99.9, 100.0}) {
+    ASSERT_EQ(result.Percentile(percentile), merged.Percentile(percentile));
+  }
+  // The histogram of the different precision is not merged.
+  LatencyHistogram other(kSubBucketBits + 1);
+  other.Record(1);
+  result.Merge(other);
+  ASSERT_EQ(result.count(), merged.count());
+}
+}  // namespace lite
+}  // namespace mindspore
@@ -0,0 +1,180 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_test.h"
+#include "tools/converter/config_parser/quant_param_parser.h"
+#include "tools/converter/quantizer/calibrator.h"
+#include "ir/func_graph.h"
+#include "abstract/abstract_value.h"
+#include "ops/fusion/add_fusion.h"
+#include "include/api/types.h"
+#include "include/errorcode.h"
+
+namespace mindspore {
+namespace lite {
+namespace {
+constexpr size_t kBatchNum = 13;
+constexpr int64_t kElementNum = 64;
+constexpr size_t kBitNum = 8;
+constexpr int kQuantMax = 127;
+constexpr int kQuantMin = -128;
+
+struct CalibrateResult {
+  double scale;
+  int32_t zero_point;
+  float real_min;
+  float real_max;
+};
+}  // namespace
+
+class FullQuantQuantizerTest : public mindspore::CommonTest {
+ public:
+  FullQuantQuantizerTest() = default;
+
+  void SetUp() override {
+    // Every batch has its own range, so the min and the max come from different batches.
+    std::mt19937 generator(0);
+    for (size_t i = 0; i < kBatchNum; i++) {
+      std::uniform_real_distribution<float> distribution(-1.0f - i * 0.37f, 1.0f + (kBatchNum - i) * 0.21f);
+      std::vector<float> data(kElementNum);
+      for (auto &value : data) {
+        value = distribution(generator);
+      }
+      batches_.push_back(data);
+    }
+    auto graph = std::make_shared<FuncGraph>();
+    auto prim = std::make_shared<ops::AddFusion>();
+    auto x = graph->add_parameter();
+    auto y = graph->add_parameter();
+    cnode_ = graph->NewCNode({NewValueNode(prim->GetPrim()), x, y});
+    cnode_->set_fullname_with_scope("add");
+    cnode_->set_abstract(std::make_shared<abstract::AbstractTensor>(kFloat32, ShapeVector{kElementNum}));
+  }
+
+  // Collects the batches the same way FullQuantQuantizer::DoInference does, each calibration thread takes the
+  // batches begin, begin + thread_num, ... and all the threads record into the same distributions.
+  std::vector<CalibrateResult> Calibrate(size_t thread_num) {
+    preprocess::DataPreProcessParam pre_process_param;
+    pre_process_param.calibrate_size = kBatchNum;
+    quant::Calibrator calibrator(kBitNum, kQuantMax, kQuantMin, quant::MAX_MIN, pre_process_param, true);
+    EXPECT_EQ(calibrator.AddQuantizedOp(cnode_), RET_OK);
+
+    std::vector<int> rets(thread_num, RET_OK);
+    auto run = [this, &calibrator, &rets, thread_num](size_t begin) {
+      for (size_t i = begin; i < calibrator.GetBatchNum(); i += thread_num) {
+        auto &data = batches_[i];
+        auto &other = batches_[kBatchNum - 1 - i];
+        std::vector<mindspore::MSTensor> inputs = {
+          mindspore::MSTensor("x", DataType::kNumberTypeFloat32, {kElementNum}, data.data(),
+                              data.size() * sizeof(float)),
+          mindspore::MSTensor("y", DataType::kNumberTypeFloat32, {kElementNum}, other.data(),
+                              other.size() * sizeof(float))};
+        std::vector<mindspore::MSTensor> outputs = {inputs[0]};
+        if (calibrator.CollectDataDistribution("add", inputs, calibrator.GetInputDivergInfo(), quant::MIN_MAX) !=
+              RET_OK ||
+            calibrator.CollectDataDistribution("add", outputs, calibrator.GetOutputDivergInfo(), quant::MIN_MAX) !=
+              RET_OK) {
+          rets[begin] = RET_ERROR;
+          return;
+        }
+      }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_num; i++) {
+      threads.emplace_back(run, i);
+    }
+    run(0);
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    for (auto ret : rets) {
+      EXPECT_EQ(ret, RET_OK);
+    }
+
+    std::vector<CalibrateResult> results;
+    for (auto *diverg_info_map : {calibrator.GetInputDivergInfo(), calibrator.GetOutputDivergInfo()}) {
+      for (auto &iter : (*diverg_info_map)["add"]) {
+        auto &info = iter.second;
+        auto scale = info->GetScale();
+        results.push_back({scale, info->GetZeroPoint(), info->GetRealMin(), info->GetRealMax()});
+      }
+    }
+    return results;
+  }
+
+ protected:
+  std::vector<std::vector<float>> batches_;
+  CNodePtr cnode_;
+};
+
+TEST_F(FullQuantQuantizerTest, ParseCalibrateThreadNum) {
+  FullQuantString full_quant_string;
+  quant::FullQuantParam full_quant;
+  ASSERT_EQ(QuantParamParser::ParseFullQuant(full_quant_string, &full_quant), RET_OK);
+  ASSERT_EQ(full_quant.calibrate_thread_num, 1);
+
+  for (auto thread_num : {"1", "4", "64"}) {
+    full_quant_string.calibrate_thread_num = thread_num;
+    ASSERT_EQ(QuantParamParser::ParseFullQuant(full_quant_string, &full_quant), RET_OK);
+    ASSERT_EQ(full_quant.calibrate_thread_num, std::stoi(thread_num));
+  }
+  for (auto thread_num : {"0", "-1", "65", "abc", "4.5"}) {
+    full_quant_string.calibrate_thread_num = thread_num;
+    quant::FullQuantParam invalid_full_quant;
+    ASSERT_EQ(QuantParamParser::ParseFullQuant(full_quant_string, &invalid_full_quant), RET_INPUT_PARAM_INVALID);
+  }
+}
+
+TEST_F(FullQuantQuantizerTest, MinMaxSameWithThreadNum) {
+  auto expect = Calibrate(1);
+  // The two inputs and the output.
+  ASSERT_EQ(expect.size(), 3);
+  float min_value = FLT_MAX;
+  float max_value = -FLT_MAX;
+  for (auto &data : batches_) {
+    for (auto value : data) {
+      min_value = std::min(min_value, value);
+      max_value = std::max(max_value, value);
+    }
+  }
+  for (auto &result : expect) {
+    ASSERT_EQ(result.real_min, min_value);
+    ASSERT_EQ(result.real_max, max_value);
+  }
+
+  for (size_t thread_num : {2, 4}) {
+    // The threads record in a different order every time.
+    for (int round = 0; round < 10; round++) {
+      auto results = Calibrate(thread_num);
+      ASSERT_EQ(results.size(), expect.size());
+      for (size_t i = 0; i < expect.size(); i++) {
+        ASSERT_EQ(results[i].scale, expect[i].scale);
+        ASSERT_EQ(results[i].zero_point, expect[i].zero_point);
+        ASSERT_EQ(results[i].real_min, expect[i].real_min);
+        ASSERT_EQ(results[i].real_max, expect[i].real_max);
+      }
+    }
+  }
+}
+}  // namespace lite
+}  // namespace mindspore
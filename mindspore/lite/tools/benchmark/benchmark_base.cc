@@ -265,6 +265,47 @@ void BenchmarkFlags::InitResizeDimsList() {
   }
 }
 
+void BenchmarkFlags::InitResizeLoopShapes() {
+  if (resize_loop_shapes_in_.empty()) {
+    return;
+  }
+  for (const auto &shapes_str : StrSplit(resize_loop_shapes_in_, std::string(DELIM_SEMICOLON))) {
+    std::vector<std::vector<int>> shapes;
+    for (const auto &shape_str : StrSplit(shapes_str, std::string(DELIM_COLON))) {
+      std::vector<int> shape;
+      for (const auto &dim_str : StrSplit(shape_str, std::string(DELIM_COMMA))) {
+        shape.emplace_back(static_cast<int>(std::stoi(dim_str)));
+      }
+      shapes.emplace_back(shape);
+    }
+    resize_loop_shapes_.emplace_back(shapes);
+  }
+}
+
+int BenchmarkFlags::InitSweepNums() {
+  auto parse_nums = [](const std::string &flag_name, const std::string &nums_str, std::vector<int> *nums) {
+    if (nums_str.empty()) {
+      return RET_OK;
+    }
+    for (const auto &num_str : StrSplit(nums_str, std::string(DELIM_COMMA))) {
+      int num = 0;
+      if (num_str.empty() || !ConvertStrToInt(num_str, &num) || num <= 0) {
+        MS_LOG(ERROR) << flag_name << " should be positive integers separated by comma, but got: " << nums_str;
+        std::cerr << flag_name << " should be positive integers separated by comma, but got: " << nums_str
+                  << std::endl;
+        return RET_ERROR;
+      }
+      nums->emplace_back(num);
+    }
+    return RET_OK;
+  };
+  if (parse_nums("sweepThreadNums", sweep_thread_nums_in_, &sweep_thread_nums_) != RET_OK ||
+      parse_nums("sweepWorkersNums", sweep_workers_nums_in_, &sweep_workers_nums_) != RET_OK) {
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
+
 void BenchmarkFlags::InitCoreList() {
   std::string core_list_str = this->core_list_str_;
   if (core_list_str.empty()) {
@@ -333,6 +374,35 @@ int BenchmarkBase::CheckDeviceTypeValid() {
   return RET_OK;
 }
 
+int BenchmarkBase::CheckLoadModeValid() {
+  if (flags_->load_mode_.empty()) {
+    return RET_OK;
+  }
+  if (flags_->load_mode_ != "poisson" && flags_->load_mode_ != "fixed") {
+    MS_LOG(ERROR) << "Load mode:" << flags_->load_mode_ << " is not supported.";
+    std::cerr << "Load mode:" << flags_->load_mode_ << " is not supported." << std::endl;
+    return RET_ERROR;
+  }
+  if (!flags_->enable_parallel_predict_) {
+    MS_LOG(ERROR) << "Load mode should be used with enableParallelPredict.";
+    std::cerr << "Load mode should be used with enableParallelPredict." << std::endl;
+    return RET_ERROR;
+  }
+  if (flags_->target_qps_ <= 0 || flags_->load_duration_ <= 0 || flags_->parallel_num_ <= 0) {
+    MS_LOG(ERROR) << "targetQps, loadDuration and parallelNum should be greater than 0.";
+    std::cerr << "targetQps, loadDuration and parallelNum should be greater than 0." << std::endl;
+    return RET_ERROR;
+  }
+  auto invalid_num = [](int num) { return num <= 0; };
+  if (std::any_of(flags_->sweep_thread_nums_.begin(), flags_->sweep_thread_nums_.end(), invalid_num) ||
+      std::any_of(flags_->sweep_workers_nums_.begin(), flags_->sweep_workers_nums_.end(), invalid_num)) {
+    MS_LOG(ERROR) << "sweepThreadNums and sweepWorkersNums should be greater than 0.";
+    std::cerr << "sweepThreadNums and sweepWorkersNums should be greater than 0." << std::endl;
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
+
 int BenchmarkBase::InitDumpConfigFromJson(const char *path) {
 #ifndef BENCHMARK_CLIP_JSON
   auto real_path = RealPath(path);
@@ -486,6 +556,11 @@ int BenchmarkBase::Init() {
   flags_->InitInputDataList();
   flags_->InitCoreList();
   flags_->InitResizeDimsList();
+  flags_->InitResizeLoopShapes();
+  if (flags_->InitSweepNums() != RET_OK) {
+    MS_LOG(ERROR) << "Init sweep nums failed.";
+    return RET_ERROR;
+  }
   if (!flags_->resize_dims_.empty() && !flags_->input_data_list_.empty() &&
       flags_->resize_dims_.size() != flags_->input_data_list_.size()) {
     MS_LOG(ERROR) << "Size of input resizeDims should be equal to size of input inDataPath";
@@ -498,6 +573,11 @@ int BenchmarkBase::Init() {
     return RET_ERROR;
   }
 
+  if (CheckLoadModeValid() != RET_OK) {
+    MS_LOG(ERROR) << "Load mode is invalid.";
+    return RET_ERROR;
+  }
+
   if (flags_->time_profiling_ && flags_->perf_profiling_) {
     MS_LOG(INFO) << "time_profiling is enabled, will not run perf_profiling.";
   }
@@ -70,6 +70,7 @@ constexpr int kNumPrintMin = 5;
 constexpr const char *DELIM_COLON = ":";
 constexpr const char *DELIM_COMMA = ",";
 constexpr const char *DELIM_SLASH = "/";
+constexpr const char *DELIM_SEMICOLON = ";";
 constexpr size_t kEncMaxLen = 16;
 
 extern const std::unordered_map<int, std::string> kTypeIdMap;
@@ -153,12 +154,33 @@ class MS_API BenchmarkFlags : public virtual FlagParser {
     AddFlag(&BenchmarkFlags::parallel_task_num_, "parallelTaskNum",
             "parallel task num of parallel predict, unlimited number of tasks when the value is -1", 2);
     AddFlag(&BenchmarkFlags::workers_num_, "workersNum", "works num of parallel predict", 2);
+    AddFlag(&BenchmarkFlags::load_mode_, "loadMode",
+            "Send the requests of parallel predict at the target qps instead of the closed loop, the parallelNum "
+            "clients serve the requests and the latency is counted from the arrival of request: poisson | fixed",
+            "");
+    AddFlag(&BenchmarkFlags::target_qps_, "targetQps", "The target qps of the requests in load mode", 100.0f);
+    AddFlag(&BenchmarkFlags::load_duration_, "loadDuration", "The seconds of sending the requests in load mode", 10);
+    AddFlag(&BenchmarkFlags::sweep_thread_nums_in_, "sweepThreadNums",
+            "The thread nums of each worker to sweep in load mode, e.g. 1,2,4", "");
+    AddFlag(&BenchmarkFlags::sweep_workers_nums_in_, "sweepWorkersNums",
+            "The workers nums to sweep in load mode, e.g. 1,2,4", "");
+    AddFlag(&BenchmarkFlags::load_result_file_, "loadResultFile",
+            "The file to save the latency percentiles of load mode, json if the file ends with .json, else csv", "");
     AddFlag(&BenchmarkFlags::core_list_str_, "cpuCoreList", "The core id of the bundled core, e.g. 0,1,2,3", "");
     AddFlag(&BenchmarkFlags::inter_op_parallel_num_, "interOpParallelNum", "parallel number of operators in predict",
             1);
     AddFlag(&BenchmarkFlags::enable_gl_texture_, "enableGLTexture", "Enable GlTexture2D", false);
     AddFlag(&BenchmarkFlags::delegate_mode_, "delegateMode", "set the delegate mode: CoreML | NNAPI", "");
     AddFlag(&BenchmarkFlags::enable_shared_thread_pool_, "enableSharedThreadPool", "Enable shared thread pool", false);
+    AddFlag(&BenchmarkFlags::enable_mmap_, "enableMmap",
+            "Map the model file instead of reading it into memory, the weights are loaded on demand: true | false",
+            false);
+    AddFlag(&BenchmarkFlags::resize_plan_cache_size_, "resizePlanCacheSize",
+            "The number of the input shapes whose resize plans are cached, 0 means not caching the plans", 0);
+    AddFlag(&BenchmarkFlags::resize_loop_shapes_in_, "resizeLoopShapes",
+            "Resize the model to the groups of input shapes in turn loopCount times and report the resize time, the "
+            "groups are split by ';'. e.g. 1,32,32,3;1,64,64,3",
+            "");
     AddFlag(&BenchmarkFlags::thread_num_limit_per_worker_, "threadNumLimitPerWorker", "thread num limit per worker ",
             "");
     AddFlag(&BenchmarkFlags::thread_num_remaining_per_worker_, "threadNumRemainingPerWorker",
@@ -171,6 +193,10 @@ class MS_API BenchmarkFlags : public virtual FlagParser {
 
   void InitResizeDimsList();
 
+  void InitResizeLoopShapes();
+
+  int InitSweepNums();
+
   void InitCoreList();
 
  public:
@@ -180,6 +206,15 @@ class MS_API BenchmarkFlags : public virtual FlagParser {
   int parallel_task_num_ = 2;
   int inter_op_parallel_num_ = 1;
   int workers_num_ = 2;
+  // load mode of parallel predict
+  std::string load_mode_;
+  float target_qps_ = 100.0f;
+  int load_duration_ = 10;
+  std::string sweep_thread_nums_in_;
+  std::vector<int> sweep_thread_nums_;
+  std::string sweep_workers_nums_in_;
+  std::vector<int> sweep_workers_nums_;
+  std::string load_result_file_;
   std::string model_file_;
   std::string in_data_file_;
   std::string config_file_;
@@ -205,6 +240,9 @@ class MS_API BenchmarkFlags : public virtual FlagParser {
   // Resize
   std::string resize_dims_in_;
   std::vector<std::vector<int>> resize_dims_;
+  int resize_plan_cache_size_ = 0;
+  std::string resize_loop_shapes_in_;
+  std::vector<std::vector<std::vector<int>>> resize_loop_shapes_;
 
   std::string device_ = "CPU";
   std::string provider_ = "litert";
@@ -218,6 +256,7 @@ class MS_API BenchmarkFlags : public virtual FlagParser {
   std::string crypto_lib_path_;
   std::string delegate_mode_;
   bool enable_shared_thread_pool_ = false;
+  bool enable_mmap_ = false;
   std::string thread_num_limit_per_worker_;
   std::string thread_num_remaining_per_worker_;
 };
@@ -498,6 +537,8 @@ class MS_API BenchmarkBase {
 
   int CheckDeviceTypeValid();
 
+  int CheckLoadModeValid();
+
  protected:
   BenchmarkFlags *flags_;
   std::vector<std::string> benchmark_tensor_names_;
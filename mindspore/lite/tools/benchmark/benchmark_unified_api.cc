@@ -40,9 +40,13 @@
 #include "include/mpi_vb.h"
 #endif
 #ifdef PARALLEL_INFERENCE
+#include <chrono>
 #include <thread>
 #include "src/common/config_file.h"
 #endif
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
 
 namespace mindspore {
 constexpr size_t kDataToStringMaxNum = 40;
@@ -53,8 +57,28 @@ constexpr int kDumpInputsAndOutputs = 0;
 constexpr int kDumpOutputs = 2;
 #ifdef PARALLEL_INFERENCE
 constexpr int kMaxRequestNum = 200;
+constexpr uint64_t kUsPerSecond = 1000000;
+// The clients start after the delay, so that the first requests are not delayed by the thread creation.
+constexpr uint64_t kLoadStartDelayUs = 10000;
+constexpr uint32_t kLoadArrivalSeed = 1;
+constexpr double kLoadPercentiles[] = {50.0, 90.0, 99.0, 99.9};
+constexpr int kDumpJsonIndent = 2;
 #endif
+constexpr float kKBToMB = 1024.0f;
 namespace lite {
+namespace {
+// The peak resident memory of the process in MB, which includes the model file buffer and the packed weights.
+float GetPeakRssMB() {
+#ifdef __linux__
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    return static_cast<float>(usage.ru_maxrss) / kKBToMB;
+  }
+#endif
+  return 0.0f;
+}
+}  // namespace
+
 int BenchmarkUnifiedApi::GenerateGLTexture(std::map<std::string, GLuint> *input_gl_texture) {
   for (auto tensor : ms_inputs_for_api_) {
     float *input_data = reinterpret_cast<float *>(malloc(tensor.DataSize()));
@@ -932,6 +956,54 @@ int BenchmarkUnifiedApi::MarkPerformance() {
   return RET_OK;
 }
 
+int BenchmarkUnifiedApi::MarkResizePerformance() {
+  auto inputs = ms_model_.GetInputs();
+  std::vector<std::vector<int64_t>> origin_dims;
+  (void)std::transform(inputs.begin(), inputs.end(), std::back_inserter(origin_dims),
+                       [](const MSTensor &input) { return input.Shape(); });
+  // The first resize to each group of shapes builds the plan, and the later ones are served by the resize plan cache
+  // when resizePlanCacheSize is not less than the number of groups.
+  uint64_t first_time = 0;
+  uint64_t repeated_time = 0;
+  size_t repeated_num = 0;
+  for (int i = 0; i < flags_->loop_count_; i++) {
+    for (const auto &shapes : flags_->resize_loop_shapes_) {
+      std::vector<std::vector<int64_t>> resize_dims;
+      (void)std::transform(shapes.begin(), shapes.end(), std::back_inserter(resize_dims),
+                           [&](auto &shape) { return this->ConverterToInt64Vector<int>(shape); });
+      auto start = GetTimeUs();
+      auto ret = ms_model_.Resize(inputs, resize_dims);
+      if (ret != kSuccess) {
+        MS_LOG(ERROR) << "Input tensor resize failed.";
+        std::cerr << "Input tensor resize failed." << std::endl;
+        return RET_ERROR;
+      }
+      auto time = GetTimeUs() - start;
+      if (i == 0) {
+        first_time += time;
+      } else {
+        repeated_time += time;
+        repeated_num++;
+      }
+    }
+  }
+  if (ms_model_.Resize(inputs, origin_dims) != kSuccess) {
+    MS_LOG(ERROR) << "Restore the input shapes failed.";
+    std::cerr << "Restore the input shapes failed." << std::endl;
+    return RET_ERROR;
+  }
+  auto shapes_num = flags_->resize_loop_shapes_.size();
+  auto first_avg = shapes_num == 0 ? 0 : first_time / kFloatMSEC / shapes_num;
+  auto repeated_avg = repeated_num == 0 ? 0 : repeated_time / kFloatMSEC / repeated_num;
+  MS_LOG(INFO) << "ResizeShapesNum = " << shapes_num << ", ResizePlanCacheSize = " << flags_->resize_plan_cache_size_
+               << ", FirstResizeTime = " << first_avg << " ms, RepeatedResizeNum = " << repeated_num
+               << ", RepeatedResizeTime = " << repeated_avg << " ms";
+  printf("ResizeShapesNum = %zu, ResizePlanCacheSize = %d, FirstResizeTime = %f ms, RepeatedResizeNum = %zu, "
+         "RepeatedResizeTime = %f ms\n",
+         shapes_num, flags_->resize_plan_cache_size_, first_avg, repeated_num, repeated_avg);
+  return RET_OK;
+}
+
 int BenchmarkUnifiedApi::MarkAccuracy() {
   MS_LOG(INFO) << "MarkAccuracy";
   std::cout << "MarkAccuracy" << std::endl;
@@ -1119,6 +1191,188 @@ int BenchmarkUnifiedApi::AddConfigInfo(const std::shared_ptr<RunnerConfig> &runn
   return RET_OK;
 }
 
+std::vector<uint64_t> BenchmarkUnifiedApi::GenerateArrivals() {
+  // The arrival time in us of each request since the start, the interval is exponential in the poisson mode.
+  auto request_num = static_cast<size_t>(flags_->target_qps_ * flags_->load_duration_);
+  std::vector<uint64_t> arrivals(request_num);
+  std::mt19937 random_engine(kLoadArrivalSeed);
+  std::exponential_distribution<double> interval(flags_->target_qps_);
+  double arrival = 0;
+  for (size_t i = 0; i < request_num; i++) {
+    if (flags_->load_mode_ == "poisson") {
+      arrival += interval(random_engine);
+    } else {
+      arrival = static_cast<double>(i) / flags_->target_qps_;
+    }
+    arrivals[i] = static_cast<uint64_t>(arrival * kUsPerSecond);
+  }
+  return arrivals;
+}
+
+int BenchmarkUnifiedApi::RunLoadOnce(ModelParallelRunner *runner, const std::vector<uint64_t> &arrivals,
+                                     LoadResult *result) {
+  for (int i = 0; i < flags_->warm_up_loop_count_; i++) {
+    auto in = runner->GetInputs();
+    for (size_t j = 0; j < in.size(); j++) {
+      in[j].SetShape(resize_dims_[j]);
+      in[j].SetData(all_inputs_data_[i][j], false);
+    }
+    std::vector<MSTensor> output;
+    auto ret = runner->Predict(in, &output);
+    for (auto &item : in) {
+      item.SetData(nullptr);
+    }
+    MS_CHECK_FALSE_MSG(ret != kSuccess, RET_ERROR, "model pool predict failed.");
+  }
+
+  // Each client takes the next request, waits for its arrival and predicts, so the requests wait in the queue when all
+  // the clients are busy, and the latency from the arrival includes the queueing time.
+  std::atomic<size_t> next_request{0};
+  std::atomic<size_t> failed_num{0};
+  std::vector<LatencyHistogram> latencies(flags_->parallel_num_);
+  auto start_time = GetTimeUs() + kLoadStartDelayUs;
+  auto client = [&, this](int client_idx) {
+    auto in = runner->GetInputs();
+    for (size_t j = 0; j < in.size(); j++) {
+      in[j].SetShape(resize_dims_[j]);
+      in[j].SetData(all_inputs_data_[client_idx + flags_->warm_up_loop_count_][j], false);
+    }
+    for (auto request = next_request++; request < arrivals.size(); request = next_request++) {
+      auto arrival_time = start_time + arrivals[request];
+      auto now = GetTimeUs();
+      if (arrival_time > now) {
+        std::this_thread::sleep_for(std::chrono::microseconds(arrival_time - now));
+      }
+      std::vector<MSTensor> output;
+      auto ret = runner->Predict(in, &output);
+      if (ret != kSuccess) {
+        failed_num++;
+        continue;
+      }
+      latencies[client_idx].Record(GetTimeUs() - arrival_time);
+    }
+    for (auto &item : in) {
+      item.SetData(nullptr);
+    }
+  };
+  std::vector<std::thread> clients;
+  for (int i = 0; i < flags_->parallel_num_; i++) {
+    clients.push_back(std::thread(client, i));
+  }
+  for (auto &client_thread : clients) {
+    client_thread.join();
+  }
+  auto end_time = GetTimeUs();
+  for (auto &latency : latencies) {
+    result->latency.Merge(latency);
+  }
+  result->request_num = arrivals.size();
+  result->failed_num = failed_num;
+  result->achieved_qps =
+    end_time > start_time ? static_cast<double>(result->latency.count()) * kUsPerSecond / (end_time - start_time) : 0;
+  return RET_OK;
+}
+
+int BenchmarkUnifiedApi::RunLoad(const std::shared_ptr<mindspore::Context> &context) {
+  auto thread_nums =
+    flags_->sweep_thread_nums_.empty() ? std::vector<int>{flags_->num_threads_} : flags_->sweep_thread_nums_;
+  auto workers_nums =
+    flags_->sweep_workers_nums_.empty() ? std::vector<int>{flags_->workers_num_} : flags_->sweep_workers_nums_;
+  auto arrivals = GenerateArrivals();
+  std::vector<LoadResult> results;
+  for (auto thread_num : thread_nums) {
+    for (auto workers_num : workers_nums) {
+      context->SetThreadNum(thread_num);
+      auto runner_config = std::make_shared<RunnerConfig>();
+      runner_config->SetContext(context);
+      runner_config->SetWorkersNum(workers_num);
+      auto status = AddConfigInfo(runner_config);
+      MS_CHECK_FALSE_MSG(status != RET_OK, RET_ERROR, "add config info for parallel predict failed.");
+      ModelParallelRunner runner;
+      auto ret = runner.Init(flags_->model_file_, runner_config);
+      MS_CHECK_FALSE_MSG(ret != kSuccess, RET_ERROR, "model pool init failed.");
+      if (all_inputs_data_.empty()) {
+        ms_inputs_for_api_ = runner.GetInputs();
+        MS_CHECK_FALSE_MSG(ms_inputs_for_api_.empty(), RET_ERROR, "model pool input is empty.");
+        for (int i = 0; i < flags_->parallel_num_ + flags_->warm_up_loop_count_; i++) {
+          status = LoadInput();
+          MS_CHECK_FALSE_MSG(status != RET_OK, status, "Generate input data error");
+        }
+      }
+      LoadResult result;
+      result.thread_num = thread_num;
+      result.workers_num = workers_num;
+      status = RunLoadOnce(&runner, arrivals, &result);
+      MS_CHECK_FALSE_MSG(status != RET_OK, status, "run load failed.");
+      printf("NumThreads = %d, WorkersNum = %d, Clients = %d, LoadMode = %s, TargetQps = %f, AchievedQps = %f, "
+             "Requests = %zu, Failed = %zu, P50 = %f ms, P90 = %f ms, P99 = %f ms, P999 = %f ms, Max = %f ms\n",
+             thread_num, workers_num, flags_->parallel_num_, flags_->load_mode_.c_str(), flags_->target_qps_,
+             result.achieved_qps, result.request_num, result.failed_num,
+             result.latency.Percentile(kLoadPercentiles[0]) / kFloatMSEC,
+             result.latency.Percentile(kLoadPercentiles[1]) / kFloatMSEC,
+             result.latency.Percentile(kLoadPercentiles[2]) / kFloatMSEC,
+             result.latency.Percentile(kLoadPercentiles[3]) / kFloatMSEC, result.latency.max() / kFloatMSEC);
+      results.push_back(std::move(result));
+    }
+  }
+  return SaveLoadResults(results);
+}
+
+int BenchmarkUnifiedApi::SaveLoadResults(const std::vector<LoadResult> &results) {
+  if (flags_->load_result_file_.empty()) {
+    return RET_OK;
+  }
+  std::ofstream ofs(flags_->load_result_file_);
+  if (!ofs.is_open()) {
+    MS_LOG(ERROR) << "Open the load result file " << flags_->load_result_file_ << " failed.";
+    return RET_ERROR;
+  }
+  const std::string json_suffix = ".json";
+  const auto &file = flags_->load_result_file_;
+  auto is_json = file.size() >= json_suffix.size() && file.substr(file.size() - json_suffix.size()) == json_suffix;
+  if (is_json) {
+#ifndef BENCHMARK_CLIP_JSON
+    nlohmann::json json_results = nlohmann::json::array();
+    for (const auto &result : results) {
+      nlohmann::json json_result;
+      json_result["thread_num"] = result.thread_num;
+      json_result["workers_num"] = result.workers_num;
+      json_result["clients"] = flags_->parallel_num_;
+      json_result["load_mode"] = flags_->load_mode_;
+      json_result["target_qps"] = flags_->target_qps_;
+      json_result["achieved_qps"] = result.achieved_qps;
+      json_result["requests"] = result.request_num;
+      json_result["failed"] = result.failed_num;
+      json_result["p50_ms"] = result.latency.Percentile(kLoadPercentiles[0]) / kFloatMSEC;
+      json_result["p90_ms"] = result.latency.Percentile(kLoadPercentiles[1]) / kFloatMSEC;
+      json_result["p99_ms"] = result.latency.Percentile(kLoadPercentiles[2]) / kFloatMSEC;
+      json_result["p999_ms"] = result.latency.Percentile(kLoadPercentiles[3]) / kFloatMSEC;
+      json_result["max_ms"] = result.latency.max() / kFloatMSEC;
+      json_results.push_back(json_result);
+    }
+    ofs << json_results.dump(kDumpJsonIndent) << std::endl;
+#else
+    MS_LOG(ERROR) << "The json result is not supported when the json is clipped.";
+    return RET_NOT_SUPPORT;
+#endif
+  } else {
+    ofs << "thread_num,workers_num,clients,load_mode,target_qps,achieved_qps,requests,failed,p50_ms,p90_ms,p99_ms,"
+           "p999_ms,max_ms"
+        << std::endl;
+    for (const auto &result : results) {
+      ofs << result.thread_num << "," << result.workers_num << "," << flags_->parallel_num_ << "," << flags_->load_mode_
+          << "," << flags_->target_qps_ << "," << result.achieved_qps << "," << result.request_num << ","
+          << result.failed_num;
+      for (auto percentile : kLoadPercentiles) {
+        ofs << "," << result.latency.Percentile(percentile) / kFloatMSEC;
+      }
+      ofs << "," << result.latency.max() / kFloatMSEC << std::endl;
+    }
+  }
+  std::cout << "The load results are saved to " << flags_->load_result_file_ << std::endl;
+  return RET_OK;
+}
+
 int BenchmarkUnifiedApi::ParallelInference(std::shared_ptr<mindspore::Context> context) {
   if (flags_->warm_up_loop_count_ > kMaxRequestNum || flags_->parallel_num_ > kMaxRequestNum) {
     MS_LOG(WARNING) << "in parallel predict warm up loop count should less than" << kMaxRequestNum;
@@ -1126,6 +1380,9 @@ int BenchmarkUnifiedApi::ParallelInference(std::shared_ptr<mindspore::Context> c
 
   (void)std::transform(flags_->resize_dims_.begin(), flags_->resize_dims_.end(), std::back_inserter(resize_dims_),
                        [&](auto &shapes) { return this->ConverterToInt64Vector<int>(shapes); });
+  if (!flags_->load_mode_.empty()) {
+    return RunLoad(context);
+  }
 
   // model runner init
   auto runner_config = std::make_shared<RunnerConfig>();
@@ -1274,6 +1531,13 @@ int BenchmarkUnifiedApi::RunBenchmark() {
   }
 
   UpdateConfigInfo();
+  if (flags_->enable_mmap_) {
+    ms_model_.UpdateConfig(kConfigModelFileSection, std::make_pair(kConfigMmapModelKey, "true"));
+  }
+  if (flags_->resize_plan_cache_size_ > 0) {
+    ms_model_.UpdateConfig(kResizePlanCacheSection, std::make_pair(kResizePlanCacheSizeKey,
+                                                                   std::to_string(flags_->resize_plan_cache_size_)));
+  }
 #ifdef PARALLEL_INFERENCE
   if (flags_->enable_parallel_predict_) {
     MS_CHECK_FALSE_MSG(flags_->resize_dims_.empty(), RET_ERROR, "use parallel predict, inputShapes can not use empty.");
@@ -1283,11 +1547,17 @@ int BenchmarkUnifiedApi::RunBenchmark() {
   }
 #endif
 
+  auto start_build_time = GetTimeUs();
   status = CompileGraph(model_type, context, model_name);
   if (status != RET_OK) {
     MS_LOG(ERROR) << "Compile graph failed.";
     return status;
   }
+  auto end_build_time = GetTimeUs();
+  MS_LOG(INFO) << "ColdStartTime = " << ((end_build_time - start_build_time) / kFloatMSEC)
+               << " ms, PeakRss = " << GetPeakRssMB() << " MB, EnableMmap = " << flags_->enable_mmap_;
+  std::cout << "ColdStartTime = " << ((end_build_time - start_build_time) / kFloatMSEC)
+            << " ms, PeakRss = " << GetPeakRssMB() << " MB, EnableMmap = " << flags_->enable_mmap_ << std::endl;
   if (!flags_->resize_dims_.empty()) {
     std::vector<std::vector<int64_t>> resize_dims;
     (void)std::transform(flags_->resize_dims_.begin(), flags_->resize_dims_.end(), std::back_inserter(resize_dims),
@@ -1300,6 +1570,14 @@ int BenchmarkUnifiedApi::RunBenchmark() {
       return RET_ERROR;
     }
   }
+  if (!flags_->resize_loop_shapes_.empty()) {
+    status = MarkResizePerformance();
+    if (status != RET_OK) {
+      MS_LOG(ERROR) << "Run MarkResizePerformance error: " << status;
+      std::cout << "Run MarkResizePerformance error: " << status << std::endl;
+      return status;
+    }
+  }
 
   ms_inputs_for_api_ = ms_model_.GetInputs();
   ms_outputs_for_api_ = ms_model_.GetOutputs();
@@ -42,9 +42,22 @@
 #include "tools/common/opengl_util.h"
 #ifdef PARALLEL_INFERENCE
 #include "include/api/model_parallel_runner.h"
+#include "tools/benchmark/latency_histogram.h"
 #endif
 
 namespace mindspore::lite {
+#ifdef PARALLEL_INFERENCE
+// The result of the requests sent at the target qps to the model parallel runner with the thread num and workers num.
+struct LoadResult {
+  int thread_num = 0;
+  int workers_num = 0;
+  size_t request_num = 0;
+  size_t failed_num = 0;
+  double achieved_qps = 0;
+  LatencyHistogram latency;
+};
+#endif
+
 class MS_API BenchmarkUnifiedApi : public BenchmarkBase {
  public:
   explicit BenchmarkUnifiedApi(BenchmarkFlags *flags) : BenchmarkBase(flags) {}
@@ -102,6 +115,10 @@ class MS_API BenchmarkUnifiedApi : public BenchmarkBase {
   void ModelParallelRunnerRun(int task_num, int parallel_idx);
   int ParallelInference(std::shared_ptr<mindspore::Context> context);
   int AddConfigInfo(const std::shared_ptr<RunnerConfig> &runner_config);
+  std::vector<uint64_t> GenerateArrivals();
+  int RunLoad(const std::shared_ptr<mindspore::Context> &context);
+  int RunLoadOnce(ModelParallelRunner *runner, const std::vector<uint64_t> &arrivals, LoadResult *result);
+  int SaveLoadResults(const std::vector<LoadResult> &results);
 #endif
 
   template <typename T>
@@ -115,6 +132,8 @@ class MS_API BenchmarkUnifiedApi : public BenchmarkBase {
 
   int MarkPerformance();
 
+  int MarkResizePerformance();
+
   int MarkAccuracy();
 
   void UpdateDistributionName(const std::shared_ptr<mindspore::Context> &context, std::string *name);
@@ -0,0 +1,96 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tools/benchmark/latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace mindspore::lite {
+namespace {
+constexpr int kValueBits = 64;
+constexpr double kMaxPercentile = 100.0;
+
+int HighestBit(uint64_t value) {
+  int bit = 0;
+  while (value >>= 1) {
+    bit++;
+  }
+  return bit;
+}
+}  // namespace
+
+LatencyHistogram::LatencyHistogram(int sub_bucket_bits)
+    : sub_bucket_bits_(sub_bucket_bits), sub_bucket_count_(1ULL << sub_bucket_bits) {
+  counts_.resize(static_cast<size_t>(kValueBits - sub_bucket_bits_ + 1) * sub_bucket_count_, 0);
+}
+
+size_t LatencyHistogram::BucketIndex(uint64_t value) const {
+  if (value < sub_bucket_count_) {
+    return static_cast<size_t>(value);
+  }
+  // The mantissa is in [sub_bucket_count_, 2 * sub_bucket_count_), so the buckets of the shifts are contiguous.
+  auto shift = HighestBit(value) - sub_bucket_bits_;
+  auto mantissa = value >> shift;
+  return static_cast<size_t>(shift * sub_bucket_count_ + mantissa);
+}
+
+uint64_t LatencyHistogram::BucketHighestValue(size_t index) const {
+  if (index < sub_bucket_count_ * 2) {
+    return index;
+  }
+  auto shift = index / sub_bucket_count_ - 1;
+  auto mantissa = index % sub_bucket_count_ + sub_bucket_count_;
+  return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value) {
+  counts_[BucketIndex(value)]++;
+  count_++;
+  sum_ += value;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram &other) {
+  if (other.sub_bucket_bits_ != sub_bucket_bits_) {
+    return;
+  }
+  for (size_t i = 0; i < counts_.size(); i++) {
+    counts_[i] += other.counts_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+uint64_t LatencyHistogram::Percentile(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  percentile = std::min(std::max(percentile, 0.0), kMaxPercentile);
+  auto target = static_cast<uint64_t>(std::ceil(percentile / kMaxPercentile * count_));
+  target = std::max<uint64_t>(target, 1);
+  uint64_t total = 0;
+  for (size_t i = 0; i < counts_.size(); i++) {
+    total += counts_[i];
+    if (total >= target) {
+      return std::min(BucketHighestValue(i), max_);
+    }
+  }
+  return max_;
+}
+}  // namespace mindspore::lite
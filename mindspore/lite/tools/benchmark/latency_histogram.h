@@ -0,0 +1,56 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_LITE_TOOLS_BENCHMARK_LATENCY_HISTOGRAM_H_
+#define MINDSPORE_LITE_TOOLS_BENCHMARK_LATENCY_HISTOGRAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mindspore::lite {
+// The histogram of the latencies in us with the bounded relative error, like the HDR histogram. The values less than
+// 2^sub_bucket_bits are counted exactly, and each larger power of two range is divided into 2^sub_bucket_bits sub
+// buckets, so the percentiles are accurate to 2^-sub_bucket_bits of the value with the fixed memory.
+class LatencyHistogram {
+ public:
+  explicit LatencyHistogram(int sub_bucket_bits = 7);
+  ~LatencyHistogram() = default;
+
+  void Record(uint64_t value);
+  void Merge(const LatencyHistogram &other);
+  // Return the highest value equivalent to the value at the percentile in (0, 100].
+  uint64_t Percentile(double percentile) const;
+
+  uint64_t count() const { return count_; }
+  uint64_t min() const { return count_ == 0 ? 0 : min_; }
+  uint64_t max() const { return max_; }
+  double mean() const { return count_ == 0 ? 0 : static_cast<double>(sum_) / count_; }
+
+ private:
+  size_t BucketIndex(uint64_t value) const;
+  uint64_t BucketHighestValue(size_t index) const;
+
+  int sub_bucket_bits_;
+  uint64_t sub_bucket_count_;
+  std::vector<uint64_t> counts_;
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t min_ = UINT64_MAX;
+  uint64_t max_ = 0;
+};
+}  // namespace mindspore::lite
+#endif  // MINDSPORE_LITE_TOOLS_BENCHMARK_LATENCY_HISTOGRAM_H_
@@ -348,6 +348,7 @@ int AnfTransform::RunFusionPass(const FuncGraphPtr &old_graph, const std::shared
       MS_LOG(INFO) << "Disable fusion: " << pass->name();
       continue;
     }
+    opt::PassTimeGuard time_guard(pass->name());
     if (!pass->Run(old_graph)) {
       MS_LOG(ERROR) << pass->name() << " running failed.";
       return RET_ERROR;
@@ -527,6 +528,7 @@ bool AnfTransform::CheckExternalExtension(const std::shared_ptr<ConverterPara> &
 }
 
 int AnfTransform::DoQuantize(const FuncGraphPtr &old_graph, const std::shared_ptr<ConverterPara> &param) {
+  opt::PassTimeGuard time_guard("QuantizationOptimizer");
   quant::QuantizationOptimizer quantization_optimizer(param);
   auto ret = quantization_optimizer.Run(old_graph);
   if (ret != RET_OK) {
@@ -781,6 +783,7 @@ STATUS AnfTransform::Transform(const FuncGraphPtr &main_graph, const std::shared
   }
 
   auto status = TransformFuncGraph(main_graph, param);
+  opt::PassTimeRecorder::GetInstance()->Report();
   if (status != RET_OK) {
     MS_LOG(ERROR) << "optimizer failed.";
     return RET_NULL_PTR;
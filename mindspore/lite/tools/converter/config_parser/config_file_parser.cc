@@ -363,6 +363,7 @@ int ConfigFileParser::ParseFullQuantString(const std::map<std::string, std::map<
       {"bias_correction", full_quant_string_.bias_correction},
       {"target_device", full_quant_string_.target_device},
       {"per_channel", full_quant_string_.per_channel},
+      {"calibrate_thread_num", full_quant_string_.calibrate_thread_num},
     };
     return SetMapData(map, parse_map, kFullQuantParam);
   }
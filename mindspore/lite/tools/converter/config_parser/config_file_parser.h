@@ -65,6 +65,7 @@ struct FullQuantString {
   std::string bias_correction;
   std::string target_device;
   std::string per_channel;
+  std::string calibrate_thread_num;
 };
 
 struct RegistryInfoString {
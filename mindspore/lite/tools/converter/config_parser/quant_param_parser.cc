@@ -27,6 +27,8 @@ constexpr int kQuantBitNumInt16 = 16;
 constexpr int kQuantBitNumInt8 = 8;
 constexpr int kMinSize = 0;
 constexpr int kMaxSize = 65535;
+constexpr int kMinCalibrateThreadNum = 1;
+constexpr int kMaxCalibrateThreadNum = 64;
 }  // namespace
 int QuantParamParser::ParseFilter(const CommonQuantString &common_quant_string, quant::CommonQuantParam *common_quant) {
   MS_ASSERT(common_quant != nullptr);
@@ -196,6 +198,17 @@ int QuantParamParser::ParseFullQuant(const FullQuantString &full_quant_string, q
     MS_LOG(ERROR) << "INPUT ILLEGAL: per_channel should be true or false.";
     return RET_INPUT_PARAM_INVALID;
   }
+  if (!full_quant_string.calibrate_thread_num.empty()) {
+    if (!ConvertIntNum(full_quant_string.calibrate_thread_num, &full_quant->calibrate_thread_num)) {
+      MS_LOG(ERROR) << "INPUT ILLEGAL: calibrate_thread_num should be a valid number.";
+      return RET_INPUT_PARAM_INVALID;
+    }
+    if (full_quant->calibrate_thread_num < kMinCalibrateThreadNum ||
+        full_quant->calibrate_thread_num > kMaxCalibrateThreadNum) {
+      MS_LOG(ERROR) << "INPUT ILLEGAL: calibrate_thread_num should be in the range [1,64].";
+      return RET_INPUT_PARAM_INVALID;
+    }
+  }
   return RET_OK;
 }
 
@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 #include "backend/common/optimizer/pass.h"
+#include "tools/optimizer/common/pass_manager_extends.h"
 #include "src/common/log_util.h"
 #include "tools/converter/parser/parser_utils.h"
 #include "include/registry/pass_base.h"
@@ -46,6 +47,7 @@ bool RunOptimizerPass(const FuncGraphPtr &func_graph, const std::vector<std::str
     }
   }
   for (auto &pass_name : pass_names) {
+    opt::PassTimeGuard time_guard(pass_name);
     auto pass_outer = registry::PassRegistry::GetPassFromStoreRoom(pass_name);
     if (pass_outer != nullptr) {
       auto api_graph = api::MakeShared<api::FuncGraph>(func_graph);
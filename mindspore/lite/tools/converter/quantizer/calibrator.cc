@@ -169,9 +169,12 @@ int Calibrator::CollectDataDistribution(
   std::unordered_map<std::string, std::map<int, std::unique_ptr<DataDistribution>>> *diverg_info_map,
   CollectType collect_type) {
   MS_CHECK_TRUE_MSG(diverg_info_map != nullptr, RET_ERROR, "diverg_info_map is nullptr.");
-  if (diverg_info_map->find(node_name) == diverg_info_map->end()) {
+  // The calibration threads collect concurrently, only find the distributions here and never insert.
+  auto diverg_iter = diverg_info_map->find(node_name);
+  if (diverg_iter == diverg_info_map->end()) {
     return RET_OK;
   }
+  auto &diverg_infos = diverg_iter->second;
   for (size_t i = 0; i < tensors.size(); i++) {
     auto tensor = tensors[i];
     if (tensor.IsConst() || tensor.DataType() != DataType::kNumberTypeFloat32) {
@@ -186,15 +189,17 @@ int Calibrator::CollectDataDistribution(
     MS_CHECK_GT(elem_count, 0, RET_ERROR);
     std::vector<float> data(tensor_data, tensor_data + elem_count);
     if (collect_type == MIN_MAX) {
-      MS_CHECK_LT(i, (*diverg_info_map)[node_name].size(), RET_ERROR);
-      auto ret = RecordMaxMinValue(data, (*diverg_info_map)[node_name][i]);
+      auto info_iter = diverg_infos.find(static_cast<int>(i));
+      MS_CHECK_TRUE_RET(info_iter != diverg_infos.end(), RET_ERROR);
+      auto ret = RecordMaxMinValue(data, info_iter->second);
       if (ret != RET_OK) {
         MS_LOG(ERROR) << tensor.Name() << " record max min value failed.";
         return RET_ERROR;
       }
     } else if (collect_type == KL_BIN) {
-      MS_CHECK_LT(i, (*diverg_info_map)[node_name].size(), RET_ERROR);
-      auto ret = UpdateDataFrequency(data, (*diverg_info_map)[node_name][i]);
+      auto info_iter = diverg_infos.find(static_cast<int>(i));
+      MS_CHECK_TRUE_RET(info_iter != diverg_infos.end(), RET_ERROR);
+      auto ret = UpdateDataFrequency(data, info_iter->second);
       if (ret != RET_OK) {
         MS_LOG(ERROR) << tensor.Name() << " update data frequency failed.";
         return RET_ERROR;
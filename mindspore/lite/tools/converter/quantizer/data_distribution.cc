@@ -32,23 +32,28 @@ int DataDistribution::RecordMaxMinValueArray(const std::vector<float> &data) {
   auto min_max = GetFloatMinMaxValue(data.data(), data.size());
   float min_num = min_max.first;
   float max_num = min_max.second;
+  if (activation_quant_method_ != REMOVAL_OUTLIER) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    real_min_ = std::min(min_num, real_min_);
+    real_max_ = std::max(max_num, real_max_);
+    return RET_OK;
+  }
+  auto bak_data(data);
+  const float min_percentage = 0.0001;
+  const float max_percentage = 0.9999;
+  auto const quantile_min_index = static_cast<int>(min_percentage * bak_data.size());
+  auto const quantile_max_index = static_cast<int>(max_percentage * bak_data.size());
+  std::nth_element(bak_data.begin(), bak_data.begin() + quantile_min_index, bak_data.end());
+  auto quantile_min = bak_data.at(quantile_min_index);
+  std::nth_element(bak_data.begin() + quantile_min_index + 1, bak_data.begin() + quantile_max_index, bak_data.end());
+  auto quantile_max = bak_data.at(quantile_max_index);
+  std::lock_guard<std::mutex> lock(mutex_);
   real_min_ = std::min(min_num, real_min_);
   real_max_ = std::max(max_num, real_max_);
-  if (activation_quant_method_ == REMOVAL_OUTLIER) {
-    auto bak_data(data);
-    const float min_percentage = 0.0001;
-    const float max_percentage = 0.9999;
-    auto const quantile_min_index = static_cast<int>(min_percentage * bak_data.size());
-    auto const quantile_max_index = static_cast<int>(max_percentage * bak_data.size());
-    std::nth_element(bak_data.begin(), bak_data.begin() + quantile_min_index, bak_data.end());
-    auto quantile_min = bak_data.at(quantile_min_index);
-    std::nth_element(bak_data.begin() + quantile_min_index + 1, bak_data.begin() + quantile_max_index, bak_data.end());
-    auto quantile_max = bak_data.at(quantile_max_index);
-    MS_LOG(DEBUG) << "real_min_:" << real_min_ << " real_max_:" << real_max_ << " quantile_min:" << quantile_min
-                  << " quantile_max:" << quantile_max;
-    this->min_datas_.emplace_back(quantile_min);
-    this->max_datas_.emplace_back(quantile_max);
-  }
+  MS_LOG(DEBUG) << "real_min_:" << real_min_ << " real_max_:" << real_max_ << " quantile_min:" << quantile_min
+                << " quantile_max:" << quantile_max;
+  this->min_datas_.emplace_back(quantile_min);
+  this->max_datas_.emplace_back(quantile_max);
   return RET_OK;
 }
 
@@ -59,6 +64,7 @@ void DataDistribution::UpdateInterval() {
 }
 
 int DataDistribution::UpdateHistogram(const std::vector<float> &data) {
+  std::lock_guard<std::mutex> lock(mutex_);
   for (auto value : data) {
     if (fabs(value) <= DBL_EPSILON) {
       continue;
@@ -20,6 +20,7 @@
 #include <vector>
 #include <utility>
 #include <limits>
+#include <mutex>
 #include "tools/converter/quantizer/quant_params.h"
 #include "tools/converter/quantizer/quantize_util.h"
 #include "src/common/quant_utils.h"
@@ -108,6 +109,8 @@ class DataDistribution {
   double scale_ = 0;
   int zero_point_ = 0;
   bool symmetric_ = true;
+  // The calibration threads record the data of the same tensor concurrently.
+  std::mutex mutex_;
 };
 }  // namespace mindspore::lite::quant
 #endif  // MINDSPORE_LITE_TOOLS_CONVERTER_QUANTIZER_DATA_DISTRIBUTION_H_
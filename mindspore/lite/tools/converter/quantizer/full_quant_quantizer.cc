@@ -18,7 +18,9 @@
 
 #include "tools/converter/quantizer/full_quant_quantizer.h"
 #include <dirent.h>
+#include <algorithm>
 #include <memory>
+#include <thread>
 #include <unordered_map>
 #include <string>
 #include <vector>
@@ -594,16 +596,17 @@ int FullQuantQuantizer::InitDeviceConfig(const FuncGraphPtr &func_graph) {
   return RET_OK;
 }
 
-int FullQuantQuantizer::DoInference(CollectType collect_type) {
+int FullQuantQuantizer::DoInferenceByModel(const std::shared_ptr<mindspore::Model> &model, CollectType collect_type,
+                                           size_t begin, size_t stride) {
   // get input tensor
-  vector<mindspore::MSTensor> inputs = fp32_ms_model_->GetInputs();
+  vector<mindspore::MSTensor> inputs = model->GetInputs();
   if (inputs.size() != calibrator_->GetInputNum()) {
     MS_LOG(ERROR) << "model's input tensor count: " << inputs.size() << " != "
                   << " calibrator count:" << calibrator_->GetInputNum();
     return RET_ERROR;
   }
 
-  for (size_t calib_index = 0; calib_index < calibrator_->GetBatchNum(); calib_index++) {
+  for (size_t calib_index = begin; calib_index < calibrator_->GetBatchNum(); calib_index += stride) {
     MS_LOG(INFO) << "Do inference round: " << calib_index;
     // set multi-input data
     for (auto tensor : inputs) {
@@ -633,8 +636,8 @@ int FullQuantQuantizer::DoInference(CollectType collect_type) {
       }
       return true;
     };
-    auto outputs = fp32_ms_model_->GetOutputs();
-    auto status = fp32_ms_model_->Predict(inputs, &outputs, beforeCallBack, afterCallBack);
+    auto outputs = model->GetOutputs();
+    auto status = model->Predict(inputs, &outputs, beforeCallBack, afterCallBack);
     if (status != mindspore::kSuccess) {
       MS_LOG(ERROR) << "run model failed!";
       return RET_ERROR;
@@ -643,6 +646,55 @@ int FullQuantQuantizer::DoInference(CollectType collect_type) {
   return RET_OK;
 }
 
+int FullQuantQuantizer::DoInference(CollectType collect_type) {
+  if (calibrate_models_.size() <= 1) {
+    return DoInferenceByModel(fp32_ms_model_, collect_type, 0, 1);
+  }
+  // The statistics of the data distribution don't depend on the order of batches, so that the batches are
+  // interleaved among the models.
+  auto stride = calibrate_models_.size();
+  std::vector<int> rets(stride, RET_OK);
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < stride; i++) {
+    threads.emplace_back([this, collect_type, i, stride, &rets]() {
+      rets[i] = DoInferenceByModel(calibrate_models_[i], collect_type, i, stride);
+    });
+  }
+  rets[0] = DoInferenceByModel(calibrate_models_[0], collect_type, 0, stride);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (auto ret : rets) {
+    if (ret != RET_OK) {
+      return ret;
+    }
+  }
+  return RET_OK;
+}
+
+int FullQuantQuantizer::BuildCalibrateModels(const FuncGraphPtr &func_graph) {
+  auto model_num = std::min(static_cast<size_t>(param_->fullQuantParam.calibrate_thread_num),
+                            calibrator_->GetBatchNum());
+  model_num = std::max(model_num, static_cast<size_t>(1));
+  for (size_t i = 0; i < model_num; i++) {
+    auto model = std::make_shared<mindspore::Model>();
+    if (model == nullptr) {
+      MS_LOG(ERROR) << "New model failed.";
+      return RET_ERROR;
+    }
+    calibrate_models_.push_back(model);
+  }
+  fp32_ms_model_ = calibrate_models_.front();
+  size_t size = 0;
+  auto ret = BuildModelsByFuncGraph(calibrate_models_, func_graph, param_, &size);
+  if (ret != mindspore::kSuccess) {
+    MS_LOG(ERROR) << "Build model failed.";
+    return RET_ERROR;
+  }
+  MS_LOG(INFO) << "Run the calibration with " << model_num << " models.";
+  return RET_OK;
+}
+
 int FullQuantQuantizer::DoQuantize(FuncGraphPtr func_graph) {
   MS_ASSERT(func_graph != nullptr);
   MS_LOG(INFO) << "start to parse config file";
@@ -659,16 +711,10 @@ int FullQuantQuantizer::DoQuantize(FuncGraphPtr func_graph) {
 
   // anf -- fb
   MS_LOG(INFO) << "start create session";
-  fp32_ms_model_ = std::make_shared<mindspore::Model>();
-  if (fp32_ms_model_ == nullptr) {
-    MS_LOG(ERROR) << "New model failed.";
-    return RET_ERROR;
-  }
-  size_t size = 0;
-  auto ret = BuildModelByFuncGraph(fp32_ms_model_, func_graph, param_, &size);
-  if (ret != mindspore::kSuccess) {
-    MS_LOG(ERROR) << "Build model failed.";
-    return RET_ERROR;
+  status = BuildCalibrateModels(func_graph);
+  if (status != RET_OK) {
+    MS_LOG(ERROR) << "Build calibrate models failed.";
+    return status;
   }
   MS_LOG(INFO) << "start to update divergence's max value";
   status = DoInference(MIN_MAX);
@@ -685,6 +731,9 @@ int FullQuantQuantizer::DoQuantize(FuncGraphPtr func_graph) {
     }
   }
 
+  // Only fp32_ms_model_ is used by the bias correction.
+  calibrate_models_.clear();
+
   MS_LOG(INFO) << "start to generate quant param and quantize tensor's data";
   status = QuantNode(func_graph);
   if (status != RET_OK) {
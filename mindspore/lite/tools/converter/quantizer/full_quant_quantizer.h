@@ -70,6 +70,12 @@ class FullQuantQuantizer : public Quantizer {
 
   int DoInference(CollectType collect_type);
 
+  // Run the calibration batches begin, begin + stride, ... on the model.
+  int DoInferenceByModel(const std::shared_ptr<mindspore::Model> &model, CollectType collect_type, size_t begin,
+                         size_t stride);
+
+  int BuildCalibrateModels(const FuncGraphPtr &func_graph);
+
   int UpdateDivergeInterval();
 
   int QuantNodeSimpleOp(const CNodePtr &cnode);
@@ -119,6 +125,8 @@ class FullQuantQuantizer : public Quantizer {
   std::shared_ptr<Calibrator> calibrator_{nullptr};
   std::shared_ptr<QuantStrategy> quant_strategy_{nullptr};
   std::shared_ptr<mindspore::Model> fp32_ms_model_{nullptr};
+  // The fp32 models running the calibration concurrently, the first one is fp32_ms_model_.
+  std::vector<std::shared_ptr<mindspore::Model>> calibrate_models_;
 
   // key is tensor_name
   std::map<std::string, std::vector<schema::QuantParamT>> weight_quant_params_bak_;
@@ -39,6 +39,7 @@ constexpr size_t kMaxNum1024 = 1024;
 constexpr size_t kMillisecondsBase = 10;
 constexpr float kDelta = 0.1;
 constexpr float kRatio = 10.0;
+constexpr int kNoBindMode = 0;
 constexpr int kCpuBindMode = 1;
 constexpr int kPrimIndex = 0;
 constexpr int kPrimOffset = 1;
@@ -135,6 +136,8 @@ struct FullQuantParam {
   bool bias_correction = true;
   bool per_channel = true;
   TargetDevice target_device = CPU;
+  // The number of threads running the calibration inference, each thread holds an fp32 model.
+  int calibrate_thread_num = 1;
 };
 }  // namespace mindspore::lite::quant
 
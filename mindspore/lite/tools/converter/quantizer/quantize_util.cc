@@ -24,6 +24,7 @@
 #include <set>
 #include <functional>
 #include <deque>
+#include <algorithm>
 #include "abstract/abstract_value.h"
 #include "tools/common/graph_util.h"
 #include "tools/lite_exporter/anf_exporter.h"
@@ -206,6 +207,16 @@ std::string NodePrimitiveType(const CNodePtr &cnode) {
 
 Status BuildModelByFuncGraph(const std::shared_ptr<mindspore::Model> &model, const FuncGraphPtr &func_graph,
                              const std::shared_ptr<ConverterPara> &param, size_t *size) {
+  return BuildModelsByFuncGraph({model}, func_graph, param, size);
+}
+
+Status BuildModelsByFuncGraph(const std::vector<std::shared_ptr<mindspore::Model>> &models,
+                              const FuncGraphPtr &func_graph, const std::shared_ptr<ConverterPara> &param,
+                              size_t *size) {
+  if (models.empty()) {
+    MS_LOG(ERROR) << "There is no model to build.";
+    return kLiteNullptr;
+  }
   FuncGraphPtr func_graph_clone;
   if (CloneFuncGraph(func_graph, param, &func_graph_clone) != RET_OK) {
     MS_LOG(ERROR) << "Clone func_graph failed";
@@ -247,26 +258,35 @@ Status BuildModelByFuncGraph(const std::shared_ptr<mindspore::Model> &model, con
     delete meta_graph;
     return kLiteNullptr;
   }
-  auto context = std::make_shared<mindspore::Context>();
-  if (context == nullptr) {
-    MS_LOG(ERROR) << "New context failed while running.";
-    delete meta_graph;
-    return kLiteNullptr;
-  }
-  context->SetThreadNum(kDefaultThreadNum);
-  context->SetThreadAffinity(kCpuBindMode);
-
-  std::shared_ptr<CPUDeviceInfo> device_info = std::make_shared<CPUDeviceInfo>();
-  if (device_info == nullptr) {
-    MS_LOG(ERROR) << "New device_info failed while running.";
-    delete meta_graph;
-    return kLiteNullptr;
+  // The models built from the same buffer share the cpu cores, so that each one runs with fewer threads.
+  auto thread_num = std::max(kDefaultThreadNum / static_cast<int>(models.size()), 1);
+  for (const auto &model : models) {
+    auto context = std::make_shared<mindspore::Context>();
+    if (context == nullptr) {
+      MS_LOG(ERROR) << "New context failed while running.";
+      delete meta_graph;
+      return kLiteNullptr;
+    }
+    context->SetThreadNum(thread_num);
+    context->SetThreadAffinity(models.size() > 1 ? kNoBindMode : kCpuBindMode);
+
+    std::shared_ptr<CPUDeviceInfo> device_info = std::make_shared<CPUDeviceInfo>();
+    if (device_info == nullptr) {
+      MS_LOG(ERROR) << "New device_info failed while running.";
+      delete meta_graph;
+      return kLiteNullptr;
+    }
+    auto &device_list = context->MutableDeviceInfo();
+    device_list.push_back(device_info);
+    auto ret = model->Build(content, *size, kMindIR, context);
+    if (ret != kSuccess) {
+      MS_LOG(ERROR) << "Build model failed.";
+      delete meta_graph;
+      return ret;
+    }
   }
-  auto &device_list = context->MutableDeviceInfo();
-  device_list.push_back(device_info);
-  auto ret = model->Build(content, *size, kMindIR, context);
   delete meta_graph;
-  return ret;
+  return kSuccess;
 }
 
 mindspore::lite::Tensor *MSTensorToLiteTensor(const MSTensor &tensor) {
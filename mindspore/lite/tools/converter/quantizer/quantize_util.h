@@ -88,6 +88,11 @@ std::string NodePrimitiveType(const CNodePtr &cnode);
 Status BuildModelByFuncGraph(const std::shared_ptr<mindspore::Model> &model, const FuncGraphPtr &func_graph,
                              const std::shared_ptr<mindspore::ConverterPara> &param, size_t *size);
 
+// Build the models from one flatbuffer of the func graph, the models are independent and can run concurrently.
+Status BuildModelsByFuncGraph(const std::vector<std::shared_ptr<mindspore::Model>> &models,
+                              const FuncGraphPtr &func_graph, const std::shared_ptr<mindspore::ConverterPara> &param,
+                              size_t *size);
+
 mindspore::lite::Tensor *MSTensorToLiteTensor(const mindspore::MSTensor &tensor);
 
 std::vector<mindspore::lite::Tensor *> MSTensorToLiteTensors(const std::vector<mindspore::MSTensor> &src_tensors);
@@ -20,6 +20,8 @@
 #include <deque>
 #include <string>
 #include <algorithm>
+#include <utility>
+#include <vector>
 #include "ir/anf.h"
 
 namespace mindspore {
@@ -79,11 +81,13 @@ bool LitePassManager::RunPass(const FuncGraphPtr &func_graph, size_t pass_id, co
   auto end_time = std::chrono::steady_clock::now();
   std::chrono::duration<double, std::ratio<1, kUSecondInSecond>> cost = end_time - start_time;
   MS_LOG(INFO) << "Run pass " << GetPassFullname(pass_id, pass) << " in " << cost.count() << " us.";
+  PassTimeRecorder::GetInstance()->Record(pass->name(), static_cast<uint64_t>(cost.count()));
 #else
   (void)gettimeofday(&end_time, nullptr);
   uint64_t cost = kUSecondInSecond * static_cast<uint64_t>(end_time.tv_sec - start_time.tv_sec);
   cost += static_cast<uint64_t>(end_time.tv_usec - start_time.tv_usec);
   MS_LOG(INFO) << "Run pass " << GetPassFullname(pass_id, pass) << " in " << cost << " us.";
+  PassTimeRecorder::GetInstance()->Record(pass->name(), cost);
 #endif
   return changed;
 }
@@ -128,5 +132,44 @@ bool LitePassManager::Run(const FuncGraphPtr &func_graph) const {
   }
   return changed;
 }
+
+PassTimeRecorder *PassTimeRecorder::GetInstance() {
+  static PassTimeRecorder instance;
+  return &instance;
+}
+
+void PassTimeRecorder::Record(const std::string &pass_name, uint64_t cost_us) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &pass_cost = pass_costs_[pass_name];
+  pass_cost.count++;
+  pass_cost.total_us += cost_us;
+  pass_cost.max_us = std::max(pass_cost.max_us, cost_us);
+}
+
+void PassTimeRecorder::Report() {
+  std::vector<std::pair<std::string, PassCost>> pass_costs;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pass_costs.assign(pass_costs_.begin(), pass_costs_.end());
+    pass_costs_.clear();
+  }
+  if (pass_costs.empty()) {
+    return;
+  }
+  std::stable_sort(pass_costs.begin(), pass_costs.end(),
+                   [](const auto &a, const auto &b) { return a.second.total_us > b.second.total_us; });
+  // The cost of the pass includes the cost of the passes nested in it.
+  MS_LOG(INFO) << "Pass time report of " << pass_costs.size() << " passes:";
+  for (const auto &pass_cost : pass_costs) {
+    const auto &cost = pass_cost.second;
+    MS_LOG(INFO) << "  " << pass_cost.first << ": total " << cost.total_us << " us, count " << cost.count
+                 << ", average " << cost.total_us / cost.count << " us, max " << cost.max_us << " us.";
+  }
+}
+
+PassTimeGuard::~PassTimeGuard() {
+  auto cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time_);
+  PassTimeRecorder::GetInstance()->Record(pass_name_, static_cast<uint64_t>(cost.count()));
+}
 }  // namespace opt
 }  // namespace mindspore
@@ -16,7 +16,10 @@
 #ifndef MINDSPORE_LITE_TOOLS_OPTIMIZER_COMMON_PASS_MANAGER_EXTENDS_H_
 #define MINDSPORE_LITE_TOOLS_OPTIMIZER_COMMON_PASS_MANAGER_EXTENDS_H_
 
+#include <chrono>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "backend/common/optimizer/pass_manager.h"
@@ -36,6 +39,41 @@ class LitePassManager : public PassManager {
   bool RunPass(const FuncGraphPtr &func_graph, size_t pass_id, const PassPtr &pass) const override;
   std::string GetPassFullname(size_t pass_id, const PassPtr &pass) const override;
 };
+
+// The cost of the passes run in the conversion, keyed by the pass name. The report lists the passes in the descending
+// order of total cost, so that the slow passes and the regressions of passes are visible.
+class PassTimeRecorder {
+ public:
+  static PassTimeRecorder *GetInstance();
+  ~PassTimeRecorder() = default;
+
+  void Record(const std::string &pass_name, uint64_t cost_us);
+  // Log the report and clear the records.
+  void Report();
+
+ private:
+  PassTimeRecorder() = default;
+  struct PassCost {
+    size_t count = 0;
+    uint64_t total_us = 0;
+    uint64_t max_us = 0;
+  };
+
+  std::mutex mutex_;
+  std::map<std::string, PassCost> pass_costs_;
+};
+
+// Record the cost of the scope as a pass.
+class PassTimeGuard {
+ public:
+  explicit PassTimeGuard(const std::string &pass_name)
+      : pass_name_(pass_name), start_time_(std::chrono::steady_clock::now()) {}
+  ~PassTimeGuard();
+
+ private:
+  std::string pass_name_;
+  std::chrono::steady_clock::time_point start_time_;
+};
 }  // namespace opt
 }  // namespace mindspore
 #endif  // MINDSPORE_LITE_TOOLS_OPTIMIZER_COMMON_PASS_MANAGER_EXTENDS_H_
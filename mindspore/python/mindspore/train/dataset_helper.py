@@ -15,6 +15,7 @@
 """Dataset help for minddata dataset"""
 from __future__ import absolute_import
 
+import os
 import math
 
 from mindspore._checkparam import Validator
@@ -31,6 +32,15 @@ from mindspore.parallel._ps_context import _is_role_sched
 from mindspore.ops import operations as P
 
 
+def _is_cpu_dataset_sink():
+    """
+    Whether the dataset sink mode is enabled on CPU by the env MS_DEV_CPU_DATASET_SINK. In this mode, the data is pulled
+    from the CPU data queue by GetNext and the network loops sink_size steps in one launch.
+    """
+    return context.get_context("device_target") == "CPU" and context.get_context("mode") == context.GRAPH_MODE and \
+        os.getenv("MS_DEV_CPU_DATASET_SINK") == "1"
+
+
 def _send_data(dataset, epoch_num):
     """Engine dataset to write data to tdt queue."""
     if not hasattr(dataset, '__has_sent__'):
@@ -253,7 +263,8 @@ def connect_network_with_dataset(network, dataset_helper):
     if hasattr(aux, '__sink_network__'):
         network = aux.__sink_network__
     else:
-        if not context.get_context("enable_ge") and context.get_context("device_target") in ("Ascend", "GPU"):
+        if not context.get_context("enable_ge") and \
+                (context.get_context("device_target") in ("Ascend", "GPU") or _is_cpu_dataset_sink()):
             network = offload.check_add_offload_sink_mode(
                 dataset, dataset_helper, network)
             network = _generate_network_with_dataset(
@@ -323,7 +334,7 @@ class DatasetHelper:
                     if _is_role_sched():
                         iterclass = _DatasetIterPSServer
                     elif (context.get_context("device_target") == "Ascend") or \
-                         (context.get_context("device_target") == "GPU"):
+                         (context.get_context("device_target") == "GPU") or _is_cpu_dataset_sink():
                         iterclass = _DatasetIterMSLoopSink
                     else:
                         target = context.get_context("device_target")
@@ -476,7 +487,7 @@ class _DatasetIter:
             sink_size = self.dataset.__loop_size__
         else:
             if context.get_context("enable_ge") or context.get_context("device_target") == "Ascend" \
-                    or context.get_context("device_target") == "GPU":
+                    or context.get_context("device_target") == "GPU" or _is_cpu_dataset_sink():
                 if self.sink_size > 0:
                     sink_size = self.sink_size
                 else:
@@ -43,7 +43,7 @@ from mindspore import nn
 from mindspore.boost import AutoBoost
 from mindspore.context import ParallelMode
 from mindspore.parallel._recovery_context import _set_recovery_context, _get_recovery_context
-from mindspore.train.dataset_helper import DatasetHelper, connect_network_with_dataset
+from mindspore.train.dataset_helper import DatasetHelper, connect_network_with_dataset, _is_cpu_dataset_sink
 from mindspore.common.api import _pynative_executor
 from mindspore.dataset.engine.datasets import _set_training_dataset, _reset_training_dataset
 from mindspore.train import amp
@@ -605,7 +605,7 @@ class Model:
             self._check_reuse_dataset(train_dataset)
             if not dataset_sink_mode:
                 self._train_process(epoch, train_dataset, list_callback, cb_params, initial_epoch, valid_infos)
-            elif context.get_context("device_target") == "CPU":
+            elif context.get_context("device_target") == "CPU" and not _is_cpu_dataset_sink():
                 logger.info("The CPU cannot support dataset sink mode currently."
                             "So the training process will be performed with dataset not sink.")
                 self._train_process(epoch, train_dataset, list_callback, cb_params, initial_epoch, valid_infos)
@@ -1251,7 +1251,7 @@ class Model:
 
         self._clear_metrics()
 
-        if context.get_context("device_target") == "CPU" and dataset_sink_mode:
+        if context.get_context("device_target") == "CPU" and dataset_sink_mode and not _is_cpu_dataset_sink():
             dataset_sink_mode = False
             logger.info("CPU cannot support dataset sink mode currently."
                         "So the evaluating process will be performed with dataset non-sink mode.")
@@ -1423,7 +1423,7 @@ class Model:
             cb_params.metrics = metrics
             return metrics
 
-        if context.get_context("device_target") == "CPU" and dataset_sink_mode:
+        if context.get_context("device_target") == "CPU" and dataset_sink_mode and not _is_cpu_dataset_sink():
             dataset_sink_mode = False
             logger.info("CPU cannot support dataset sink mode currently."
                         "So the evaluating process will be performed with dataset non-sink mode.")
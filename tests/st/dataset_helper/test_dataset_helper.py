@@ -17,7 +17,9 @@
 import pytest
 import numpy as np
 import mindspore.context as context
-from mindspore.train.dataset_helper import DatasetHelper
+import mindspore.dataset as ds
+from mindspore import nn, ops, Parameter, Tensor
+from mindspore.train.dataset_helper import DatasetHelper, connect_network_with_dataset
 from ...dataset_mock import MindData
 
 def get_dataset(batch_size=1):
@@ -46,3 +48,72 @@ def test_dataset_iter_ms_loop_sink():
             count += 1
             assert inputs == tuple()
     assert count == 2
+
+
+@pytest.mark.skipif('context.get_context("enable_ge")')
+def test_dataset_iter_ms_loop_sink_cpu(monkeypatch):
+    """
+    Feature: Dataset iter loop sink on CPU.
+    Description: Test dataset iter loop sink with the env MS_DEV_CPU_DATASET_SINK on CPU.
+    Expectation: Dataset loop sink succeeds and the sink size is used as the loop count.
+    """
+    monkeypatch.setenv("MS_DEV_CPU_DATASET_SINK", "1")
+    context.set_context(device_target='CPU', mode=context.GRAPH_MODE)
+    dataset = get_dataset(32)
+    dataset_helper = DatasetHelper(dataset, dataset_sink_mode=True, sink_size=10)
+    assert dataset_helper.sink_size() == 10
+    count = 0
+    for _ in range(2):
+        for inputs in dataset_helper:
+            count += 1
+            assert inputs == tuple()
+    assert count == 2
+
+
+class AccumulateNet(nn.Cell):
+    """Accumulate the sunk batches and record the last one."""
+    def __init__(self, shape):
+        super(AccumulateNet, self).__init__()
+        self.total = Parameter(Tensor(np.zeros(shape, np.float32)), name="total")
+        self.last = Parameter(Tensor(np.zeros(shape, np.float32)), name="last")
+        self.assign_add = ops.AssignAdd()
+        self.assign = ops.Assign()
+
+    def construct(self, x):
+        self.assign_add(self.total, x)
+        self.assign(self.last, x)
+        return self.total
+
+
+@pytest.mark.level1
+@pytest.mark.platform_x86_cpu
+@pytest.mark.env_onecard
+def test_dataset_sink_values_cpu(monkeypatch):
+    """
+    Feature: Dataset sink mode on CPU.
+    Description: Sink 8 batches with sink size 4, each launch runs 4 steps of the network which accumulates the batches.
+    Expectation: The batches are consumed in order, and the accumulated values are right at each sink boundary.
+    """
+    monkeypatch.setenv("MS_DEV_CPU_DATASET_SINK", "1")
+    context.set_context(device_target='CPU', mode=context.GRAPH_MODE)
+    shape = (2, 3)
+    batch_num = 8
+    sink_size = 4
+
+    def generator():
+        for i in range(batch_num):
+            yield (np.full(shape, i, np.float32),)
+
+    dataset = ds.GeneratorDataset(generator, ["data"], shuffle=False)
+    dataset_helper = DatasetHelper(dataset, dataset_sink_mode=True, sink_size=sink_size)
+    net = AccumulateNet(shape)
+    sink_net = connect_network_with_dataset(net, dataset_helper)
+    launch_count = 0
+    for inputs in dataset_helper:
+        sink_net(*inputs)
+        launch_count += 1
+        last_batch = launch_count * sink_size - 1
+        expect_total = np.full(shape, sum(range(last_batch + 1)), np.float32)
+        assert np.allclose(net.total.asnumpy(), expect_total)
+        assert np.allclose(net.last.asnumpy(), np.full(shape, last_batch, np.float32))
+    assert launch_count == batch_num // sink_size
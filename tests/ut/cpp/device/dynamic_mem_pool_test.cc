@@ -0,0 +1,426 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include "common/common_test.h"
+#include "common/mem_reuse/mem_dynamic_allocator.h"
+#include "common/mem_reuse/mem_pool_trace.h"
+
+namespace mindspore::device {
+namespace {
+constexpr size_t kTestPoolSize = 1 << 30;
+constexpr size_t kTraceThreadNum = 4;
+constexpr size_t kTraceLength = 20000;
+
+// The memory pool on the host memory for testing.
+class TestMemPool : public DynamicMemPoolBestFit {
+ public:
+  TestMemPool() = default;
+  ~TestMemPool() override {
+    ReleaseDeviceRes();
+    for (auto addr : addrs_) {
+      free(addr);
+    }
+  }
+
+  size_t AllocDeviceMem(size_t size, DeviceMemPtr *addr) override {
+    if (allocated_size_ + size > kTestPoolSize) {
+      return 0;
+    }
+    *addr = malloc(size);
+    if (*addr == nullptr) {
+      return 0;
+    }
+    (void)addrs_.emplace_back(*addr);
+    allocated_size_ += size;
+    return size;
+  }
+  bool FreeDeviceMem(const DeviceMemPtr &addr) override { return true; }
+  size_t free_mem_size() override { return kTestPoolSize - allocated_size_; }
+  bool CopyDeviceMem(const DeviceMemPtr &dst, const DeviceMemPtr &src, size_t size) override {
+    (void)memmove(dst, src, size);
+    return true;
+  }
+
+ private:
+  size_t allocated_size_{0};
+  std::vector<DeviceMemPtr> addrs_;
+};
+
+// One event of allocation trace: allocate the size with the id when is_alloc is true, otherwise free the id.
+struct TraceEvent {
+  bool is_alloc;
+  size_t id;
+  size_t size;
+};
+
+// Generate the trace like the actor execution: most allocations are small and live shortly, and a few large ones live
+// long.
+std::vector<TraceEvent> GenerateTrace(size_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<size_t> small_size(1, 32 << 10);
+  std::uniform_int_distribution<size_t> large_size(1 << 20, 8 << 20);
+  std::uniform_int_distribution<size_t> percent(0, 99);
+  std::vector<TraceEvent> trace;
+  std::vector<size_t> live_ids;
+  for (size_t id = 0; id < kTraceLength; ++id) {
+    auto size = percent(gen) < 95 ? small_size(gen) : large_size(gen);
+    trace.push_back({true, id, size});
+    live_ids.push_back(id);
+    if (live_ids.size() > 64 || percent(gen) < 50) {
+      auto index = percent(gen) % live_ids.size();
+      trace.push_back({false, live_ids[index], 0});
+      live_ids.erase(live_ids.begin() + index);
+    }
+  }
+  for (auto id : live_ids) {
+    trace.push_back({false, id, 0});
+  }
+  return trace;
+}
+
+void ReplayTrace(DynamicMemPoolBestFit *pool, const std::vector<TraceEvent> &trace, size_t *peak_used) {
+  std::map<size_t, DeviceMemPtr> addrs;
+  for (const auto &event : trace) {
+    if (event.is_alloc) {
+      auto addr = pool->AllocTensorMem(event.size);
+      ASSERT_NE(addr, nullptr);
+      addrs[event.id] = addr;
+      *peak_used = std::max(*peak_used, pool->TotalUsedMemStatistics());
+    } else {
+      pool->FreeTensorMem(addrs[event.id]);
+      (void)addrs.erase(event.id);
+    }
+  }
+}
+
+// Replay the traces in the threads.
+void ReplayTraces(DynamicMemPoolBestFit *pool, const std::vector<std::vector<TraceEvent>> &traces, size_t *peak_used) {
+  std::vector<size_t> peak_useds(traces.size(), 0);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < traces.size(); ++i) {
+    threads.emplace_back([pool, &traces, &peak_useds, i]() { ReplayTrace(pool, traces[i], &peak_useds[i]); });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  *peak_used = *std::max_element(peak_useds.begin(), peak_useds.end());
+}
+}  // namespace
+
+class TestDynamicMemPool : public UT::Common {
+ public:
+  TestDynamicMemPool() {}
+};
+
+/// Feature: the segregated-fit index of idle memory bufs.
+/// Description: insert the idle memory bufs of different size classes, pop the best fit and erase.
+/// Expectation: the smallest memory buf not less than the required size is popped.
+TEST_F(TestDynamicMemPool, test_idle_mem_buf_index_best_fit) {
+  IdleMemBufIndex index;
+  std::vector<uint8_t> buffer(1 << 20);
+  std::vector<size_t> sizes = {512, 1024, 4096, 40960, 65536, 1 << 20};
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    index.Insert(std::make_shared<DynamicMemBuf>(buffer.data() + i, DynamicMemBufStatus::kMemBufIdle, sizes[i]));
+  }
+  ASSERT_EQ(index.size(), sizes.size());
+
+  auto mem_buf = index.PopBestFit(1536);
+  ASSERT_NE(mem_buf, nullptr);
+  ASSERT_EQ(mem_buf->size_, 4096);
+  mem_buf = index.PopBestFit(40448);
+  ASSERT_NE(mem_buf, nullptr);
+  ASSERT_EQ(mem_buf->size_, 40960);
+  ASSERT_EQ(index.PopBestFit(2 << 20), nullptr);
+
+  ASSERT_FALSE(index.Erase(65536, buffer.data()));
+  ASSERT_TRUE(index.Erase(65536, buffer.data() + 4));
+  mem_buf = index.PopBestFit(50000);
+  ASSERT_NE(mem_buf, nullptr);
+  ASSERT_EQ(mem_buf->size_, 1 << 20);
+  ASSERT_EQ(index.size(), 2);
+  index.clear();
+  ASSERT_TRUE(index.empty());
+  ASSERT_EQ(index.PopBestFit(512), nullptr);
+}
+
+/// Feature: the thread cache of memory pool.
+/// Description: free the small memory and allocate the same size class in the thread, and free the memory twice.
+/// Expectation: the cached memory is reused, and the double free throws the exception.
+TEST_F(TestDynamicMemPool, test_thread_cache_reuse) {
+  TestMemPool pool;
+  pool.set_enable_thread_cache(true);
+  auto addr = pool.AllocTensorMem(1000);
+  ASSERT_NE(addr, nullptr);
+  auto used_size = pool.TotalUsedMemStatistics();
+  pool.FreeTensorMem(addr);
+  // The cached memory is still in use of the memory pool.
+  ASSERT_EQ(pool.TotalUsedMemStatistics(), used_size);
+  ASSERT_ANY_THROW(pool.FreeTensorMem(addr));
+  ASSERT_EQ(pool.AllocTensorMem(900), addr);
+  pool.FreeTensorMem(addr);
+
+  pool.FlushThreadCaches();
+  ASSERT_EQ(pool.TotalUsedMemStatistics(), 0);
+  auto large_addr = pool.AllocTensorMem(1 << 20);
+  ASSERT_NE(large_addr, nullptr);
+  pool.FreeTensorMem(large_addr);
+  ASSERT_EQ(pool.TotalUsedMemStatistics(), 0);
+}
+
+/// Feature: the thread cache of memory pool.
+/// Description: free the memory of 32K and allocate the larger memory of 36352 bytes which is in the same size class.
+/// Expectation: the memory of 32K isn't reused for the larger memory, and the memory of the exact small size class is
+/// still reused.
+TEST_F(TestDynamicMemPool, test_thread_cache_exact_size) {
+  constexpr size_t kCachedSize = 32768;
+  constexpr size_t kLargerSize = 36352;
+  TestMemPool pool;
+  pool.set_enable_thread_cache(true);
+  auto addr = pool.AllocTensorMem(kCachedSize);
+  ASSERT_NE(addr, nullptr);
+  // The neighbour memory buf is in use, so the memory after the 32K memory can't be written by the larger memory.
+  auto neighbour_addr = pool.AllocTensorMem(kCachedSize);
+  ASSERT_NE(neighbour_addr, nullptr);
+  pool.FreeTensorMem(addr);
+  auto larger_addr = pool.AllocTensorMem(kLargerSize);
+  ASSERT_NE(larger_addr, nullptr);
+  auto larger_begin = static_cast<uint8_t *>(larger_addr);
+  auto neighbour_begin = static_cast<uint8_t *>(neighbour_addr);
+  ASSERT_TRUE((neighbour_begin + kCachedSize <= larger_begin) || (larger_begin + kLargerSize <= neighbour_begin));
+  pool.FreeTensorMem(larger_addr);
+  pool.FreeTensorMem(neighbour_addr);
+
+  constexpr size_t kSmallSize = kCachedSize - DYNAMIC_MEM_ALIGN_SIZE;
+  auto small_addr = pool.AllocTensorMem(kSmallSize);
+  ASSERT_NE(small_addr, nullptr);
+  pool.FreeTensorMem(small_addr);
+  ASSERT_EQ(pool.AllocTensorMem(kSmallSize), small_addr);
+  pool.FreeTensorMem(small_addr);
+  pool.FlushThreadCaches();
+  ASSERT_EQ(pool.TotalUsedMemStatistics(), 0);
+}
+
+/// Feature: the fragmentation of memory pool.
+/// Description: replay the allocation traces in the threads with the thread cache disabled and enabled.
+/// Expectation: all the allocations succeed and all the memory is returned after replaying.
+TEST_F(TestDynamicMemPool, test_replay_trace) {
+  std::vector<std::vector<TraceEvent>> traces;
+  for (size_t i = 0; i < kTraceThreadNum; ++i) {
+    (void)traces.emplace_back(GenerateTrace(i));
+  }
+  for (bool enable_thread_cache : {false, true}) {
+    TestMemPool pool;
+    pool.set_enable_thread_cache(enable_thread_cache);
+    size_t peak_used = 0;
+    ReplayTraces(&pool, traces, &peak_used);
+    pool.FlushThreadCaches();
+    ASSERT_GT(peak_used, 0);
+    ASSERT_EQ(pool.TotalUsedMemStatistics(), 0);
+  }
+
+  // The segregated-fit index pops the same sizes as the multimap of idle memory bufs.
+  std::vector<uint8_t> buffer(1);
+  IdleMemBufIndex index;
+  SizeMapMemBuf size_map;
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<size_t> size_dist(1, 1 << 16);
+  std::vector<size_t> sizes;
+  for (size_t i = 0; i < kTraceLength; ++i) {
+    sizes.push_back(size_dist(gen) * DYNAMIC_MEM_ALIGN_SIZE);
+  }
+  for (auto size : sizes) {
+    index.Insert(std::make_shared<DynamicMemBuf>(buffer.data(), DynamicMemBufStatus::kMemBufIdle, size));
+    auto mem_buf = std::make_shared<DynamicMemBuf>(buffer.data(), DynamicMemBufStatus::kMemBufIdle, size);
+    (void)size_map.emplace(size, mem_buf);
+  }
+  for (auto size : sizes) {
+    auto mem_buf = index.PopBestFit(size / 2);
+    ASSERT_NE(mem_buf, nullptr);
+    auto iter = size_map.lower_bound(size / 2);
+    ASSERT_NE(iter, size_map.end());
+    ASSERT_EQ(mem_buf->size_, iter->first);
+    (void)size_map.erase(iter);
+  }
+  ASSERT_TRUE(index.empty());
+}
+
+/// Feature: the throughput benchmark of memory pool.
+/// Description: replay the allocation traces in the threads with the thread cache disabled and enabled, and pop the
+/// best fit from the segregated-fit index and the multimap of idle memory bufs.
+/// Expectation: all the allocations succeed. It is disabled by default, run it with --gtest_also_run_disabled_tests to
+/// print the cost.
+TEST_F(TestDynamicMemPool, DISABLED_test_replay_trace_benchmark) {
+  std::vector<std::vector<TraceEvent>> traces;
+  size_t event_num = 0;
+  for (size_t i = 0; i < kTraceThreadNum; ++i) {
+    (void)traces.emplace_back(GenerateTrace(i));
+    event_num += traces.back().size();
+  }
+  for (bool enable_thread_cache : {false, true}) {
+    TestMemPool pool;
+    pool.set_enable_thread_cache(enable_thread_cache);
+    size_t peak_used = 0;
+    auto start = std::chrono::steady_clock::now();
+    ReplayTraces(&pool, traces, &peak_used);
+    auto end = std::chrono::steady_clock::now();
+    pool.FlushThreadCaches();
+    ASSERT_EQ(pool.TotalUsedMemStatistics(), 0);
+    MS_LOG(WARNING) << "Replay trace with thread cache " << enable_thread_cache << ", events:" << event_num
+                    << ", cost:" << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+                    << "us, peak total mem:" << pool.TotalMemStatistics() << "B, peak used mem:" << peak_used << "B.";
+  }
+
+  std::vector<uint8_t> buffer(1);
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<size_t> size_dist(1, 1 << 16);
+  std::vector<size_t> sizes;
+  for (size_t i = 0; i < kTraceLength; ++i) {
+    sizes.push_back(size_dist(gen) * DYNAMIC_MEM_ALIGN_SIZE);
+  }
+  auto run = [&sizes, &buffer](const std::string &name, auto &&insert, auto &&pop) {
+    auto start = std::chrono::steady_clock::now();
+    for (auto size : sizes) {
+      insert(std::make_shared<DynamicMemBuf>(buffer.data(), DynamicMemBufStatus::kMemBufIdle, size));
+    }
+    for (auto size : sizes) {
+      ASSERT_NE(pop(size / 2), nullptr);
+    }
+    auto end = std::chrono::steady_clock::now();
+    MS_LOG(WARNING) << "Best fit of " << name << ", cost:"
+                    << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << "us.";
+  };
+  IdleMemBufIndex index;
+  run(
+    "segregated-fit index", [&index](const DynamicMemBufPtr &mem_buf) { index.Insert(mem_buf); },
+    [&index](size_t size) { return index.PopBestFit(size); });
+  SizeMapMemBuf size_map;
+  run(
+    "multimap", [&size_map](const DynamicMemBufPtr &mem_buf) { (void)size_map.emplace(mem_buf->size_, mem_buf); },
+    [&size_map](size_t size) -> DynamicMemBufPtr {
+      auto iter = size_map.lower_bound(size);
+      if (iter == size_map.end()) {
+        return nullptr;
+      }
+      auto mem_buf = iter->second;
+      (void)size_map.erase(iter);
+      return mem_buf;
+    });
+}
+
+/// Feature: the trace of memory pool.
+/// Description: record the memory alloc and free of memory pool to the trace file, load and replay the trace.
+/// Expectation: the trace records the operations in order and the replay reproduces the peak memory.
+TEST_F(TestDynamicMemPool, test_record_and_replay_trace) {
+  const std::string trace_path = "./mem_pool_trace_test.bin";
+  size_t peak_used = 0;
+  {
+    TestMemPool pool;
+    pool.set_trace_writer(std::make_shared<MemPoolTraceWriter>(trace_path));
+    DynamicMemAllocatorDebugInfo::SetDebugInfo("test", AllocatorType::kWeight);
+    auto weight_addr = pool.AllocTensorMem(1000, true);
+    DynamicMemAllocatorDebugInfo::SetDebugInfo("test", AllocatorType::kKernelOutput);
+    auto addr_list = pool.AllocContinuousTensorMem({1024, 2048});
+    ASSERT_EQ(addr_list.size(), 2);
+    peak_used = pool.TotalUsedMemStatistics();
+    pool.FreeTensorMem(addr_list[0]);
+    pool.FreeTensorMem(addr_list[1]);
+    pool.FreeTensorMem(weight_addr);
+    pool.trace_writer()->Flush();
+  }
+
+  std::vector<MemPoolTraceRecord> records;
+  ASSERT_TRUE(LoadMemPoolTrace(trace_path, &records));
+  ASSERT_EQ(records.size(), 6);
+  ASSERT_EQ(records[0].op_, MemPoolTraceOp::kAlloc);
+  ASSERT_EQ(records[0].size_, 1000);
+  ASSERT_EQ(records[0].from_persistent_mem_, 1);
+  ASSERT_EQ(records[0].allocator_type_, static_cast<uint8_t>(AllocatorType::kWeight));
+  ASSERT_EQ(records[1].op_, MemPoolTraceOp::kAllocContinuous);
+  ASSERT_EQ(records[1].group_size_, 2);
+  ASSERT_EQ(records[2].size_, 2048);
+  ASSERT_EQ(records[2].allocator_type_, static_cast<uint8_t>(AllocatorType::kKernelOutput));
+  ASSERT_EQ(records[3].op_, MemPoolTraceOp::kFree);
+  ASSERT_EQ(records[3].addr_, records[1].addr_);
+  ASSERT_LE(records[0].timestamp_, records[5].timestamp_);
+
+  TestMemPool replay_pool;
+  auto result = ReplayMemPoolTrace(records, &replay_pool);
+  ASSERT_EQ(result.op_num_, 6);
+  ASSERT_EQ(result.trace_failed_num_, 0);
+  ASSERT_EQ(result.replay_failed_num_, 0);
+  ASSERT_EQ(result.peak_used_mem_, peak_used);
+  ASSERT_EQ(replay_pool.TotalUsedMemStatistics(), 0);
+  (void)remove(trace_path.c_str());
+}
+
+/// Feature: the compaction of memory pool.
+/// Description: free every other memory buf of the memory block, and compact the memory pool.
+/// Expectation: the used memory bufs are moved to the low address with the data, and the idle memory is merged.
+TEST_F(TestDynamicMemPool, test_compact_mem_bufs) {
+  constexpr size_t kBlockSize = 4 << 20;
+  constexpr size_t kBufSize = 512 << 10;
+  constexpr size_t kBufNum = kBlockSize / kBufSize;
+  TestMemPool pool;
+  pool.SetMemAllocUintSize(kBlockSize, kBlockSize);
+  std::vector<DeviceMemPtr> addrs;
+  for (size_t i = 0; i < kBufNum; ++i) {
+    auto addr = pool.AllocTensorMem(kBufSize);
+    ASSERT_NE(addr, nullptr);
+    (void)memset(addr, static_cast<int>(i), kBufSize);
+    addrs.push_back(addr);
+  }
+  ASSERT_EQ(pool.TotalMemStatistics(), kBlockSize);
+  for (size_t i = 0; i < kBufNum; i += 2) {
+    pool.FreeTensorMem(addrs[i]);
+  }
+  ASSERT_GT(pool.FragmentationRatio(), 0.5);
+  auto all_movable = [](const DeviceMemPtr &) { return true; };
+  ASSERT_TRUE(pool.CompactMemBufs(0.9, all_movable).empty());
+
+  auto relocations = pool.CompactMemBufs(0.5, all_movable);
+  ASSERT_EQ(relocations.size(), kBufNum / 2);
+  ASSERT_EQ(pool.FragmentationRatio(), 0);
+  for (size_t i = 1; i < kBufNum; i += 2) {
+    auto iter = relocations.find(addrs[i]);
+    ASSERT_NE(iter, relocations.end());
+    auto data = static_cast<uint8_t *>(iter->second);
+    ASSERT_EQ(data[0], i);
+    ASSERT_EQ(data[kBufSize - 1], i);
+    addrs[i] = iter->second;
+  }
+
+  // The continuous memory of the merged idle memory is allocated from the same memory block.
+  auto addr_list = pool.AllocContinuousTensorMem({kBufSize, kBufSize, kBufSize});
+  ASSERT_EQ(addr_list.size(), 3);
+  ASSERT_EQ(pool.TotalMemStatistics(), kBlockSize);
+  for (auto addr : addr_list) {
+    pool.FreeTensorMem(addr);
+  }
+  for (size_t i = 1; i < kBufNum; i += 2) {
+    pool.FreeTensorMem(addrs[i]);
+  }
+  ASSERT_EQ(pool.TotalUsedMemStatistics(), 0);
+}
+}  // namespace mindspore::device
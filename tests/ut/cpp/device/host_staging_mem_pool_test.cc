@@ -0,0 +1,93 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "common/common_test.h"
+#include "runtime/device/host_staging_mem_pool.h"
+
+namespace mindspore {
+namespace device {
+class TestHostStagingMemPool : public UT::Common {
+ public:
+  TestHostStagingMemPool() {}
+};
+
+/// Feature: host staging memory pool.
+/// Description: get the block size of the sizes in the different size classes.
+/// Expectation: the size is rounded up to the page size or the quarter of its power of two.
+TEST_F(TestHostStagingMemPool, test_block_size) {
+  ASSERT_EQ(HostStagingMemPool::GetBlockSize(1), 4096);
+  ASSERT_EQ(HostStagingMemPool::GetBlockSize(4096), 4096);
+  ASSERT_EQ(HostStagingMemPool::GetBlockSize(4097), 8192);
+  ASSERT_EQ(HostStagingMemPool::GetBlockSize(1UL << 20), 1UL << 20);
+  ASSERT_EQ(HostStagingMemPool::GetBlockSize((1UL << 20) + 1), (1UL << 20) + (1UL << 18));
+  ASSERT_EQ(HostStagingMemPool::GetBlockSize(3UL << 20), 3UL << 20);
+}
+
+/// Feature: host staging memory pool.
+/// Description: malloc, free and malloc the memory of the same size class again.
+/// Expectation: the memory freed is reused and the statistics count the used and cached memory.
+TEST_F(TestHostStagingMemPool, test_reuse_cached_mem) {
+  const auto &pool = HostStagingMemPool::GetInstance();
+  pool->ReleaseCachedMem();
+  const auto origin_statistics = pool->GetStatistics();
+  constexpr size_t kMemSize = (1UL << 20) + 100;
+  auto ptr = pool->Malloc(kMemSize);
+  ASSERT_NE(ptr, nullptr);
+  auto statistics = pool->GetStatistics();
+  ASSERT_EQ(statistics.used_size_ - origin_statistics.used_size_, HostStagingMemPool::GetBlockSize(kMemSize));
+
+  pool->Free(ptr);
+  statistics = pool->GetStatistics();
+  ASSERT_EQ(statistics.used_size_, origin_statistics.used_size_);
+  ASSERT_EQ(statistics.cached_size_, HostStagingMemPool::GetBlockSize(kMemSize));
+
+  {
+    auto shared_ptr = pool->MallocShared(kMemSize + 100);
+    ASSERT_EQ(shared_ptr.get(), ptr);
+    ASSERT_EQ(pool->GetStatistics().reuse_count_, origin_statistics.reuse_count_ + 1);
+  }
+  ASSERT_EQ(pool->GetStatistics().cached_size_, HostStagingMemPool::GetBlockSize(kMemSize));
+  ASSERT_ANY_THROW(pool->Free(ptr));
+
+  pool->ReleaseCachedMem();
+  statistics = pool->GetStatistics();
+  ASSERT_EQ(statistics.cached_size_, 0);
+  ASSERT_EQ(statistics.total_size_, origin_statistics.total_size_);
+}
+
+/// Feature: host staging memory pool.
+/// Description: write the memory, free it and malloc it again with and without zero fill.
+/// Expectation: the memory reused with zero fill is zero.
+TEST_F(TestHostStagingMemPool, test_zero_fill_cached_mem) {
+  const auto &pool = HostStagingMemPool::GetInstance();
+  pool->ReleaseCachedMem();
+  constexpr size_t kMemSize = 10000;
+  auto ptr = static_cast<uint8_t *>(pool->Malloc(kMemSize));
+  ASSERT_NE(ptr, nullptr);
+  ASSERT_TRUE(std::all_of(ptr, ptr + kMemSize, [](uint8_t value) { return value == 0; }));
+  (void)memset(ptr, 1, kMemSize);
+  pool->Free(ptr);
+
+  auto zero_ptr = static_cast<uint8_t *>(pool->Malloc(kMemSize, true));
+  ASSERT_EQ(zero_ptr, ptr);
+  ASSERT_TRUE(std::all_of(zero_ptr, zero_ptr + kMemSize, [](uint8_t value) { return value == 0; }));
+  pool->Free(zero_ptr);
+  pool->ReleaseCachedMem();
+}
+}  // namespace device
+}  // namespace mindspore
@@ -14,10 +14,17 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
 #include <vector>
 #include <map>
+#include <unistd.h>
 #include "common/common_test.h"
+#define private public
 #include "runtime/device/memory_scheduler.h"
+#undef private
 namespace mindspore::device {
 constexpr size_t kDeviceMemSize = 5;
 constexpr size_t kMaxVirtualCount = 1024;
@@ -81,7 +88,24 @@ class TestMemScheduler : public UT::Common {
  public:
   TestMemScheduler() {}
 
+  void TearDown() override {
+    if (!disk_path_.empty()) {
+      (void)rmdir(disk_path_.c_str());
+      disk_path_.clear();
+    }
+  }
+
  protected:
+  // The offload files are unlinked once created, so the directory is empty and removed at tear down.
+  const std::string &CreateDiskPath() {
+    char disk_path[] = "/tmp/offload_disk_test_XXXXXX";
+    if (mkdtemp(disk_path) != nullptr) {
+      disk_path_ = disk_path;
+    }
+    return disk_path_;
+  }
+
+  std::string disk_path_;
   size_t used_tensor_num_{1};
   size_t total_step_{1};
   std::vector<uint8_t> tensor_keys_;
@@ -283,4 +307,145 @@ scheduler->Optimize();
 // run
 Run(scheduler);
 }
-}  // namespace mindspore::device
\ No newline at end of file
+
+/// Feature: OffloadedMemPool
+/// Description: set the offload disk path without host memory limit, malloc, write, free and prefetch host memory
+/// Expectation: the host memory is backed by file, keeps the written data and is reused and zero filled after free
+TEST_F(TestMemScheduler, test_file_backed_offloaded_mem_pool) {
+  const auto &disk_path = CreateDiskPath();
+  ASSERT_FALSE(disk_path.empty());
+  (void)setenv("MS_DEV_OFFLOAD_DISK_PATH", disk_path.c_str(), 1);
+  OffloadedMemPool mem_pool;
+  (void)unsetenv("MS_DEV_OFFLOAD_DISK_PATH");
+  ASSERT_TRUE(mem_pool.enable_file_backed_mem());
+
+  constexpr size_t kMemSize = 10000;
+  auto ptr = static_cast<uint8_t *>(mem_pool.MallocHost(kMemSize));
+  ASSERT_NE(ptr, nullptr);
+  (void)memset(ptr, 1, kMemSize);
+  auto other_ptr = static_cast<uint8_t *>(mem_pool.MallocHost(kMemSize));
+  ASSERT_NE(other_ptr, nullptr);
+  ASSERT_NE(other_ptr, ptr);
+  mem_pool.Prefetch(ptr);
+  ASSERT_EQ(ptr[kMemSize - 1], 1);
+  mem_pool.FreeHost(ptr);
+  // The memory reused is zero filled.
+  ASSERT_EQ(mem_pool.MallocHost(kMemSize), ptr);
+  ASSERT_EQ(ptr[0], 0);
+  ASSERT_EQ(ptr[kMemSize - 1], 0);
+}
+
+/// Feature: MemScheduler
+/// Description: Test MemScheduler with the offloaded data backed by file
+/// Expectation: MemScheduler GetOrMalloc return valid ptr, and the data is prefetched ahead of each swap in
+TEST_F(TestMemScheduler, test_mem_scheduler_with_file_backed_host_mem) {
+  MemSchedulerManager mem_scheduler_manager;
+  auto scheduler = mem_scheduler_manager.GetOrCreateMemScheduler(0);
+  ASSERT_NE(scheduler, nullptr);
+  const auto &disk_path = CreateDiskPath();
+  ASSERT_FALSE(disk_path.empty());
+  (void)setenv("MS_DEV_OFFLOAD_DISK_PATH", disk_path.c_str(), 1);
+  std::shared_ptr<MemHandler> mem_handler = std::make_shared<MemHandler>(std::make_shared<MemoryManagerStub>());
+  (void)unsetenv("MS_DEV_OFFLOAD_DISK_PATH");
+  ASSERT_TRUE(mem_handler->enable_file_backed_host_mem());
+  scheduler->SetMemHandler(mem_handler);
+
+  // input data
+  used_tensor_num_ = 10;
+  total_step_ = 8;
+  std::vector<uint8_t> tensor_keys(used_tensor_num_, 0);
+  std::vector<uint8_t> tensor_datas(used_tensor_num_, 0);
+  std::vector<size_t> init_tensors = {0, 2, 4};
+  std::vector<size_t> offload_tensor = {1, 2, 3};
+  std::vector<std::vector<size_t>> step_used_tensors = {{0, 1},    {1, 2, 3}, {3, 4, 5}, {5, 6},
+                                                        {4, 6, 7}, {3, 7, 8}, {2, 8, 9}, {1, 9}};
+  tensor_keys_.swap(tensor_keys);
+  tensor_datas_.swap(tensor_datas);
+  init_tensors_.swap(init_tensors);
+  step_used_tensors_.swap(step_used_tensors);
+  scheduler->SetTotalStep(total_step_);
+
+  // set offload key
+  for (auto index : offload_tensor) {
+    scheduler->SetOffload(tensor_keys_.data() + index);
+  }
+  // record
+  Record(scheduler);
+  // optimize
+  ASSERT_TRUE(scheduler->Optimize());
+  // Each prefetch event is followed by the swap in event of the same memory within the prefetch span.
+  constexpr size_t kPrefetchSpan = 2;
+  auto strategy = scheduler->strategy_;
+  ASSERT_NE(strategy, nullptr);
+  size_t prefetch_num = 0;
+  for (size_t step = 0; step < total_step_; ++step) {
+    for (const auto &event : strategy->GetPreComputeEvents(step)) {
+      if (event->type != kPrefetch) {
+        continue;
+      }
+      ++prefetch_num;
+      bool swap_in_ahead = false;
+      for (size_t span = 1; span <= kPrefetchSpan; ++span) {
+        const auto &events = strategy->GetPreComputeEvents((step + span) % total_step_);
+        swap_in_ahead = swap_in_ahead || std::any_of(events.begin(), events.end(), [&event](const auto &other) {
+                          return other->type == kSwapIn && other->key == event->key;
+                        });
+      }
+      ASSERT_TRUE(swap_in_ahead);
+    }
+  }
+  ASSERT_GT(prefetch_num, 0);
+  // run twice to prefetch the data swapped out in the previous run
+  Run(scheduler);
+  Run(scheduler);
+}
+
+/// Feature: MemOffloadStrategy
+/// Description: offload the output of a cheap kernel whose input stays in device memory with a low bandwidth
+/// Expectation: the output is freed after its first use and recomputed before its next use instead of swapped
+TEST_F(TestMemScheduler, test_mem_offload_strategy_with_recompute) {
+  std::vector<uint8_t> tensor_keys(2, 0);
+  const void *input_key = tensor_keys.data();
+  const void *output_key = tensor_keys.data() + 1;
+  constexpr size_t kTotalStep = 4;
+  constexpr size_t kMemSize = 1000;
+  GraphMemStatistic<const void *> mem_statistic;
+  mem_statistic.total_compute_index_ = kTotalStep;
+  for (size_t index : {0, 3}) {
+    mem_statistic.Record(input_key, kGet, kMemSize, kMemPriorityLow, index);
+    mem_statistic.Record(output_key, kGet, kMemSize, kMemPriorityLow, index);
+  }
+  (void)mem_statistic.manual_offload_keys_.insert(output_key);
+
+  MemOffloadStrategy<const void *> strategy(mem_statistic);
+  strategy.set_mem_size(kTotalStep * kMemSize);
+  strategy.SetComputeTime(std::vector<double>(kTotalStep, 1.0));
+  strategy.SetRecomputeInfo(output_key, {input_key});
+  strategy.set_transfer_bandwidth(1.0);
+  strategy.Execute();
+
+  const auto &actions = strategy.offload_actions();
+  ASSERT_EQ(actions.size(), 1);
+  ASSERT_EQ(actions[0].key, output_key);
+  ASSERT_EQ(actions[0].type, OffloadActionType::kRecompute);
+  ASSERT_EQ(actions[0].release_index, 0);
+  ASSERT_EQ(actions[0].reload_index, 3);
+  auto has_event = [output_key](const MemEventPtrList<const void *> &events, MemEventType type) {
+    return std::any_of(events.begin(), events.end(), [output_key, type](const auto &event) {
+      return event->key == output_key && event->type == type;
+    });
+  };
+  ASSERT_TRUE(has_event(strategy.GetPostComputeEvents(0), kFree));
+  ASSERT_TRUE(has_event(strategy.GetPreComputeEvents(3), kRecompute));
+  ASSERT_FALSE(has_event(strategy.GetPostComputeEvents(0), kSwapOut));
+  ASSERT_FALSE(has_event(strategy.GetPreComputeEvents(3), kSwapIn));
+  ASSERT_FALSE(has_event(strategy.GetPreComputeEvents(3), kGet));
+
+  // Swap is cheaper than recompute with a high bandwidth.
+  strategy.set_transfer_bandwidth(1.0e6);
+  strategy.Execute();
+  ASSERT_EQ(strategy.offload_actions().size(), 1);
+  ASSERT_EQ(strategy.offload_actions()[0].type, OffloadActionType::kSwap);
+  ASSERT_TRUE(has_event(strategy.GetPreComputeEvents(3), kSwapIn));
+}
+}  // namespace mindspore::device
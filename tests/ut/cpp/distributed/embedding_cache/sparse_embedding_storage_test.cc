@@ -0,0 +1,95 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include <numeric>
+
+#include "common/common_test.h"
+#include "distributed/embedding_cache/embedding_storage/sparse_embedding_storage.h"
+#include "plugin/device/cpu/hal/device/cpu_device_address.h"
+#include "plugin/device/cpu/hal/device/cpu_hash_table.h"
+
+namespace mindspore {
+namespace distributed {
+namespace storage {
+class TestSparseEmbeddingStorage : public UT::Common {
+ public:
+  TestSparseEmbeddingStorage() = default;
+  virtual ~TestSparseEmbeddingStorage() = default;
+
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+using device::DeviceAddressPtr;
+using device::cpu::CPUDeviceAddress;
+using device::cpu::CPUHashTable;
+/// Feature: test sparse embedding storage all api.
+/// Description: put more embeddings than the capacity of host cache, and get all of them and the unseen ones.
+/// Expectation: the evicted embeddings are read back from the persistent storage, and the unseen ones are initialized
+/// with the default value.
+TEST_F(TestSparseEmbeddingStorage, test_sparse_embedding_storage) {
+  int32_t embedding_key = 1;
+  size_t embedding_dim = 8;
+  size_t capacity = 10;
+  SparseEmbeddingStorage<int, float, std::allocator<uint8_t>> embed_storage(embedding_key, embedding_dim, capacity);
+
+  auto user_data = std::make_shared<UserData>();
+  auto hash_table = std::make_shared<CPUHashTable<int, float>>(embedding_dim);
+  user_data->set<CPUHashTable<int, float>>(kUserDataData, hash_table);
+  DeviceAddressPtr device_address = std::make_shared<CPUDeviceAddress>(nullptr, 1);
+  EXPECT_NE(device_address, nullptr);
+  device_address->set_user_data(user_data);
+  EXPECT_NO_THROW(embed_storage.Initialize(device_address.get()));
+
+  // Put twice the capacity of embeddings, the first half are evicted to the persistent storage.
+  size_t key_num = capacity * 2;
+  std::vector<int> keys(key_num);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<float> embeddings_to_put(key_num * embedding_dim);
+  for (size_t i = 0; i < key_num; i++) {
+    for (size_t j = 0; j < embedding_dim; j++) {
+      embeddings_to_put[i * embedding_dim + j] = static_cast<float>(i + 1);
+    }
+  }
+  EXPECT_EQ(embed_storage.Put(keys.data(), capacity, embeddings_to_put.data()), true);
+  EXPECT_EQ(embed_storage.Put(keys.data() + capacity, capacity, embeddings_to_put.data() + capacity * embedding_dim),
+            true);
+  EXPECT_EQ(hash_table->size(), capacity);
+
+  // The batch larger than the capacity of host cache can not be held.
+  std::vector<float> embeddings_to_get(key_num * embedding_dim);
+  EXPECT_EQ(embed_storage.Get(keys.data(), key_num, embeddings_to_get.data()), false);
+
+  // Get the evicted embeddings back from the persistent storage.
+  EXPECT_EQ(embed_storage.Get(keys.data(), capacity, embeddings_to_get.data()), true);
+  EXPECT_EQ(embed_storage.Get(keys.data() + capacity, capacity, embeddings_to_get.data() + capacity * embedding_dim),
+            true);
+  EXPECT_EQ(embeddings_to_get, embeddings_to_put);
+  EXPECT_EQ(hash_table->size(), capacity);
+
+  // The embeddings never put are initialized with the default value.
+  std::vector<int> new_keys(capacity);
+  std::iota(new_keys.begin(), new_keys.end(), static_cast<int>(key_num));
+  std::vector<float> new_embeddings(capacity * embedding_dim, -1);
+  EXPECT_EQ(embed_storage.Get(new_keys.data(), capacity, new_embeddings.data()), true);
+  EXPECT_EQ(new_embeddings, std::vector<float>(capacity * embedding_dim, 0));
+
+  EXPECT_NO_THROW(embed_storage.Finalize());
+}
+}  // namespace storage
+}  // namespace distributed
+}  // namespace mindspore
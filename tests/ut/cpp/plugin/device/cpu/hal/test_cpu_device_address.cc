@@ -0,0 +1,73 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include <memory>
+#include "common/common_test.h"
+#include "ir/tensor.h"
+#include "plugin/device/cpu/hal/device/cpu_device_address.h"
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+class TestCPUDeviceAddress : public UT::Common {
+ protected:
+  void SetUp() {}
+  void TearDown() {}
+};
+
+/// Feature: bind the host tensor to the cpu device address.
+/// Description: bind the host tensor, sync the data and unbind the host tensor.
+/// Expectation: the device address shares the buffer of host tensor until unbinding.
+TEST_F(TestCPUDeviceAddress, BindHostTensor) {
+  std::vector<int64_t> shape = {2, 3};
+  auto host_tensor = std::make_shared<tensor::Tensor>(kNumberTypeFloat32, shape);
+  size_t size = 6 * sizeof(float);
+  auto device_address = std::make_shared<CPUDeviceAddress>(nullptr, size, "DefaultFormat", kNumberTypeFloat32);
+  EXPECT_FALSE(device_address->IsHostTensorBound());
+
+  device_address->BindHostTensor(host_tensor);
+  EXPECT_TRUE(device_address->IsHostTensorBound());
+  EXPECT_EQ(device_address->GetMutablePtr(), host_tensor->data_c());
+  EXPECT_FALSE(device_address->from_mem_pool());
+  EXPECT_TRUE(
+    device_address->SyncHostToDevice(shape, size, kNumberTypeFloat32, host_tensor->data_c(), "DefaultFormat"));
+
+  device_address->UnbindHostTensor();
+  EXPECT_FALSE(device_address->IsHostTensorBound());
+  EXPECT_EQ(device_address->GetPtr(), nullptr);
+}
+
+/// Feature: unbind the host tensor from the cpu device address.
+/// Description: the ptr of device address is replaced after binding.
+/// Expectation: the replaced ptr isn't reset by unbinding.
+TEST_F(TestCPUDeviceAddress, UnbindReplacedHostTensor) {
+  std::vector<int64_t> shape = {4};
+  auto host_tensor = std::make_shared<tensor::Tensor>(kNumberTypeInt32, shape);
+  std::vector<int32_t> other_buffer(4);
+  auto device_address =
+    std::make_shared<CPUDeviceAddress>(nullptr, 4 * sizeof(int32_t), "DefaultFormat", kNumberTypeInt32);
+
+  device_address->BindHostTensor(host_tensor);
+  device_address->set_ptr(other_buffer.data());
+  EXPECT_FALSE(device_address->IsHostTensorBound());
+  device_address->UnbindHostTensor();
+  EXPECT_EQ(device_address->GetPtr(), other_buffer.data());
+  device_address->set_ptr(nullptr);
+}
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
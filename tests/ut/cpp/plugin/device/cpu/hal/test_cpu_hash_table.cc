@@ -0,0 +1,253 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "common/common_test.h"
+#include "plugin/device/cpu/hal/device/cpu_hash_table.h"
+
+namespace mindspore {
+namespace device {
+namespace cpu {
+namespace {
+constexpr size_t kValueDim = 8;
+
+std::vector<float> GenValues(const std::vector<int64_t> &keys) {
+  std::vector<float> values(keys.size() * kValueDim);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    for (size_t j = 0; j < kValueDim; ++j) {
+      values[i * kValueDim + j] = static_cast<float>(keys[i] % 10007 + j);
+    }
+  }
+  return values;
+}
+
+// The hash table with one heap value per key and a global lock, which is the former implementation of the cpu hash
+// table, to compare the lookup throughput.
+class LockedMapHashTable {
+ public:
+  ~LockedMapHashTable() {
+    for (auto &item : values_) {
+      delete[] item.second;
+    }
+  }
+
+  void Insert(const int64_t *keys, size_t key_num, const float *values) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (size_t i = 0; i < key_num; ++i) {
+      auto &value = values_[keys[i]];
+      if (value == nullptr) {
+        value = new float[kValueDim];
+      }
+      std::copy(values + i * kValueDim, values + (i + 1) * kValueDim, value);
+    }
+  }
+
+  void Find(const int64_t *keys, size_t key_num, float *outputs) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (size_t i = 0; i < key_num; ++i) {
+      auto iter = values_.find(keys[i]);
+      if (iter != values_.end()) {
+        std::copy(iter->second, iter->second + kValueDim, outputs + i * kValueDim);
+      }
+    }
+  }
+
+ private:
+  std::unordered_map<int64_t, float *> values_;
+  std::shared_mutex mutex_;
+};
+
+// Look up the batches of keys in the threads and return the lookups per microsecond.
+template <typename FindFunc>
+double RunLookups(const std::vector<std::vector<int64_t>> &thread_keys, size_t batch_size, const FindFunc &find) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &keys : thread_keys) {
+    threads.emplace_back([&keys, batch_size, &find]() {
+      std::vector<float> outputs(batch_size * kValueDim);
+      for (size_t i = 0; i + batch_size <= keys.size(); i += batch_size) {
+        find(keys.data() + i, batch_size, outputs.data());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto end = std::chrono::steady_clock::now();
+  auto cost = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+  return static_cast<double>(thread_keys.size() * thread_keys.front().size()) / std::max<int64_t>(cost, 1);
+}
+}  // namespace
+
+class TestCPUHashTable : public UT::Common {
+ public:
+  TestCPUHashTable() {}
+};
+
+/// Feature: cpu hash table.
+/// Description: insert, update, find and erase the keys.
+/// Expectation: the values found are the last inserted ones and the erased keys are removed.
+TEST_F(TestCPUHashTable, test_insert_find_erase) {
+  CPUHashTable<int64_t, float> hash_table(kValueDim);
+  ASSERT_TRUE(hash_table.Initialize());
+  std::vector<int64_t> keys = {3, -7, 100000000000, 3, 42};
+  std::vector<float> values = GenValues(keys);
+  values[kValueDim * 3] = -1.0f;
+  ASSERT_TRUE(hash_table.Insert(keys.data(), keys.size(), values.data(), nullptr));
+  ASSERT_EQ(hash_table.size(), 4);
+
+  std::vector<float> outputs(keys.size() * kValueDim);
+  ASSERT_TRUE(hash_table.Find(keys.data(), keys.size(), false, outputs.data(), nullptr));
+  // The duplicate key takes the value inserted later.
+  ASSERT_EQ(outputs[0], -1.0f);
+  ASSERT_TRUE(std::equal(values.begin() + kValueDim, values.begin() + kValueDim * 3, outputs.begin() + kValueDim));
+
+  std::vector<int64_t> erased_keys = {3, 42};
+  ASSERT_TRUE(hash_table.Erase(erased_keys.data(), erased_keys.size(), nullptr));
+  ASSERT_EQ(hash_table.size(), 2);
+  std::vector<int64_t> all_keys(hash_table.size());
+  std::vector<float> all_values(hash_table.size() * kValueDim);
+  ASSERT_TRUE(hash_table.GetKeysAndValues(all_keys.data(), all_values.data(), nullptr));
+  std::sort(all_keys.begin(), all_keys.end());
+  ASSERT_EQ(all_keys, std::vector<int64_t>({-7, 100000000000}));
+  ASSERT_TRUE(hash_table.Finalize());
+  ASSERT_EQ(hash_table.size(), 0);
+}
+
+/// Feature: cpu hash table.
+/// Description: insert and erase many keys to grow and rehash the table, then reserve and export it.
+/// Expectation: all the remaining keys keep their values, and the export contains all the elements.
+TEST_F(TestCPUHashTable, test_grow_and_export) {
+  CPUHashTable<int64_t, float> hash_table(kValueDim);
+  constexpr int64_t kKeyNum = 100000;
+  std::vector<int64_t> keys(kKeyNum);
+  for (int64_t i = 0; i < kKeyNum; ++i) {
+    keys[i] = i * 31;
+  }
+  auto values = GenValues(keys);
+  ASSERT_TRUE(hash_table.Insert(keys.data(), keys.size(), values.data(), nullptr));
+  std::vector<int64_t> erased_keys(keys.begin(), keys.begin() + kKeyNum / 2);
+  ASSERT_TRUE(hash_table.Erase(erased_keys.data(), erased_keys.size(), nullptr));
+  ASSERT_TRUE(hash_table.Insert(keys.data(), keys.size(), values.data(), nullptr));
+  ASSERT_TRUE(hash_table.Reserve(kKeyNum * 4, nullptr));
+  ASSERT_GE(hash_table.capacity(), kKeyNum * 4);
+  ASSERT_EQ(hash_table.size(), kKeyNum);
+
+  std::vector<float> outputs(values.size());
+  ASSERT_TRUE(hash_table.Find(keys.data(), keys.size(), false, outputs.data(), nullptr));
+  ASSERT_EQ(outputs, values);
+
+  auto export_data = hash_table.Export(false);
+  ASSERT_EQ(export_data.size(), 3);
+  ASSERT_EQ(export_data[0]->size(), kKeyNum * sizeof(int64_t));
+  ASSERT_EQ(export_data[1]->size(), kKeyNum * kValueDim * sizeof(float));
+  auto export_keys = reinterpret_cast<const int64_t *>(export_data[0]->data());
+  auto export_values = reinterpret_cast<const float *>(export_data[1]->data());
+  for (int64_t i = 0; i < kKeyNum; ++i) {
+    auto index = export_keys[i] / 31;
+    ASSERT_TRUE(std::equal(export_values + i * kValueDim, export_values + (i + 1) * kValueDim,
+                           values.begin() + index * kValueDim));
+  }
+}
+
+/// Feature: cpu hash table.
+/// Description: insert and find the keys in the threads concurrently.
+/// Expectation: each thread finds the values it inserted and the size counts all the keys.
+TEST_F(TestCPUHashTable, test_concurrent_insert_find) {
+  CPUHashTable<int64_t, float> hash_table(kValueDim);
+  constexpr size_t kThreadNum = 4;
+  constexpr size_t kBatchNum = 100;
+  constexpr size_t kBatchSize = 256;
+  std::vector<std::thread> threads;
+  // Not std::vector<bool>, whose elements share the words written by the threads.
+  std::vector<int> results(kThreadNum, 1);
+  for (size_t t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back([&hash_table, &results, t]() {
+      for (size_t b = 0; b < kBatchNum; ++b) {
+        std::vector<int64_t> keys(kBatchSize);
+        for (size_t i = 0; i < kBatchSize; ++i) {
+          keys[i] = static_cast<int64_t>((t * kBatchNum + b) * kBatchSize + i);
+        }
+        auto values = GenValues(keys);
+        std::vector<float> outputs(values.size());
+        if (!hash_table.Insert(keys.data(), keys.size(), values.data(), nullptr) ||
+            !hash_table.Find(keys.data(), keys.size(), false, outputs.data(), nullptr) || outputs != values) {
+          results[t] = 0;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_TRUE(std::all_of(results.begin(), results.end(), [](int result) { return result != 0; }));
+  ASSERT_EQ(hash_table.size(), kThreadNum * kBatchNum * kBatchSize);
+}
+
+/// Feature: the lookup throughput benchmark of cpu hash table.
+/// Description: look up the random keys in the threads from the cpu hash table and the locked unordered map.
+/// Expectation: both tables find the same values.
+/// It is disabled by default, run it with --gtest_also_run_disabled_tests to print the throughput.
+TEST_F(TestCPUHashTable, DISABLED_test_lookup_benchmark) {
+  constexpr size_t kKeyNum = 1 << 20;
+  constexpr size_t kLookupNum = 1 << 20;
+  constexpr size_t kBatchSize = 4096;
+  std::mt19937_64 gen(0);
+  std::vector<int64_t> keys(kKeyNum);
+  for (auto &key : keys) {
+    key = static_cast<int64_t>(gen() >> 1);
+  }
+  auto values = GenValues(keys);
+  CPUHashTable<int64_t, float> hash_table(kValueDim);
+  LockedMapHashTable locked_map;
+  ASSERT_TRUE(hash_table.Insert(keys.data(), keys.size(), values.data(), nullptr));
+  locked_map.Insert(keys.data(), keys.size(), values.data());
+
+  std::vector<int64_t> batch(keys.begin(), keys.begin() + kBatchSize);
+  std::vector<float> outputs(kBatchSize * kValueDim);
+  std::vector<float> expect_outputs(kBatchSize * kValueDim);
+  ASSERT_TRUE(hash_table.Find(batch.data(), batch.size(), false, outputs.data(), nullptr));
+  locked_map.Find(batch.data(), batch.size(), expect_outputs.data());
+  ASSERT_EQ(outputs, expect_outputs);
+
+  for (size_t thread_num : {1, 4}) {
+    std::vector<std::vector<int64_t>> thread_keys(thread_num, std::vector<int64_t>(kLookupNum));
+    for (auto &lookup_keys : thread_keys) {
+      for (auto &key : lookup_keys) {
+        key = keys[gen() % kKeyNum];
+      }
+    }
+    auto hash_table_speed = RunLookups(thread_keys, kBatchSize, [&hash_table](const int64_t *k, size_t n, float *o) {
+      (void)hash_table.Find(k, n, false, o, nullptr);
+    });
+    auto locked_map_speed = RunLookups(thread_keys, kBatchSize, [&locked_map](const int64_t *k, size_t n, float *o) {
+      locked_map.Find(k, n, o);
+    });
+    MS_LOG(WARNING) << "Lookup " << kKeyNum << " keys in " << thread_num << " threads, cpu hash table: "
+                    << hash_table_speed << "M/s, locked unordered map: " << locked_map_speed << "M/s.";
+  }
+}
+}  // namespace cpu
+}  // namespace device
+}  // namespace mindspore
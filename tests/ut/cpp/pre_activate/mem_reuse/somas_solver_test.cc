@@ -0,0 +1,134 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/common_test.h"
+#include "backend/common/session/kernel_graph.h"
+#include "backend/common/somas/somas_solver_pre.h"
+#include "backend/common/somas/somas_tensor.h"
+#define private public
+#include "backend/common/somas/somas.h"
+#undef private
+
+namespace mindspore {
+namespace somas {
+class TestSomasSolver : public UT::Common {
+ public:
+  TestSomasSolver() {}
+};
+
+namespace {
+constexpr size_t kTensorNum = 3;
+constexpr size_t kTensorSize = 512;
+
+class TestSomas : public Somas {
+ private:
+  bool Initialize() override { return true; }
+  string GetDeviceName() const override { return "TEST"; }
+  size_t GetAlignSize(size_t original_size) const override { return original_size; }
+  bool GetDependExecOrderFlag(const session::KernelGraph &) const override { return false; }
+  bool InitDevSpecControlTensors(const session::KernelGraph &) override { return true; }
+  bool DevSpecNodeProcess(const session::KernelGraph &) override { return true; }
+  bool NeedContiguous(const std::vector<size_t> &) const override { return false; }
+};
+
+// The tensors conflict with each other, so every strategy needs the total size of them.
+TensorsDescMap BuildConflictTensors(std::vector<DynamicBitSet> *constraints) {
+  TensorsDescMap tensors;
+  for (size_t i = 0; i < kTensorNum; i++) {
+    tensors[i] = std::make_shared<SomasSolverTensorDesc>(i, kTensorSize, 0, false);
+    constraints->emplace_back(kTensorNum);
+  }
+  return tensors;
+}
+
+void BuildSomasTensors(TestSomas *somas, size_t last_end) {
+  for (size_t i = 0; i < kTensorNum; i++) {
+    auto tensor = std::make_shared<SomasTensor>(i, i, 0, kTensorSize, kTensorSize);
+    tensor->lifetime_.start_ = i;
+    tensor->lifetime_.end_ = (i + 1 == kTensorNum) ? last_end : i + 1;
+    somas->tensors_list_.push_back(tensor);
+    somas->reuse_matrix_.emplace_back(kTensorNum);
+  }
+}
+}  // namespace
+
+/// Feature: Somas solver lower bound.
+/// Description: solve the conflicting tensors with the preferred strategy and the lower bound of their total size.
+/// Expectation: the preferred strategy reaches the lower bound and the other strategies are skipped.
+TEST_F(TestSomasSolver, StopAtLowerBound) {
+  auto graph = std::make_shared<session::KernelGraph>();
+  std::vector<DynamicBitSet> constraints;
+  auto tensors = BuildConflictTensors(&constraints);
+  SomasStrategy preferred{kSingleObject, kGreaterSizeSmallerIndex, kSmallest};
+  SomasSolverPre solver;
+  solver.SetLowerBound(kTensorNum * kTensorSize);
+  solver.SetPreferredStrategy(preferred);
+  ASSERT_EQ(solver.Solving(*graph, &tensors, &constraints, {}, true), SUCCESS);
+  ASSERT_EQ(solver.GetMaxOffset(), kTensorNum * kTensorSize);
+  ASSERT_EQ(solver.GetSolvedNum(), 1);
+  ASSERT_EQ(solver.GetBestStrategy().algorithm, preferred.algorithm);
+  ASSERT_EQ(solver.GetBestStrategy().sorting, preferred.sorting);
+  ASSERT_EQ(solver.GetBestStrategy().fitting, preferred.fitting);
+
+  // Without the lower bound all the strategies are solved.
+  std::vector<DynamicBitSet> all_constraints;
+  auto all_tensors = BuildConflictTensors(&all_constraints);
+  SomasSolverPre all_solver;
+  ASSERT_EQ(all_solver.Solving(*graph, &all_tensors, &all_constraints, {}, true), SUCCESS);
+  ASSERT_EQ(all_solver.GetMaxOffset(), kTensorNum * kTensorSize);
+  ASSERT_EQ(all_solver.GetSolvedNum(), static_cast<size_t>(kNumAlgorithmTypes * kNumSortingTypes * kNumFittingTypes));
+}
+
+/// Feature: Somas strategy cache.
+/// Description: calculate the structure hash of the different lifetimes, and load the strategy of another hash.
+/// Expectation: the hashes differ, and the strategy file of the mismatched hash is rejected.
+TEST_F(TestSomasSolver, RejectMismatchedStrategyHash) {
+  TestSomas somas1;
+  TestSomas somas2;
+  TestSomas somas3;
+  BuildSomasTensors(&somas1, kTensorNum);
+  BuildSomasTensors(&somas2, kTensorNum);
+  BuildSomasTensors(&somas3, kTensorNum + 1);
+  auto hash = somas1.CalcSomasStructureHash();
+  ASSERT_EQ(hash, somas2.CalcSomasStructureHash());
+  auto other_hash = somas3.CalcSomasStructureHash();
+  ASSERT_NE(hash, other_hash);
+
+  SomasStrategy strategy{kSingleObject, kGreaterSizeSmallerIndex, kSmallest};
+  somas1.SaveSomasStrategy(hash, strategy);
+  auto loaded = somas2.LoadSomasStrategy(hash);
+  ASSERT_TRUE(loaded.has_value());
+  ASSERT_EQ(loaded->algorithm, strategy.algorithm);
+  ASSERT_EQ(loaded->sorting, strategy.sorting);
+  ASSERT_EQ(loaded->fitting, strategy.fitting);
+
+  // The strategy file of the other graph structure is not reused even if it is found by the file name.
+  {
+    std::ifstream src(somas1.GetSomasStrategyFileName(hash));
+    std::ofstream dst(somas3.GetSomasStrategyFileName(other_hash));
+    dst << src.rdbuf();
+  }
+  ASSERT_FALSE(somas3.LoadSomasStrategy(other_hash).has_value());
+  (void)std::remove(somas1.GetSomasStrategyFileName(hash).c_str());
+  (void)std::remove(somas3.GetSomasStrategyFileName(other_hash).c_str());
+}
+}  // namespace somas
+}  // namespace mindspore
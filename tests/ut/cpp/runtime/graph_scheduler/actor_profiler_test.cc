@@ -0,0 +1,75 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/common_test.h"
+#include "runtime/graph_scheduler/actor_profiler.h"
+
+namespace mindspore {
+namespace runtime {
+class ActorProfilerTest : public UT::Common {
+ public:
+  ActorProfilerTest() {}
+};
+
+/// Feature: actor profiler.
+/// Description: push more events than the capacity of ring buffer and drain the buffer.
+/// Expectation: the oldest event is overwritten and the other events are drained in the order of writing.
+TEST_F(ActorProfilerTest, test_ring_buffer_overwrite) {
+  ActorTraceRingBuffer buffer(0, 2);
+  buffer.Push({nullptr, ActorTraceEventType::kRun, 0, 10});
+  buffer.Push({nullptr, ActorTraceEventType::kSend, 20, 20});
+  buffer.Push({nullptr, ActorTraceEventType::kLaunch, 30, 40});
+
+  std::vector<ActorTraceEvent> events;
+  ASSERT_EQ(buffer.Drain(&events), 1);
+  ASSERT_EQ(events.size(), 2);
+  ASSERT_EQ(events[0].start_, 20);
+  ASSERT_EQ(events[1].start_, 30);
+
+  events.clear();
+  ASSERT_EQ(buffer.Drain(&events), 0);
+  ASSERT_TRUE(events.empty());
+}
+
+/// Feature: actor profiler.
+/// Description: actor C depends on actor A and actor B which run in the different threads, and the output of actor A
+/// arrives later.
+/// Expectation: the critical path is A -> C with the queue time of C, and the idle ratio counts the idle threads.
+TEST_F(ActorProfilerTest, test_analyze_critical_path) {
+  std::vector<ActorTraceRecord> records = {{"A", 0, ActorTraceEventType::kRun, 0, 100},
+                                           {"A", 0, ActorTraceEventType::kSend, 90, 90},
+                                           {"B", 1, ActorTraceEventType::kRun, 0, 50},
+                                           {"B", 1, ActorTraceEventType::kSend, 40, 40},
+                                           {"C", 0, ActorTraceEventType::kRun, 120, 200},
+                                           {"C", 0, ActorTraceEventType::kSend, 180, 180}};
+  mindspore::HashMap<std::string, std::vector<std::string>> actor_inputs = {{"C", {"A", "B"}}};
+
+  auto summary = ActorProfiler::Analyze(records, actor_inputs);
+  ASSERT_EQ(summary.step_time_, 200);
+  ASSERT_EQ(summary.critical_path_time_, 180);
+  ASSERT_EQ(summary.critical_path_.size(), 2);
+  ASSERT_EQ(summary.critical_path_[0].actor_name_, "A");
+  ASSERT_EQ(summary.critical_path_[0].queue_time_, 0);
+  ASSERT_EQ(summary.critical_path_[0].exec_time_, 90);
+  ASSERT_EQ(summary.critical_path_[1].actor_name_, "C");
+  ASSERT_EQ(summary.critical_path_[1].queue_time_, 30);
+  ASSERT_EQ(summary.critical_path_[1].exec_time_, 60);
+  ASSERT_EQ(summary.thread_busy_times_.at(0), 180);
+  ASSERT_EQ(summary.thread_busy_times_.at(1), 50);
+  ASSERT_DOUBLE_EQ(summary.thread_idle_ratio_, 0.425);
+}
+}  // namespace runtime
+}  // namespace mindspore
@@ -0,0 +1,153 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include "common/common_test.h"
+#include "runtime/graph_scheduler/graph_scheduler_common_test.h"
+#include "runtime/graph_scheduler/actor/memory_manager_actor.h"
+#define private public
+#define protected public
+#include "runtime/graph_scheduler/actor/kernel_actor.h"
+#undef private
+#undef protected
+
+namespace mindspore {
+namespace runtime {
+class KernelActorTest : public UT::Common {
+ public:
+  KernelActorTest() {}
+};
+
+namespace {
+class PrefetchResManager : public test::TestDeviceResManager {
+ public:
+  void *AllocateMemory(size_t size) const override { return malloc(size); }
+  void FreeMemory(void *const ptr) const override { free(ptr); }
+};
+
+class PrefetchDeviceContext : public device::DeviceInterface<test::TestKernelExecutor, PrefetchResManager> {
+ public:
+  explicit PrefetchDeviceContext(const device::DeviceContextKey &device_context_key)
+      : DeviceInterface(device_context_key) {}
+  ~PrefetchDeviceContext() override = default;
+  void Initialize() override {}
+  device::DeviceType GetDeviceType() const override { return device::DeviceType::kCPU; }
+  device::RunMode GetRunMode(const FuncGraphPtr &func_graph) const override { return device::RunMode::kKernelMode; }
+};
+
+// Build the dynamic shape kernel actor with one output and one workspace of 4 bytes.
+std::shared_ptr<KernelActor> BuildPrefetchKernelActor(const KernelGraphPtr &kernel_graph,
+                                                      const DeviceContext *device_context,
+                                                      const std::shared_ptr<MemoryManagerActor> &memory_manager_actor) {
+  std::vector<AnfNodePtr> inputs{NewValueNode(prim::kPrimLess)};
+  auto backend_node = kernel_graph->NewCNode(inputs);
+  MS_EXCEPTION_IF_NULL(backend_node);
+  test::TestKernelExecutor kernel_executor;
+  kernel_executor.CreateKernel({backend_node});
+  AnfAlgo::SetOutputAddr(std::make_shared<test::TestDeviceAddress>(nullptr, 4), 0, backend_node.get());
+  AnfAlgo::SetWorkspaceAddr(std::make_shared<test::TestDeviceAddress>(nullptr, 4), 0, backend_node.get());
+  std::set<size_t> ref_input_indexes;
+  std::set<size_t> ref_output_indexes;
+  auto kernel_actor =
+    std::make_shared<KernelActor>("kernel_actor", backend_node, device_context, memory_manager_actor->GetAID(), nullptr,
+                                  nullptr, GraphExecutionStrategy::kPipeline, ref_input_indexes, ref_output_indexes);
+  kernel_actor->Init();
+  kernel_actor->is_dynamic_shape_ = true;
+  return kernel_actor;
+}
+
+void FreePrefetchedMemory(const std::shared_ptr<KernelActor> &kernel_actor) {
+  for (auto &device_tensor : kernel_actor->memory_alloc_list_) {
+    free(const_cast<void *>(device_tensor->GetPtr()));
+    device_tensor->set_ptr(nullptr);
+  }
+}
+}  // namespace
+
+/// Feature: memory prefetch of the dynamic shape kernel.
+/// Description: prefetch the memory after the resize, and the run of the same step consumes the prefetch.
+/// Expectation: the output and workspace are allocated in the prefetch, and the prefetch is consumed only once.
+TEST_F(KernelActorTest, test_prefetch_memory) {
+  auto memory_manager_actor = std::make_shared<MemoryManagerActor>();
+  PrefetchDeviceContext device_context({"CPU", 0});
+  auto kernel_graph = std::make_shared<KernelGraph>();
+  auto kernel_actor = BuildPrefetchKernelActor(kernel_graph, &device_context, memory_manager_actor);
+  ASSERT_EQ(kernel_actor->memory_alloc_list_.size(), 2);
+
+  std::vector<Promise<int>> results(1);
+  OpContext<DeviceTensor> context;
+  context.sequential_num_ = 1;
+  context.results_ = &results;
+  kernel_actor->PrefetchMemory(&context);
+  ASSERT_TRUE(kernel_actor->is_memory_prefetched_);
+  for (auto &device_tensor : kernel_actor->memory_alloc_list_) {
+    ASSERT_NE(device_tensor->GetPtr(), nullptr);
+  }
+
+  ASSERT_TRUE(kernel_actor->TakePrefetchedMemory(&context));
+  ASSERT_FALSE(kernel_actor->is_memory_prefetched_);
+  // The next step fetches and allocates the memory again.
+  ASSERT_FALSE(kernel_actor->TakePrefetchedMemory(&context));
+  FreePrefetchedMemory(kernel_actor);
+}
+
+/// Feature: memory prefetch of the dynamic shape kernel.
+/// Description: the step which prefetches the memory is aborted, and the kernel actor runs in the next step.
+/// Expectation: the stale prefetch is discarded.
+TEST_F(KernelActorTest, test_stale_prefetch_memory) {
+  auto memory_manager_actor = std::make_shared<MemoryManagerActor>();
+  PrefetchDeviceContext device_context({"CPU", 0});
+  auto kernel_graph = std::make_shared<KernelGraph>();
+  auto kernel_actor = BuildPrefetchKernelActor(kernel_graph, &device_context, memory_manager_actor);
+
+  std::vector<Promise<int>> results(1);
+  OpContext<DeviceTensor> aborted_context;
+  aborted_context.sequential_num_ = 1;
+  aborted_context.results_ = &results;
+  kernel_actor->PrefetchMemory(&aborted_context);
+  ASSERT_TRUE(kernel_actor->is_memory_prefetched_);
+  ASSERT_EQ(kernel_actor->prefetched_sequential_num_, 1);
+
+  OpContext<DeviceTensor> next_context;
+  next_context.sequential_num_ = 2;
+  next_context.results_ = &results;
+  ASSERT_FALSE(kernel_actor->TakePrefetchedMemory(&next_context));
+  ASSERT_FALSE(kernel_actor->is_memory_prefetched_);
+  FreePrefetchedMemory(kernel_actor);
+}
+
+/// Feature: memory prefetch of the dynamic shape kernel.
+/// Description: prefetch the memory of the kernel which is not dynamic shape.
+/// Expectation: nothing is prefetched.
+TEST_F(KernelActorTest, test_prefetch_memory_of_static_shape) {
+  auto memory_manager_actor = std::make_shared<MemoryManagerActor>();
+  PrefetchDeviceContext device_context({"CPU", 0});
+  auto kernel_graph = std::make_shared<KernelGraph>();
+  auto kernel_actor = BuildPrefetchKernelActor(kernel_graph, &device_context, memory_manager_actor);
+  kernel_actor->is_dynamic_shape_ = false;
+
+  std::vector<Promise<int>> results(1);
+  OpContext<DeviceTensor> context;
+  context.sequential_num_ = 1;
+  context.results_ = &results;
+  kernel_actor->PrefetchMemory(&context);
+  ASSERT_FALSE(kernel_actor->is_memory_prefetched_);
+  for (auto &device_tensor : kernel_actor->memory_alloc_list_) {
+    ASSERT_EQ(device_tensor->GetPtr(), nullptr);
+  }
+}
+}  // namespace runtime
+}  // namespace mindspore
@@ -0,0 +1,205 @@
+/**
+ * Copyright 2023 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdlib>
+#include "common/common_test.h"
+#include "runtime/graph_scheduler/memory_plan_cache.h"
+#include "runtime/graph_scheduler/actor/actor_common.h"
+#include "runtime/graph_scheduler/graph_scheduler_common_test.h"
+
+namespace mindspore {
+namespace runtime {
+class MemoryPlanCacheTest : public UT::Common {
+ public:
+  MemoryPlanCacheTest() {}
+};
+
+namespace {
+// Count the memory of whole blocks which is not freed.
+size_t g_allocated_block_num = 0;
+
+class MemoryPlanResManager : public test::TestDeviceResManager {
+ public:
+  void *AllocateMemory(size_t size) const override {
+    ++g_allocated_block_num;
+    return malloc(size);
+  }
+  void FreeMemory(void *const ptr) const override {
+    --g_allocated_block_num;
+    free(ptr);
+  }
+};
+
+class MemoryPlanDeviceContext : public device::DeviceInterface<test::TestKernelExecutor, MemoryPlanResManager> {
+ public:
+  explicit MemoryPlanDeviceContext(const device::DeviceContextKey &device_context_key)
+      : DeviceInterface(device_context_key) {}
+  ~MemoryPlanDeviceContext() override = default;
+  void Initialize() override {}
+  device::DeviceType GetDeviceType() const override { return device::DeviceType::kCPU; }
+  device::RunMode GetRunMode(const FuncGraphPtr &func_graph) const override { return device::RunMode::kKernelMode; }
+};
+}  // namespace
+
+/// Feature: memory plan cache in the dynamic shape scenario.
+/// Description: generate the offsets of tensors whose lifetimes are not overlapped.
+/// Expectation: the tensors share the same memory and the whole block size is the max aligned size.
+TEST_F(MemoryPlanCacheTest, test_generate_offsets_without_overlap) {
+  std::vector<MemoryPlanTensorInfo> tensor_infos;
+  (void)tensor_infos.emplace_back(nullptr, 100, 0);
+  tensor_infos.back().free_time_ = 1;
+  (void)tensor_infos.emplace_back(nullptr, 1000, 2);
+  tensor_infos.back().free_time_ = 3;
+
+  std::vector<size_t> offsets;
+  auto whole_block_size = MemoryPlanCache::GenerateOffsets(tensor_infos, &offsets);
+  ASSERT_EQ(offsets.size(), 2);
+  ASSERT_EQ(offsets[0], 0);
+  ASSERT_EQ(offsets[1], 0);
+  ASSERT_EQ(whole_block_size, 1024);
+}
+
+/// Feature: memory plan cache in the dynamic shape scenario.
+/// Description: generate the offsets of tensors whose lifetimes are overlapped.
+/// Expectation: the overlapped tensors don't share the memory and the freed gap is reused by the best fit.
+TEST_F(MemoryPlanCacheTest, test_generate_offsets_with_overlap) {
+  std::vector<MemoryPlanTensorInfo> tensor_infos;
+  // Lifetime [0, 3).
+  (void)tensor_infos.emplace_back(nullptr, 512, 0);
+  tensor_infos.back().free_time_ = 3;
+  // Lifetime [1, 6).
+  (void)tensor_infos.emplace_back(nullptr, 600, 1);
+  tensor_infos.back().free_time_ = 6;
+  // Lifetime [2, 5), overlapped with the first and second tensors.
+  (void)tensor_infos.emplace_back(nullptr, 512, 2);
+  tensor_infos.back().free_time_ = 5;
+  // Lifetime [4, 7), reuses the memory of the first tensor.
+  (void)tensor_infos.emplace_back(nullptr, 100, 4);
+  tensor_infos.back().free_time_ = 7;
+
+  std::vector<size_t> offsets;
+  auto whole_block_size = MemoryPlanCache::GenerateOffsets(tensor_infos, &offsets);
+  ASSERT_EQ(offsets.size(), 4);
+  ASSERT_EQ(offsets[0], 0);
+  ASSERT_EQ(offsets[1], 512);
+  ASSERT_EQ(offsets[2], 1536);
+  ASSERT_EQ(offsets[3], 0);
+  ASSERT_EQ(whole_block_size, 2048);
+}
+
+/// Feature: memory plan cache in the dynamic shape scenario.
+/// Description: end the replaying step while a device tensor of the whole block is still in use.
+/// Expectation: the whole block is released when the device tensor in use is freed after the step.
+TEST_F(MemoryPlanCacheTest, test_defer_release_whole_block) {
+  MemoryPlanDeviceContext device_context({"CPU", 0});
+  auto device_tensor = std::make_shared<test::TestDeviceAddress>(nullptr, 100);
+  auto &memory_plan_cache = MemoryPlanCache::GetInstance();
+  const std::string actor_set_name = "test_defer_release_whole_block";
+  g_allocated_block_num = 0;
+
+  // Record the memory plan.
+  memory_plan_cache.BeginStep(actor_set_name, {}, true);
+  ASSERT_FALSE(memory_plan_cache.AllocateMemory(device_tensor.get(), &device_context));
+  ASSERT_FALSE(memory_plan_cache.FreeMemory(device_tensor.get()));
+  memory_plan_cache.EndStep();
+
+  // Replay the memory plan and end the step without freeing the device tensor.
+  memory_plan_cache.BeginStep(actor_set_name, {}, true);
+  ASSERT_EQ(g_allocated_block_num, 1);
+  ASSERT_TRUE(memory_plan_cache.AllocateMemory(device_tensor.get(), &device_context));
+  ASSERT_NE(device_tensor->GetPtr(), nullptr);
+  memory_plan_cache.EndStep();
+  ASSERT_EQ(g_allocated_block_num, 1);
+
+  ASSERT_TRUE(memory_plan_cache.FreeMemory(device_tensor.get()));
+  ASSERT_EQ(device_tensor->GetPtr(), nullptr);
+  ASSERT_EQ(g_allocated_block_num, 0);
+  ASSERT_FALSE(memory_plan_cache.FreeMemory(device_tensor.get()));
+  memory_plan_cache.Clear(actor_set_name);
+}
+
+/// Feature: memory plan cache in the dynamic shape scenario.
+/// Description: free the device tensor of memory plan through the device context as the actors do.
+/// Expectation: the memory is released to the memory plan instead of the memory pool.
+TEST_F(MemoryPlanCacheTest, test_free_by_device_context) {
+  MemoryPlanDeviceContext device_context({"CPU", 0});
+  auto device_tensor = std::make_shared<test::TestDeviceAddress>(nullptr, 100);
+  auto &memory_plan_cache = MemoryPlanCache::GetInstance();
+  const std::string actor_set_name = "test_free_by_device_context";
+  g_allocated_block_num = 0;
+
+  memory_plan_cache.BeginStep(actor_set_name, {}, true);
+  ASSERT_FALSE(memory_plan_cache.AllocateMemory(device_tensor.get(), &device_context));
+  ASSERT_FALSE(memory_plan_cache.FreeMemory(device_tensor.get()));
+  memory_plan_cache.EndStep();
+
+  memory_plan_cache.BeginStep(actor_set_name, {}, true);
+  ASSERT_TRUE(memory_plan_cache.AllocateMemory(device_tensor.get(), &device_context));
+  ASSERT_FALSE(device_tensor->from_mem_pool());
+  FreeMemoryByDeviceContext(device_tensor.get(), &device_context);
+  ASSERT_EQ(device_tensor->GetPtr(), nullptr);
+  // The whole block isn't freed to the memory pool by the device tensor.
+  ASSERT_EQ(g_allocated_block_num, 1);
+  memory_plan_cache.EndStep();
+  ASSERT_EQ(g_allocated_block_num, 0);
+  memory_plan_cache.Clear(actor_set_name);
+}
+
+/// Feature: memory plan cache in the dynamic shape scenario.
+/// Description: the ptr of device tensor in use is freed or replaced outside the memory plan.
+/// Expectation: the device tensor is dropped from the whole block, which is released at the end of step, and the
+/// memory plan is recorded again.
+TEST_F(MemoryPlanCacheTest, test_free_outside_memory_plan) {
+  MemoryPlanDeviceContext device_context({"CPU", 0});
+  auto device_tensor = std::make_shared<test::TestDeviceAddress>(nullptr, 100);
+  auto &memory_plan_cache = MemoryPlanCache::GetInstance();
+  const std::string actor_set_name = "test_free_outside_memory_plan";
+  g_allocated_block_num = 0;
+
+  memory_plan_cache.BeginStep(actor_set_name, {}, true);
+  ASSERT_FALSE(memory_plan_cache.AllocateMemory(device_tensor.get(), &device_context));
+  ASSERT_FALSE(memory_plan_cache.FreeMemory(device_tensor.get()));
+  memory_plan_cache.EndStep();
+
+  // The device tensor is freed outside the memory plan and the whole block isn't kept by it.
+  memory_plan_cache.BeginStep(actor_set_name, {}, true);
+  ASSERT_TRUE(memory_plan_cache.AllocateMemory(device_tensor.get(), &device_context));
+  device_tensor->set_ptr(nullptr);
+  memory_plan_cache.EndStep();
+  ASSERT_EQ(g_allocated_block_num, 0);
+
+  // The mismatched memory plan is recorded again.
+  auto miss_count = memory_plan_cache.miss_count();
+  memory_plan_cache.BeginStep(actor_set_name, {}, true);
+  ASSERT_EQ(memory_plan_cache.miss_count(), miss_count + 1);
+  ASSERT_FALSE(memory_plan_cache.AllocateMemory(device_tensor.get(), &device_context));
+  ASSERT_FALSE(memory_plan_cache.FreeMemory(device_tensor.get()));
+  memory_plan_cache.EndStep();
+
+  // The ptr replaced outside the memory plan is freed by the caller, not released to the memory plan.
+  memory_plan_cache.BeginStep(actor_set_name, {}, true);
+  ASSERT_TRUE(memory_plan_cache.AllocateMemory(device_tensor.get(), &device_context));
+  int replaced_data = 0;
+  device_tensor->set_ptr(&replaced_data);
+  ASSERT_FALSE(memory_plan_cache.FreeMemory(device_tensor.get()));
+  ASSERT_EQ(device_tensor->GetPtr(), &replaced_data);
+  memory_plan_cache.EndStep();
+  ASSERT_EQ(g_allocated_block_num, 0);
+  device_tensor->set_ptr(nullptr);
+  memory_plan_cache.Clear(actor_set_name);
+}
+}  // namespace runtime
+}  // namespace mindspore